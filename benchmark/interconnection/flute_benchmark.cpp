@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include <ophidian/interconnection/Flute.h>
+#include <ophidian/interconnection/SteinerTree.h>
+
+namespace
+{
+    using ophidian::interconnection::Flute;
+
+    std::vector<Flute::Point> make_pins(std::size_t degree, unsigned seed)
+    {
+        auto generator = std::mt19937{seed};
+        auto distribution = std::uniform_int_distribution<int>{0, 100000};
+
+        auto pins = std::vector<Flute::Point>{};
+        pins.reserve(degree);
+        for(std::size_t i = 0; i < degree; ++i)
+        {
+            pins.emplace_back(Flute::dbu_t{static_cast<double>(distribution(generator))}, Flute::dbu_t{static_cast<double>(distribution(generator))});
+        }
+
+        return pins;
+    }
+
+    // state.range(0): number of pins, state.range(1): maximum FLUTE degree
+    void steiner_tree(benchmark::State & state)
+    {
+        auto degree = static_cast<std::size_t>(state.range(0));
+        auto & flute = Flute::instance();
+        auto previous = flute.maxFluteDegree();
+        flute.maxFluteDegree(static_cast<std::size_t>(state.range(1)));
+        auto pins = make_pins(degree, 1);
+        auto length = 0.0;
+
+        for(auto _ : state)
+        {
+            length = units::unit_cast<double>(flute.create(pins)->length());
+            benchmark::DoNotOptimize(length);
+        }
+
+        flute.maxFluteDegree(previous);
+        state.counters["length"] = length;
+        state.SetItemsProcessed(state.iterations() * degree);
+    }
+}
+
+// low degree nets use the lookup table, mid-range ones are broken by FLUTE
+BENCHMARK(steiner_tree)->Args({4, 512})->Args({9, 512})->Args({16, 512})->Args({64, 512})->Args({256, 512});
+
+// high fanout nets, FLUTE net breaking against the spanning tree heuristic
+BENCHMARK(steiner_tree)->Args({256, 0})->Args({1024, 1 << 20})->Args({1024, 0})->Args({8192, 1 << 20})->Args({8192, 0})->Args({65536, 0});
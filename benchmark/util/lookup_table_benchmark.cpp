@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include <ophidian/util/LookupTable.h>
+#include <ophidian/util/Units.h>
+
+namespace
+{
+    template <class Unit>
+    ophidian::util::TableContents<Unit, Unit, Unit> make_contents(std::size_t rows, std::size_t columns)
+    {
+        auto contents = ophidian::util::TableContents<Unit, Unit, Unit>{};
+
+        for(std::size_t i = 0; i < rows; ++i)
+        {
+            contents.row_values.push_back(Unit{static_cast<double>(i * i)});
+        }
+
+        for(std::size_t j = 0; j < columns; ++j)
+        {
+            contents.column_values.push_back(Unit{static_cast<double>(3 * j)});
+        }
+
+        for(std::size_t i = 0; i < rows; ++i)
+        {
+            auto row = std::vector<Unit>{};
+            for(std::size_t j = 0; j < columns; ++j)
+            {
+                row.push_back(Unit{static_cast<double>(i + 2 * j)});
+            }
+            contents.values.push_back(std::move(row));
+        }
+
+        return contents;
+    }
+
+    template <class Unit>
+    std::vector<Unit> make_points(std::size_t n, double max, unsigned seed)
+    {
+        auto generator = std::mt19937{seed};
+        auto distribution = std::uniform_real_distribution<double>{-0.1 * max, 1.1 * max};
+
+        auto points = std::vector<Unit>{};
+        points.reserve(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            points.push_back(Unit{distribution(generator)});
+        }
+
+        return points;
+    }
+
+    template <class Unit>
+    using interpolation_table = ophidian::util::LookupTable<Unit, Unit, Unit,
+        ophidian::util::InterpolationStrategy<Unit, Unit, Unit>>;
+
+    // state.range(0): number of points, state.range(1): table dimension (square)
+    template <class Unit>
+    void scalar_interpolation(benchmark::State & state)
+    {
+        auto n = static_cast<std::size_t>(state.range(0));
+        auto dimension = static_cast<std::size_t>(state.range(1));
+        auto table = interpolation_table<Unit>{make_contents<Unit>(dimension, dimension)};
+        auto rows = make_points<Unit>(n, static_cast<double>((dimension - 1) * (dimension - 1)), 1);
+        auto columns = make_points<Unit>(n, static_cast<double>(3 * (dimension - 1)), 2);
+        auto out = std::vector<Unit>(n);
+
+        for(auto _ : state)
+        {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = table.compute(rows[i], columns[i]);
+            }
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+
+    template <class Unit>
+    void batch_interpolation(benchmark::State & state)
+    {
+        auto n = static_cast<std::size_t>(state.range(0));
+        auto dimension = static_cast<std::size_t>(state.range(1));
+        auto table = interpolation_table<Unit>{make_contents<Unit>(dimension, dimension)};
+        auto rows = make_points<Unit>(n, static_cast<double>((dimension - 1) * (dimension - 1)), 1);
+        auto columns = make_points<Unit>(n, static_cast<double>(3 * (dimension - 1)), 2);
+        auto out = std::vector<Unit>(n);
+
+        for(auto _ : state)
+        {
+            table.compute_batch(rows.data(), columns.data(), out.data(), n);
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+}
+
+BENCHMARK_TEMPLATE(scalar_interpolation, double)->Args({4096, 4})->Args({4096, 7})->Args({65536, 7});
+BENCHMARK_TEMPLATE(batch_interpolation, double)->Args({4096, 4})->Args({4096, 7})->Args({65536, 7});
+BENCHMARK_TEMPLATE(scalar_interpolation, ophidian::util::database_unit_t)->Args({4096, 7})->Args({65536, 7});
+BENCHMARK_TEMPLATE(batch_interpolation, ophidian::util::database_unit_t)->Args({4096, 7})->Args({65536, 7});
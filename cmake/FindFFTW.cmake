@@ -0,0 +1,17 @@
+find_path(FFTW_INCLUDE_DIR "fftw3.h" PATHS "/usr/include" )
+find_library(FFTW_LIBRARY "fftw3" PATHS "/usr/lib" "/usr/lib/x86_64-linux-gnu")
+
+include(FindPackageHandleStandardArgs)
+
+find_package_handle_standard_args(FFTW DEFAULT_MSG
+    FFTW_INCLUDE_DIR
+    FFTW_LIBRARY
+)
+
+if(FFTW_FOUND)
+    add_library(FFTW::fftw3 UNKNOWN IMPORTED)
+    set_target_properties(FFTW::fftw3 PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES ${FFTW_INCLUDE_DIR}
+        IMPORTED_LOCATION ${FFTW_LIBRARY}
+    )
+endif()
@@ -18,6 +18,9 @@
 
 #include "Floorplan.h"
 #include "iostream"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ophidian::floorplan
 {
@@ -103,6 +106,127 @@ namespace ophidian::floorplan
         return m_row_site_types[row];
     }
 
+    namespace
+    {
+        double to_double(const Floorplan::unit_type & value)
+        {
+            return units::unit_cast<double>(value);
+        }
+    }
+
+    Floorplan::row_type Floorplan::find_row(const Floorplan::point_type & point) const
+    {
+        auto y = to_double(point.y());
+        auto x = to_double(point.x());
+
+        // last line at or below y
+        auto line = std::ptrdiff_t{-1};
+        if(!m_line_ys.empty() && y >= m_line_ys.front()){
+            if(m_line_pitch > 0.0){
+                line = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>((y - m_line_ys.front()) / m_line_pitch), m_line_ys.size() - 1);
+            }else{
+                line = std::upper_bound(m_line_ys.begin(), m_line_ys.end(), y) - m_line_ys.begin() - 1;
+            }
+        }
+        if(line < 0){
+            return row_type{};
+        }
+
+        auto first = m_sorted_rows.begin() + m_line_begins[line];
+        auto last = m_sorted_rows.begin() + m_line_begins[line + 1];
+        auto next = std::upper_bound(first, last, x, [this](double value, const row_type & row){
+            return value < to_double(m_row_origins[row].x());
+        });
+        if(next == first){
+            return row_type{};
+        }
+
+        auto row = *(next - 1);
+        auto upper = upper_right_corner(row);
+        if(x < to_double(upper.x()) && y < to_double(upper.y())){
+            return row;
+        }
+        return row_type{};
+    }
+
+    Floorplan::row_type Floorplan::nearest_row(const Floorplan::point_type & point) const
+    {
+        if(m_line_ys.empty()){
+            return row_type{};
+        }
+
+        auto y = to_double(point.y());
+        auto x = to_double(point.x());
+
+        auto line = std::ptrdiff_t{-1};
+        if(y >= m_line_ys.front()){
+            if(m_line_pitch > 0.0){
+                line = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>((y - m_line_ys.front()) / m_line_pitch), m_line_ys.size() - 1);
+            }else{
+                line = std::upper_bound(m_line_ys.begin(), m_line_ys.end(), y) - m_line_ys.begin() - 1;
+            }
+        }
+
+        auto best = row_type{};
+        auto best_distance = std::numeric_limits<double>::max();
+        auto visit = [&](std::ptrdiff_t candidate){
+            auto first = m_sorted_rows.begin() + m_line_begins[candidate];
+            auto last = m_sorted_rows.begin() + m_line_begins[candidate + 1];
+            auto next = std::upper_bound(first, last, x, [this](double value, const row_type & row){
+                return value < to_double(m_row_origins[row].x());
+            });
+
+            for(auto it = (next == first ? next : next - 1); it != last && it <= next; ++it){
+                auto lower = m_row_origins[*it];
+                auto upper = upper_right_corner(*it);
+                auto dx = std::max({0.0, to_double(lower.x()) - x, x - to_double(upper.x())});
+                auto dy = std::max({0.0, to_double(lower.y()) - y, y - to_double(upper.y())});
+                if(dx + dy < best_distance){
+                    best = *it;
+                    best_distance = dx + dy;
+                }
+            }
+        };
+
+        // widen the search away from y until the y distance alone exceeds the best row; the rows
+        // of a line below end under the highest top of the lines up to it
+        for(auto candidate = line; candidate >= 0 && y - m_line_tops[candidate] < best_distance; --candidate){
+            visit(candidate);
+        }
+        for(auto candidate = line + 1; candidate < static_cast<std::ptrdiff_t>(m_line_ys.size()) && m_line_ys[candidate] - y < best_distance; ++candidate){
+            visit(candidate);
+        }
+        return best;
+    }
+
+    Floorplan::row_size_type Floorplan::site_index(const Floorplan::row_type & row, const Floorplan::unit_type & x) const
+    {
+        auto width = to_double(m_site_dimensions[m_row_site_types[row]].x());
+        auto sites = units::unit_cast<double>(m_row_number_of_sites[row]);
+        auto index = std::floor((to_double(x) - to_double(m_row_origins[row].x())) / width);
+        return row_size_type{std::clamp(index, 0.0, std::max(0.0, sites - 1.0))};
+    }
+
+    Floorplan::point_type Floorplan::snap_to_site(const Floorplan::point_type & point) const
+    {
+        auto row = nearest_row(point);
+        if(row == row_type{}){
+            return point;
+        }
+
+        auto origin = m_row_origins[row];
+        auto width = to_double(m_site_dimensions[m_row_site_types[row]].x());
+        auto sites = units::unit_cast<double>(m_row_number_of_sites[row]);
+        auto index = std::round((to_double(point.x()) - to_double(origin.x())) / width);
+        index = std::clamp(index, 0.0, std::max(0.0, sites - 1.0));
+        return point_type{origin.x() + unit_type{index * width}, origin.y()};
+    }
+
+    bool Floorplan::uniform_row_pitch() const noexcept
+    {
+        return m_line_pitch > 0.0 || m_line_ys.size() == 1;
+    }
+
     // Iterators
     ophidian::util::Range<Floorplan::SitesIterator> Floorplan::range_site() const
     {
@@ -150,4 +274,40 @@ namespace ophidian::floorplan
     {
         m_rows.erase(row);
     }
+
+    void Floorplan::update_row_index()
+    {
+        m_sorted_rows.assign(m_rows.begin(), m_rows.end());
+        std::sort(m_sorted_rows.begin(), m_sorted_rows.end(), [this](const row_type & a, const row_type & b){
+            auto origin_a = m_row_origins[a];
+            auto origin_b = m_row_origins[b];
+            return origin_a.y() < origin_b.y() || (origin_a.y() == origin_b.y() && origin_a.x() < origin_b.x());
+        });
+
+        m_line_ys.clear();
+        m_line_begins.clear();
+        m_line_tops.clear();
+        for(std::size_t i = 0; i < m_sorted_rows.size(); ++i){
+            auto y = to_double(m_row_origins[m_sorted_rows[i]].y());
+            auto top = to_double(upper_right_corner(m_sorted_rows[i]).y());
+            if(m_line_ys.empty() || y != m_line_ys.back()){
+                m_line_ys.push_back(y);
+                m_line_begins.push_back(i);
+                m_line_tops.push_back(m_line_tops.empty() ? top : std::max(m_line_tops.back(), top));
+            }else{
+                m_line_tops.back() = std::max(m_line_tops.back(), top);
+            }
+        }
+        m_line_begins.push_back(m_sorted_rows.size());
+
+        m_line_pitch = 0.0;
+        if(m_line_ys.size() >= 2){
+            auto pitch = m_line_ys[1] - m_line_ys[0];
+            auto uniform = true;
+            for(std::size_t i = 2; i < m_line_ys.size() && uniform; ++i){
+                uniform = m_line_ys[i] - m_line_ys[i - 1] == pitch;
+            }
+            m_line_pitch = uniform ? pitch : 0.0;
+        }
+    }
 }
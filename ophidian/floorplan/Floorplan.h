@@ -20,6 +20,7 @@
 #define OPHIDIAN_FLOORPLAN_FLOORPLAN_H
 
 #include <unordered_map>
+#include <vector>
 
 #include <ophidian/entity_system/EntitySystem.h>
 #include <ophidian/entity_system/Property.h>
@@ -92,6 +93,41 @@ namespace ophidian::floorplan
 
         site_type find(const site_name_type& siteName) const;
 
+        // Row index queries, valid after update_row_index()
+
+        //! Row containing a point
+        /*!
+           \brief Finds the row whose site area contains the point in O(1) when the rows have a
+           uniform pitch, O(log n) otherwise.
+           \param point A point
+           \return The row, or an invalid row_type when no row contains the point
+         */
+        row_type find_row(const point_type & point) const;
+
+        //! Row closest to a point
+        /*!
+           \param point A point
+           \return The row whose site area is the closest to the point, or an invalid row_type without rows
+         */
+        row_type nearest_row(const point_type & point) const;
+
+        //! Site column of a row under an x coordinate
+        /*!
+           \brief Index of the site containing x, clamped to the sites of the row.
+         */
+        row_size_type site_index(const row_type & row, const unit_type & x) const;
+
+        //! Legal site position
+        /*!
+           \brief Lower left corner of the site, in the nearest row, whose corner is the closest to the point.
+           \param point A point
+           \return The snapped position, or the point itself without rows
+         */
+        point_type snap_to_site(const point_type & point) const;
+
+        //! True when the origin y of the indexed rows are evenly spaced, enabling O(1) row lookup
+        bool uniform_row_pitch() const noexcept;
+
         // Iterators
         ophidian::util::Range<SitesIterator> range_site() const;
 
@@ -108,6 +144,18 @@ namespace ophidian::floorplan
 
         void erase(const row_type & row);
 
+        //! Rebuild the row index
+        /*!
+           \brief Sorts the rows by origin, must be called again after adding, erasing or moving rows.
+         */
+        void update_row_index();
+
+        template <typename Value>
+        entity_system::Property<row_type, Value> make_property_row() const noexcept
+        {
+            return entity_system::Property<row_type, Value>(m_rows);
+        }
+
     private:
         entity_system::EntitySystem<row_type>                           m_rows{};
         entity_system::Property<row_type, point_type>                   m_row_origins{m_rows};
@@ -119,6 +167,13 @@ namespace ophidian::floorplan
         entity_system::Property<site_type, point_type>     m_site_dimensions{m_sites};
         std::unordered_map<site_name_type, site_type>      m_name_to_site{};
 
+        // rows sorted by (y, x); the rows sharing an origin y form a line
+        std::vector<row_type>    m_sorted_rows{};
+        std::vector<double>      m_line_ys{};
+        std::vector<std::size_t> m_line_begins{};
+        std::vector<double>      m_line_tops{};     // highest row top of the lines up to each one
+        double                   m_line_pitch{0.0};
+
         point_type m_chip_origin{unit_type{0.0}, unit_type{0.0}};
         point_type m_chip_upper_right_corner{unit_type{0.0}, unit_type{0.0}};
     };
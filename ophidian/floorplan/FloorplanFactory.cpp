@@ -41,5 +41,7 @@ namespace ophidian::floorplan::factory
                 floorplan.find(row.site())
             );
         }
+
+        floorplan.update_row_index();
     }
 }
@@ -21,10 +21,91 @@
 #include <flute.h>
 #include <ophidian/geometry/Distance.h>
 #include <ophidian/geometry/Operations.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <tuple>
 
 namespace ophidian::interconnection
 {
-    Flute::Flute()
+    namespace
+    {
+        using coordinate_type = std::int64_t;
+
+        //! Rectilinear minimum spanning tree of the points in O(n log n)
+        /*!
+           The nearest neighbours of a point in each octant are the only candidate edges, they
+           are found sweeping the points in order of x + y for four reflections of the plane and
+           the tree is built from them with Kruskal.
+         */
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> spanningTree(std::vector<coordinate_type> x, std::vector<coordinate_type> y)
+        {
+            const auto kSize = static_cast<std::uint32_t>(x.size());
+            auto candidates = std::vector<std::tuple<coordinate_type, std::uint32_t, std::uint32_t>>{};
+            auto order = std::vector<std::uint32_t>(kSize);
+            std::iota(order.begin(), order.end(), 0);
+
+            for(int reflection = 0; reflection < 4; ++reflection)
+            {
+                std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b){
+                    return std::make_pair(x[a] + y[a], a) < std::make_pair(x[b] + y[b], b);
+                });
+                auto sweep = std::map<coordinate_type, std::uint32_t>{};
+                for(auto i : order)
+                {
+                    for(auto it = sweep.lower_bound(-y[i]); it != sweep.end(); it = sweep.erase(it))
+                    {
+                        auto j = it->second;
+                        auto dx = x[i] - x[j];
+                        auto dy = y[i] - y[j];
+                        if(dy > dx) {
+                            break;
+                        }
+                        candidates.emplace_back(dx + dy, i, j);
+                    }
+                    sweep[-y[i]] = i;
+                }
+                for(std::uint32_t i = 0; i < kSize; ++i)
+                {
+                    if(reflection % 2 == 1) {
+                        x[i] = -x[i];
+                    }
+                    else {
+                        std::swap(x[i], y[i]);
+                    }
+                }
+            }
+
+            std::sort(candidates.begin(), candidates.end());
+            auto parent = std::vector<std::uint32_t>(kSize);
+            std::iota(parent.begin(), parent.end(), 0);
+            auto find = [&](std::uint32_t node){
+                while(parent[node] != node)
+                {
+                    node = parent[node] = parent[parent[node]];
+                }
+                return node;
+            };
+            auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>>{};
+            edges.reserve(kSize - 1);
+            for(const auto & [length, a, b] : candidates)
+            {
+                auto rootA = find(a);
+                auto rootB = find(b);
+                if(rootA != rootB) {
+                    parent[rootA] = rootB;
+                    edges.emplace_back(a, b);
+                }
+            }
+
+            return edges;
+        }
+    }     // namespace
+
+    Flute::Flute() :
+        mMaxFluteDegree(512),
+        mAccuracy(ACCURACY)
     {
         readLUT();
     }
@@ -40,6 +121,45 @@ namespace ophidian::interconnection
     {
     }
 
+    std::size_t Flute::maxFluteDegree() const noexcept
+    {
+        return mMaxFluteDegree;
+    }
+
+    void Flute::maxFluteDegree(std::size_t degree) noexcept
+    {
+        mMaxFluteDegree = degree;
+    }
+
+    int Flute::accuracy() const noexcept
+    {
+        return mAccuracy;
+    }
+
+    void Flute::accuracy(int accuracy) noexcept
+    {
+        mAccuracy = accuracy;
+    }
+
+    Flute::dbu_t Flute::update(
+        std::unique_ptr<SteinerTree> & tree,
+        const SteinerTree::Point & pin,
+        const Flute::Point & position,
+        const std::vector<Flute::Point> & container,
+        double tolerance)
+    {
+        const auto kBefore = tree->length();
+        const auto kBound = (kBefore + geometry::ManhattanDistance(tree->position(pin), position)) * (1.0 + tolerance);
+
+        auto delta = tree->move(pin, position);
+        if(tree->length() > kBound) {
+            tree = create(container);
+            delta = tree->length() - kBefore;
+        }
+
+        return delta;
+    }
+
     std::unique_ptr<SteinerTree> Flute::singleSegment(
         const Flute::Point & p1,
         const Flute::Point & p2)
@@ -69,7 +189,7 @@ namespace ophidian::interconnection
             static_cast<int32_t>(X.size()),
             const_cast<unsigned *>(X.data()),
             const_cast<unsigned *>(Y.data()),
-            ACCURACY);
+            mAccuracy);
         auto      steiner = SteinerTree::create();
         const int numBranches = 2 * tree.deg - 2;
 
@@ -100,11 +220,119 @@ namespace ophidian::interconnection
             translate(v);
 
             if(geometry::ManhattanDistance(u, v) > dbu_t{std::numeric_limits<double>::epsilon()}) {
-                steiner->add(steiner->add(u), steiner->add(v));
+                // the first deg branches are the pins
+                steiner->add(steiner->add(u, i < tree.deg), steiner->add(v, n < tree.deg));
             }
         }
         delete[] tree.branch;
 
         return std::move(steiner);
     }
+
+    std::unique_ptr<SteinerTree> Flute::spanningSteinerTree(
+        const std::vector<unsigned> & X,
+        const std::vector<unsigned> & Y,
+        const Flute::Point & offset)
+    {
+        auto x = std::vector<coordinate_type>(X.begin(), X.end());
+        auto y = std::vector<coordinate_type>(Y.begin(), Y.end());
+        const auto kPins = static_cast<std::uint32_t>(x.size());
+
+        auto adjacent = std::vector<std::vector<std::uint32_t>>(kPins);
+        for(auto [a, b] : spanningTree(x, y))
+        {
+            adjacent[a].push_back(b);
+            adjacent[b].push_back(a);
+        }
+
+        auto distance = [&](std::uint32_t a, std::uint32_t b){
+            return std::abs(x[a] - x[b]) + std::abs(y[a] - y[b]);
+        };
+        auto median = [](coordinate_type a, coordinate_type b, coordinate_type c){
+            return std::max(std::min(a, b), std::min(std::max(a, b), c));
+        };
+        auto replace = [&](std::uint32_t node, std::uint32_t from, std::uint32_t to){
+            *std::find(adjacent[node].begin(), adjacent[node].end(), from) = to;
+        };
+
+        // two edges of a pin sharing a direction overlap, routing both through the median of
+        // the three ends removes the overlap; every step lowers the degree of the pin by one
+        for(std::uint32_t pin = 0; pin < kPins; ++pin)
+        {
+            while(true)
+            {
+                auto & edges = adjacent[pin];
+                auto bestGain = coordinate_type{0};
+                auto bestA = kPins;
+                auto bestB = kPins;
+                for(std::size_t i = 0; i < edges.size(); ++i)
+                {
+                    for(std::size_t j = i + 1; j < edges.size(); ++j)
+                    {
+                        auto a = edges[i];
+                        auto b = edges[j];
+                        auto spanX = std::max({x[pin], x[a], x[b]}) - std::min({x[pin], x[a], x[b]});
+                        auto spanY = std::max({y[pin], y[a], y[b]}) - std::min({y[pin], y[a], y[b]});
+                        auto gain = distance(pin, a) + distance(pin, b) - spanX - spanY;
+                        if(gain > bestGain) {
+                            bestGain = gain;
+                            bestA = a;
+                            bestB = b;
+                        }
+                    }
+                }
+                if(bestGain == 0) {
+                    break;
+                }
+
+                auto steinerX = median(x[pin], x[bestA], x[bestB]);
+                auto steinerY = median(y[pin], y[bestA], y[bestB]);
+                if(steinerX == x[bestA] && steinerY == y[bestA]) {
+                    // the median is an end, the other end hangs from it
+                    edges.erase(std::find(edges.begin(), edges.end(), bestB));
+                    replace(bestB, pin, bestA);
+                    adjacent[bestA].push_back(bestB);
+                    continue;
+                }
+                if(steinerX == x[bestB] && steinerY == y[bestB]) {
+                    edges.erase(std::find(edges.begin(), edges.end(), bestA));
+                    replace(bestA, pin, bestB);
+                    adjacent[bestB].push_back(bestA);
+                    continue;
+                }
+
+                auto steiner = static_cast<std::uint32_t>(x.size());
+                x.push_back(steinerX);
+                y.push_back(steinerY);
+                adjacent.push_back({pin, bestA, bestB});
+                auto & pinEdges = adjacent[pin];
+                pinEdges.erase(std::find(pinEdges.begin(), pinEdges.end(), bestB));
+                *std::find(pinEdges.begin(), pinEdges.end(), bestA) = steiner;
+                replace(bestA, pin, steiner);
+                replace(bestB, pin, steiner);
+            }
+        }
+
+        auto steiner = SteinerTree::create();
+        auto points = std::vector<SteinerTree::Point>{};
+        points.reserve(x.size());
+        for(std::size_t node = 0; node < x.size(); ++node)
+        {
+            points.push_back(steiner->add(Flute::Point{
+                dbu_t{static_cast<double>(x[node])} - offset.x(),
+                dbu_t{static_cast<double>(y[node])} - offset.y()
+            }, node < kPins));
+        }
+        for(std::uint32_t node = 0; node < adjacent.size(); ++node)
+        {
+            for(auto other : adjacent[node])
+            {
+                if(node < other && distance(node, other) > 0) {
+                    steiner->add(points[node], points[other]);
+                }
+            }
+        }
+
+        return steiner;
+    }
 }
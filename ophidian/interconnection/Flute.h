@@ -21,17 +21,22 @@
 
 #include <ophidian/geometry/Models.h>
 #include <ophidian/util/Units.h>
+#include <ophidian/interconnection/SteinerTree.h>
 #include <vector>
 #include <memory>
 
 namespace ophidian::interconnection
 {
-    class SteinerTree;
-
     //! FLUTE: Fast Lookup Table Based Technique for RSMT Construction and Wirelength Estimation
 
     /*!
        From: http://home.eng.iastate.edu/~cnchu/flute.html
+
+       Trees are dispatched on the number of pins: FLUTE looks the optimal topology of nets up to
+       nine pins up in its table and breaks larger nets into smaller ones with the configured
+       accuracy. Nets above the maximum FLUTE degree, such as clock and reset nets, use a
+       rectilinear spanning tree instead, built in O(n log n) and improved with Steiner points
+       at the medians of adjacent edges.
      */
     class Flute final
     {
@@ -44,6 +49,16 @@ namespace ophidian::interconnection
 
         ~Flute();
 
+        //! Nets with more pins use the spanning tree heuristic, set it before creating trees
+        std::size_t maxFluteDegree() const noexcept;
+
+        void maxFluteDegree(std::size_t degree) noexcept;
+
+        //! Accuracy of the net breaking of FLUTE, higher is slower and closer to optimal
+        int accuracy() const noexcept;
+
+        void accuracy(int accuracy) noexcept;
+
         //! Create Steiner Tree
 
         /*!
@@ -88,9 +103,33 @@ namespace ophidian::interconnection
                 Y.push_back(static_cast<unsigned>(std::round(units::unit_cast<double>(point.y()) + units::unit_cast<double>(offset.y()))));
             }
 
+            if(kSize > mMaxFluteDegree) {
+                return spanningSteinerTree(X, Y, offset);
+            }
+
             return callFlute(X, Y, offset);
         }
 
+        //! Update a Steiner Tree after one of its pins moved
+
+        /*!
+            \brief Moves the pin with SteinerTree::move and creates the tree again from the pins only
+            when the local update is longer than the old tree plus the distance the pin moved, a
+            bound the optimal tree of the moved pins always meets, scaled by 1 + \p tolerance.
+            \param tree The Steiner Tree of the pins, replaced when it is created again.
+            \param pin The Steiner Point of the moved pin.
+            \param position The new position of the pin.
+            \param container Every pin, the moved one at its new position.
+            \param tolerance Allowed excess over the bound.
+            \return The change of the length of the tree.
+         */
+        dbu_t update(
+            std::unique_ptr<SteinerTree> & tree,
+            const SteinerTree::Point & pin,
+            const Point & position,
+            const std::vector<Point> & container,
+            double tolerance = 0.0);
+
     private:
         std::unique_ptr<SteinerTree> singleSegment(
             const Point & p1,
@@ -103,11 +142,19 @@ namespace ophidian::interconnection
             const std::vector<unsigned> & Y,
             const Point & offset);
 
+        std::unique_ptr<SteinerTree> spanningSteinerTree(
+            const std::vector<unsigned> & X,
+            const std::vector<unsigned> & Y,
+            const Point & offset);
+
         Flute();
 
         Flute(const Flute & o) = delete;
 
         Flute & operator=(const Flute & o) = delete;
+
+        std::size_t mMaxFluteDegree;
+        int         mAccuracy;
     };
 }
 
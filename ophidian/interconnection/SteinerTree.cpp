@@ -18,7 +18,12 @@
 
 #include "SteinerTree.h"
 #include <ophidian/geometry/Distance.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
+#include <set>
+#include <vector>
 #include "ToEps.h"
 #include <lemon/graph_to_eps.h>
 
@@ -50,25 +55,6 @@ namespace ophidian::interconnection
         return lemon::countNodes(mGraph);
     }
 
-namespace
-{
-    SteinerTree::GraphType::Node findNodeWithPositionEqualsTo(
-        const DbuPoint & position,
-        const SteinerTree::GraphType::NodeMap<lemon::dim2::Point<double>> & mPosition,
-        const SteinerTree::GraphType & mGraph)
-    {
-        for(SteinerTree::GraphType::NodeIt i(mGraph); mGraph.valid(i); ++i)
-        {
-            if(geometry::ManhattanDistance(position, convert(mPosition[i])) == dbu_t{0.0}) {
-                return i;
-            }
-        }
-
-        return lemon::INVALID;
-    }
-}     // namespace
-      //
-
     std::unique_ptr<SteinerTree> SteinerTree::create()
     {
         return std::unique_ptr<SteinerTree>{new SteinerTree};
@@ -76,15 +62,237 @@ namespace
 
     SteinerTree::Point SteinerTree::add(const DbuPoint & position)
     {
-        GraphType::Node node = findNodeWithPositionEqualsTo(position, mPosition, mGraph);
-        if(node == lemon::INVALID) {
-            node = mGraph.addNode();
-            mPosition[node] = convert(position);
+        return add(position, true);
+    }
+
+    SteinerTree::Point SteinerTree::add(const DbuPoint & position, bool terminal)
+    {
+        auto key = std::make_pair(units::unit_cast<double>(position.x()), units::unit_cast<double>(position.y()));
+        auto found = mNodes.find(key);
+        if(found != mNodes.end()) {
+            if(terminal) {
+                mTerminal[found->second] = 1;
+            }
+            return Point(found->second);
         }
 
+        GraphType::Node node = mGraph.addNode();
+        mPosition[node] = convert(position);
+        mTerminal[node] = terminal;
+        mNodes.emplace(key, node);
+
         return Point(node);
     }
 
+    dbu_t SteinerTree::move(const SteinerTree::Point & point, const DbuPoint & position)
+    {
+        using position_type = lemon::dim2::Point<double>;
+
+        const auto kBefore = mLength;
+        const auto kMoved = point.mEl;
+        const auto kFrom = mPosition[kMoved];
+        const auto kTo = convert(position);
+
+        auto distance = [](const position_type & a, const position_type & b){
+            return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+        };
+        auto key = [&](GraphType::Node node){
+            return std::make_pair(mPosition[node].x, mPosition[node].y);
+        };
+        auto incident = [&](GraphType::Node node){
+            auto edges = std::vector<GraphType::Edge>{};
+            for(GraphType::IncEdgeIt edge(mGraph, node); edge != lemon::INVALID; ++edge)
+            {
+                edges.push_back(edge);
+            }
+            return edges;
+        };
+        auto erase = [&](GraphType::Edge edge){
+            mLength -= length(Segment(edge));
+            mGraph.erase(edge);
+        };
+
+        // points that no longer belong to the tree leave the position index and the graph
+        auto release = [&](GraphType::Node node){
+            auto found = mNodes.find(key(node));
+            if(found != mNodes.end() && found->second == node) {
+                mNodes.erase(found);
+            }
+            for(auto edge : incident(node))
+            {
+                erase(edge);
+            }
+            mGraph.erase(node);
+        };
+        auto split = [&](GraphType::Edge edge, const position_type & at){
+            const auto kU = mGraph.u(edge);
+            const auto kV = mGraph.v(edge);
+            auto node = mGraph.addNode();
+            mTerminal[node] = 0;
+            mPosition[node] = at;
+            mNodes.emplace(key(node), node);
+            erase(edge);
+            add(Point(kU), Point(node));
+            add(Point(node), Point(kV));
+            return node;
+        };
+
+        auto neighbours = std::vector<GraphType::Node>{};
+        for(auto edge : incident(kMoved))
+        {
+            neighbours.push_back(mGraph.oppositeNode(kMoved, edge));
+            erase(edge);
+        }
+        auto found = mNodes.find(key(kMoved));
+        if(found != mNodes.end() && found->second == kMoved) {
+            mNodes.erase(found);
+        }
+        mPosition[kMoved] = kTo;
+
+        // the search is bound to the box around the old position, the new one and the neighbours
+        auto lower = position_type{std::min(kFrom.x, kTo.x), std::min(kFrom.y, kTo.y)};
+        auto upper = position_type{std::max(kFrom.x, kTo.x), std::max(kFrom.y, kTo.y)};
+        for(auto neighbour : neighbours)
+        {
+            lower = {std::min(lower.x, mPosition[neighbour].x), std::min(lower.y, mPosition[neighbour].y)};
+            upper = {std::max(upper.x, mPosition[neighbour].x), std::max(upper.y, mPosition[neighbour].y)};
+        }
+        auto inside = [&](GraphType::Node node){
+            const auto & kAt = mPosition[node];
+            return lower.x <= kAt.x && kAt.x <= upper.x && lower.y <= kAt.y && kAt.y <= upper.y;
+        };
+
+        // points of the subtrees of roots reachable through the box, the last ones may lie outside it
+        auto nearby = [&](const std::vector<GraphType::Node> & roots){
+            auto visited = std::set<int>{};
+            auto reached = std::vector<GraphType::Node>{};
+            auto stack = roots;
+            while(!stack.empty())
+            {
+                auto node = stack.back();
+                stack.pop_back();
+                if(!visited.insert(mGraph.id(node)).second) {
+                    continue;
+                }
+                reached.push_back(node);
+                if(!inside(node)) {
+                    continue;
+                }
+                for(auto edge : incident(node))
+                {
+                    stack.push_back(mGraph.oppositeNode(node, edge));
+                }
+            }
+            return reached;
+        };
+
+        // joins a point to the nearest point or segment of the subtrees of roots
+        auto join = [&](GraphType::Node node, const std::vector<GraphType::Node> & roots){
+            const auto kAt = mPosition[node];
+            auto best = std::numeric_limits<double>::max();
+            auto bestNode = node;
+            auto bestEdge = GraphType::Edge{lemon::INVALID};
+            auto bestAt = kAt;
+            for(auto candidate : nearby(roots))
+            {
+                if(distance(kAt, mPosition[candidate]) < best) {
+                    best = distance(kAt, mPosition[candidate]);
+                    bestNode = candidate;
+                    bestEdge = lemon::INVALID;
+                    bestAt = mPosition[candidate];
+                }
+                if(!inside(candidate)) {
+                    continue;
+                }
+                for(auto edge : incident(candidate))
+                {
+                    const auto & kU = mPosition[mGraph.u(edge)];
+                    const auto & kV = mPosition[mGraph.v(edge)];
+                    auto at = position_type{
+                        std::clamp(kAt.x, std::min(kU.x, kV.x), std::max(kU.x, kV.x)),
+                        std::clamp(kAt.y, std::min(kU.y, kV.y), std::max(kU.y, kV.y))
+                    };
+                    if(distance(kAt, at) < best) {
+                        best = distance(kAt, at);
+                        bestNode = candidate;
+                        bestEdge = edge;
+                        bestAt = at;
+                    }
+                }
+            }
+            if(bestNode == node) {
+                return;
+            }
+            if(bestEdge != lemon::INVALID) {
+                const auto kU = mGraph.u(bestEdge);
+                const auto kV = mGraph.v(bestEdge);
+                if(distance(bestAt, mPosition[kU]) == 0) {
+                    bestNode = kU;
+                }
+                else if(distance(bestAt, mPosition[kV]) == 0) {
+                    bestNode = kV;
+                }
+                else {
+                    bestNode = split(bestEdge, bestAt);
+                }
+            }
+            add(Point(node), Point(bestNode));
+        };
+
+        for(std::size_t i = 1; i < neighbours.size(); ++i)
+        {
+            join(neighbours[i], std::vector<GraphType::Node>(neighbours.begin(), neighbours.begin() + i));
+        }
+
+        // a Steiner Point at the new position hands its segments over to the moved point
+        found = mNodes.find(key(kMoved));
+        if(found != mNodes.end() && !mTerminal[found->second]) {
+            auto other = found->second;
+            for(auto edge : incident(other))
+            {
+                auto next = mGraph.oppositeNode(other, edge);
+                erase(edge);
+                add(Point(kMoved), Point(next));
+            }
+            release(other);
+        }
+        if(!neighbours.empty() && incident(kMoved).empty()) {
+            join(kMoved, neighbours);
+        }
+        mNodes.emplace(key(kMoved), kMoved);
+
+        // bypass the non terminal points that no longer branch
+        auto candidates = neighbours;
+        candidates.push_back(kMoved);
+        while(!candidates.empty())
+        {
+            auto node = candidates.back();
+            candidates.pop_back();
+            if(!mGraph.valid(node) || mTerminal[node]) {
+                continue;
+            }
+            auto edges = incident(node);
+            if(edges.size() > 2) {
+                continue;
+            }
+            if(edges.size() == 1) {
+                auto next = mGraph.oppositeNode(node, edges.front());
+                erase(edges.front());
+                candidates.push_back(next);
+            }
+            else if(edges.size() == 2) {
+                auto a = mGraph.oppositeNode(node, edges[0]);
+                auto b = mGraph.oppositeNode(node, edges[1]);
+                erase(edges[0]);
+                erase(edges[1]);
+                add(Point(a), Point(b));
+            }
+            release(node);
+        }
+
+        return mLength - kBefore;
+    }
+
     SteinerTree::Segment SteinerTree::add(
         const SteinerTree::Point & p1,
         const SteinerTree::Point & p2)
@@ -112,6 +320,11 @@ namespace
         return convert(mPosition[p.mEl]);
     }
 
+    bool SteinerTree::terminal(const SteinerTree::Point & p) const
+    {
+        return mTerminal[p.mEl];
+    }
+
     dbu_t SteinerTree::length(const SteinerTree::Segment & segment) const
     {
         const auto kU = mGraph.u(segment.mEl);
@@ -127,10 +340,9 @@ namespace
 
     std::pair<SteinerTree::PointIterator, SteinerTree::PointIterator> SteinerTree::points() const
     {
-        PointIterator first {Point {GraphType::NodeIt {mGraph}
-                             }
+        PointIterator first {GraphType::NodeIt {mGraph}
         };
-        PointIterator second {Point {static_cast<GraphType::Node>(lemon::INVALID)}
+        PointIterator second {GraphType::NodeIt {lemon::INVALID}
         };
 
         return std::make_pair(first, second);
@@ -157,8 +369,9 @@ namespace
         return std::make_pair(first, second);
     }
 
-    SteinerTree::PointIterator::PointIterator(const SteinerTree::Point & p):
-            mPoint(p)
+    SteinerTree::PointIterator::PointIterator(GraphType::NodeIt it):
+            mIt(it),
+            mPoint(it)
     {
     }
 
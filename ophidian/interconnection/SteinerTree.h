@@ -21,12 +21,14 @@
 
 #include <ophidian/geometry/Models.h>
 #include <ophidian/util/Units.h>
-#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
 #include <lemon/maps.h>
 #include <lemon/dim2.h>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <iterator>
+#include <utility>
 
 namespace ophidian::interconnection
 {
@@ -36,11 +38,13 @@ namespace ophidian::interconnection
        A graph G(V,E), where V is the set of Steiner Points and E is the set of segments.
        One can iterate over its Steiner Points and Segments.
        Also, one can query the length of a Segment as well as the total length of the Steiner Tree.
+       Steiner Points are terminals, the pins of the net, unless added otherwise; only the
+       other ones may be dropped when the tree is updated after a move.
      */
     class SteinerTree
     {
     public:
-        using GraphType = lemon::SmartGraph;
+        using GraphType = lemon::ListGraph;
 
         using dbu_t = util::database_unit_t;
         using DbuPoint = geometry::Point<dbu_t>;
@@ -181,14 +185,15 @@ namespace ophidian::interconnection
 
             inline PointIterator & operator++()
             {
-                GraphType::next(mPoint.mEl);
+                ++mIt;
+                mPoint = Point(mIt);
 
                 return *this;
             }
 
             inline bool operator==(const PointIterator & o) const
             {
-                return mPoint.mEl == o.mPoint.mEl;
+                return mIt == o.mIt;
             }
 
             inline bool operator!=(const PointIterator & o) const
@@ -203,8 +208,9 @@ namespace ophidian::interconnection
 
         private:
 
-            PointIterator(const Point & p);
+            PointIterator(GraphType::NodeIt it);
 
+            GraphType::NodeIt mIt;
             Point mPoint;
         };
 
@@ -315,6 +321,16 @@ namespace ophidian::interconnection
          */
         Point add(const DbuPoint & position);
 
+        //! Add Steiner Point
+
+        /*!
+           \brief Creates a Steiner point given a position, a point at the position of a terminal is a terminal.
+           \param position The position.
+           \param terminal False when the point does not belong to a pin.
+           \return A handler for the created Steiner Point.
+         */
+        Point add(const DbuPoint & position, bool terminal);
+
         //! Add Segment
 
         /*!
@@ -325,6 +341,24 @@ namespace ophidian::interconnection
          */
         Segment add(const Point & p1, const Point & p2);
 
+        //! Move a Steiner Point
+
+        /*!
+           \brief Moves a point and reconnects the tree around it in place.
+           Only the segments of the point are removed, the subtrees they held are joined back
+           at their nearest segments and the point is attached to the nearest segment from its
+           new position, splitting it with a Steiner Point when needed. The search only visits
+           the part of the former neighbours' subtrees inside the bounding box of the old
+           position, the new one and the neighbours. A Steiner Point already at the new
+           position is merged into the moved point. Non terminal points left with one or two
+           segments are then bypassed and erased, like the merged Steiner Point; handlers of
+           the other points stay valid.
+           \param point The handler for the moved Steiner Point.
+           \param position Its new position.
+           \return The change of the length of the Steiner Tree.
+         */
+        dbu_t move(const Point & point, const DbuPoint & position);
+
         //! Number of Segments
 
         /*!
@@ -364,6 +398,14 @@ namespace ophidian::interconnection
          */
         DbuPoint position(const Point & p) const;
 
+        //! Terminal Steiner Point
+
+        /*!
+           \param p The handler for a Steiner Point.
+           \return True when \p p is the position of a pin.
+         */
+        bool terminal(const Point & p) const;
+
         //! Length of a Segment.
 
         /*!
@@ -412,6 +454,8 @@ namespace ophidian::interconnection
 
         GraphType                                      mGraph{};
         GraphType::NodeMap<lemon::dim2::Point<double>> mPosition{mGraph};
+        GraphType::NodeMap<char>                       mTerminal{mGraph};
+        std::map<std::pair<double, double>, GraphType::Node> mNodes{};
         dbu_t                                          mLength{0.0};
     };
 
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "TopologyCache.h"
+#include "SteinerTree.h"
+#include "TreeReader.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ophidian::interconnection
+{
+    namespace
+    {
+        //! Serializes the FLUTE calls of every cache
+        std::mutex flute_mutex;
+    }
+
+    TopologyCache::TopologyCache(const TopologyCache::Parameters & parameters):
+        m_parameters(parameters),
+        m_hits(0),
+        m_misses(0)
+    {
+    }
+
+    TopologyCache::TopologyCache():
+        TopologyCache(Parameters{})
+    {
+    }
+
+    std::size_t TopologyCache::hits() const noexcept
+    {
+        return m_hits.load(std::memory_order_relaxed);
+    }
+
+    std::size_t TopologyCache::misses() const noexcept
+    {
+        return m_misses.load(std::memory_order_relaxed);
+    }
+
+    double TopologyCache::hit_rate() const noexcept
+    {
+        auto hits = this->hits();
+        auto lookups = hits + misses();
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+
+    std::size_t TopologyCache::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_topologies.size();
+    }
+
+    std::unique_ptr<SteinerTree> TopologyCache::create(const TopologyCache::point_container_type & pins)
+    {
+        auto points = point_container_type{};
+        auto segments = segment_container_type{};
+        create(pins, points, segments);
+
+        // points at the position of a pin are terminals
+        auto steiner = SteinerTree::create();
+        auto positions = std::vector<std::pair<double, double>>{};
+        for(const auto & pin : pins)
+        {
+            positions.emplace_back(units::unit_cast<double>(pin.x()), units::unit_cast<double>(pin.y()));
+        }
+        std::sort(positions.begin(), positions.end());
+        auto add = [&](const Point & point){
+            auto position = std::make_pair(units::unit_cast<double>(point.x()), units::unit_cast<double>(point.y()));
+            return steiner->add(point, std::binary_search(positions.begin(), positions.end(), position));
+        };
+
+        if(segments.empty() && !points.empty())
+        {
+            add(points.front());
+        }
+        for(auto [a, b] : segments)
+        {
+            steiner->add(add(points[a]), add(points[b]));
+        }
+        return steiner;
+    }
+
+    void TopologyCache::create(const TopologyCache::point_container_type & pins, TopologyCache::point_container_type & points, TopologyCache::segment_container_type & segments)
+    {
+        points.clear();
+        segments.clear();
+        if(pins.size() <= 2)
+        {
+            points = pins;
+            if(pins.size() == 2)
+            {
+                if(pins[0].x() == pins[1].x() && pins[0].y() == pins[1].y())
+                {
+                    points.pop_back();
+                }
+                else
+                {
+                    segments.emplace_back(0, 1);
+                }
+            }
+            return;
+        }
+        if(pins.size() > m_parameters.max_degree)
+        {
+            auto topology = compute(pins);
+            points = topology->points;
+            segments = topology->segments;
+            return;
+        }
+
+        auto corner = pins.front();
+        for(const auto & pin : pins)
+        {
+            corner.x(std::min(corner.x(), pin.x()));
+            corner.y(std::min(corner.y(), pin.y()));
+        }
+        auto offsets = std::vector<std::pair<std::int64_t, std::int64_t>>{};
+        offsets.reserve(pins.size());
+        for(const auto & pin : pins)
+        {
+            offsets.emplace_back(
+                static_cast<std::int64_t>(std::round(units::unit_cast<double>(pin.x() - corner.x()))),
+                static_cast<std::int64_t>(std::round(units::unit_cast<double>(pin.y() - corner.y()))));
+        }
+        std::sort(offsets.begin(), offsets.end());
+        auto key = key_type{};
+        key.reserve(2 * offsets.size());
+        for(auto [x, y] : offsets)
+        {
+            key.push_back(x);
+            key.push_back(y);
+        }
+
+        auto topology = std::shared_ptr<const Topology>{};
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto found = m_topologies.find(key);
+            if(found != m_topologies.end())
+            {
+                topology = found->second;
+            }
+        }
+        if(topology)
+        {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            auto relative = point_container_type{};
+            relative.reserve(offsets.size());
+            for(auto [x, y] : offsets)
+            {
+                relative.emplace_back(dbu_t{static_cast<double>(x)}, dbu_t{static_cast<double>(y)});
+            }
+            topology = compute(relative);
+
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            if(m_topologies.size() >= m_parameters.capacity)
+            {
+                m_topologies.clear();
+            }
+            m_topologies.emplace(std::move(key), topology);
+        }
+
+        points.reserve(topology->points.size());
+        for(const auto & point : topology->points)
+        {
+            points.emplace_back(point.x() + corner.x(), point.y() + corner.y());
+        }
+        segments = topology->segments;
+    }
+
+    void TopologyCache::clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_topologies.clear();
+        m_hits.store(0, std::memory_order_relaxed);
+        m_misses.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t TopologyCache::KeyHash::operator()(const TopologyCache::key_type & key) const noexcept
+    {
+        auto hash = static_cast<std::uint64_t>(key.size());
+        for(auto value : key)
+        {
+            hash ^= static_cast<std::uint64_t>(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return static_cast<std::size_t>(hash);
+    }
+
+    std::shared_ptr<const TopologyCache::Topology> TopologyCache::compute(const TopologyCache::point_container_type & pins)
+    {
+        auto topology = std::make_shared<Topology>();
+        std::lock_guard<std::mutex> lock(flute_mutex);
+        detail::TreeReader::read(*Flute::instance().create(pins), topology->points, topology->segments);
+        return topology;
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_INTERCONNECTION_TOPOLOGYCACHE_H
+#define OPHIDIAN_INTERCONNECTION_TOPOLOGYCACHE_H
+
+#include <ophidian/interconnection/Flute.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ophidian::interconnection
+{
+    class SteinerTree;
+
+    //! Memoized FLUTE topologies
+
+    /*!
+       \brief Caches the Steiner trees created by FLUTE, keyed by the pin pattern of the net.
+
+       The key of a net is its sorted pin coordinates relative to the lower left corner of its
+       pins, rounded to integers like FLUTE does. Nets that were not moved and nets that are
+       translated copies of each other share the same key, so they reuse the tree instead of
+       calling FLUTE and converting its branches again. The tree is stored relative to the
+       corner and translated back on every lookup.
+
+       Lookups from several threads are safe: hits only take a shared lock, while misses call
+       FLUTE, which is not reentrant, one at a time across every cache. Nets with one or two
+       pins and nets above the maximum degree bypass the cache and are not counted.
+     */
+    class TopologyCache
+    {
+    public:
+        using dbu_t                     = Flute::dbu_t;
+        using Point                     = Flute::Point;
+        using node_type                 = std::uint32_t;
+        using point_container_type      = std::vector<Point>;
+        using segment_container_type    = std::vector<std::pair<node_type, node_type>>;
+
+        //! Cache parameters
+        struct Parameters
+        {
+            //! Nets with more pins are not cached
+            std::size_t max_degree{64};
+            //! Number of cached topologies, the cache is emptied when it is full
+            std::size_t capacity{1 << 20};
+        };
+
+        // Constructors
+        TopologyCache(const Parameters & parameters);
+
+        TopologyCache();
+
+        TopologyCache(const TopologyCache &) = delete;
+        TopologyCache & operator=(const TopologyCache &) = delete;
+
+        // Element access
+        //! Lookups answered by a cached topology
+        std::size_t hits() const noexcept;
+
+        //! Lookups that called FLUTE
+        std::size_t misses() const noexcept;
+
+        //! Fraction of the lookups that were hits, zero before the first lookup
+        double hit_rate() const noexcept;
+
+        //! Number of cached topologies
+        std::size_t size() const;
+
+        // Modifiers
+        //! Create the Steiner tree of the pins
+        std::unique_ptr<SteinerTree> create(const point_container_type & pins);
+
+        //! Create the Steiner tree of the pins as a list of nodes and segments
+        /*!
+           \param pins Pin positions
+           \param points Positions of the tree nodes, replaced
+           \param segments Pairs of indices of points, replaced
+         */
+        void create(const point_container_type & pins, point_container_type & points, segment_container_type & segments);
+
+        //! Drop every cached topology and reset the counters
+        void clear();
+
+    private:
+        using key_type                  = std::vector<std::int64_t>;
+
+        //! Tree relative to the lower left corner of the pins
+        struct Topology
+        {
+            point_container_type points;
+            segment_container_type segments;
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const key_type & key) const noexcept;
+        };
+
+        std::shared_ptr<const Topology> compute(const point_container_type & pins);
+
+        Parameters                                                              m_parameters;
+        std::unordered_map<key_type, std::shared_ptr<const Topology>, KeyHash>  m_topologies;
+        mutable std::shared_mutex                                               m_mutex;
+        std::atomic<std::size_t>                                                m_hits;
+        std::atomic<std::size_t>                                                m_misses;
+    };
+}
+
+#endif // OPHIDIAN_INTERCONNECTION_TOPOLOGYCACHE_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_INTERCONNECTION_TREE_READER_H
+#define OPHIDIAN_INTERCONNECTION_TREE_READER_H
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SteinerTree.h"
+
+namespace ophidian::interconnection::detail
+{
+    //! Flat copy of a Steiner tree
+
+    /*!
+       \brief Reads the graph of a tree without going through its handles. Points are numbered
+       from 0 in the order of their ids, the holes left by erased points are skipped, and every
+       segment refers to its two ends by those numbers. Internal to the library.
+     */
+    class TreeReader :
+        public SteinerTree::Attorney
+    {
+    public:
+        template <class Point, class Node>
+        static void read(const SteinerTree & steiner, std::vector<Point> & points, std::vector<std::pair<Node, Node>> & segments)
+        {
+            using coordinate_type = std::decay_t<decltype(std::declval<const Point &>().x())>;
+
+            const auto & graph = Attorney::graph(steiner);
+            const auto & position = Attorney::position(steiner);
+            auto index = std::vector<Node>(graph.maxNodeId() + 1);
+            points.clear();
+            points.reserve(lemon::countNodes(graph));
+            for(auto id = 0; id <= graph.maxNodeId(); ++id)
+            {
+                auto node = graph.nodeFromId(id);
+                if(!graph.valid(node))
+                {
+                    continue;
+                }
+                index[id] = static_cast<Node>(points.size());
+                points.push_back(Point{coordinate_type{position[node].x}, coordinate_type{position[node].y}});
+            }
+            segments.clear();
+            segments.reserve(lemon::countEdges(graph));
+            for(SteinerTree::GraphType::EdgeIt edge(graph); edge != lemon::INVALID; ++edge)
+            {
+                segments.emplace_back(index[graph.id(graph.u(edge))], index[graph.id(graph.v(edge))]);
+            }
+        }
+    };
+}
+
+#endif // OPHIDIAN_INTERCONNECTION_TREE_READER_H
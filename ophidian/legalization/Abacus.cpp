@@ -0,0 +1,353 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Abacus.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::legalization
+{
+    namespace
+    {
+        // tolerance of the conversion from coordinates to site indices
+        constexpr double site_epsilon = 1e-6;
+    }
+
+    Abacus::Abacus(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, const Abacus::Parameters & parameters):
+        m_parameters(parameters),
+        m_netlist(netlist),
+        m_floorplan(floorplan),
+        m_placement(placement)
+    {
+    }
+
+    Abacus::Abacus(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement):
+        Abacus(netlist, floorplan, placement, Parameters{})
+    {
+    }
+
+    const std::vector<Abacus::cell_type> & Abacus::failed() const noexcept
+    {
+        return m_failed;
+    }
+
+    Abacus::Statistics Abacus::legalize()
+    {
+        m_rows.clear();
+        m_line_ys.clear();
+        m_line_begins.clear();
+        m_cells.clear();
+        m_failed.clear();
+
+        // free segments between fixed cells, rows grouped into lines of equal y
+        auto map = FreeSpaceMap{m_netlist, m_floorplan, m_placement, m_parameters.number_of_threads};
+        for(auto row : map.rows())
+        {
+            auto origin = m_floorplan.origin(row);
+            auto dimension = m_floorplan.dimension(m_floorplan.site(row));
+            auto data = Row{};
+            data.x = units::unit_cast<double>(origin.x());
+            data.y = units::unit_cast<double>(origin.y());
+            data.height = units::unit_cast<double>(dimension.y());
+            data.site_width = units::unit_cast<double>(dimension.x());
+            for(const auto & free : map.segments(row))
+            {
+                auto begin = static_cast<site_type>(std::lround((units::unit_cast<double>(free.begin) - data.x) / data.site_width));
+                auto end = static_cast<site_type>(std::lround((units::unit_cast<double>(free.end) - data.x) / data.site_width));
+                data.segments.push_back(Segment{begin, end, 0, {}, {}});
+            }
+
+            if(m_line_ys.empty() || data.y != m_line_ys.back())
+            {
+                m_line_ys.push_back(data.y);
+                m_line_begins.push_back(m_rows.size());
+            }
+            m_rows.push_back(std::move(data));
+        }
+        m_line_begins.push_back(m_rows.size());
+
+        // movable cells by increasing x
+        auto all_cells = std::vector<cell_type>(m_netlist.begin_cell_instance(), m_netlist.end_cell_instance());
+        auto cells = std::vector<Cell>(all_cells.size());
+        auto movable = std::vector<char>(all_cells.size(), 0);
+        util::parallel_for(0, all_cells.size(), [&](std::size_t i){
+            auto cell = all_cells[i];
+            if(m_placement.fixed(cell))
+            {
+                return;
+            }
+            auto geometry = m_placement.geometry(cell);
+            if(geometry.size() == 0)
+            {
+                return;
+            }
+
+            auto x_low = std::numeric_limits<double>::max(), y_low = std::numeric_limits<double>::max();
+            auto x_high = std::numeric_limits<double>::lowest(), y_high = std::numeric_limits<double>::lowest();
+            for(const auto & box : geometry)
+            {
+                x_low = std::min(x_low, units::unit_cast<double>(box.min_corner().x()));
+                y_low = std::min(y_low, units::unit_cast<double>(box.min_corner().y()));
+                x_high = std::max(x_high, units::unit_cast<double>(box.max_corner().x()));
+                y_high = std::max(y_high, units::unit_cast<double>(box.max_corner().y()));
+            }
+
+            auto location = m_placement.location(cell);
+            auto & data = cells[i];
+            data.cell = cell;
+            data.x = x_low;
+            data.y = y_low;
+            data.width = x_high - x_low;
+            data.height = y_high - y_low;
+            data.offset_x = x_low - units::unit_cast<double>(location.x());
+            data.offset_y = y_low - units::unit_cast<double>(location.y());
+            data.line = 0;
+            if(!m_line_ys.empty())
+            {
+                auto next = std::lower_bound(m_line_ys.begin(), m_line_ys.end(), y_low);
+                auto line = static_cast<std::size_t>(next - m_line_ys.begin());
+                if(line == m_line_ys.size() || (line > 0 && y_low - m_line_ys[line - 1] <= *next - y_low))
+                {
+                    --line;
+                }
+                data.line = line;
+            }
+            movable[i] = 1;
+        }, m_parameters.number_of_threads, 1024);
+
+        for(std::size_t i = 0; i < all_cells.size(); ++i)
+        {
+            if(!movable[i])
+            {
+                continue;
+            }
+            if(m_rows.empty() || cells[i].height > m_rows[m_line_begins[cells[i].line]].height + site_epsilon)
+            {
+                m_failed.push_back(cells[i].cell);
+                continue;
+            }
+            m_cells.push_back(cells[i]);
+        }
+        std::stable_sort(m_cells.begin(), m_cells.end(), [](const Cell & a, const Cell & b){
+            return a.x < b.x;
+        });
+
+        // bands of lines are independent, cells that do not fit in their band get a second chance over every line
+        auto lines_per_band = std::max<std::size_t>(1, m_parameters.lines_per_band);
+        auto number_of_bands = (m_line_ys.size() + lines_per_band - 1) / lines_per_band;
+        auto band_cells = std::vector<std::vector<std::size_t>>(number_of_bands);
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            band_cells[m_cells[i].line / lines_per_band].push_back(i);
+        }
+
+        auto band_failed = std::vector<std::vector<std::size_t>>(number_of_bands);
+        util::parallel_for(0, number_of_bands, [&](std::size_t band){
+            auto first_line = band * lines_per_band;
+            auto last_line = std::min(m_line_ys.size(), first_line + lines_per_band);
+            for(auto cell : band_cells[band])
+            {
+                if(!place_cell(cell, first_line, last_line))
+                {
+                    band_failed[band].push_back(cell);
+                }
+            }
+        }, m_parameters.number_of_threads);
+
+        auto retry = std::vector<std::size_t>{};
+        for(const auto & failed : band_failed)
+        {
+            retry.insert(retry.end(), failed.begin(), failed.end());
+        }
+        // Abacus needs the cells of a row in x order, across bands as well
+        std::sort(retry.begin(), retry.end(), [&](std::size_t a, std::size_t b){
+            return m_cells[a].x < m_cells[b].x || (m_cells[a].x == m_cells[b].x && a < b);
+        });
+        for(auto cell : retry)
+        {
+            if(!place_cell(cell, 0, m_line_ys.size()))
+            {
+                m_failed.push_back(m_cells[cell].cell);
+            }
+        }
+
+        // write the clusters back
+        auto statistics = Statistics{};
+        auto total = 0.0;
+        auto maximum = 0.0;
+        for(const auto & row : m_rows)
+        {
+            for(const auto & segment : row.segments)
+            {
+                for(std::size_t c = 0; c < segment.clusters.size(); ++c)
+                {
+                    const auto & cluster = segment.clusters[c];
+                    auto last = c + 1 < segment.clusters.size() ? segment.clusters[c + 1].first : segment.cells.size();
+                    auto site = cluster.x;
+                    for(auto i = cluster.first; i < last; ++i)
+                    {
+                        const auto & cell = m_cells[segment.cells[i]];
+                        auto x = row.x + site * row.site_width;
+                        auto displacement = std::abs(x - cell.x) + std::abs(row.y - cell.y);
+                        total += displacement;
+                        maximum = std::max(maximum, displacement);
+                        m_placement.place(cell.cell, point_type{unit_type{x - cell.offset_x}, unit_type{row.y - cell.offset_y}});
+                        site += width_in_sites(row, cell);
+                        ++statistics.legalized;
+                    }
+                }
+            }
+        }
+
+        statistics.failed = m_failed.size();
+        statistics.total_displacement = unit_type{total};
+        statistics.average_displacement = unit_type{statistics.legalized > 0 ? total / statistics.legalized : 0.0};
+        statistics.max_displacement = unit_type{maximum};
+        return statistics;
+    }
+
+    Abacus::site_type Abacus::width_in_sites(const Abacus::Row & row, const Abacus::Cell & cell) const
+    {
+        return static_cast<site_type>(std::ceil(cell.width / row.site_width - site_epsilon));
+    }
+
+    Abacus::site_type Abacus::position(const Abacus::Segment & segment, double x, Abacus::site_type w) const
+    {
+        return std::clamp(static_cast<site_type>(std::lround(x)), segment.begin, segment.end - w);
+    }
+
+    Abacus::site_type Abacus::trial(const Abacus::Segment & segment, double x, Abacus::site_type w) const
+    {
+        // collapses the cell into the clusters on its left without changing them
+        auto e = 1.0;
+        auto q = x;
+        auto width = w;
+        auto index = segment.clusters.size();
+        auto cluster_x = position(segment, q / e, width);
+        while(index > 0)
+        {
+            const auto & previous = segment.clusters[index - 1];
+            if(previous.x + previous.w <= cluster_x)
+            {
+                break;
+            }
+            q = previous.q + q - e * previous.w;
+            e += previous.e;
+            width += previous.w;
+            --index;
+            cluster_x = position(segment, q / e, width);
+        }
+        return cluster_x + width - w;
+    }
+
+    void Abacus::commit(Abacus::Segment & segment, std::size_t cell, double x, Abacus::site_type w)
+    {
+        segment.clusters.push_back(Cluster{1.0, x, 0, w, segment.cells.size()});
+        segment.cells.push_back(cell);
+        segment.used += w;
+        while(true)
+        {
+            auto & cluster = segment.clusters.back();
+            cluster.x = position(segment, cluster.q / cluster.e, cluster.w);
+            if(segment.clusters.size() < 2)
+            {
+                break;
+            }
+            auto & previous = segment.clusters[segment.clusters.size() - 2];
+            if(previous.x + previous.w <= cluster.x)
+            {
+                break;
+            }
+            previous.q += cluster.q - cluster.e * previous.w;
+            previous.e += cluster.e;
+            previous.w += cluster.w;
+            segment.clusters.pop_back();
+        }
+    }
+
+    bool Abacus::place_cell(std::size_t cell, std::size_t first_line, std::size_t last_line)
+    {
+        const auto & data = m_cells[cell];
+        auto best_cost = std::numeric_limits<double>::max();
+        auto best_row = std::size_t{0};
+        auto best_segment = std::size_t{0};
+
+        auto try_line = [&](std::size_t line){
+            auto dy = std::abs(m_line_ys[line] - data.y);
+            for(auto r = m_line_begins[line]; r < m_line_begins[line + 1]; ++r)
+            {
+                const auto & row = m_rows[r];
+                auto w = width_in_sites(row, data);
+                auto x = (data.x - row.x) / row.site_width;
+                const auto & segments = row.segments;
+
+                auto evaluate = [&](std::size_t s){
+                    const auto & segment = segments[s];
+                    if(segment.end - segment.begin - segment.used < w)
+                    {
+                        return;
+                    }
+                    auto site = trial(segment, x, w);
+                    auto cost = std::abs(row.x + site * row.site_width - data.x) + dy;
+                    if(cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_row = r;
+                        best_segment = s;
+                    }
+                };
+
+                // segments right of x are visited while their start can beat the best cost, then the ones on the left
+                auto next = static_cast<std::size_t>(std::upper_bound(segments.begin(), segments.end(), x, [](double value, const Segment & segment){
+                    return value < segment.begin;
+                }) - segments.begin());
+                for(auto s = next; s < segments.size() && (segments[s].begin - x) * row.site_width + dy < best_cost; ++s)
+                {
+                    evaluate(s);
+                }
+                for(auto s = next; s-- > 0 && std::max(0.0, x - (segments[s].end - w)) * row.site_width + dy < best_cost;)
+                {
+                    evaluate(s);
+                }
+            }
+        };
+
+        auto nearest = std::clamp(data.line, first_line, last_line - 1);
+        for(auto line = nearest; line < last_line && std::abs(m_line_ys[line] - data.y) < best_cost; ++line)
+        {
+            try_line(line);
+        }
+        for(auto line = nearest; line-- > first_line && std::abs(m_line_ys[line] - data.y) < best_cost;)
+        {
+            try_line(line);
+        }
+
+        if(best_cost == std::numeric_limits<double>::max())
+        {
+            return false;
+        }
+
+        auto & row = m_rows[best_row];
+        commit(row.segments[best_segment], cell, (data.x - row.x) / row.site_width, width_in_sites(row, data));
+        return true;
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_LEGALIZATION_ABACUS_H
+#define OPHIDIAN_LEGALIZATION_ABACUS_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+#include <ophidian/legalization/FreeSpaceMap.h>
+
+namespace ophidian::legalization
+{
+    //! Abacus legalizer
+
+    /*!
+       \brief Moves the movable cells to legal sites with the Abacus algorithm: cells are taken by
+       increasing x, each one is tried in the rows closest to it and kept in the row where its
+       displacement is the smallest, where it joins the clusters of abutting cells of the free
+       segment between fixed cells that is closest to it. A cluster sits at the mean of the
+       positions its cells want, snapped to the sites, and merges with its left neighbour when
+       they overlap.
+
+       Rows are split into bands of consecutive row lines and each band legalizes the cells whose
+       nearest row is inside it, bands running concurrently. Cells that do not fit in their band
+       are then legalized over every row, in order, so the result does not depend on the number
+       of threads. Cells taller than their row are left where they are.
+     */
+    class Abacus
+    {
+    public:
+        using unit_type             = util::database_unit_t;
+        using point_type            = util::LocationDbu;
+        using cell_type             = placement::Placement::cell_type;
+
+        //! Legalizer parameters
+        struct Parameters
+        {
+            //! Number of row lines of a band legalized by one thread
+            std::size_t lines_per_band{32};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        //! Displacement of a legalization
+        struct Statistics
+        {
+            //! Number of cells moved to legal sites
+            std::size_t legalized{0};
+            //! Number of movable cells that could not be legalized
+            std::size_t failed{0};
+            //! Sum of the Manhattan displacements of the legalized cells
+            unit_type total_displacement{0.0};
+            unit_type average_displacement{0.0};
+            unit_type max_displacement{0.0};
+        };
+
+        // Constructors
+        Abacus() = delete;
+
+        Abacus(const Abacus &) = delete;
+        Abacus & operator=(const Abacus &) = delete;
+
+        //! Construct the legalizer
+        /*!
+           \param netlist Netlist owning the cells
+           \param floorplan Floorplan with the rows
+           \param placement Placement of the cells, legalized cells are moved with Placement::place
+           \param parameters Legalizer parameters
+         */
+        Abacus(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, const Parameters & parameters);
+
+        Abacus(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement);
+
+        //! Legalize every movable cell
+        Statistics legalize();
+
+        //! Movable cells that could not be legalized by the last call to legalize()
+        const std::vector<cell_type> & failed() const noexcept;
+
+    private:
+        using site_type = int;
+
+        struct Cluster
+        {
+            double e;
+            double q;
+            site_type x;
+            site_type w;
+            std::size_t first;
+        };
+
+        struct Segment
+        {
+            site_type begin;
+            site_type end;
+            site_type used;
+            std::vector<std::size_t> cells;
+            std::vector<Cluster> clusters;
+        };
+
+        struct Row
+        {
+            double x;
+            double y;
+            double height;
+            double site_width;
+            std::vector<Segment> segments;
+        };
+
+        //! Movable cell, x and y are the lower left corner of its bounding box
+        struct Cell
+        {
+            cell_type cell;
+            double x;
+            double y;
+            double width;
+            double height;
+            double offset_x;
+            double offset_y;
+            std::size_t line;
+        };
+
+        site_type width_in_sites(const Row & row, const Cell & cell) const;
+        site_type position(const Segment & segment, double x, site_type w) const;
+        site_type trial(const Segment & segment, double x, site_type w) const;
+        void commit(Segment & segment, std::size_t cell, double x, site_type w);
+        bool place_cell(std::size_t cell, std::size_t first_line, std::size_t last_line);
+
+        Parameters m_parameters;
+        const circuit::Netlist & m_netlist;
+        const floorplan::Floorplan & m_floorplan;
+        placement::Placement & m_placement;
+
+        std::vector<Row> m_rows;
+        std::vector<double> m_line_ys;
+        std::vector<std::size_t> m_line_begins;
+        std::vector<Cell> m_cells;
+        std::vector<cell_type> m_failed;
+    };
+}
+
+#endif // OPHIDIAN_LEGALIZATION_ABACUS_H
@@ -0,0 +1,905 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "DetailedPlacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <ophidian/util/Parallel.h>
+#include <ophidian/legalization/FreeSpaceMap.h>
+
+namespace ophidian::legalization
+{
+    namespace
+    {
+        constexpr auto no_cell = std::numeric_limits<std::uint32_t>::max();
+
+        // smallest wirelength change worth a move, and tolerance of width comparisons
+        constexpr double epsilon = 1e-6;
+
+        //! Minimum cost assignment of a square matrix, the Hungarian algorithm with potentials
+        std::vector<std::size_t> assign(const std::vector<std::vector<double>> & cost)
+        {
+            auto size = cost.size();
+            auto infinity = std::numeric_limits<double>::infinity();
+            auto u = std::vector<double>(size + 1, 0.0);
+            auto v = std::vector<double>(size + 1, 0.0);
+            auto owner = std::vector<std::size_t>(size + 1, 0);
+            auto way = std::vector<std::size_t>(size + 1, 0);
+            for(std::size_t row = 1; row <= size; ++row)
+            {
+                owner[0] = row;
+                auto column = std::size_t{0};
+                auto minimum = std::vector<double>(size + 1, infinity);
+                auto used = std::vector<char>(size + 1, 0);
+                do
+                {
+                    used[column] = 1;
+                    auto current = owner[column];
+                    auto delta = infinity;
+                    auto next = std::size_t{0};
+                    for(std::size_t j = 1; j <= size; ++j)
+                    {
+                        if(used[j])
+                        {
+                            continue;
+                        }
+                        auto reduced = cost[current - 1][j - 1] - u[current] - v[j];
+                        if(reduced < minimum[j])
+                        {
+                            minimum[j] = reduced;
+                            way[j] = column;
+                        }
+                        if(minimum[j] < delta)
+                        {
+                            delta = minimum[j];
+                            next = j;
+                        }
+                    }
+                    for(std::size_t j = 0; j <= size; ++j)
+                    {
+                        if(used[j])
+                        {
+                            u[owner[j]] += delta;
+                            v[j] -= delta;
+                        }
+                        else
+                        {
+                            minimum[j] -= delta;
+                        }
+                    }
+                    column = next;
+                }
+                while(owner[column] != 0);
+                do
+                {
+                    auto previous = way[column];
+                    owner[column] = owner[previous];
+                    column = previous;
+                }
+                while(column != 0);
+            }
+
+            auto result = std::vector<std::size_t>(size);
+            for(std::size_t column = 1; column <= size; ++column)
+            {
+                result[owner[column] - 1] = column - 1;
+            }
+            return result;
+        }
+    }
+
+    DetailedPlacer::DetailedPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, const DetailedPlacer::Parameters & parameters):
+        m_netlist(netlist),
+        m_floorplan(floorplan),
+        m_placement(placement),
+        m_parameters(parameters)
+    {
+    }
+
+    DetailedPlacer::DetailedPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement):
+        DetailedPlacer(netlist, floorplan, placement, Parameters{})
+    {
+    }
+
+    DetailedPlacer::Statistics DetailedPlacer::place()
+    {
+        load();
+
+        auto statistics = Statistics{};
+        statistics.initial_wirelength = wirelength(true);
+        for(std::size_t pass = 0; pass < m_parameters.passes; ++pass)
+        {
+            if(m_parameters.global_swap)
+            {
+                statistics.global_swaps += swap(false);
+            }
+            if(m_parameters.vertical_swap)
+            {
+                statistics.vertical_swaps += swap(true);
+            }
+            if(m_parameters.reordering)
+            {
+                statistics.reorderings += reorder();
+            }
+            if(m_parameters.independent_set)
+            {
+                statistics.matched += match();
+            }
+        }
+        statistics.wirelength = wirelength(true);
+
+        store();
+        return statistics;
+    }
+
+    void DetailedPlacer::load()
+    {
+        auto map = FreeSpaceMap{m_netlist, m_floorplan, m_placement, m_parameters.number_of_threads};
+
+        m_cells.assign(m_netlist.begin_cell_instance(), m_netlist.end_cell_instance());
+        auto size = m_cells.size();
+        auto index = m_netlist.make_property_cell_instance<index_type>();
+        m_x.resize(size);
+        m_y.resize(size);
+        m_widths.resize(size);
+        m_offset_x.resize(size);
+        m_offset_y.resize(size);
+        auto heights = std::vector<double>(size);
+        for(index_type cell = 0; cell < size; ++cell)
+        {
+            index[m_cells[cell]] = cell;
+            auto x_low = std::numeric_limits<double>::max();
+            auto y_low = std::numeric_limits<double>::max();
+            auto x_high = std::numeric_limits<double>::lowest();
+            auto y_high = std::numeric_limits<double>::lowest();
+            for(const auto & box : m_placement.geometry(m_cells[cell]))
+            {
+                x_low = std::min(x_low, units::unit_cast<double>(box.min_corner().x()));
+                y_low = std::min(y_low, units::unit_cast<double>(box.min_corner().y()));
+                x_high = std::max(x_high, units::unit_cast<double>(box.max_corner().x()));
+                y_high = std::max(y_high, units::unit_cast<double>(box.max_corner().y()));
+            }
+            auto location = m_placement.location(m_cells[cell]);
+            if(x_low > x_high)
+            {
+                x_low = x_high = units::unit_cast<double>(location.x());
+                y_low = y_high = units::unit_cast<double>(location.y());
+            }
+            m_x[cell] = x_low;
+            m_y[cell] = y_low;
+            m_widths[cell] = x_high - x_low;
+            heights[cell] = y_high - y_low;
+            m_offset_x[cell] = x_low - units::unit_cast<double>(location.x());
+            m_offset_y[cell] = y_low - units::unit_cast<double>(location.y());
+        }
+
+        // rows and lines of rows sharing their y
+        m_rows.clear();
+        m_line_y.clear();
+        m_line_begins.clear();
+        auto occurrences = std::vector<std::size_t>(size, 0);
+        auto owner_rows = std::vector<std::int32_t>(size, -1);
+        auto row_heights = std::vector<double>{};
+        for(const auto & floorplan_row : map.rows())
+        {
+            auto origin = m_floorplan.origin(floorplan_row);
+            auto dimension = m_floorplan.dimension(m_floorplan.site(floorplan_row));
+            auto row = Row{};
+            row.x = units::unit_cast<double>(origin.x());
+            row.y = units::unit_cast<double>(origin.y());
+            row.site_width = units::unit_cast<double>(dimension.x());
+            row.x_end = row.x + units::unit_cast<double>(m_floorplan.number_of_sites(floorplan_row)) * row.site_width;
+            for(auto cell : map.cells(floorplan_row))
+            {
+                auto i = index[cell];
+                row.cells.push_back(i);
+                ++occurrences[i];
+                owner_rows[i] = static_cast<std::int32_t>(m_rows.size());
+            }
+            if(m_line_y.empty() || m_line_y.back() != row.y)
+            {
+                m_line_y.push_back(row.y);
+                m_line_begins.push_back(m_rows.size());
+            }
+            row_heights.push_back(units::unit_cast<double>(dimension.y()));
+            m_rows.push_back(std::move(row));
+        }
+        m_line_begins.push_back(m_rows.size());
+
+        m_cell_rows.assign(size, -1);
+        for(index_type cell = 0; cell < size; ++cell)
+        {
+            auto row = owner_rows[cell];
+            if(occurrences[cell] == 1 && !m_placement.fixed(m_cells[cell]) &&
+               std::abs(m_y[cell] - m_rows[row].y) < epsilon && heights[cell] <= row_heights[row] + epsilon)
+            {
+                m_cell_rows[cell] = row;
+            }
+        }
+
+        // nets, with pin offsets from the lower left corner of their cell
+        m_net_begins.assign(1, 0);
+        m_pin_cells.clear();
+        m_pin_x.clear();
+        m_pin_y.clear();
+        m_optimized.clear();
+        for(auto net = m_netlist.begin_net(); net != m_netlist.end_net(); ++net)
+        {
+            auto first = m_pin_cells.size();
+            for(auto pin : m_netlist.pins(*net))
+            {
+                auto cell = m_netlist.cell(pin);
+                auto location = point_type{};
+                auto owner = no_cell;
+                if(cell != circuit::CellInstance{})
+                {
+                    location = m_placement.location(pin);
+                    owner = index[cell];
+                }
+                else if(m_netlist.input(pin) != circuit::Input{})
+                {
+                    location = m_placement.location(m_netlist.input(pin));
+                }
+                else if(m_netlist.output(pin) != circuit::Output{})
+                {
+                    location = m_placement.location(m_netlist.output(pin));
+                }
+                else
+                {
+                    continue;
+                }
+                auto x = units::unit_cast<double>(location.x());
+                auto y = units::unit_cast<double>(location.y());
+                m_pin_cells.push_back(owner);
+                m_pin_x.push_back(owner == no_cell ? x : x - m_x[owner]);
+                m_pin_y.push_back(owner == no_cell ? y : y - m_y[owner]);
+            }
+            auto degree = m_pin_cells.size() - first;
+            if(degree < 2)
+            {
+                m_pin_cells.resize(first);
+                m_pin_x.resize(first);
+                m_pin_y.resize(first);
+                continue;
+            }
+            m_net_begins.push_back(m_pin_cells.size());
+            m_optimized.push_back(degree <= m_parameters.max_net_degree);
+        }
+
+        // optimized nets of every cell
+        auto nets = m_optimized.size();
+        m_cell_net_begins.assign(size + 1, 0);
+        auto pairs = std::vector<std::pair<index_type, index_type>>{};
+        for(index_type net = 0; net < nets; ++net)
+        {
+            if(!m_optimized[net])
+            {
+                continue;
+            }
+            for(auto pin = m_net_begins[net]; pin < m_net_begins[net + 1]; ++pin)
+            {
+                if(m_pin_cells[pin] != no_cell)
+                {
+                    pairs.emplace_back(m_pin_cells[pin], net);
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        m_cell_nets.clear();
+        for(const auto & pair : pairs)
+        {
+            ++m_cell_net_begins[pair.first + 1];
+            m_cell_nets.push_back(pair.second);
+        }
+        for(std::size_t cell = 0; cell < size; ++cell)
+        {
+            m_cell_net_begins[cell + 1] += m_cell_net_begins[cell];
+        }
+
+        m_boxes.resize(nets);
+        util::parallel_for(0, nets, [&](std::size_t net){
+            m_boxes[net] = box(static_cast<index_type>(net), nullptr, 0);
+        }, m_parameters.number_of_threads, 1024);
+    }
+
+    void DetailedPlacer::store()
+    {
+        for(index_type cell = 0; cell < m_cells.size(); ++cell)
+        {
+            if(m_cell_rows[cell] < 0)
+            {
+                continue;
+            }
+            auto location = point_type{unit_type{m_x[cell] - m_offset_x[cell]}, unit_type{m_y[cell] - m_offset_y[cell]}};
+            auto current = m_placement.location(m_cells[cell]);
+            if(location.x() != current.x() || location.y() != current.y())
+            {
+                m_placement.place(m_cells[cell], location);
+            }
+        }
+    }
+
+    DetailedPlacer::Box DetailedPlacer::box(DetailedPlacer::index_type net, const DetailedPlacer::Move * moves, std::size_t count) const
+    {
+        auto result = Box{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+        for(auto pin = m_net_begins[net]; pin < m_net_begins[net + 1]; ++pin)
+        {
+            auto cell = m_pin_cells[pin];
+            auto x = m_pin_x[pin];
+            auto y = m_pin_y[pin];
+            if(cell != no_cell)
+            {
+                auto cell_x = m_x[cell];
+                auto cell_y = m_y[cell];
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    if(moves[i].cell == cell)
+                    {
+                        cell_x = moves[i].x;
+                        cell_y = moves[i].y;
+                        break;
+                    }
+                }
+                x += cell_x;
+                y += cell_y;
+            }
+            result.x_low = std::min(result.x_low, x);
+            result.x_high = std::max(result.x_high, x);
+            result.y_low = std::min(result.y_low, y);
+            result.y_high = std::max(result.y_high, y);
+        }
+        return result;
+    }
+
+    double DetailedPlacer::delta(const DetailedPlacer::move_container_type & moves) const
+    {
+        auto nets = std::vector<index_type>{};
+        for(const auto & move : moves)
+        {
+            nets.insert(nets.end(), m_cell_nets.begin() + m_cell_net_begins[move.cell], m_cell_nets.begin() + m_cell_net_begins[move.cell + 1]);
+        }
+        std::sort(nets.begin(), nets.end());
+        nets.erase(std::unique(nets.begin(), nets.end()), nets.end());
+
+        auto result = 0.0;
+        for(auto net : nets)
+        {
+            auto before = m_boxes[net];
+            auto after = box(net, moves.data(), moves.size());
+            result += (after.x_high - after.x_low + after.y_high - after.y_low) - (before.x_high - before.x_low + before.y_high - before.y_low);
+        }
+        return result;
+    }
+
+    void DetailedPlacer::commit(const DetailedPlacer::move_container_type & moves)
+    {
+        for(const auto & move : moves)
+        {
+            m_x[move.cell] = move.x;
+            m_y[move.cell] = move.y;
+        }
+        for(const auto & move : moves)
+        {
+            for(auto i = m_cell_net_begins[move.cell]; i < m_cell_net_begins[move.cell + 1]; ++i)
+            {
+                m_boxes[m_cell_nets[i]] = box(m_cell_nets[i], nullptr, 0);
+            }
+        }
+    }
+
+    double DetailedPlacer::wirelength(bool every_net) const
+    {
+        auto result = 0.0;
+        for(index_type net = 0; net < m_optimized.size(); ++net)
+        {
+            if(every_net || m_optimized[net])
+            {
+                auto bounds = box(net, nullptr, 0);
+                result += bounds.x_high - bounds.x_low + bounds.y_high - bounds.y_low;
+            }
+        }
+        return result;
+    }
+
+    std::size_t DetailedPlacer::entry(const DetailedPlacer::Row & row, DetailedPlacer::index_type cell) const
+    {
+        auto it = std::lower_bound(row.cells.begin(), row.cells.end(), m_x[cell], [this](index_type other, double x){
+            return m_x[other] < x;
+        });
+        while(*it != cell)
+        {
+            ++it;
+        }
+        return static_cast<std::size_t>(it - row.cells.begin());
+    }
+
+    std::size_t DetailedPlacer::nearest_line(double y) const
+    {
+        auto it = std::lower_bound(m_line_y.begin(), m_line_y.end(), y);
+        if(it == m_line_y.end())
+        {
+            return m_line_y.size() - 1;
+        }
+        if(it != m_line_y.begin() && y - *(it - 1) < *it - y)
+        {
+            --it;
+        }
+        return static_cast<std::size_t>(it - m_line_y.begin());
+    }
+
+    double DetailedPlacer::snap(const DetailedPlacer::Row & row, double x) const
+    {
+        return row.x + std::round((x - row.x) / row.site_width) * row.site_width;
+    }
+
+    std::size_t DetailedPlacer::swap(bool vertical)
+    {
+        auto result = std::size_t{0};
+        for(index_type cell = 0; cell < m_cells.size(); ++cell)
+        {
+            if(m_cell_rows[cell] >= 0 && m_cell_net_begins[cell] < m_cell_net_begins[cell + 1])
+            {
+                result += swap_cell(cell, vertical);
+            }
+        }
+        return result;
+    }
+
+    bool DetailedPlacer::swap_cell(DetailedPlacer::index_type cell, bool vertical)
+    {
+        const auto & own_row = m_rows[m_cell_rows[cell]];
+        auto own_line = nearest_line(own_row.y);
+        auto width = m_widths[cell];
+        auto target_x = m_x[cell];
+        auto lines = std::vector<std::size_t>{};
+        if(vertical)
+        {
+            if(own_line > 0)
+            {
+                lines.push_back(own_line - 1);
+            }
+            if(own_line + 1 < m_line_y.size())
+            {
+                lines.push_back(own_line + 1);
+            }
+        }
+        else
+        {
+            // optimal region, between the medians of the bounds of the nets without the cell
+            auto xs = std::vector<double>{};
+            auto ys = std::vector<double>{};
+            for(auto i = m_cell_net_begins[cell]; i < m_cell_net_begins[cell + 1]; ++i)
+            {
+                auto net = m_cell_nets[i];
+                auto bounds = Box{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+                for(auto pin = m_net_begins[net]; pin < m_net_begins[net + 1]; ++pin)
+                {
+                    auto owner = m_pin_cells[pin];
+                    if(owner == cell)
+                    {
+                        continue;
+                    }
+                    auto x = m_pin_x[pin] + (owner == no_cell ? 0.0 : m_x[owner]);
+                    auto y = m_pin_y[pin] + (owner == no_cell ? 0.0 : m_y[owner]);
+                    bounds = Box{std::min(bounds.x_low, x), std::max(bounds.x_high, x), std::min(bounds.y_low, y), std::max(bounds.y_high, y)};
+                }
+                if(bounds.x_low <= bounds.x_high)
+                {
+                    xs.insert(xs.end(), {bounds.x_low, bounds.x_high});
+                    ys.insert(ys.end(), {bounds.y_low, bounds.y_high});
+                }
+            }
+            if(xs.empty())
+            {
+                return false;
+            }
+            std::sort(xs.begin(), xs.end());
+            std::sort(ys.begin(), ys.end());
+            auto half = xs.size() / 2;
+            auto center = std::clamp(m_x[cell] + width / 2, xs[half - 1], xs[half]);
+            target_x = center - width / 2;
+            auto target_line = nearest_line(std::clamp(m_y[cell], ys[half - 1], ys[half]));
+            if(target_line == own_line && std::abs(target_x - m_x[cell]) < own_row.site_width)
+            {
+                return false;
+            }
+            lines.push_back(target_line);
+        }
+
+        auto best = -epsilon;
+        auto best_moves = move_container_type{};
+        auto best_swap = no_cell;
+        auto best_row = std::size_t{0};
+        auto moves = move_container_type{};
+        auto search = static_cast<std::ptrdiff_t>(m_parameters.search_cells);
+        for(auto line : lines)
+        {
+            for(auto r = m_line_begins[line]; r < m_line_begins[line + 1]; ++r)
+            {
+                const auto & row = m_rows[r];
+                if(target_x + width < row.x || target_x > row.x_end)
+                {
+                    continue;
+                }
+                auto size = static_cast<std::ptrdiff_t>(row.cells.size());
+                auto position = std::lower_bound(row.cells.begin(), row.cells.end(), target_x, [this](index_type other, double x){
+                    return m_x[other] < x;
+                }) - row.cells.begin();
+                auto first = std::max<std::ptrdiff_t>(0, position - search);
+                auto last = std::min(size, position + search);
+
+                // swaps with cells of the same width
+                for(auto i = first; i < last; ++i)
+                {
+                    auto other = row.cells[i];
+                    if(other == cell || m_cell_rows[other] < 0 || std::abs(m_widths[other] - width) > epsilon)
+                    {
+                        continue;
+                    }
+                    moves = {Move{cell, m_x[other], m_y[other]}, Move{other, m_x[cell], m_y[cell]}};
+                    auto change = delta(moves);
+                    if(change < best)
+                    {
+                        best = change;
+                        best_moves = moves;
+                        best_swap = other;
+                    }
+                }
+
+                // moves into the gaps between the cells
+                for(auto i = first; i <= last; ++i)
+                {
+                    if((i > 0 && row.cells[i - 1] == cell) || (i < size && row.cells[i] == cell))
+                    {
+                        continue;
+                    }
+                    auto left = i > 0 ? m_x[row.cells[i - 1]] + m_widths[row.cells[i - 1]] : row.x;
+                    auto right = i < size ? m_x[row.cells[i]] : row.x_end;
+                    if(right - left < width - epsilon)
+                    {
+                        continue;
+                    }
+                    auto x = snap(row, std::clamp(target_x, left, right - width));
+                    if(x < left - epsilon)
+                    {
+                        x += row.site_width;
+                    }
+                    if(x + width > right + epsilon)
+                    {
+                        continue;
+                    }
+                    moves = {Move{cell, x, row.y}};
+                    auto change = delta(moves);
+                    if(change < best)
+                    {
+                        best = change;
+                        best_moves = moves;
+                        best_swap = no_cell;
+                        best_row = r;
+                    }
+                }
+            }
+        }
+
+        if(best_moves.empty())
+        {
+            return false;
+        }
+
+        auto & from = m_rows[m_cell_rows[cell]];
+        if(best_swap != no_cell)
+        {
+            auto & to = m_rows[m_cell_rows[best_swap]];
+            auto from_entry = entry(from, cell);
+            auto to_entry = entry(to, best_swap);
+            from.cells[from_entry] = best_swap;
+            to.cells[to_entry] = cell;
+            std::swap(m_cell_rows[cell], m_cell_rows[best_swap]);
+            commit(best_moves);
+        }
+        else
+        {
+            from.cells.erase(from.cells.begin() + entry(from, cell));
+            commit(best_moves);
+            auto & to = m_rows[best_row];
+            auto it = std::upper_bound(to.cells.begin(), to.cells.end(), m_x[cell], [this](double x, index_type other){
+                return x < m_x[other];
+            });
+            to.cells.insert(it, cell);
+            m_cell_rows[cell] = static_cast<std::int32_t>(best_row);
+        }
+        return true;
+    }
+
+    std::size_t DetailedPlacer::reorder()
+    {
+        auto size = m_parameters.window_size;
+        if(size < 2)
+        {
+            return 0;
+        }
+
+        // two phases of disjoint windows, the second one straddling the first
+        auto result = std::size_t{0};
+        for(auto offset : {std::size_t{0}, size / 2})
+        {
+            auto windows = std::vector<Window>{};
+            for(const auto & row : m_rows)
+            {
+                for(auto first = offset; first + size <= row.cells.size(); first += size)
+                {
+                    auto window = Window{};
+                    for(auto i = first; i < first + size; ++i)
+                    {
+                        if(m_cell_rows[row.cells[i]] < 0)
+                        {
+                            window.cells.clear();
+                            break;
+                        }
+                        window.cells.push_back(row.cells[i]);
+                    }
+                    if(!window.cells.empty())
+                    {
+                        windows.push_back(std::move(window));
+                    }
+                }
+            }
+            result += process(windows, true);
+        }
+        return result;
+    }
+
+    std::size_t DetailedPlacer::match()
+    {
+        auto movable = std::vector<index_type>{};
+        for(index_type cell = 0; cell < m_cells.size(); ++cell)
+        {
+            if(m_cell_rows[cell] >= 0 && m_cell_net_begins[cell] < m_cell_net_begins[cell + 1])
+            {
+                movable.push_back(cell);
+            }
+        }
+        if(movable.size() < 2 || m_parameters.set_size < 2)
+        {
+            return 0;
+        }
+
+        // square regions holding a few sets each
+        auto x_low = units::unit_cast<double>(m_floorplan.chip_origin().x());
+        auto y_low = units::unit_cast<double>(m_floorplan.chip_origin().y());
+        auto x_high = units::unit_cast<double>(m_floorplan.chip_upper_right_corner().x());
+        auto y_high = units::unit_cast<double>(m_floorplan.chip_upper_right_corner().y());
+        auto bins = static_cast<std::size_t>(std::ceil(std::sqrt(movable.size() / (4.0 * m_parameters.set_size))));
+        bins = std::max<std::size_t>(1, bins);
+        auto bin_of = [&](index_type cell){
+            auto bx = static_cast<std::size_t>(std::clamp((m_x[cell] - x_low) / std::max(epsilon, x_high - x_low) * bins, 0.0, bins - 1.0));
+            auto by = static_cast<std::size_t>(std::clamp((m_y[cell] - y_low) / std::max(epsilon, y_high - y_low) * bins, 0.0, bins - 1.0));
+            return by * bins + bx;
+        };
+        std::stable_sort(movable.begin(), movable.end(), [&](index_type a, index_type b){
+            auto bin_a = bin_of(a);
+            auto bin_b = bin_of(b);
+            return bin_a < bin_b || (bin_a == bin_b && m_widths[a] < m_widths[b] - epsilon);
+        });
+
+        // greedy independent sets of cells of the same width in each region
+        auto marks = std::vector<std::size_t>(m_optimized.size(), 0);
+        auto stamp = std::size_t{0};
+        auto windows = std::vector<Window>{};
+        auto current = Window{};
+        auto close = [&](){
+            if(current.cells.size() >= 2)
+            {
+                windows.push_back(std::move(current));
+            }
+            current = Window{};
+            ++stamp;
+        };
+        for(std::size_t i = 0; i < movable.size(); ++i)
+        {
+            auto cell = movable[i];
+            if(i > 0 && (bin_of(movable[i - 1]) != bin_of(cell) || std::abs(m_widths[movable[i - 1]] - m_widths[cell]) > epsilon))
+            {
+                close();
+            }
+            auto independent = true;
+            for(auto j = m_cell_net_begins[cell]; j < m_cell_net_begins[cell + 1] && independent; ++j)
+            {
+                independent = marks[m_cell_nets[j]] != stamp + 1;
+            }
+            if(!independent)
+            {
+                continue;
+            }
+            for(auto j = m_cell_net_begins[cell]; j < m_cell_net_begins[cell + 1]; ++j)
+            {
+                marks[m_cell_nets[j]] = stamp + 1;
+            }
+            current.cells.push_back(cell);
+            if(current.cells.size() == m_parameters.set_size)
+            {
+                close();
+            }
+        }
+        close();
+
+        return process(windows, false);
+    }
+
+    std::size_t DetailedPlacer::process(std::vector<DetailedPlacer::Window> & windows, bool reordering)
+    {
+        auto marks = std::vector<std::size_t>(m_optimized.size(), 0);
+        auto stamp = std::size_t{0};
+        auto remaining = std::vector<std::size_t>(windows.size());
+        std::iota(remaining.begin(), remaining.end(), 0);
+        auto batch = std::vector<std::size_t>{};
+        auto deferred = std::vector<std::size_t>{};
+        auto result = std::size_t{0};
+        while(!remaining.empty())
+        {
+            // windows sharing no net with the batch join it, the others wait for the next one
+            ++stamp;
+            batch.clear();
+            deferred.clear();
+            for(auto w : remaining)
+            {
+                auto conflict = false;
+                for(auto cell : windows[w].cells)
+                {
+                    for(auto i = m_cell_net_begins[cell]; i < m_cell_net_begins[cell + 1] && !conflict; ++i)
+                    {
+                        conflict = marks[m_cell_nets[i]] == stamp;
+                    }
+                }
+                if(conflict)
+                {
+                    deferred.push_back(w);
+                    continue;
+                }
+                for(auto cell : windows[w].cells)
+                {
+                    for(auto i = m_cell_net_begins[cell]; i < m_cell_net_begins[cell + 1]; ++i)
+                    {
+                        marks[m_cell_nets[i]] = stamp;
+                    }
+                }
+                batch.push_back(w);
+            }
+
+            util::parallel_for(0, batch.size(), [&](std::size_t i){
+                if(reordering)
+                {
+                    evaluate_reordering(windows[batch[i]]);
+                }
+                else
+                {
+                    evaluate_matching(windows[batch[i]]);
+                }
+            }, m_parameters.number_of_threads, 16);
+
+            for(auto w : batch)
+            {
+                auto & window = windows[w];
+                if(window.moves.empty())
+                {
+                    continue;
+                }
+                if(reordering)
+                {
+                    auto & row = m_rows[m_cell_rows[window.cells.front()]];
+                    auto first = row.cells.begin() + entry(row, window.cells.front());
+                    commit(window.moves);
+                    std::sort(first, first + window.cells.size(), [this](index_type a, index_type b){
+                        return m_x[a] < m_x[b];
+                    });
+                    ++result;
+                }
+                else
+                {
+                    // every cell takes the row entry of the cell whose slot it gets
+                    auto slots = std::vector<std::pair<std::int32_t, std::size_t>>{};
+                    for(auto cell : window.cells)
+                    {
+                        slots.emplace_back(m_cell_rows[cell], entry(m_rows[m_cell_rows[cell]], cell));
+                    }
+                    commit(window.moves);
+                    for(std::size_t i = 0; i < window.cells.size(); ++i)
+                    {
+                        auto slot = slots[window.assignment[i]];
+                        m_rows[slot.first].cells[slot.second] = window.cells[i];
+                        m_cell_rows[window.cells[i]] = slot.first;
+                        result += window.assignment[i] != i;
+                    }
+                }
+            }
+            std::swap(remaining, deferred);
+        }
+        return result;
+    }
+
+    void DetailedPlacer::evaluate_reordering(DetailedPlacer::Window & window) const
+    {
+        const auto & cells = window.cells;
+        auto left = m_x[cells.front()];
+        auto order = std::vector<std::size_t>(cells.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto moves = move_container_type(cells.size());
+        auto best = -epsilon;
+        window.moves.clear();
+        while(std::next_permutation(order.begin(), order.end()))
+        {
+            auto x = left;
+            for(std::size_t i = 0; i < order.size(); ++i)
+            {
+                auto cell = cells[order[i]];
+                moves[i] = Move{cell, x, m_y[cell]};
+                x += m_widths[cell];
+            }
+            auto change = delta(moves);
+            if(change < best)
+            {
+                best = change;
+                window.moves = moves;
+            }
+        }
+    }
+
+    void DetailedPlacer::evaluate_matching(DetailedPlacer::Window & window) const
+    {
+        // the cells share no net, so the cost of a slot only depends on the cell taking it
+        const auto & cells = window.cells;
+        auto size = cells.size();
+        auto cost = std::vector<std::vector<double>>(size, std::vector<double>(size, 0.0));
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            for(std::size_t slot = 0; slot < size; ++slot)
+            {
+                auto move = Move{cells[i], m_x[cells[slot]], m_y[cells[slot]]};
+                for(auto j = m_cell_net_begins[cells[i]]; j < m_cell_net_begins[cells[i] + 1]; ++j)
+                {
+                    auto bounds = box(m_cell_nets[j], &move, 1);
+                    cost[i][slot] += bounds.x_high - bounds.x_low + bounds.y_high - bounds.y_low;
+                }
+            }
+        }
+
+        window.assignment = assign(cost);
+        window.moves.clear();
+        auto before = 0.0;
+        auto after = 0.0;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            before += cost[i][i];
+            after += cost[i][window.assignment[i]];
+        }
+        if(after > before - epsilon)
+        {
+            return;
+        }
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            auto slot = cells[window.assignment[i]];
+            window.moves.push_back(Move{cells[i], m_x[slot], m_y[slot]});
+        }
+    }
+}
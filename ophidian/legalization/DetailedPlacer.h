@@ -0,0 +1,208 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_LEGALIZATION_DETAILED_PLACER_H
+#define OPHIDIAN_LEGALIZATION_DETAILED_PLACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+
+namespace ophidian::legalization
+{
+    //! Wirelength driven detailed placer
+
+    /*!
+       \brief Improves the half perimeter wirelength of a legal placement while keeping it legal.
+       Movable cells are the ones lying in a single row; fixed cells and taller cells are
+       obstacles. The passes are:
+
+       - global swap: a cell is swapped with a cell of the same width, or moved into a gap,
+         near the median of the bounding boxes of its nets, its optimal region;
+       - vertical swap: the same search in the rows above and below the cell;
+       - local reordering: every permutation of windows of consecutive cells is tried, packed
+         from the left of the window;
+       - independent set matching: cells of the same width sharing no net are gathered per
+         region and reassigned to their own slots by an optimal bipartite assignment.
+
+       The rows keep their cells sorted by x, found by binary search, and net bounding boxes are
+       cached so a move only evaluates the nets of the moved cells. Reordering windows and
+       independent sets are grouped into batches sharing no net, each batch evaluated
+       concurrently and committed in order, so the result does not depend on the number of
+       threads. Nets with more pins than max_net_degree are ignored.
+     */
+    class DetailedPlacer
+    {
+    public:
+        using unit_type             = util::database_unit_t;
+        using point_type            = util::LocationDbu;
+        using cell_type             = placement::Placement::cell_type;
+
+        //! Detailed placer parameters
+        struct Parameters
+        {
+            //! Number of times every optimization runs
+            std::size_t passes{2};
+            bool global_swap{true};
+            bool vertical_swap{true};
+            bool reordering{true};
+            bool independent_set{true};
+            //! Cells searched on each side of the target of a swap
+            std::size_t search_cells{8};
+            //! Number of cells of a reordering window
+            std::size_t window_size{3};
+            //! Maximum number of cells of an independent set
+            std::size_t set_size{16};
+            //! Nets with more pins are not optimized
+            std::size_t max_net_degree{100};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        //! Result of a detailed placement
+        struct Statistics
+        {
+            //! Half perimeter wirelength before and after, in dbu
+            double initial_wirelength{0.0};
+            double wirelength{0.0};
+            std::size_t global_swaps{0};
+            std::size_t vertical_swaps{0};
+            std::size_t reorderings{0};
+            //! Cells moved by independent set matching
+            std::size_t matched{0};
+        };
+
+        // Constructors
+        DetailedPlacer() = delete;
+
+        DetailedPlacer(const DetailedPlacer &) = delete;
+        DetailedPlacer & operator=(const DetailedPlacer &) = delete;
+
+        //! Construct the placer
+        /*!
+           \param netlist Netlist owning the cells
+           \param floorplan Floorplan with the rows
+           \param placement Legal placement, improved cells are moved with Placement::place
+           \param parameters Detailed placer parameters
+         */
+        DetailedPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, const Parameters & parameters);
+
+        DetailedPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement);
+
+        //! Run the optimization passes
+        Statistics place();
+
+    private:
+        using index_type = std::uint32_t;
+
+        //! Cell moved to a lower left corner
+        struct Move
+        {
+            index_type cell;
+            double x;
+            double y;
+        };
+
+        using move_container_type = std::vector<Move>;
+
+        struct Box
+        {
+            double x_low;
+            double x_high;
+            double y_low;
+            double y_high;
+        };
+
+        //! Row with every cell overlapping it sorted by x
+        struct Row
+        {
+            double x;
+            double y;
+            double x_end;
+            double site_width;
+            std::vector<index_type> cells;
+        };
+
+        //! Cells of a reordering window or an independent set, and their evaluated moves
+        struct Window
+        {
+            std::vector<index_type> cells;
+            move_container_type moves;
+            //! Set cell whose slot each cell of an independent set takes
+            std::vector<std::size_t> assignment;
+        };
+
+        void load();
+        void store();
+
+        // wirelength evaluation
+        Box box(index_type net, const Move * moves, std::size_t count) const;
+        double delta(const move_container_type & moves) const;
+        void commit(const move_container_type & moves);
+        double wirelength(bool every_net) const;
+
+        // row index
+        std::size_t entry(const Row & row, index_type cell) const;
+        std::size_t nearest_line(double y) const;
+        double snap(const Row & row, double x) const;
+
+        // optimizations
+        std::size_t swap(bool vertical);
+        bool swap_cell(index_type cell, bool vertical);
+        std::size_t reorder();
+        std::size_t match();
+        std::size_t process(std::vector<Window> & windows, bool reordering);
+        void evaluate_reordering(Window & window) const;
+        void evaluate_matching(Window & window) const;
+
+        const circuit::Netlist &        m_netlist;
+        const floorplan::Floorplan &    m_floorplan;
+        placement::Placement &          m_placement;
+        Parameters                      m_parameters;
+
+        // cells, x and y are the lower left corner of their bounding box
+        std::vector<cell_type>          m_cells;
+        std::vector<double>             m_x;
+        std::vector<double>             m_y;
+        std::vector<double>             m_widths;
+        std::vector<double>             m_offset_x;
+        std::vector<double>             m_offset_y;
+        std::vector<std::int32_t>       m_cell_rows;
+        std::vector<std::size_t>        m_cell_net_begins;
+        std::vector<index_type>         m_cell_nets;
+
+        // pins of the nets, pads have no cell and an absolute position
+        std::vector<std::size_t>        m_net_begins;
+        std::vector<index_type>         m_pin_cells;
+        std::vector<double>             m_pin_x;
+        std::vector<double>             m_pin_y;
+        std::vector<char>               m_optimized;
+        std::vector<Box>                m_boxes;
+
+        std::vector<Row>                m_rows;
+        std::vector<double>             m_line_y;
+        std::vector<std::size_t>        m_line_begins;
+    };
+}
+
+#endif // OPHIDIAN_LEGALIZATION_DETAILED_PLACER_H
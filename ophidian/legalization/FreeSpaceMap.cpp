@@ -0,0 +1,335 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "FreeSpaceMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::legalization
+{
+    namespace
+    {
+        // tolerance of the conversion from coordinates to site indices
+        constexpr double site_epsilon = 1e-6;
+    }
+
+    FreeSpaceMap::FreeSpaceMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, std::size_t number_of_threads):
+        Subscription(placement, *this),
+        m_netlist(netlist),
+        m_floorplan(floorplan),
+        m_placement(placement),
+        m_number_of_threads(number_of_threads),
+        m_row_index(floorplan.make_property_row<std::size_t>()),
+        m_cell_spans(netlist.make_property_cell_instance<std::vector<Span>>())
+    {
+        build();
+    }
+
+    const FreeSpaceMap::row_container_type & FreeSpaceMap::rows() const noexcept
+    {
+        return m_rows;
+    }
+
+    FreeSpaceMap::segment_container_type FreeSpaceMap::segments(const FreeSpaceMap::row_type & row) const
+    {
+        return free_space(m_rows_data[m_row_index[row]], true);
+    }
+
+    FreeSpaceMap::segment_container_type FreeSpaceMap::free_segments(const FreeSpaceMap::row_type & row) const
+    {
+        return free_space(m_rows_data[m_row_index[row]], false);
+    }
+
+    FreeSpaceMap::cell_container_type FreeSpaceMap::cells(const FreeSpaceMap::row_type & row) const
+    {
+        const auto & data = m_rows_data[m_row_index[row]];
+        auto result = cell_container_type{};
+        result.reserve(data.occupations.size());
+        for(const auto & occupation : data.occupations)
+        {
+            result.push_back(occupation.cell);
+        }
+        return result;
+    }
+
+    FreeSpaceMap::unit_type FreeSpaceMap::free_width(const FreeSpaceMap::row_type & row, const FreeSpaceMap::unit_type & begin, const FreeSpaceMap::unit_type & end) const
+    {
+        const auto & data = m_rows_data[m_row_index[row]];
+        auto [first, last] = inner_sites(data, begin, end);
+        if(first >= last)
+        {
+            return unit_type{0.0};
+        }
+
+        // cells starting before the range only matter through the furthest site they reach
+        auto it = std::lower_bound(data.occupations.begin(), data.occupations.end(), first, [](const Occupation & occupation, site_type site){
+            return occupation.begin < site;
+        });
+        auto index = static_cast<std::size_t>(it - data.occupations.begin());
+        auto cursor = index > 0 ? std::max(first, data.reach[index - 1]) : first;
+
+        auto free = site_type{0};
+        for(; it != data.occupations.end() && it->begin < last; ++it)
+        {
+            if(it->begin > cursor)
+            {
+                free += it->begin - cursor;
+            }
+            cursor = std::max(cursor, it->end);
+        }
+        free += std::max(0, last - cursor);
+
+        return unit_type{free * data.site_width};
+    }
+
+    bool FreeSpaceMap::is_free(const FreeSpaceMap::row_type & row, const FreeSpaceMap::unit_type & begin, const FreeSpaceMap::unit_type & end) const
+    {
+        const auto & data = m_rows_data[m_row_index[row]];
+        auto [first, last] = inner_sites(data, begin, end);
+        return free_width(row, begin, end) == unit_type{std::max(0, last - first) * data.site_width};
+    }
+
+    void FreeSpaceMap::build()
+    {
+        m_rows.assign(m_floorplan.range_row().begin(), m_floorplan.range_row().end());
+        std::sort(m_rows.begin(), m_rows.end(), [this](const row_type & a, const row_type & b){
+            auto origin_a = m_floorplan.origin(a);
+            auto origin_b = m_floorplan.origin(b);
+            return origin_a.y() < origin_b.y() || (origin_a.y() == origin_b.y() && origin_a.x() < origin_b.x());
+        });
+
+        m_rows_data.clear();
+        m_rows_data.reserve(m_rows.size());
+        m_max_row_height = 0.0;
+        for(std::size_t i = 0; i < m_rows.size(); ++i)
+        {
+            auto row = m_rows[i];
+            auto origin = m_floorplan.origin(row);
+            auto dimension = m_floorplan.dimension(m_floorplan.site(row));
+            auto data = RowData{};
+            data.row = row;
+            data.x = units::unit_cast<double>(origin.x());
+            data.y = units::unit_cast<double>(origin.y());
+            data.top = data.y + units::unit_cast<double>(dimension.y());
+            data.site_width = units::unit_cast<double>(dimension.x());
+            data.sites = static_cast<site_type>(units::unit_cast<double>(m_floorplan.number_of_sites(row)));
+            m_max_row_height = std::max(m_max_row_height, data.top - data.y);
+            m_rows_data.push_back(std::move(data));
+            m_row_index[row] = i;
+        }
+
+        auto cells = cell_container_type(m_netlist.begin_cell_instance(), m_netlist.end_cell_instance());
+
+        // each cell writes its own spans, then rows are filled in cell order and sorted in parallel
+        util::parallel_for(0, cells.size(), [&](std::size_t i){
+            m_cell_spans[cells[i]] = spans(cells[i]);
+        }, m_number_of_threads, 256);
+
+        for(auto cell : cells)
+        {
+            auto fixed = m_placement.fixed(cell);
+            for(const auto & span : m_cell_spans[cell])
+            {
+                m_rows_data[span.row].occupations.push_back(Occupation{span.begin, span.end, cell, fixed});
+            }
+        }
+
+        util::parallel_for(0, m_rows_data.size(), [&](std::size_t i){
+            auto & data = m_rows_data[i];
+            std::stable_sort(data.occupations.begin(), data.occupations.end(), [](const Occupation & a, const Occupation & b){
+                return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
+            });
+            data.reach.resize(data.occupations.size());
+            update_reach(data, 0);
+        }, m_number_of_threads, 16);
+    }
+
+    void FreeSpaceMap::place(const FreeSpaceMap::cell_type & cell, const FreeSpaceMap::point_type & location)
+    {
+        m_placement.place(cell, location);
+        if(!attached())
+        {
+            update(cell);
+        }
+    }
+
+    void FreeSpaceMap::fix(const FreeSpaceMap::cell_type & cell, bool fixed)
+    {
+        m_placement.fix(cell, fixed);
+        if(!attached())
+        {
+            update(cell);
+        }
+    }
+
+    void FreeSpaceMap::update(const FreeSpaceMap::cell_type & cell)
+    {
+        remove(cell);
+        m_cell_spans[cell] = spans(cell);
+        insert(cell);
+    }
+
+    void FreeSpaceMap::moved(const placement::Placement::move_container_type & moves)
+    {
+        if(rebuild(moves))
+        {
+            build();
+            return;
+        }
+        for(const auto & move : moves)
+        {
+            update(move.cell);
+        }
+    }
+
+    void FreeSpaceMap::fixed(const FreeSpaceMap::cell_type & cell)
+    {
+        update(cell);
+    }
+
+    void FreeSpaceMap::oriented(const FreeSpaceMap::cell_type & cell)
+    {
+        update(cell);
+    }
+
+    std::vector<FreeSpaceMap::Span> FreeSpaceMap::spans(const FreeSpaceMap::cell_type & cell) const
+    {
+        auto result = std::vector<Span>{};
+        for(const auto & box : m_placement.geometry(cell))
+        {
+            auto x_low = units::unit_cast<double>(box.min_corner().x());
+            auto x_high = units::unit_cast<double>(box.max_corner().x());
+            auto y_low = units::unit_cast<double>(box.min_corner().y());
+            auto y_high = units::unit_cast<double>(box.max_corner().y());
+
+            // rows starting below the top of the box, walked down while they can still reach it
+            auto it = std::lower_bound(m_rows_data.begin(), m_rows_data.end(), y_high, [](const RowData & data, double y){
+                return data.y < y;
+            });
+            while(it != m_rows_data.begin())
+            {
+                --it;
+                if(it->y + m_max_row_height <= y_low)
+                {
+                    break;
+                }
+                if(it->top <= y_low)
+                {
+                    continue;
+                }
+
+                auto begin = static_cast<site_type>(std::floor((x_low - it->x) / it->site_width + site_epsilon));
+                auto end = static_cast<site_type>(std::ceil((x_high - it->x) / it->site_width - site_epsilon));
+                begin = std::max(begin, 0);
+                end = std::min(end, it->sites);
+                if(begin < end)
+                {
+                    result.push_back(Span{static_cast<std::size_t>(it - m_rows_data.begin()), begin, end});
+                }
+            }
+        }
+        return result;
+    }
+
+    void FreeSpaceMap::insert(const FreeSpaceMap::cell_type & cell)
+    {
+        auto fixed = m_placement.fixed(cell);
+        for(const auto & span : m_cell_spans[cell])
+        {
+            auto & data = m_rows_data[span.row];
+            auto it = std::upper_bound(data.occupations.begin(), data.occupations.end(), span, [](const Span & value, const Occupation & occupation){
+                return value.begin < occupation.begin || (value.begin == occupation.begin && value.end < occupation.end);
+            });
+            auto index = static_cast<std::size_t>(it - data.occupations.begin());
+            data.occupations.insert(it, Occupation{span.begin, span.end, cell, fixed});
+            data.reach.push_back(0);
+            update_reach(data, index);
+        }
+    }
+
+    void FreeSpaceMap::remove(const FreeSpaceMap::cell_type & cell)
+    {
+        for(const auto & span : m_cell_spans[cell])
+        {
+            auto & data = m_rows_data[span.row];
+            auto it = std::lower_bound(data.occupations.begin(), data.occupations.end(), span, [](const Occupation & occupation, const Span & value){
+                return occupation.begin < value.begin || (occupation.begin == value.begin && occupation.end < value.end);
+            });
+            while(it != data.occupations.end() && it->cell != cell)
+            {
+                ++it;
+            }
+            if(it == data.occupations.end())
+            {
+                continue;
+            }
+            auto index = static_cast<std::size_t>(it - data.occupations.begin());
+            data.occupations.erase(it);
+            data.reach.pop_back();
+            update_reach(data, index);
+        }
+        m_cell_spans[cell].clear();
+    }
+
+    void FreeSpaceMap::update_reach(FreeSpaceMap::RowData & data, std::size_t from)
+    {
+        auto reach = from > 0 ? data.reach[from - 1] : site_type{0};
+        for(auto i = from; i < data.occupations.size(); ++i)
+        {
+            reach = std::max(reach, data.occupations[i].end);
+            data.reach[i] = reach;
+        }
+    }
+
+    std::pair<FreeSpaceMap::site_type, FreeSpaceMap::site_type> FreeSpaceMap::inner_sites(const FreeSpaceMap::RowData & data, const FreeSpaceMap::unit_type & begin, const FreeSpaceMap::unit_type & end) const
+    {
+        auto first = static_cast<site_type>(std::ceil((units::unit_cast<double>(begin) - data.x) / data.site_width - site_epsilon));
+        auto last = static_cast<site_type>(std::floor((units::unit_cast<double>(end) - data.x) / data.site_width + site_epsilon));
+        return {std::max(first, 0), std::min(last, data.sites)};
+    }
+
+    FreeSpaceMap::segment_container_type FreeSpaceMap::free_space(const FreeSpaceMap::RowData & data, bool fixed_only) const
+    {
+        auto result = segment_container_type{};
+        auto push = [&](site_type begin, site_type end){
+            result.push_back(Segment{unit_type{data.x + begin * data.site_width}, unit_type{data.x + end * data.site_width}});
+        };
+
+        auto cursor = site_type{0};
+        for(const auto & occupation : data.occupations)
+        {
+            if(fixed_only && !occupation.fixed)
+            {
+                continue;
+            }
+            if(occupation.begin > cursor)
+            {
+                push(cursor, occupation.begin);
+            }
+            cursor = std::max(cursor, occupation.end);
+        }
+        if(cursor < data.sites)
+        {
+            push(cursor, data.sites);
+        }
+        return result;
+    }
+}
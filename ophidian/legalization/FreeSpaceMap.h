@@ -0,0 +1,172 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_LEGALIZATION_FREE_SPACE_MAP_H
+#define OPHIDIAN_LEGALIZATION_FREE_SPACE_MAP_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+
+namespace ophidian::legalization
+{
+    //! Occupied and free sites of every floorplan row
+
+    /*!
+       \brief Each row keeps the site ranges covered by the cells overlapping it in a vector sorted
+       by first site, along with the furthest site reached by any prefix of that vector, so a
+       whitespace query is a binary search followed by a walk over the cells inside the range.
+       Fixed cells are blockages: segments() returns the free space between them, which is where
+       movable cells can be legalized, while free_segments() also removes the movable cells.
+       The map is built in parallel from the placement and updated one cell at a time when cells
+       are moved through place() or changed behind its back and passed to update(). An attached
+       map listens to the placement and follows every move, fix and orientation change by
+       itself, rebuilding when a batch moves more than rebuild_fraction() of the cells.
+     */
+    class FreeSpaceMap :
+        private placement::Placement::Listener,
+        public placement::Placement::Subscription
+    {
+    public:
+        using unit_type             = util::database_unit_t;
+        using point_type            = util::LocationDbu;
+        using cell_type             = placement::Placement::cell_type;
+        using row_type              = floorplan::Floorplan::row_type;
+        using row_container_type    = std::vector<row_type>;
+        using cell_container_type   = std::vector<cell_type>;
+
+        //! Horizontal range of a row, [begin, end)
+        struct Segment
+        {
+            unit_type begin;
+            unit_type end;
+        };
+
+        using segment_container_type = std::vector<Segment>;
+
+        // Constructors
+        FreeSpaceMap() = delete;
+
+        FreeSpaceMap(const FreeSpaceMap &) = delete;
+        FreeSpaceMap & operator=(const FreeSpaceMap &) = delete;
+
+        //! Construct and build the map
+        /*!
+           \param netlist Netlist owning the cells
+           \param floorplan Floorplan with the rows
+           \param placement Placement of the cells, modified by place() and fix()
+           \param number_of_threads Threads used by build(), 0 for one per hardware thread
+         */
+        FreeSpaceMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, placement::Placement & placement, std::size_t number_of_threads = 0);
+
+        // Element access
+
+        //! Rows sorted by origin, bottom-up and left to right
+        const row_container_type & rows() const noexcept;
+
+        //! Free space of a row between fixed cells
+        segment_container_type segments(const row_type & row) const;
+
+        //! Free space of a row between every cell
+        segment_container_type free_segments(const row_type & row) const;
+
+        //! Cells overlapping a row, sorted by their first site
+        cell_container_type cells(const row_type & row) const;
+
+        //! Free width of a row inside a range
+        /*!
+           \brief Width of the free sites lying entirely inside [begin, end).
+         */
+        unit_type free_width(const row_type & row, const unit_type & begin, const unit_type & end) const;
+
+        //! True when every site inside [begin, end) is free
+        bool is_free(const row_type & row, const unit_type & begin, const unit_type & end) const;
+
+        // Modifiers
+
+        //! Rebuild the map from the placement and the floorplan rows
+        void build();
+
+        //! Move a cell through the placement and update its occupation
+        void place(const cell_type & cell, const point_type & location);
+
+        //! Fix or release a cell through the placement and update its occupation
+        void fix(const cell_type & cell, bool fixed);
+
+        //! Update the occupation of a cell after its location or fixed state changed
+        void update(const cell_type & cell);
+
+    private:
+        using site_type = int;
+
+        struct Occupation
+        {
+            site_type begin;
+            site_type end;
+            cell_type cell;
+            bool fixed;
+        };
+
+        struct Span
+        {
+            std::size_t row;
+            site_type begin;
+            site_type end;
+        };
+
+        struct RowData
+        {
+            row_type row;
+            double x;
+            double y;
+            double top;
+            double site_width;
+            site_type sites;
+            std::vector<Occupation> occupations;
+            std::vector<site_type> reach;
+        };
+
+        std::vector<Span> spans(const cell_type & cell) const;
+        void insert(const cell_type & cell);
+        void remove(const cell_type & cell);
+        void update_reach(RowData & data, std::size_t from);
+        std::pair<site_type, site_type> inner_sites(const RowData & data, const unit_type & begin, const unit_type & end) const;
+        segment_container_type free_space(const RowData & data, bool fixed_only) const;
+        void moved(const placement::Placement::move_container_type & moves) override;
+        void fixed(const cell_type & cell) override;
+        void oriented(const cell_type & cell) override;
+
+        const circuit::Netlist &        m_netlist;
+        const floorplan::Floorplan &    m_floorplan;
+        placement::Placement &          m_placement;
+        std::size_t                     m_number_of_threads;
+
+        std::vector<RowData>                                    m_rows_data;
+        row_container_type                                      m_rows;
+        double                                                  m_max_row_height{0.0};
+        entity_system::Property<row_type, std::size_t>          m_row_index;
+        entity_system::Property<cell_type, std::vector<Span>>   m_cell_spans;
+    };
+}
+
+#endif // OPHIDIAN_LEGALIZATION_FREE_SPACE_MAP_H
@@ -0,0 +1,552 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+#include "Liberty.h"
+#include "ParserException.h"
+
+namespace ophidian::parser
+{
+    namespace
+    {
+        struct Token
+        {
+            enum class Kind { WORD, STRING, SYMBOL };
+
+            Kind kind;
+            std::string text;
+        };
+
+        //! Attribute or group statement of a Liberty file
+        struct Group
+        {
+            std::string type;
+            std::vector<std::string> arguments;
+            std::vector<std::pair<std::string, std::vector<std::string>>> attributes;
+            std::vector<Group> groups;
+
+            const std::vector<std::string>* attribute(const std::string & name) const
+            {
+                for(const auto & attribute : attributes)
+                {
+                    if(attribute.first == name)
+                    {
+                        return &attribute.second;
+                    }
+                }
+                return nullptr;
+            }
+
+            const std::string* value(const std::string & name) const
+            {
+                auto values = attribute(name);
+                return values == nullptr || values->empty() ? nullptr : &values->front();
+            }
+        };
+
+        bool is_symbol(char c)
+        {
+            return c == '(' || c == ')' || c == '{' || c == '}' || c == ':' || c == ';' || c == ',';
+        }
+
+        std::vector<Token> tokenize(const std::string & text)
+        {
+            auto tokens = std::vector<Token>{};
+            auto i = std::size_t{0};
+            while(i < text.size())
+            {
+                auto c = text[i];
+                if(std::isspace(static_cast<unsigned char>(c)) || c == '\\')
+                {
+                    ++i;
+                }
+                else if(c == '/' && i + 1 < text.size() && text[i + 1] == '*')
+                {
+                    auto end = text.find("*/", i + 2);
+                    i = end == std::string::npos ? text.size() : end + 2;
+                }
+                else if(c == '/' && i + 1 < text.size() && text[i + 1] == '/')
+                {
+                    auto end = text.find('\n', i);
+                    i = end == std::string::npos ? text.size() : end;
+                }
+                else if(c == '"')
+                {
+                    auto end = text.find('"', i + 1);
+                    if(end == std::string::npos)
+                    {
+                        throw exceptions::LibertySyntaxError{};
+                    }
+                    tokens.push_back(Token{Token::Kind::STRING, text.substr(i + 1, end - i - 1)});
+                    i = end + 1;
+                }
+                else if(is_symbol(c))
+                {
+                    tokens.push_back(Token{Token::Kind::SYMBOL, std::string(1, c)});
+                    ++i;
+                }
+                else
+                {
+                    auto begin = i;
+                    while(i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) && !is_symbol(text[i]) && text[i] != '"')
+                    {
+                        ++i;
+                    }
+                    tokens.push_back(Token{Token::Kind::WORD, text.substr(begin, i - begin)});
+                }
+            }
+            return tokens;
+        }
+
+        class GroupParser
+        {
+        public:
+            explicit GroupParser(std::vector<Token> tokens):
+                m_tokens{std::move(tokens)}
+            {
+            }
+
+            //! Statements until the end of the enclosing group
+            void parse_body(Group & group)
+            {
+                while(m_position < m_tokens.size() && !symbol("}"))
+                {
+                    auto name = word();
+                    if(symbol(":"))
+                    {
+                        ++m_position;
+                        auto value = word_or_string();
+                        group.attributes.emplace_back(name, std::vector<std::string>{value});
+                        skip(";");
+                    }
+                    else if(symbol("("))
+                    {
+                        ++m_position;
+                        auto arguments = std::vector<std::string>{};
+                        while(!symbol(")"))
+                        {
+                            arguments.push_back(word_or_string());
+                            skip(",");
+                        }
+                        ++m_position;
+                        if(symbol("{"))
+                        {
+                            ++m_position;
+                            auto child = Group{name, std::move(arguments), {}, {}};
+                            parse_body(child);
+                            expect("}");
+                            group.groups.push_back(std::move(child));
+                        }
+                        else
+                        {
+                            group.attributes.emplace_back(name, std::move(arguments));
+                            skip(";");
+                        }
+                    }
+                    else
+                    {
+                        throw exceptions::LibertySyntaxError{};
+                    }
+                }
+            }
+
+        private:
+            bool symbol(const char * text) const
+            {
+                return m_position < m_tokens.size() && m_tokens[m_position].kind == Token::Kind::SYMBOL && m_tokens[m_position].text == text;
+            }
+
+            void skip(const char * text)
+            {
+                if(symbol(text))
+                {
+                    ++m_position;
+                }
+            }
+
+            void expect(const char * text)
+            {
+                if(!symbol(text))
+                {
+                    throw exceptions::LibertySyntaxError{};
+                }
+                ++m_position;
+            }
+
+            std::string word()
+            {
+                if(m_position >= m_tokens.size() || m_tokens[m_position].kind != Token::Kind::WORD)
+                {
+                    throw exceptions::LibertySyntaxError{};
+                }
+                return m_tokens[m_position++].text;
+            }
+
+            std::string word_or_string()
+            {
+                if(m_position >= m_tokens.size() || m_tokens[m_position].kind == Token::Kind::SYMBOL)
+                {
+                    throw exceptions::LibertySyntaxError{};
+                }
+                return m_tokens[m_position++].text;
+            }
+
+            std::vector<Token> m_tokens;
+            std::size_t m_position{0};
+        };
+
+        double number(const std::string & text)
+        {
+            try
+            {
+                return std::stod(text);
+            }
+            catch(const std::exception &)
+            {
+                throw exceptions::LibertySyntaxError{};
+            }
+        }
+
+        Liberty::value_container_type numbers(const std::string & text)
+        {
+            auto result = Liberty::value_container_type{};
+            auto begin = std::size_t{0};
+            while(begin < text.size())
+            {
+                auto end = text.find(',', begin);
+                end = end == std::string::npos ? text.size() : end;
+                auto item = text.substr(begin, end - begin);
+                if(item.find_first_not_of(" \t\r\n") != std::string::npos)
+                {
+                    result.push_back(number(item));
+                }
+                begin = end + 1;
+            }
+            return result;
+        }
+
+        double scale(const std::string & unit)
+        {
+            static const auto scales = std::unordered_map<std::string, double>{
+                {"s", 1.0}, {"ms", 1e-3}, {"us", 1e-6}, {"ns", 1e-9}, {"ps", 1e-12}, {"fs", 1e-15},
+                {"f", 1.0}, {"mf", 1e-3}, {"uf", 1e-6}, {"nf", 1e-9}, {"pf", 1e-12}, {"ff", 1e-15}
+            };
+            auto lower = unit;
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c){ return std::tolower(c); });
+            auto it = scales.find(lower);
+            if(it == scales.end())
+            {
+                throw exceptions::LibertySyntaxError{};
+            }
+            return it->second;
+        }
+
+        // "1ns" or "10ps"
+        double time_value(const std::string & text)
+        {
+            auto split = text.find_first_not_of("0123456789.+-eE");
+            if(split == 0 || split == std::string::npos)
+            {
+                throw exceptions::LibertySyntaxError{};
+            }
+            return number(text.substr(0, split)) * scale(text.substr(split));
+        }
+
+        Liberty::Table table(const Group & group, const std::unordered_map<std::string, Liberty::Table> & templates)
+        {
+            auto result = Liberty::Table{};
+            if(!group.arguments.empty())
+            {
+                auto it = templates.find(group.arguments.front());
+                if(it != templates.end())
+                {
+                    result = it->second;
+                }
+            }
+            if(auto index = group.attribute("index_1"); index != nullptr && !index->empty())
+            {
+                result.index_1 = numbers(index->front());
+            }
+            if(auto index = group.attribute("index_2"); index != nullptr && !index->empty())
+            {
+                result.index_2 = numbers(index->front());
+            }
+            if(auto values = group.attribute("values"); values != nullptr)
+            {
+                for(const auto & row : *values)
+                {
+                    result.values.push_back(numbers(row));
+                }
+            }
+
+            // one dimensional tables are written as a single row along index_1
+            if(result.index_2.empty() && result.values.size() == 1 && result.index_1.size() > 1)
+            {
+                auto row = result.values.front();
+                result.values.clear();
+                for(auto value : row)
+                {
+                    result.values.push_back({value});
+                }
+            }
+
+            auto rows = result.index_1.empty() ? std::size_t{1} : result.index_1.size();
+            auto columns = result.index_2.empty() ? std::size_t{1} : result.index_2.size();
+            if(result.values.size() != rows || std::any_of(result.values.begin(), result.values.end(), [columns](const auto & row){ return row.size() != columns; }))
+            {
+                throw exceptions::LibertySyntaxError{};
+            }
+            return result;
+        }
+
+        Liberty::Timing timing(const Group & group, const std::unordered_map<std::string, Liberty::Table> & templates)
+        {
+            static const auto senses = std::unordered_map<std::string, Liberty::TimingSense>{
+                {"positive_unate", Liberty::TimingSense::POSITIVE_UNATE},
+                {"negative_unate", Liberty::TimingSense::NEGATIVE_UNATE},
+                {"non_unate", Liberty::TimingSense::NON_UNATE}
+            };
+            static const auto types = std::unordered_map<std::string, Liberty::TimingType>{
+                {"combinational", Liberty::TimingType::COMBINATIONAL},
+                {"rising_edge", Liberty::TimingType::RISING_EDGE},
+                {"falling_edge", Liberty::TimingType::FALLING_EDGE},
+                {"setup_rising", Liberty::TimingType::SETUP_RISING},
+                {"setup_falling", Liberty::TimingType::SETUP_FALLING},
+                {"hold_rising", Liberty::TimingType::HOLD_RISING},
+                {"hold_falling", Liberty::TimingType::HOLD_FALLING}
+            };
+
+            auto result = Liberty::Timing{};
+            if(auto value = group.value("related_pin"))
+            {
+                result.related_pin = *value;
+            }
+            if(auto value = group.value("timing_sense"))
+            {
+                auto it = senses.find(*value);
+                if(it == senses.end())
+                {
+                    throw exceptions::LibertySyntaxError{};
+                }
+                result.timing_sense = it->second;
+            }
+            if(auto value = group.value("timing_type"))
+            {
+                auto it = types.find(*value);
+                result.timing_type = it == types.end() ? Liberty::TimingType::OTHER : it->second;
+            }
+
+            for(const auto & child : group.groups)
+            {
+                if(child.type == "cell_rise")
+                {
+                    result.cell_rise = table(child, templates);
+                }
+                else if(child.type == "cell_fall")
+                {
+                    result.cell_fall = table(child, templates);
+                }
+                else if(child.type == "rise_transition")
+                {
+                    result.rise_transition = table(child, templates);
+                }
+                else if(child.type == "fall_transition")
+                {
+                    result.fall_transition = table(child, templates);
+                }
+                else if(child.type == "rise_constraint")
+                {
+                    result.rise_constraint = table(child, templates);
+                }
+                else if(child.type == "fall_constraint")
+                {
+                    result.fall_constraint = table(child, templates);
+                }
+            }
+            return result;
+        }
+
+        Liberty::Pin pin(const std::string & name, const Group & group, const std::unordered_map<std::string, Liberty::Table> & templates)
+        {
+            static const auto directions = std::unordered_map<std::string, Liberty::Direction>{
+                {"input", Liberty::Direction::INPUT},
+                {"output", Liberty::Direction::OUTPUT},
+                {"inout", Liberty::Direction::INOUT},
+                {"internal", Liberty::Direction::INTERNAL}
+            };
+
+            auto result = Liberty::Pin{};
+            result.name = name;
+            if(auto value = group.value("direction"))
+            {
+                auto it = directions.find(*value);
+                if(it == directions.end())
+                {
+                    throw exceptions::LibertySyntaxError{};
+                }
+                result.direction = it->second;
+            }
+            for(auto attribute : {"rise_capacitance", "fall_capacitance", "capacitance"})
+            {
+                if(auto value = group.value(attribute))
+                {
+                    result.capacitance = std::max(result.capacitance, number(*value));
+                }
+            }
+            if(auto value = group.value("max_capacitance"))
+            {
+                result.max_capacitance = number(*value);
+            }
+            if(auto value = group.value("clock"))
+            {
+                result.clock = *value == "true";
+            }
+            for(const auto & child : group.groups)
+            {
+                if(child.type == "timing")
+                {
+                    result.timings.push_back(timing(child, templates));
+                }
+            }
+            return result;
+        }
+    }
+
+    Liberty::Liberty(const std::string& liberty_file)
+    {
+        read_file(liberty_file);
+    }
+
+    void Liberty::read_file(const std::string& liberty_file)
+    {
+        auto file = std::ifstream{liberty_file};
+
+        if(!file.is_open())
+        {
+            throw exceptions::InexistentFile{};
+        }
+
+        auto text = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        auto root = Group{};
+        auto parser = GroupParser{tokenize(text)};
+        parser.parse_body(root);
+
+        auto library = std::find_if(root.groups.begin(), root.groups.end(), [](const auto & group){ return group.type == "library"; });
+        if(library == root.groups.end())
+        {
+            throw exceptions::LibertySyntaxError{};
+        }
+
+        m_name = library->arguments.empty() ? string_type{} : library->arguments.front();
+        if(auto value = library->value("time_unit"))
+        {
+            m_time_unit = second_type{time_value(*value)};
+        }
+        if(auto values = library->attribute("capacitive_load_unit"))
+        {
+            if(values->size() != 2)
+            {
+                throw exceptions::LibertySyntaxError{};
+            }
+            m_capacitance_unit = farad_type{number((*values)[0]) * scale((*values)[1])};
+        }
+
+        auto templates = std::unordered_map<std::string, Table>{};
+        for(const auto & group : library->groups)
+        {
+            if(group.type == "lu_table_template" && !group.arguments.empty())
+            {
+                auto lut = Table{};
+                if(auto value = group.value("variable_1"))
+                {
+                    lut.variable_1 = *value;
+                }
+                if(auto value = group.value("variable_2"))
+                {
+                    lut.variable_2 = *value;
+                }
+                if(auto index = group.attribute("index_1"); index != nullptr && !index->empty())
+                {
+                    lut.index_1 = numbers(index->front());
+                }
+                if(auto index = group.attribute("index_2"); index != nullptr && !index->empty())
+                {
+                    lut.index_2 = numbers(index->front());
+                }
+                templates[group.arguments.front()] = std::move(lut);
+            }
+        }
+
+        for(const auto & group : library->groups)
+        {
+            if(group.type != "cell" || group.arguments.empty())
+            {
+                continue;
+            }
+            auto cell = Cell{};
+            cell.name = group.arguments.front();
+            if(auto value = group.value("area"))
+            {
+                cell.area = number(*value);
+            }
+            for(const auto & child : group.groups)
+            {
+                if(child.type == "pin")
+                {
+                    for(const auto & name : child.arguments)
+                    {
+                        cell.pins.push_back(pin(name, child, templates));
+                    }
+                }
+            }
+            m_cells.push_back(std::move(cell));
+        }
+    }
+
+    const Liberty::string_type& Liberty::name() const noexcept
+    {
+        return m_name;
+    }
+
+    const Liberty::second_type& Liberty::time_unit() const noexcept
+    {
+        return m_time_unit;
+    }
+
+    const Liberty::farad_type& Liberty::capacitance_unit() const noexcept
+    {
+        return m_capacitance_unit;
+    }
+
+    const Liberty::cell_container_type& Liberty::cells() const noexcept
+    {
+        return m_cells;
+    }
+
+    const Liberty::cell_type* Liberty::find_cell(const Liberty::string_type& name) const
+    {
+        auto it = std::find_if(m_cells.begin(), m_cells.end(), [&name](const auto & cell){ return cell.name == name; });
+        return it == m_cells.end() ? nullptr : &*it;
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PARSER_LIBERTY_H
+#define OPHIDIAN_PARSER_LIBERTY_H
+
+// std headers
+#include <string>
+#include <vector>
+
+// ophidian headers
+#include <ophidian/util/Units.h>
+
+namespace ophidian::parser
+{
+    /**
+     * Subset of the Liberty format used by static timing analysis: the
+     * time and capacitance units, lookup table templates, and for every
+     * cell its pins with their direction, capacitance and timing groups
+     * with NLDM delay, transition and constraint tables. Other groups and
+     * attributes are skipped.
+     */
+    class Liberty
+    {
+    public:
+        // Class member types
+        struct Table;
+        struct Timing;
+        struct Pin;
+        struct Cell;
+
+        template <class T> using container_type = std::vector<T>;
+
+        using string_type                       = std::string;
+        using value_container_type              = container_type<double>;
+        using second_type                       = util::second_t;
+        using farad_type                        = util::farad_t;
+
+        using cell_type                         = Cell;
+        using cell_container_type               = container_type<cell_type>;
+
+        enum class TimingSense : int {
+            POSITIVE_UNATE,
+            NEGATIVE_UNATE,
+            NON_UNATE
+        };
+
+        enum class TimingType : int {
+            COMBINATIONAL,
+            RISING_EDGE,
+            FALLING_EDGE,
+            SETUP_RISING,
+            SETUP_FALLING,
+            HOLD_RISING,
+            HOLD_FALLING,
+            OTHER
+        };
+
+        enum class Direction : int {
+            INPUT,
+            OUTPUT,
+            INOUT,
+            INTERNAL
+        };
+
+        //! NLDM table, values[i][j] is at index_1[i] and index_2[j], in library units
+        struct Table
+        {
+            string_type variable_1;
+            string_type variable_2;
+            value_container_type index_1;
+            value_container_type index_2;
+            container_type<value_container_type> values;
+
+            bool empty() const noexcept
+            {
+                return values.empty();
+            }
+        };
+
+        struct Timing
+        {
+            string_type related_pin;
+            TimingSense timing_sense{TimingSense::NON_UNATE};
+            TimingType timing_type{TimingType::COMBINATIONAL};
+            Table cell_rise;
+            Table cell_fall;
+            Table rise_transition;
+            Table fall_transition;
+            Table rise_constraint;
+            Table fall_constraint;
+        };
+
+        struct Pin
+        {
+            string_type name;
+            Direction direction{Direction::INPUT};
+            double capacitance{0.0};
+            double max_capacitance{0.0};
+            bool clock{false};
+            container_type<Timing> timings;
+        };
+
+        struct Cell
+        {
+            string_type name;
+            double area{0.0};
+            container_type<Pin> pins;
+        };
+
+        // Class constructors
+        Liberty() = default;
+
+        Liberty(const Liberty&) = default;
+        Liberty& operator=(const Liberty&) = default;
+
+        Liberty(Liberty&&) = default;
+        Liberty& operator=(Liberty&&) = default;
+
+        Liberty(const std::string& liberty_file);
+
+        // Class member functions
+        void read_file(const std::string& liberty_file);
+
+        const string_type& name() const noexcept;
+
+        //! Value of one library time unit
+        const second_type& time_unit() const noexcept;
+
+        //! Value of one library capacitance unit
+        const farad_type& capacitance_unit() const noexcept;
+
+        const cell_container_type& cells() const noexcept;
+
+        //! Cell with the given name, nullptr when there is none
+        const cell_type* find_cell(const string_type& name) const;
+
+    private:
+        string_type         m_name{};
+        second_type         m_time_unit{1e-9};
+        farad_type          m_capacitance_unit{1e-12};
+        cell_container_type m_cells{};
+    };
+}
+
+#endif // OPHIDIAN_PARSER_LIBERTY_H
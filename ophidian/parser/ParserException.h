@@ -43,6 +43,15 @@ namespace ophidian::parser::exceptions
             return "Invalid Syntax of .guide file";
         }
     };
+
+    class LibertySyntaxError :
+            public std::exception
+    {
+        const char * what() const noexcept override
+        {
+            return "Invalid Syntax of .lib file";
+        }
+    };
 }
 
 #endif
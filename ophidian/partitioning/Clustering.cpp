@@ -0,0 +1,418 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Clustering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::partitioning
+{
+    namespace
+    {
+        constexpr auto no_vertex = std::numeric_limits<Clustering::vertex_type>::max();
+
+        // weights below one dbu² are rounded up by the rating penalty
+        double penalty(double weight)
+        {
+            return std::max(weight, 1.0);
+        }
+    }
+
+    Clustering::Clustering(const Hypergraph & hypergraph, const Clustering::Parameters & parameters):
+        m_hypergraph(hypergraph),
+        m_parameters(parameters)
+    {
+    }
+
+    Clustering::Clustering(const Hypergraph & hypergraph):
+        Clustering(hypergraph, Parameters{})
+    {
+    }
+
+    void Clustering::coarsen()
+    {
+        coarsen(community_container_type{});
+    }
+
+    void Clustering::coarsen(const Clustering::community_container_type & communities)
+    {
+        m_levels.clear();
+        m_parents.clear();
+        m_communities.assign(1, communities);
+
+        // levels are never reallocated while the next one is built from them
+        m_levels.reserve(m_parameters.max_levels);
+
+        auto limit = m_parameters.max_cluster_weight * m_hypergraph.total_weight() / std::max<std::size_t>(1, m_parameters.coarsest_size);
+        while(m_levels.size() < m_parameters.max_levels)
+        {
+            const auto & fine = hypergraph(levels() - 1);
+            auto size = fine.size_vertex();
+            if(size <= m_parameters.coarsest_size)
+            {
+                break;
+            }
+
+            auto leaders = match(fine, m_communities.back(), limit);
+            auto clusters = std::size_t{0};
+            for(std::size_t vertex = 0; vertex < size; ++vertex)
+            {
+                clusters += leaders[vertex] == vertex;
+            }
+            if(clusters > (1.0 - m_parameters.min_reduction) * size)
+            {
+                break;
+            }
+
+            contract(fine, leaders);
+        }
+    }
+
+    std::size_t Clustering::levels() const noexcept
+    {
+        return m_levels.size() + 1;
+    }
+
+    const Hypergraph & Clustering::hypergraph(std::size_t level) const
+    {
+        return level == 0 ? m_hypergraph : m_levels[level - 1];
+    }
+
+    const Clustering::vertex_container_type & Clustering::parents(std::size_t level) const
+    {
+        return m_parents[level];
+    }
+
+    const Clustering::community_container_type & Clustering::communities(std::size_t level) const
+    {
+        return m_communities[level];
+    }
+
+    Clustering::vertex_type Clustering::cluster(Clustering::vertex_type vertex, std::size_t level) const
+    {
+        for(std::size_t i = 0; i < level; ++i)
+        {
+            vertex = m_parents[i][vertex];
+        }
+        return vertex;
+    }
+
+    void Clustering::place(std::size_t level, const std::vector<Clustering::point_type> & locations, placement::Placement & placement) const
+    {
+        const auto & cells = m_hypergraph.cells();
+        for(std::size_t vertex = 0; vertex < cells.size(); ++vertex)
+        {
+            if(!m_hypergraph.fixed(vertex))
+            {
+                placement.place(cells[vertex], locations[cluster(vertex, level)]);
+            }
+        }
+    }
+
+    Clustering::vertex_container_type Clustering::match(const Hypergraph & fine, const Clustering::community_container_type & communities, double limit) const
+    {
+        auto size = fine.size_vertex();
+        auto threads = util::number_of_threads(m_parameters.number_of_threads);
+        auto heavy_edge = m_parameters.scheme == Scheme::HEAVY_EDGE;
+        auto apart = [&](vertex_type a, vertex_type b){
+            return !communities.empty() && communities[a] != communities[b];
+        };
+
+        auto leaders = vertex_container_type(size);
+        std::iota(leaders.begin(), leaders.end(), 0);
+        auto weights = fine.vertex_weights();
+        auto clustered = std::vector<char>(size, 0);
+        auto targets = vertex_container_type(size);
+        auto scores = std::vector<double>(size);
+        auto incoming = std::vector<std::size_t>(size + 1);
+        auto order = vertex_container_type{};
+        auto hosts = vertex_container_type{};
+        auto ratings = std::vector<std::vector<std::pair<vertex_type, double>>>(threads);
+
+        for(std::size_t round = 0; round < m_parameters.rounds; ++round)
+        {
+            // every single vertex proposes to its best neighbour cluster
+            util::parallel_for(0, size, [&](std::size_t vertex, std::size_t thread){
+                targets[vertex] = no_vertex;
+                if(clustered[vertex] || fine.fixed(vertex))
+                {
+                    return;
+                }
+
+                auto & rating = ratings[thread];
+                rating.clear();
+                for(auto edge : fine.edges(vertex))
+                {
+                    auto edge_size = fine.edge_size(edge);
+                    if(edge_size > m_parameters.max_edge_size)
+                    {
+                        continue;
+                    }
+                    auto score = fine.edge_weight(edge) / (edge_size - 1);
+                    for(auto neighbour : fine.pins(edge))
+                    {
+                        if(neighbour != vertex && !fine.fixed(neighbour) && !(heavy_edge && clustered[neighbour]) && !apart(vertex, neighbour))
+                        {
+                            rating.emplace_back(leaders[neighbour], score);
+                        }
+                    }
+                }
+                std::sort(rating.begin(), rating.end());
+
+                auto weight = fine.weight(vertex);
+                auto best = no_vertex;
+                auto best_score = 0.0;
+                for(std::size_t i = 0; i < rating.size();)
+                {
+                    auto target = rating[i].first;
+                    auto connectivity = 0.0;
+                    for(; i < rating.size() && rating[i].first == target; ++i)
+                    {
+                        connectivity += rating[i].second;
+                    }
+                    if(weights[target] + weight > limit)
+                    {
+                        continue;
+                    }
+                    auto score = connectivity / (penalty(weight) * penalty(weights[target]));
+                    if(score > best_score)
+                    {
+                        best = target;
+                        best_score = score;
+                    }
+                }
+                targets[vertex] = best;
+                scores[vertex] = best_score;
+            }, threads, 1024);
+
+            // targeted vertices host the others, apart from the larger end of a mutual pair
+            std::fill(incoming.begin(), incoming.end(), 0);
+            for(std::size_t vertex = 0; vertex < size; ++vertex)
+            {
+                if(targets[vertex] != no_vertex)
+                {
+                    ++incoming[targets[vertex]];
+                }
+            }
+            auto joins = [&](vertex_type vertex){
+                auto target = targets[vertex];
+                return target != no_vertex && (incoming[vertex] == 0 || (incoming[vertex] == 1 && targets[target] == vertex && vertex > target));
+            };
+
+            // proposals grouped by target, in vertex order
+            auto begins = std::vector<std::size_t>(size + 1, 0);
+            for(vertex_type vertex = 0; vertex < size; ++vertex)
+            {
+                if(joins(vertex))
+                {
+                    ++begins[targets[vertex] + 1];
+                }
+            }
+            hosts.clear();
+            for(vertex_type vertex = 0; vertex < size; ++vertex)
+            {
+                if(begins[vertex + 1] > 0)
+                {
+                    hosts.push_back(vertex);
+                }
+                begins[vertex + 1] += begins[vertex];
+            }
+            if(hosts.empty())
+            {
+                break;
+            }
+            order.resize(begins[size]);
+            auto next = std::vector<std::size_t>(begins.begin(), begins.end() - 1);
+            for(vertex_type vertex = 0; vertex < size; ++vertex)
+            {
+                if(joins(vertex))
+                {
+                    order[next[targets[vertex]]++] = vertex;
+                }
+            }
+
+            // each host is claimed by one worker, which accepts its best proposals
+            util::parallel_for(0, hosts.size(), [&](std::size_t i){
+                auto host = hosts[i];
+                auto first = order.begin() + begins[host];
+                auto last = order.begin() + begins[host + 1];
+                std::sort(first, last, [&](vertex_type a, vertex_type b){
+                    return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+                });
+                for(auto it = first; it != last; ++it)
+                {
+                    auto weight = fine.weight(*it);
+                    if(weights[host] + weight > limit)
+                    {
+                        continue;
+                    }
+                    leaders[*it] = host;
+                    weights[host] += weight;
+                    clustered[*it] = 1;
+                    clustered[host] = 1;
+                    if(heavy_edge)
+                    {
+                        break;
+                    }
+                }
+            }, threads, 64);
+        }
+
+        return leaders;
+    }
+
+    void Clustering::contract(const Hypergraph & fine, const Clustering::vertex_container_type & leaders)
+    {
+        auto threads = util::number_of_threads(m_parameters.number_of_threads);
+        auto size = fine.size_vertex();
+
+        auto parents = vertex_container_type(size);
+        auto coarse_size = vertex_type{0};
+        for(std::size_t vertex = 0; vertex < size; ++vertex)
+        {
+            if(leaders[vertex] == vertex)
+            {
+                parents[vertex] = coarse_size++;
+            }
+        }
+        auto vertex_weights = Hypergraph::weight_container_type(coarse_size, 0.0);
+        for(std::size_t vertex = 0; vertex < size; ++vertex)
+        {
+            parents[vertex] = parents[leaders[vertex]];
+            vertex_weights[parents[vertex]] += fine.weight(vertex);
+        }
+
+        // hyperedges mapped to the clusters, each one sorted in place of its fine pins
+        auto edges = fine.size_edge();
+        auto offsets = Hypergraph::offset_container_type(edges + 1, 0);
+        for(std::size_t edge = 0; edge < edges; ++edge)
+        {
+            offsets[edge + 1] = offsets[edge] + fine.edge_size(edge);
+        }
+        auto buffer = vertex_container_type(fine.size_pin());
+        auto sizes = std::vector<std::size_t>(edges);
+        auto hashes = std::vector<std::uint64_t>(edges);
+        util::parallel_for(0, edges, [&](std::size_t edge){
+            auto first = buffer.begin() + offsets[edge];
+            auto last = first;
+            for(auto vertex : fine.pins(edge))
+            {
+                *last++ = parents[vertex];
+            }
+            std::sort(first, last);
+            last = std::unique(first, last);
+            sizes[edge] = last - first < 2 ? 0 : last - first;
+
+            auto hash = std::uint64_t{14695981039346656037ull};
+            for(auto it = first; it != last; ++it)
+            {
+                hash = (hash ^ *it) * 1099511628211ull;
+            }
+            hashes[edge] = hash;
+        }, threads, 1024);
+
+        // parallel hyperedges are merged into the first one, comparing the ones with equal hashes
+        auto edge_weights = fine.edge_weights();
+        auto buckets = std::vector<std::pair<std::uint64_t, Hypergraph::edge_type>>{};
+        for(std::size_t edge = 0; edge < edges; ++edge)
+        {
+            if(sizes[edge] > 0)
+            {
+                buckets.emplace_back(hashes[edge], static_cast<Hypergraph::edge_type>(edge));
+            }
+        }
+        std::sort(buckets.begin(), buckets.end());
+        auto pins_of = [&](Hypergraph::edge_type edge){
+            return std::make_pair(buffer.begin() + offsets[edge], buffer.begin() + offsets[edge] + sizes[edge]);
+        };
+        for(std::size_t first = 0; first < buckets.size();)
+        {
+            auto last = first + 1;
+            while(last < buckets.size() && buckets[last].first == buckets[first].first)
+            {
+                ++last;
+            }
+            for(auto i = first; i < last; ++i)
+            {
+                auto edge = buckets[i].second;
+                if(sizes[edge] == 0)
+                {
+                    continue;
+                }
+                auto [edge_first, edge_last] = pins_of(edge);
+                for(auto j = i + 1; j < last; ++j)
+                {
+                    auto other = buckets[j].second;
+                    auto [other_first, other_last] = pins_of(other);
+                    if(sizes[other] > 0 && std::equal(edge_first, edge_last, other_first, other_last))
+                    {
+                        edge_weights[edge] += edge_weights[other];
+                        sizes[other] = 0;
+                    }
+                }
+            }
+            first = last;
+        }
+
+        auto coarse_weights = Hypergraph::weight_container_type{};
+        auto coarse_begins = Hypergraph::offset_container_type{0};
+        auto coarse_pins = vertex_container_type{};
+        coarse_pins.reserve(fine.size_pin());
+        for(std::size_t edge = 0; edge < edges; ++edge)
+        {
+            if(sizes[edge] == 0)
+            {
+                continue;
+            }
+            auto [first, last] = pins_of(edge);
+            coarse_pins.insert(coarse_pins.end(), first, last);
+            coarse_begins.push_back(coarse_pins.size());
+            coarse_weights.push_back(edge_weights[edge]);
+        }
+        coarse_pins.shrink_to_fit();
+
+        m_levels.emplace_back(std::move(vertex_weights), std::move(coarse_weights), std::move(coarse_begins), std::move(coarse_pins));
+        auto & coarse = m_levels.back();
+        for(std::size_t vertex = 0; vertex < size; ++vertex)
+        {
+            if(fine.fixed(vertex))
+            {
+                coarse.fix(parents[vertex], true);
+            }
+        }
+        const auto & fine_communities = m_communities.back();
+        auto coarse_communities = community_container_type{};
+        if(!fine_communities.empty())
+        {
+            coarse_communities.resize(coarse.size_vertex());
+            for(std::size_t vertex = 0; vertex < size; ++vertex)
+            {
+                coarse_communities[parents[vertex]] = fine_communities[vertex];
+            }
+        }
+        m_communities.push_back(std::move(coarse_communities));
+        m_parents.push_back(std::move(parents));
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PARTITIONING_CLUSTERING_H
+#define OPHIDIAN_PARTITIONING_CLUSTERING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/util/Units.h>
+#include <ophidian/placement/Placement.h>
+#include <ophidian/partitioning/Hypergraph.h>
+
+namespace ophidian::partitioning
+{
+    //! Multilevel hypergraph coarsening
+
+    /*!
+       \brief Builds a hierarchy of coarser hypergraphs, each level contracting clusters of
+       strongly connected vertices of the previous one. Vertices are rated against their
+       neighbour clusters by the connectivity sum of w / (|e| - 1) over the shared hyperedges,
+       divided by the product of the two weights so small clusters are preferred. Heavy edge
+       matching only pairs single vertices; first choice lets a vertex join a cluster formed in
+       an earlier round, up to the maximum cluster weight.
+
+       Every round, the vertices pick their best neighbour cluster in parallel, then the
+       proposals are grouped by target and each target accepts its best proposals, so no cluster
+       is ever claimed by two workers and no lock is taken. A vertex that is itself targeted
+       stays in place and hosts the others, which keeps clusters from chaining, and the
+       result does not depend on the number of threads. Fixed vertices are never clustered.
+       Coarsening can be restricted to communities, such as the blocks of a partition, which
+       the coarse levels then inherit. Coarse levels are stored as compact Hypergraph arrays with parallel hyperedges merged,
+       along with the parent of each vertex in the next level.
+     */
+    class Clustering
+    {
+    public:
+        using vertex_type               = Hypergraph::vertex_type;
+        using vertex_container_type     = Hypergraph::vertex_container_type;
+        using community_type            = std::uint32_t;
+        using community_container_type  = std::vector<community_type>;
+        using point_type                = util::LocationDbu;
+
+        //! Matching schemes
+        enum class Scheme
+        {
+            HEAVY_EDGE,
+            FIRST_CHOICE
+        };
+
+        //! Coarsening parameters
+        struct Parameters
+        {
+            Scheme scheme{Scheme::FIRST_CHOICE};
+            //! Stop when a level has at most this number of vertices
+            std::size_t coarsest_size{160};
+            //! Maximum number of coarse levels
+            std::size_t max_levels{32};
+            //! Stop when a level removes less than this fraction of the vertices
+            double min_reduction{0.05};
+            //! Maximum cluster weight, in multiples of the total weight over coarsest_size
+            double max_cluster_weight{1.5};
+            //! Matching rounds of each level
+            std::size_t rounds{3};
+            //! Hyperedges with more vertices are ignored by the ratings
+            std::size_t max_edge_size{256};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        Clustering() = delete;
+
+        Clustering(const Clustering &) = delete;
+        Clustering & operator=(const Clustering &) = delete;
+
+        Clustering(const Hypergraph & hypergraph, const Parameters & parameters);
+
+        explicit Clustering(const Hypergraph & hypergraph);
+
+        // Modifiers
+
+        //! Build the hierarchy, replacing the previous one
+        void coarsen();
+
+        //! Build the hierarchy, only clustering vertices of the same community
+        /*!
+           \param communities Community of every vertex of the input, such as a partition
+         */
+        void coarsen(const community_container_type & communities);
+
+        // Capacity
+
+        //! Number of levels, the input hypergraph included
+        std::size_t levels() const noexcept;
+
+        // Element access
+
+        //! Hypergraph of a level, 0 being the input
+        const Hypergraph & hypergraph(std::size_t level) const;
+
+        //! Vertex of the next level containing each vertex of a level
+        const vertex_container_type & parents(std::size_t level) const;
+
+        //! Community of every vertex of a level, empty when coarsening without communities
+        const community_container_type & communities(std::size_t level) const;
+
+        //! Vertex of a level containing a vertex of the input
+        vertex_type cluster(vertex_type vertex, std::size_t level) const;
+
+        //! Project values of the vertices of a level onto the level below
+        template <class Value>
+        std::vector<Value> project(std::size_t level, const std::vector<Value> & values) const
+        {
+            const auto & parent = parents(level - 1);
+            auto result = std::vector<Value>{};
+            result.reserve(parent.size());
+            for(auto coarse : parent)
+            {
+                result.push_back(values[coarse]);
+            }
+            return result;
+        }
+
+        //! Place every movable cell of the input at the location of its cluster in a level
+        void place(std::size_t level, const std::vector<point_type> & locations, placement::Placement & placement) const;
+
+    private:
+        vertex_container_type match(const Hypergraph & fine, const community_container_type & communities, double limit) const;
+        void contract(const Hypergraph & fine, const vertex_container_type & leaders);
+
+        const Hypergraph &                  m_hypergraph;
+        Parameters                          m_parameters;
+        std::vector<Hypergraph>             m_levels;
+        std::vector<vertex_container_type>  m_parents;
+        std::vector<community_container_type> m_communities;
+    };
+}
+
+#endif // OPHIDIAN_PARTITIONING_CLUSTERING_H
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Hypergraph.h"
+
+#include <algorithm>
+
+namespace ophidian::partitioning
+{
+    namespace
+    {
+        Hypergraph::weight_type area(const geometry::CellGeometry & geometry)
+        {
+            auto result = Hypergraph::weight_type{0.0};
+            for(const auto & box : geometry)
+            {
+                result += units::unit_cast<double>(box.max_corner().x() - box.min_corner().x()) *
+                          units::unit_cast<double>(box.max_corner().y() - box.min_corner().y());
+            }
+            return result;
+        }
+    }
+
+    Hypergraph::Hypergraph(const circuit::Netlist & netlist, const placement::Library & library):
+        m_cell_vertices(netlist.make_property_cell_instance<vertex_type>())
+    {
+        m_cells.reserve(netlist.size_cell_instance());
+        m_vertex_weights.reserve(netlist.size_cell_instance());
+        for(auto it = netlist.begin_cell_instance(); it != netlist.end_cell_instance(); ++it)
+        {
+            m_cell_vertices[*it] = static_cast<vertex_type>(m_cells.size());
+            m_cells.push_back(*it);
+            m_vertex_weights.push_back(area(library.geometry(netlist.std_cell(*it))));
+        }
+
+        m_edge_weights.reserve(netlist.size_net());
+        for(auto net = netlist.begin_net(); net != netlist.end_net(); ++net)
+        {
+            auto first = m_pins.size();
+            for(auto pin : netlist.pins(*net))
+            {
+                auto cell = netlist.cell(pin);
+                if(cell != circuit::CellInstance{})
+                {
+                    m_pins.push_back(m_cell_vertices[cell]);
+                }
+            }
+            std::sort(m_pins.begin() + first, m_pins.end());
+            m_pins.erase(std::unique(m_pins.begin() + first, m_pins.end()), m_pins.end());
+            if(m_pins.size() - first < 2)
+            {
+                m_pins.resize(first);
+                continue;
+            }
+            m_edge_begins.push_back(m_pins.size());
+            m_edge_weights.push_back(1.0);
+        }
+
+        update_incidence();
+    }
+
+    Hypergraph::Hypergraph(const circuit::Netlist & netlist, const placement::Library & library, const placement::Placement & placement):
+        Hypergraph(netlist, library)
+    {
+        for(std::size_t vertex = 0; vertex < m_cells.size(); ++vertex)
+        {
+            m_fixed[vertex] = placement.fixed(m_cells[vertex]);
+        }
+    }
+
+    Hypergraph::Hypergraph(Hypergraph::weight_container_type vertex_weights, Hypergraph::weight_container_type edge_weights, Hypergraph::offset_container_type edge_begins, Hypergraph::vertex_container_type pins):
+        m_vertex_weights(std::move(vertex_weights)),
+        m_edge_weights(std::move(edge_weights)),
+        m_edge_begins(std::move(edge_begins)),
+        m_pins(std::move(pins))
+    {
+        update_incidence();
+    }
+
+    std::size_t Hypergraph::size_vertex() const noexcept
+    {
+        return m_vertex_weights.size();
+    }
+
+    std::size_t Hypergraph::size_edge() const noexcept
+    {
+        return m_edge_weights.size();
+    }
+
+    std::size_t Hypergraph::size_pin() const noexcept
+    {
+        return m_pins.size();
+    }
+
+    Hypergraph::weight_type Hypergraph::total_weight() const noexcept
+    {
+        return m_total_weight;
+    }
+
+    const Hypergraph::weight_container_type & Hypergraph::vertex_weights() const noexcept
+    {
+        return m_vertex_weights;
+    }
+
+    const Hypergraph::weight_container_type & Hypergraph::edge_weights() const noexcept
+    {
+        return m_edge_weights;
+    }
+
+    const Hypergraph::cell_container_type & Hypergraph::cells() const noexcept
+    {
+        return m_cells;
+    }
+
+    Hypergraph::vertex_type Hypergraph::vertex(const Hypergraph::cell_type & cell) const
+    {
+        return m_cell_vertices[cell];
+    }
+
+    void Hypergraph::fix(const Hypergraph::vertex_type & vertex, bool fixed)
+    {
+        m_fixed[vertex] = fixed;
+    }
+
+    void Hypergraph::update_incidence()
+    {
+        auto vertices = m_vertex_weights.size();
+        m_fixed.assign(vertices, 0);
+        m_total_weight = 0.0;
+        for(auto weight : m_vertex_weights)
+        {
+            m_total_weight += weight;
+        }
+
+        // counting sort of the pins by vertex, hyperedges of a vertex end in increasing order
+        m_vertex_begins.assign(vertices + 1, 0);
+        for(auto vertex : m_pins)
+        {
+            ++m_vertex_begins[vertex + 1];
+        }
+        for(std::size_t vertex = 0; vertex < vertices; ++vertex)
+        {
+            m_vertex_begins[vertex + 1] += m_vertex_begins[vertex];
+        }
+        m_incidence.resize(m_pins.size());
+        auto next = offset_container_type(m_vertex_begins.begin(), m_vertex_begins.end() - 1);
+        for(std::size_t edge = 0; edge + 1 < m_edge_begins.size(); ++edge)
+        {
+            for(auto pin = m_edge_begins[edge]; pin < m_edge_begins[edge + 1]; ++pin)
+            {
+                m_incidence[next[m_pins[pin]]++] = static_cast<edge_type>(edge);
+            }
+        }
+    }
+}
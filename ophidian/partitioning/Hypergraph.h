@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PARTITIONING_HYPERGRAPH_H
+#define OPHIDIAN_PARTITIONING_HYPERGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/util/Range.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/placement/Library.h>
+#include <ophidian/placement/Placement.h>
+
+namespace ophidian::partitioning
+{
+    //! Netlist hypergraph
+
+    /*!
+       \brief Cells are vertices weighted by their area and nets are hyperedges over the cells
+       owning their pins, in compressed sparse row form: the pins of every hyperedge and the
+       hyperedges of every vertex are stored contiguously, indexed by an offset vector. Pads are
+       dropped and so are nets left with less than two vertices. Vertices built from a netlist
+       keep the cell they stand for; coarse hypergraphs built from arrays have no cells.
+     */
+    class Hypergraph
+    {
+    public:
+        using vertex_type               = std::uint32_t;
+        using edge_type                 = std::uint32_t;
+        using weight_type               = double;
+        using cell_type                 = circuit::CellInstance;
+        using vertex_container_type     = std::vector<vertex_type>;
+        using edge_container_type       = std::vector<edge_type>;
+        using weight_container_type     = std::vector<weight_type>;
+        using offset_container_type     = std::vector<std::size_t>;
+        using cell_container_type       = std::vector<cell_type>;
+        using vertex_range_type         = util::Range<vertex_container_type::const_iterator>;
+        using edge_range_type           = util::Range<edge_container_type::const_iterator>;
+
+        // Constructors
+        Hypergraph() = default;
+
+        //! Build the hypergraph of a netlist
+        /*!
+           \param netlist Netlist with the cells and nets
+           \param library Geometry of the standard cells, giving the vertex weights
+         */
+        Hypergraph(const circuit::Netlist & netlist, const placement::Library & library);
+
+        //! Build the hypergraph of a netlist, fixing the vertices of fixed cells
+        Hypergraph(const circuit::Netlist & netlist, const placement::Library & library, const placement::Placement & placement);
+
+        //! Build a hypergraph from its hyperedges
+        /*!
+           \param vertex_weights Weight of every vertex
+           \param edge_weights Weight of every hyperedge
+           \param edge_begins Offsets of the pins of every hyperedge, with a final one past the end
+           \param pins Vertices of every hyperedge
+         */
+        Hypergraph(weight_container_type vertex_weights, weight_container_type edge_weights, offset_container_type edge_begins, vertex_container_type pins);
+
+        // Capacity
+        std::size_t size_vertex() const noexcept;
+
+        std::size_t size_edge() const noexcept;
+
+        std::size_t size_pin() const noexcept;
+
+        // Element access
+        weight_type weight(const vertex_type & vertex) const
+        {
+            return m_vertex_weights[vertex];
+        }
+
+        weight_type edge_weight(const edge_type & edge) const
+        {
+            return m_edge_weights[edge];
+        }
+
+        weight_type total_weight() const noexcept;
+
+        bool fixed(const vertex_type & vertex) const
+        {
+            return m_fixed[vertex];
+        }
+
+        //! Vertices of a hyperedge
+        vertex_range_type pins(const edge_type & edge) const
+        {
+            return vertex_range_type(m_pins.begin() + m_edge_begins[edge], m_pins.begin() + m_edge_begins[edge + 1]);
+        }
+
+        std::size_t edge_size(const edge_type & edge) const
+        {
+            return m_edge_begins[edge + 1] - m_edge_begins[edge];
+        }
+
+        //! Hyperedges of a vertex
+        edge_range_type edges(const vertex_type & vertex) const
+        {
+            return edge_range_type(m_incidence.begin() + m_vertex_begins[vertex], m_incidence.begin() + m_vertex_begins[vertex + 1]);
+        }
+
+        const weight_container_type & vertex_weights() const noexcept;
+
+        const weight_container_type & edge_weights() const noexcept;
+
+        //! Cells of the vertices, empty for coarse hypergraphs
+        const cell_container_type & cells() const noexcept;
+
+        //! Vertex of a cell of the netlist the hypergraph was built from
+        vertex_type vertex(const cell_type & cell) const;
+
+        // Modifiers
+        void fix(const vertex_type & vertex, bool fixed);
+
+    private:
+        void update_incidence();
+
+        weight_container_type   m_vertex_weights;
+        weight_container_type   m_edge_weights;
+        offset_container_type   m_edge_begins{0};
+        vertex_container_type   m_pins;
+        offset_container_type   m_vertex_begins{0};
+        edge_container_type     m_incidence;
+        std::vector<char>       m_fixed;
+        weight_type             m_total_weight{0.0};
+        cell_container_type     m_cells;
+        entity_system::Property<cell_type, vertex_type> m_cell_vertices;
+    };
+}
+
+#endif // OPHIDIAN_PARTITIONING_HYPERGRAPH_H
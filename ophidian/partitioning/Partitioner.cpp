@@ -0,0 +1,586 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Partitioner.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::partitioning
+{
+    namespace
+    {
+        using vertex_type = Hypergraph::vertex_type;
+        using side_container_type = std::vector<char>;
+
+        constexpr auto no_vertex = std::numeric_limits<vertex_type>::max();
+
+        // buckets and vertices examined below the best gain when its vertices break the balance
+        constexpr std::size_t max_scanned = 64;
+
+        //! Fiduccia-Mattheyses refinement of a bisection
+        class Bisection
+        {
+        public:
+            using gain_type = std::int64_t;
+
+            Bisection(const Hypergraph & hypergraph, const std::array<double, 2> & max_weights):
+                m_hypergraph(hypergraph),
+                m_max_weights(max_weights),
+                m_edge_weights(hypergraph.size_edge()),
+                m_counts(hypergraph.size_edge()),
+                m_gains(hypergraph.size_vertex()),
+                m_next(hypergraph.size_vertex()),
+                m_previous(hypergraph.size_vertex()),
+                m_locked(hypergraph.size_vertex())
+            {
+                for(Hypergraph::edge_type edge = 0; edge < hypergraph.size_edge(); ++edge)
+                {
+                    m_edge_weights[edge] = std::max<gain_type>(1, std::llround(hypergraph.edge_weight(edge)));
+                }
+                for(vertex_type vertex = 0; vertex < hypergraph.size_vertex(); ++vertex)
+                {
+                    auto degree = gain_type{0};
+                    for(auto edge : hypergraph.edges(vertex))
+                    {
+                        degree += m_edge_weights[edge];
+                    }
+                    m_bound = std::max(m_bound, degree);
+                    m_slack = std::max(m_slack, hypergraph.weight(vertex));
+                }
+                for(auto & buckets : m_buckets)
+                {
+                    buckets.assign(2 * m_bound + 1, no_vertex);
+                }
+            }
+
+            void assign(side_container_type sides)
+            {
+                m_sides = std::move(sides);
+                m_weights = {0.0, 0.0};
+                for(vertex_type vertex = 0; vertex < m_sides.size(); ++vertex)
+                {
+                    m_weights[m_sides[vertex]] += m_hypergraph.weight(vertex);
+                }
+                for(Hypergraph::edge_type edge = 0; edge < m_counts.size(); ++edge)
+                {
+                    m_counts[edge] = {0, 0};
+                    for(auto vertex : m_hypergraph.pins(edge))
+                    {
+                        ++m_counts[edge][m_sides[vertex]];
+                    }
+                }
+            }
+
+            const side_container_type & sides() const noexcept
+            {
+                return m_sides;
+            }
+
+            gain_type cut() const
+            {
+                auto result = gain_type{0};
+                for(Hypergraph::edge_type edge = 0; edge < m_counts.size(); ++edge)
+                {
+                    if(m_counts[edge][0] > 0 && m_counts[edge][1] > 0)
+                    {
+                        result += m_edge_weights[edge];
+                    }
+                }
+                return result;
+            }
+
+            bool feasible() const noexcept
+            {
+                return m_weights[0] <= m_max_weights[0] && m_weights[1] <= m_max_weights[1];
+            }
+
+            void refine(std::size_t passes)
+            {
+                for(std::size_t pass = 0; pass < passes && this->pass(); ++pass)
+                {
+                }
+            }
+
+        private:
+            double imbalance() const noexcept
+            {
+                return std::max(m_weights[0] / m_max_weights[0], m_weights[1] / m_max_weights[1]);
+            }
+
+            bool pass()
+            {
+                auto size = m_hypergraph.size_vertex();
+                for(int side = 0; side < 2; ++side)
+                {
+                    std::fill(m_buckets[side].begin(), m_buckets[side].end(), no_vertex);
+                    m_top[side] = 0;
+                }
+                for(vertex_type vertex = 0; vertex < size; ++vertex)
+                {
+                    auto from = m_sides[vertex];
+                    auto gain = gain_type{0};
+                    for(auto edge : m_hypergraph.edges(vertex))
+                    {
+                        gain += m_counts[edge][from] == 1 ? m_edge_weights[edge] : 0;
+                        gain -= m_counts[edge][1 - from] == 0 ? m_edge_weights[edge] : 0;
+                    }
+                    m_gains[vertex] = gain;
+                    m_locked[vertex] = 0;
+                    insert(vertex);
+                }
+
+                // moves may exceed the balance by one vertex, but are only kept up to the best
+                // prefix, feasible first, then by gain and balance
+                auto stall = std::max<std::size_t>(100, size / 100);
+                m_moves.clear();
+                auto gain = gain_type{0};
+                auto best_gain = gain_type{0};
+                auto best_moves = std::size_t{0};
+                auto best_feasible = feasible();
+                auto best_imbalance = imbalance();
+                while(true)
+                {
+                    auto candidates = std::array<vertex_type, 2>{candidate(0), candidate(1)};
+                    if(candidates[0] == no_vertex && candidates[1] == no_vertex)
+                    {
+                        break;
+                    }
+                    auto side = 0;
+                    if(candidates[0] == no_vertex)
+                    {
+                        side = 1;
+                    }
+                    else if(candidates[1] != no_vertex)
+                    {
+                        auto g0 = m_gains[candidates[0]];
+                        auto g1 = m_gains[candidates[1]];
+                        side = g1 > g0 || (g1 == g0 && m_weights[1] / m_max_weights[1] > m_weights[0] / m_max_weights[0]);
+                    }
+                    auto vertex = candidates[side];
+
+                    gain += m_gains[vertex];
+                    remove(vertex);
+                    m_locked[vertex] = 1;
+                    move(vertex, true);
+                    m_moves.push_back(vertex);
+
+                    auto now_feasible = feasible();
+                    auto now_imbalance = imbalance();
+                    if((now_feasible && !best_feasible) ||
+                       (now_feasible == best_feasible && (gain > best_gain || (gain == best_gain && now_imbalance < best_imbalance))))
+                    {
+                        best_gain = gain;
+                        best_moves = m_moves.size();
+                        best_feasible = now_feasible;
+                        best_imbalance = now_imbalance;
+                    }
+                    else if(m_moves.size() - best_moves > stall)
+                    {
+                        break;
+                    }
+                }
+
+                for(auto i = m_moves.size(); i > best_moves; --i)
+                {
+                    move(m_moves[i - 1], false);
+                }
+                return best_moves > 0;
+            }
+
+            vertex_type candidate(int side)
+            {
+                auto & buckets = m_buckets[side];
+                while(m_top[side] > 0 && buckets[m_top[side]] == no_vertex)
+                {
+                    --m_top[side];
+                }
+
+                auto to = 1 - side;
+                auto scanned = std::size_t{0};
+                for(auto index = static_cast<std::int64_t>(m_top[side]); index >= 0 && scanned < max_scanned; --index)
+                {
+                    for(auto vertex = buckets[index]; vertex != no_vertex && scanned < max_scanned; vertex = m_next[vertex])
+                    {
+                        if(m_weights[to] + m_hypergraph.weight(vertex) <= m_max_weights[to] + m_slack)
+                        {
+                            return vertex;
+                        }
+                        ++scanned;
+                    }
+                    ++scanned;
+                }
+                return no_vertex;
+            }
+
+            void move(vertex_type vertex, bool update)
+            {
+                auto from = m_sides[vertex];
+                auto to = 1 - from;
+                for(auto edge : m_hypergraph.edges(vertex))
+                {
+                    auto & counts = m_counts[edge];
+                    auto weight = m_edge_weights[edge];
+                    if(update && counts[to] <= 1)
+                    {
+                        for(auto pin : m_hypergraph.pins(edge))
+                        {
+                            if(!m_locked[pin] && (counts[to] == 0 || m_sides[pin] == to))
+                            {
+                                shift(pin, counts[to] == 0 ? weight : -weight);
+                            }
+                        }
+                    }
+                    --counts[from];
+                    ++counts[to];
+                    if(update && counts[from] <= 1)
+                    {
+                        for(auto pin : m_hypergraph.pins(edge))
+                        {
+                            if(!m_locked[pin] && (counts[from] == 0 || m_sides[pin] == from))
+                            {
+                                shift(pin, counts[from] == 0 ? -weight : weight);
+                            }
+                        }
+                    }
+                }
+                m_sides[vertex] = to;
+                m_weights[from] -= m_hypergraph.weight(vertex);
+                m_weights[to] += m_hypergraph.weight(vertex);
+            }
+
+            void shift(vertex_type vertex, gain_type delta)
+            {
+                remove(vertex);
+                m_gains[vertex] += delta;
+                insert(vertex);
+            }
+
+            void insert(vertex_type vertex)
+            {
+                auto side = m_sides[vertex];
+                auto index = static_cast<std::size_t>(m_gains[vertex] + m_bound);
+                auto & head = m_buckets[side][index];
+                m_next[vertex] = head;
+                m_previous[vertex] = no_vertex;
+                if(head != no_vertex)
+                {
+                    m_previous[head] = vertex;
+                }
+                head = vertex;
+                m_top[side] = std::max(m_top[side], index);
+            }
+
+            void remove(vertex_type vertex)
+            {
+                auto side = m_sides[vertex];
+                if(m_previous[vertex] != no_vertex)
+                {
+                    m_next[m_previous[vertex]] = m_next[vertex];
+                }
+                else
+                {
+                    m_buckets[side][static_cast<std::size_t>(m_gains[vertex] + m_bound)] = m_next[vertex];
+                }
+                if(m_next[vertex] != no_vertex)
+                {
+                    m_previous[m_next[vertex]] = m_previous[vertex];
+                }
+            }
+
+            const Hypergraph &                      m_hypergraph;
+            std::array<double, 2>                   m_max_weights;
+            std::array<double, 2>                   m_weights{0.0, 0.0};
+            double                                  m_slack{0.0};
+            std::vector<gain_type>                  m_edge_weights;
+            std::vector<std::array<std::uint32_t, 2>> m_counts;
+            side_container_type                     m_sides;
+            std::vector<gain_type>                  m_gains;
+            gain_type                               m_bound{0};
+            std::array<std::vector<vertex_type>, 2> m_buckets;
+            std::array<std::size_t, 2>              m_top{0, 0};
+            std::vector<vertex_type>                m_next;
+            std::vector<vertex_type>                m_previous;
+            std::vector<char>                       m_locked;
+            std::vector<vertex_type>                m_moves;
+        };
+
+        //! Grow side 0 breadth first from a seed until it reaches its target weight
+        side_container_type grow(const Hypergraph & hypergraph, vertex_type seed, double target, double max_weight)
+        {
+            auto size = hypergraph.size_vertex();
+            auto sides = side_container_type(size, 1);
+            auto visited = std::vector<char>(size, 0);
+            auto queue = std::vector<vertex_type>{seed};
+            visited[seed] = 1;
+            auto weight = 0.0;
+            auto next = vertex_type{0};
+            for(std::size_t head = 0; weight < target;)
+            {
+                if(head == queue.size())
+                {
+                    while(next < size && visited[next])
+                    {
+                        ++next;
+                    }
+                    if(next == size)
+                    {
+                        break;
+                    }
+                    visited[next] = 1;
+                    queue.push_back(next);
+                }
+                auto vertex = queue[head++];
+                if(weight + hypergraph.weight(vertex) > max_weight)
+                {
+                    continue;
+                }
+                sides[vertex] = 0;
+                weight += hypergraph.weight(vertex);
+                for(auto edge : hypergraph.edges(vertex))
+                {
+                    for(auto pin : hypergraph.pins(edge))
+                    {
+                        if(!visited[pin])
+                        {
+                            visited[pin] = 1;
+                            queue.push_back(pin);
+                        }
+                    }
+                }
+            }
+            return sides;
+        }
+
+        //! Sub-hypergraph induced by the vertices of one side
+        Hypergraph induce(const Hypergraph & hypergraph, const side_container_type & sides, char side, std::vector<vertex_type> & vertices)
+        {
+            auto index = std::vector<vertex_type>(hypergraph.size_vertex(), no_vertex);
+            auto weights = Hypergraph::weight_container_type{};
+            auto fixed = std::vector<vertex_type>{};
+            for(vertex_type vertex = 0; vertex < hypergraph.size_vertex(); ++vertex)
+            {
+                if(sides[vertex] == side)
+                {
+                    index[vertex] = static_cast<vertex_type>(weights.size());
+                    if(hypergraph.fixed(vertex))
+                    {
+                        fixed.push_back(index[vertex]);
+                    }
+                    weights.push_back(hypergraph.weight(vertex));
+                    vertices.push_back(vertex);
+                }
+            }
+
+            auto edge_weights = Hypergraph::weight_container_type{};
+            auto begins = Hypergraph::offset_container_type{0};
+            auto pins = Hypergraph::vertex_container_type{};
+            for(Hypergraph::edge_type edge = 0; edge < hypergraph.size_edge(); ++edge)
+            {
+                auto first = pins.size();
+                for(auto pin : hypergraph.pins(edge))
+                {
+                    if(index[pin] != no_vertex)
+                    {
+                        pins.push_back(index[pin]);
+                    }
+                }
+                if(pins.size() - first < 2)
+                {
+                    pins.resize(first);
+                    continue;
+                }
+                begins.push_back(pins.size());
+                edge_weights.push_back(hypergraph.edge_weight(edge));
+            }
+
+            auto result = Hypergraph{std::move(weights), std::move(edge_weights), std::move(begins), std::move(pins)};
+            for(auto vertex : fixed)
+            {
+                result.fix(vertex, true);
+            }
+            return result;
+        }
+    }
+
+    Partitioner::Partitioner(const Hypergraph & hypergraph, const Partitioner::Parameters & parameters):
+        m_hypergraph(hypergraph),
+        m_parameters(parameters)
+    {
+    }
+
+    Partitioner::Partitioner(const Hypergraph & hypergraph):
+        Partitioner(hypergraph, Parameters{})
+    {
+    }
+
+    void Partitioner::partition()
+    {
+        auto parts = std::max<std::size_t>(1, m_parameters.number_of_partitions);
+        m_partitions.assign(m_hypergraph.size_vertex(), 0);
+
+        // the imbalance compounds over the levels of recursive bisection
+        auto depth = std::ceil(std::log2(static_cast<double>(parts)));
+        auto imbalance = depth > 0 ? std::pow(1.0 + m_parameters.imbalance, 1.0 / depth) - 1.0 : m_parameters.imbalance;
+
+        auto vertices = std::vector<vertex_type>(m_hypergraph.size_vertex());
+        for(vertex_type vertex = 0; vertex < vertices.size(); ++vertex)
+        {
+            vertices[vertex] = vertex;
+        }
+        split(m_hypergraph, vertices, 0, parts, imbalance, util::number_of_threads(m_parameters.number_of_threads));
+
+        m_weights.assign(parts, 0.0);
+        for(vertex_type vertex = 0; vertex < m_partitions.size(); ++vertex)
+        {
+            m_weights[m_partitions[vertex]] += m_hypergraph.weight(vertex);
+        }
+    }
+
+    const Partitioner::partition_container_type & Partitioner::partitions() const noexcept
+    {
+        return m_partitions;
+    }
+
+    Partitioner::partition_type Partitioner::partition(const Partitioner::vertex_type & vertex) const
+    {
+        return m_partitions[vertex];
+    }
+
+    Partitioner::partition_type Partitioner::partition(const Partitioner::cell_type & cell) const
+    {
+        return m_partitions[m_hypergraph.vertex(cell)];
+    }
+
+    Partitioner::weight_type Partitioner::weight(const Partitioner::partition_type & partition) const
+    {
+        return m_weights[partition];
+    }
+
+    Partitioner::weight_type Partitioner::cut() const
+    {
+        auto result = weight_type{0.0};
+        for(Hypergraph::edge_type edge = 0; edge < m_hypergraph.size_edge(); ++edge)
+        {
+            auto pins = m_hypergraph.pins(edge);
+            auto first = m_partitions[*pins.begin()];
+            for(auto pin : pins)
+            {
+                if(m_partitions[pin] != first)
+                {
+                    result += m_hypergraph.edge_weight(edge);
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    void Partitioner::split(const Hypergraph & hypergraph, const std::vector<vertex_type> & vertices, Partitioner::partition_type first, std::size_t parts, double imbalance, std::size_t threads)
+    {
+        if(parts == 1 || hypergraph.size_vertex() == 0)
+        {
+            for(auto vertex : vertices)
+            {
+                m_partitions[vertex] = first;
+            }
+            return;
+        }
+
+        auto first_parts = (parts + 1) / 2;
+        auto sides = bisect(hypergraph, static_cast<double>(first_parts) / parts, imbalance, threads);
+        if(parts == 2)
+        {
+            for(vertex_type vertex = 0; vertex < vertices.size(); ++vertex)
+            {
+                m_partitions[vertices[vertex]] = first + sides[vertex];
+            }
+            return;
+        }
+
+        // both halves write to disjoint vertices and are split concurrently
+        util::parallel_for(0, 2, [&](std::size_t side){
+            auto local = std::vector<vertex_type>{};
+            auto induced = induce(hypergraph, sides, static_cast<char>(side), local);
+            for(auto & vertex : local)
+            {
+                vertex = vertices[vertex];
+            }
+            auto side_first = side == 0 ? first : static_cast<partition_type>(first + first_parts);
+            auto side_parts = side == 0 ? first_parts : parts - first_parts;
+            split(induced, local, side_first, side_parts, imbalance, std::max<std::size_t>(1, threads / 2));
+        }, std::min<std::size_t>(2, threads));
+    }
+
+    std::vector<char> Partitioner::bisect(const Hypergraph & hypergraph, double fraction, double imbalance, std::size_t threads) const
+    {
+        auto total = hypergraph.total_weight();
+        auto max_weights = std::array<double, 2>{(1.0 + imbalance) * fraction * total, (1.0 + imbalance) * (1.0 - fraction) * total};
+
+        auto parameters = m_parameters.clustering;
+        parameters.number_of_threads = threads;
+        auto clustering = Clustering{hypergraph, parameters};
+        clustering.coarsen();
+
+        auto refine = [&](side_container_type sides, std::size_t level){
+            auto bisection = Bisection{clustering.hypergraph(level), max_weights};
+            bisection.assign(std::move(sides));
+            bisection.refine(m_parameters.max_passes);
+            return bisection.sides();
+        };
+        auto uncoarsen = [&](side_container_type sides){
+            for(auto level = clustering.levels() - 1; level > 0; --level)
+            {
+                sides = refine(clustering.project(level, sides), level - 1);
+            }
+            return sides;
+        };
+
+        // initial bisections of the coarsest level, the best one being kept
+        auto coarsest = clustering.levels() - 1;
+        const auto & coarse = clustering.hypergraph(coarsest);
+        auto tries = std::max<std::size_t>(1, std::min<std::size_t>(m_parameters.initial_tries, coarse.size_vertex()));
+        auto candidates = std::vector<side_container_type>(tries);
+        auto cuts = std::vector<std::pair<bool, Bisection::gain_type>>(tries);
+        util::parallel_for(0, tries, [&](std::size_t i){
+            auto seed = static_cast<vertex_type>(i * coarse.size_vertex() / tries);
+            auto bisection = Bisection{coarse, max_weights};
+            bisection.assign(grow(coarse, seed, fraction * coarse.total_weight(), max_weights[0]));
+            bisection.refine(m_parameters.max_passes);
+            candidates[i] = bisection.sides();
+            cuts[i] = {!bisection.feasible(), bisection.cut()};
+        }, threads);
+        auto best = std::min_element(cuts.begin(), cuts.end()) - cuts.begin();
+        auto sides = uncoarsen(std::move(candidates[best]));
+
+        // V-cycles coarsen inside the two sides, where the projected partition keeps its cut
+        for(std::size_t cycle = 0; cycle < m_parameters.v_cycles; ++cycle)
+        {
+            clustering.coarsen(Clustering::community_container_type(sides.begin(), sides.end()));
+            auto top = clustering.levels() - 1;
+            sides = refine(side_container_type(clustering.communities(top).begin(), clustering.communities(top).end()), top);
+            sides = uncoarsen(std::move(sides));
+        }
+        return sides;
+    }
+}
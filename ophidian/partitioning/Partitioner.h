@@ -0,0 +1,118 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PARTITIONING_PARTITIONER_H
+#define OPHIDIAN_PARTITIONING_PARTITIONER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/partitioning/Clustering.h>
+#include <ophidian/partitioning/Hypergraph.h>
+
+namespace ophidian::partitioning
+{
+    //! Multilevel min-cut hypergraph partitioner
+
+    /*!
+       \brief Splits the vertices of a Hypergraph into k blocks of balanced weight while
+       minimizing the weight of the cut hyperedges. Every bisection is multilevel: the hypergraph
+       is coarsened by Clustering, the coarsest level is bisected by growing one side from a few
+       seeds, and the partition is projected back level by level and refined by
+       Fiduccia-Mattheyses passes. V-cycles then coarsen again inside the two sides and refine
+       the partition on the way down. k-way partitions recursively bisect the sub-hypergraphs
+       of both sides, concurrently.
+
+       The FM passes keep the gains of the vertices in buckets, one doubly linked list per gain
+       and side, so moves and gain updates are constant time; the hyperedge weights are rounded
+       to integers for that purpose. A block may exceed its share of the total weight by the
+       imbalance factor. Fixed vertices are not clustered, but are partitioned like the others.
+     */
+    class Partitioner
+    {
+    public:
+        using vertex_type               = Hypergraph::vertex_type;
+        using weight_type               = Hypergraph::weight_type;
+        using cell_type                 = Hypergraph::cell_type;
+        using partition_type            = std::uint32_t;
+        using partition_container_type  = std::vector<partition_type>;
+
+        //! Partitioner parameters
+        struct Parameters
+        {
+            //! Number of blocks
+            std::size_t number_of_partitions{2};
+            //! Allowed excess of the block weights over their share of the total weight
+            double imbalance{0.05};
+            //! Maximum number of FM passes on each level
+            std::size_t max_passes{8};
+            //! Seeds tried by the initial bisection of the coarsest level
+            std::size_t initial_tries{4};
+            //! Number of V-cycles after the first multilevel bisection
+            std::size_t v_cycles{1};
+            //! Coarsening parameters, the number of threads is shared
+            Clustering::Parameters clustering{};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        Partitioner() = delete;
+
+        Partitioner(const Partitioner &) = delete;
+        Partitioner & operator=(const Partitioner &) = delete;
+
+        Partitioner(const Hypergraph & hypergraph, const Parameters & parameters);
+
+        explicit Partitioner(const Hypergraph & hypergraph);
+
+        // Modifiers
+
+        //! Partition the hypergraph, replacing the previous partition
+        void partition();
+
+        // Element access
+
+        //! Block of every vertex
+        const partition_container_type & partitions() const noexcept;
+
+        partition_type partition(const vertex_type & vertex) const;
+
+        //! Block of a cell of the netlist the hypergraph was built from
+        partition_type partition(const cell_type & cell) const;
+
+        //! Total weight of the vertices of a block
+        weight_type weight(const partition_type & partition) const;
+
+        //! Total weight of the hyperedges spanning more than one block
+        weight_type cut() const;
+
+    private:
+        void split(const Hypergraph & hypergraph, const std::vector<vertex_type> & vertices, partition_type first, std::size_t parts, double imbalance, std::size_t threads);
+
+        std::vector<char> bisect(const Hypergraph & hypergraph, double fraction, double imbalance, std::size_t threads) const;
+
+        const Hypergraph &          m_hypergraph;
+        Parameters                  m_parameters;
+        partition_container_type    m_partitions;
+        std::vector<weight_type>    m_weights;
+    };
+}
+
+#endif // OPHIDIAN_PARTITIONING_PARTITIONER_H
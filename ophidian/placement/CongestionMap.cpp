@@ -0,0 +1,396 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "CongestionMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::placement
+{
+    CongestionMap::CongestionMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y, const CongestionMap::Parameters & parameters):
+        Subscription(placement, *this),
+        m_netlist(netlist),
+        m_placement(placement),
+        m_parameters(parameters),
+        m_width(std::max<std::size_t>(1, bins_x)),
+        m_height(std::max<std::size_t>(1, bins_y)),
+        m_x(units::unit_cast<double>(floorplan.chip_origin().x())),
+        m_y(units::unit_cast<double>(floorplan.chip_origin().y())),
+        m_bin_width((units::unit_cast<double>(floorplan.chip_upper_right_corner().x()) - m_x) / m_width),
+        m_bin_height((units::unit_cast<double>(floorplan.chip_upper_right_corner().y()) - m_y) / m_height),
+        m_bin_area(m_bin_width * m_bin_height),
+        m_pins(netlist.make_property_net<pin_container_type>())
+    {
+        build();
+    }
+
+    CongestionMap::CongestionMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y):
+        CongestionMap(netlist, floorplan, placement, bins_x, bins_y, Parameters{})
+    {
+    }
+
+    std::size_t CongestionMap::width() const noexcept
+    {
+        return m_width;
+    }
+
+    std::size_t CongestionMap::height() const noexcept
+    {
+        return m_height;
+    }
+
+    CongestionMap::box_type CongestionMap::box(std::size_t x, std::size_t y) const
+    {
+        return box_type{
+            point_type{unit_type{m_x + x * m_bin_width}, unit_type{m_y + y * m_bin_height}},
+            point_type{unit_type{m_x + (x + 1) * m_bin_width}, unit_type{m_y + (y + 1) * m_bin_height}}
+        };
+    }
+
+    double CongestionMap::horizontal(std::size_t x, std::size_t y) const
+    {
+        return m_grid.horizontal[y * m_width + x];
+    }
+
+    double CongestionMap::vertical(std::size_t x, std::size_t y) const
+    {
+        return m_grid.vertical[y * m_width + x];
+    }
+
+    double CongestionMap::congestion(std::size_t x, std::size_t y) const
+    {
+        return m_congestion[y * m_width + x];
+    }
+
+    const CongestionMap::grid_type & CongestionMap::congestion() const noexcept
+    {
+        return m_congestion;
+    }
+
+    double CongestionMap::max_congestion() const
+    {
+        auto maximum = 0.0;
+        for(auto congestion : m_congestion)
+        {
+            maximum = std::max(maximum, static_cast<double>(congestion));
+        }
+        return maximum;
+    }
+
+    double CongestionMap::total_wirelength() const
+    {
+        auto total = 0.0;
+        for(std::size_t i = 0; i < m_grid.horizontal.size(); ++i)
+        {
+            total += m_grid.horizontal[i] + m_grid.vertical[i];
+        }
+        return total;
+    }
+
+    void CongestionMap::build()
+    {
+        auto nets = std::vector<net_type>(m_netlist.begin_net(), m_netlist.end_net());
+        util::parallel_for(0, nets.size(), [&](std::size_t i){
+            m_pins[nets[i]] = pins(nets[i]);
+        }, m_parameters.number_of_threads, 1024);
+
+        // each block of consecutive nets has its own grid, summed in block order
+        auto size = m_width * m_height;
+        auto blocks = std::max<std::size_t>(1, std::min(util::number_of_threads(m_parameters.number_of_threads), nets.size()));
+        auto grids = std::vector<Grid>(blocks);
+        util::parallel_for(0, blocks, [&](std::size_t block){
+            auto & grid = grids[block];
+            grid.horizontal.assign(size, 0.0);
+            grid.vertical.assign(size, 0.0);
+            auto first = nets.size() * block / blocks;
+            auto last = nets.size() * (block + 1) / blocks;
+            for(auto i = first; i < last; ++i)
+            {
+                add(m_pins[nets[i]], 1.0, grid);
+            }
+        }, m_parameters.number_of_threads, 1);
+
+        m_grid = std::move(grids.front());
+        m_congestion.assign(size, 0.0f);
+        auto pitch = units::unit_cast<double>(m_parameters.wire_pitch);
+        util::parallel_for(0, m_height, [&](std::size_t row){
+            for(auto index = row * m_width; index < (row + 1) * m_width; ++index)
+            {
+                for(std::size_t block = 1; block < blocks; ++block)
+                {
+                    m_grid.horizontal[index] += grids[block].horizontal[index];
+                    m_grid.vertical[index] += grids[block].vertical[index];
+                }
+                m_congestion[index] = static_cast<float>((m_grid.horizontal[index] + m_grid.vertical[index]) * pitch / m_bin_area);
+            }
+        }, m_parameters.number_of_threads, 1);
+    }
+
+    void CongestionMap::place(const CongestionMap::cell_type & cell, const CongestionMap::point_type & location)
+    {
+        m_placement.place(cell, location);
+        if(!attached())
+        {
+            update(cell);
+        }
+    }
+
+    void CongestionMap::update(const CongestionMap::cell_type & cell)
+    {
+        for(auto pin : m_netlist.pins(cell))
+        {
+            auto net = m_netlist.net(pin);
+            if(net != net_type{})
+            {
+                update(net);
+            }
+        }
+    }
+
+    void CongestionMap::update(const CongestionMap::net_type & net)
+    {
+        auto & stored = m_pins[net];
+        add(stored, -1.0, m_grid);
+        refresh(stored);
+        stored = pins(net);
+        add(stored, 1.0, m_grid);
+        refresh(stored);
+    }
+
+    void CongestionMap::moved(const Placement::move_container_type & moves)
+    {
+        if(rebuild(moves))
+        {
+            build();
+            return;
+        }
+        for(const auto & move : moves)
+        {
+            update(move.cell);
+        }
+    }
+
+    void CongestionMap::oriented(const CongestionMap::cell_type & cell)
+    {
+        update(cell);
+    }
+
+    CongestionMap::pin_container_type CongestionMap::pins(const CongestionMap::net_type & net) const
+    {
+        auto result = pin_container_type{};
+        for(auto pin : m_netlist.pins(net))
+        {
+            auto location = point_type{};
+            if(m_netlist.cell(pin) != circuit::CellInstance{})
+            {
+                location = m_placement.location(pin);
+            }
+            else if(m_netlist.input(pin) != circuit::Input{})
+            {
+                location = m_placement.location(m_netlist.input(pin));
+            }
+            else if(m_netlist.output(pin) != circuit::Output{})
+            {
+                location = m_placement.location(m_netlist.output(pin));
+            }
+            else
+            {
+                continue;
+            }
+            result.emplace_back(units::unit_cast<double>(location.x()), units::unit_cast<double>(location.y()));
+        }
+        return result;
+    }
+
+    void CongestionMap::add(const CongestionMap::pin_container_type & pins, double sign, CongestionMap::Grid & grid) const
+    {
+        if(pins.size() < 2)
+        {
+            return;
+        }
+
+        if(m_parameters.model == Model::PROBABILISTIC && pins.size() <= m_parameters.max_degree)
+        {
+            // Prim, each tree segment takes either L shape with half of its length
+            auto distance = std::vector<double>(pins.size(), std::numeric_limits<double>::max());
+            auto parent = std::vector<std::size_t>(pins.size(), 0);
+            auto in_tree = std::vector<char>(pins.size(), 0);
+            distance[0] = 0.0;
+            for(std::size_t step = 0; step < pins.size(); ++step)
+            {
+                auto next = pins.size();
+                for(std::size_t i = 0; i < pins.size(); ++i)
+                {
+                    if(!in_tree[i] && (next == pins.size() || distance[i] < distance[next]))
+                    {
+                        next = i;
+                    }
+                }
+                in_tree[next] = 1;
+                if(step > 0)
+                {
+                    auto [x1, y1] = pins[parent[next]];
+                    auto [x2, y2] = pins[next];
+                    add_segment(x1, y1, x2, y1, 0.5 * sign, grid);
+                    add_segment(x2, y1, x2, y2, 0.5 * sign, grid);
+                    add_segment(x1, y1, x1, y2, 0.5 * sign, grid);
+                    add_segment(x1, y2, x2, y2, 0.5 * sign, grid);
+                }
+                for(std::size_t i = 0; i < pins.size(); ++i)
+                {
+                    auto d = std::abs(pins[i].first - pins[next].first) + std::abs(pins[i].second - pins[next].second);
+                    if(!in_tree[i] && d < distance[i])
+                    {
+                        distance[i] = d;
+                        parent[i] = next;
+                    }
+                }
+            }
+            return;
+        }
+
+        auto x_low = pins.front().first;
+        auto x_high = x_low;
+        auto y_low = pins.front().second;
+        auto y_high = y_low;
+        for(auto [x, y] : pins)
+        {
+            x_low = std::min(x_low, x);
+            x_high = std::max(x_high, x);
+            y_low = std::min(y_low, y);
+            y_high = std::max(y_high, y);
+        }
+
+        // the box is widened to a bin so that flat nets keep a finite density
+        auto horizontal = x_high - x_low;
+        auto vertical = y_high - y_low;
+        auto widen_x = std::max(0.0, m_bin_width - horizontal) / 2;
+        auto widen_y = std::max(0.0, m_bin_height - vertical) / 2;
+        add_box(x_low - widen_x, y_low - widen_y, x_high + widen_x, y_high + widen_y, sign * horizontal, sign * vertical, grid);
+    }
+
+    void CongestionMap::add_box(double x_low, double y_low, double x_high, double y_high, double horizontal, double vertical, CongestionMap::Grid & grid) const
+    {
+        auto area = (x_high - x_low) * (y_high - y_low);
+        if(area <= 0.0 || (horizontal == 0.0 && vertical == 0.0))
+        {
+            return;
+        }
+
+        auto first_column = static_cast<std::size_t>(std::clamp(std::floor((x_low - m_x) / m_bin_width), 0.0, static_cast<double>(m_width)));
+        auto last_column = static_cast<std::size_t>(std::clamp(std::ceil((x_high - m_x) / m_bin_width), 0.0, static_cast<double>(m_width)));
+        auto first_row = static_cast<std::size_t>(std::clamp(std::floor((y_low - m_y) / m_bin_height), 0.0, static_cast<double>(m_height)));
+        auto last_row = static_cast<std::size_t>(std::clamp(std::ceil((y_high - m_y) / m_bin_height), 0.0, static_cast<double>(m_height)));
+        for(auto row = first_row; row < last_row; ++row)
+        {
+            auto bin_y = m_y + row * m_bin_height;
+            auto overlap_y = std::min(y_high, bin_y + m_bin_height) - std::max(y_low, bin_y);
+            if(overlap_y <= 0.0)
+            {
+                continue;
+            }
+            for(auto column = first_column; column < last_column; ++column)
+            {
+                auto bin_x = m_x + column * m_bin_width;
+                auto overlap_x = std::min(x_high, bin_x + m_bin_width) - std::max(x_low, bin_x);
+                if(overlap_x <= 0.0)
+                {
+                    continue;
+                }
+                auto fraction = overlap_x * overlap_y / area;
+                grid.horizontal[row * m_width + column] += horizontal * fraction;
+                grid.vertical[row * m_width + column] += vertical * fraction;
+            }
+        }
+    }
+
+    void CongestionMap::add_segment(double x1, double y1, double x2, double y2, double weight, CongestionMap::Grid & grid) const
+    {
+        auto along_x = y1 == y2;
+        auto low = along_x ? std::min(x1, x2) : std::min(y1, y2);
+        auto high = along_x ? std::max(x1, x2) : std::max(y1, y2);
+        if(high <= low)
+        {
+            return;
+        }
+
+        auto origin = along_x ? m_x : m_y;
+        auto size = along_x ? m_bin_width : m_bin_height;
+        auto count = along_x ? m_width : m_height;
+        auto across = along_x ? std::floor((y1 - m_y) / m_bin_height) : std::floor((x1 - m_x) / m_bin_width);
+        auto line = static_cast<std::size_t>(std::clamp(across, 0.0, static_cast<double>((along_x ? m_height : m_width) - 1)));
+
+        auto first = static_cast<std::size_t>(std::clamp(std::floor((low - origin) / size), 0.0, static_cast<double>(count)));
+        auto last = static_cast<std::size_t>(std::clamp(std::ceil((high - origin) / size), 0.0, static_cast<double>(count)));
+        for(auto bin = first; bin < last; ++bin)
+        {
+            auto start = origin + bin * size;
+            auto overlap = std::min(high, start + size) - std::max(low, start);
+            if(overlap <= 0.0)
+            {
+                continue;
+            }
+            if(along_x)
+            {
+                grid.horizontal[line * m_width + bin] += weight * overlap;
+            }
+            else
+            {
+                grid.vertical[bin * m_width + line] += weight * overlap;
+            }
+        }
+    }
+
+    void CongestionMap::refresh(const CongestionMap::pin_container_type & pins)
+    {
+        if(pins.empty())
+        {
+            return;
+        }
+
+        // the bins under the pin box, widened by a bin on each side
+        auto x_low = pins.front().first;
+        auto x_high = x_low;
+        auto y_low = pins.front().second;
+        auto y_high = y_low;
+        for(auto [x, y] : pins)
+        {
+            x_low = std::min(x_low, x);
+            x_high = std::max(x_high, x);
+            y_low = std::min(y_low, y);
+            y_high = std::max(y_high, y);
+        }
+        auto first_column = static_cast<std::size_t>(std::clamp(std::floor((x_low - m_x) / m_bin_width) - 1, 0.0, static_cast<double>(m_width)));
+        auto last_column = static_cast<std::size_t>(std::clamp(std::ceil((x_high - m_x) / m_bin_width) + 1, 0.0, static_cast<double>(m_width)));
+        auto first_row = static_cast<std::size_t>(std::clamp(std::floor((y_low - m_y) / m_bin_height) - 1, 0.0, static_cast<double>(m_height)));
+        auto last_row = static_cast<std::size_t>(std::clamp(std::ceil((y_high - m_y) / m_bin_height) + 1, 0.0, static_cast<double>(m_height)));
+        auto pitch = units::unit_cast<double>(m_parameters.wire_pitch);
+        for(auto row = first_row; row < last_row; ++row)
+        {
+            for(auto column = first_column; column < last_column; ++column)
+            {
+                auto index = row * m_width + column;
+                m_congestion[index] = static_cast<float>((m_grid.horizontal[index] + m_grid.vertical[index]) * pitch / m_bin_area);
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_CONGESTION_MAP_H
+#define OPHIDIAN_PLACEMENT_CONGESTION_MAP_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+
+namespace ophidian::placement
+{
+    //! Placement based routing congestion map
+
+    /*!
+       \brief Estimates the wire of every net over a uniform grid of bins covering the chip area
+       of the floorplan, without routing. Each bin keeps the horizontal and the vertical wire
+       length expected to cross it, in database units, and the congestion, the area of those
+       wires at the given pitch over the bin area, is mirrored in a flat row-major float grid,
+       bin (x, y) being at index y * width() + x.
+
+       The RUDY model spreads the half perimeter of the pin bounding box of a net uniformly over
+       the box, which is widened to at least one bin. The probabilistic model splits the nets up
+       to a maximum degree into the segments of their rectilinear spanning tree, each routed
+       with one of its two L shapes at equal probability, and falls back to RUDY above it.
+
+       The map is built in parallel: the nets are split into one block per thread, each block is
+       accumulated in a private grid and the grids are then summed bin by bin. Moving a cell
+       only touches the nets on its pins: move it through place() or call update() after
+       changing the placement directly. An attached map listens to the placement instead and
+       follows every cell move and orientation change, rebuilding itself when a batch moves more
+       than rebuild_fraction() of the cells.
+     */
+    class CongestionMap :
+        private Placement::Listener,
+        public Placement::Subscription
+    {
+    public:
+        using unit_type             = util::database_unit_t;
+        using point_type            = util::LocationDbu;
+        using box_type              = geometry::Box<unit_type>;
+        using cell_type             = Placement::cell_type;
+        using net_type              = circuit::Net;
+        using grid_type             = std::vector<float>;
+
+        //! Wire model of the nets
+        enum class Model
+        {
+            RUDY,
+            PROBABILISTIC
+        };
+
+        //! Estimator parameters
+        struct Parameters
+        {
+            Model model{Model::RUDY};
+            //! Nets with more pins use RUDY in the probabilistic model
+            std::size_t max_degree{16};
+            //! Distance between the centers of two routing tracks
+            unit_type wire_pitch{1.0};
+            //! Number of threads used by build(), 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        CongestionMap() = delete;
+
+        CongestionMap(const CongestionMap &) = delete;
+        CongestionMap & operator=(const CongestionMap &) = delete;
+
+        //! Construct and build the map
+        /*!
+           \param netlist Netlist owning the nets and cells
+           \param floorplan Floorplan whose chip area is binned
+           \param placement Placement of the cells and pads, modified by place()
+           \param bins_x Number of bins along x
+           \param bins_y Number of bins along y
+           \param parameters Estimator parameters
+         */
+        CongestionMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y, const Parameters & parameters);
+
+        CongestionMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y);
+
+        // Element access
+        std::size_t width() const noexcept;
+
+        std::size_t height() const noexcept;
+
+        box_type box(std::size_t x, std::size_t y) const;
+
+        //! Horizontal wire length crossing a bin
+        double horizontal(std::size_t x, std::size_t y) const;
+
+        //! Vertical wire length crossing a bin
+        double vertical(std::size_t x, std::size_t y) const;
+
+        //! Wire area at the pitch over bin area
+        double congestion(std::size_t x, std::size_t y) const;
+
+        //! Congestion of every bin
+        const grid_type & congestion() const noexcept;
+
+        //! Highest bin congestion
+        double max_congestion() const;
+
+        //! Estimated wire length of the whole design
+        double total_wirelength() const;
+
+        // Modifiers
+
+        //! Rebuild the map from the placement
+        void build();
+
+        //! Move a cell through the placement and update the nets on its pins
+        void place(const cell_type & cell, const point_type & location);
+
+        //! Update the nets on the pins of a cell after its location changed
+        void update(const cell_type & cell);
+
+        //! Update a net after one of its pins moved
+        void update(const net_type & net);
+
+    private:
+        using position_type         = std::pair<double, double>;
+        using pin_container_type    = std::vector<position_type>;
+
+        //! Per block storage
+        struct Grid
+        {
+            std::vector<double> horizontal;
+            std::vector<double> vertical;
+        };
+
+        pin_container_type pins(const net_type & net) const;
+        void add(const pin_container_type & pins, double sign, Grid & grid) const;
+        void add_box(double x_low, double y_low, double x_high, double y_high, double horizontal, double vertical, Grid & grid) const;
+        void add_segment(double x1, double y1, double x2, double y2, double weight, Grid & grid) const;
+        void refresh(const pin_container_type & pins);
+        void moved(const Placement::move_container_type & moves) override;
+        void oriented(const cell_type & cell) override;
+
+        const circuit::Netlist &    m_netlist;
+        Placement &                 m_placement;
+        Parameters                  m_parameters;
+
+        std::size_t m_width;
+        std::size_t m_height;
+        double      m_x;
+        double      m_y;
+        double      m_bin_width;
+        double      m_bin_height;
+        double      m_bin_area;
+
+        Grid        m_grid;
+        grid_type   m_congestion;
+
+        entity_system::Property<net_type, pin_container_type> m_pins;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_CONGESTION_MAP_H
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "CosineTransform.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef OPHIDIAN_USE_FFTW
+#include <fftw3.h>
+#endif
+
+namespace ophidian::placement
+{
+    namespace
+    {
+        constexpr double pi = 3.14159265358979323846;
+    }
+
+    struct CosineTransform::Plans
+    {
+#ifdef OPHIDIAN_USE_FFTW
+        fftw_plan dct{nullptr};
+        fftw_plan idct{nullptr};
+
+        ~Plans()
+        {
+            if(dct != nullptr)
+            {
+                fftw_destroy_plan(dct);
+            }
+            if(idct != nullptr)
+            {
+                fftw_destroy_plan(idct);
+            }
+        }
+#endif
+    };
+
+    CosineTransform::CosineTransform(std::size_t size):
+        m_size(size),
+        m_power_of_two(size > 0 && (size & (size - 1)) == 0),
+        m_plans(std::make_unique<Plans>())
+    {
+#ifdef OPHIDIAN_USE_FFTW
+        // plans are created once, executing them on other arrays is thread safe
+        auto n = static_cast<int>(m_size);
+        auto in = fftw_alloc_real(m_size);
+        auto out = fftw_alloc_real(m_size);
+        m_plans->dct = fftw_plan_r2r_1d(n, in, out, FFTW_REDFT10, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        m_plans->idct = fftw_plan_r2r_1d(n, in, out, FFTW_REDFT01, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        fftw_free(in);
+        fftw_free(out);
+#else
+        if(m_power_of_two)
+        {
+            m_twiddles.resize(m_size / 2);
+            for(std::size_t k = 0; k < m_twiddles.size(); ++k)
+            {
+                m_twiddles[k] = std::polar(1.0, -2.0 * pi * k / m_size);
+            }
+            m_shifts.resize(m_size);
+            for(std::size_t u = 0; u < m_size; ++u)
+            {
+                m_shifts[u] = std::polar(1.0, -pi * u / (2.0 * m_size));
+            }
+            m_bit_reversal.resize(m_size);
+            auto bits = std::size_t{0};
+            while((std::size_t{1} << bits) < m_size)
+            {
+                ++bits;
+            }
+            for(std::size_t i = 0; i < m_size; ++i)
+            {
+                auto reversed = std::size_t{0};
+                for(std::size_t b = 0; b < bits; ++b)
+                {
+                    reversed |= ((i >> b) & 1) << (bits - 1 - b);
+                }
+                m_bit_reversal[i] = reversed;
+            }
+        }
+        else
+        {
+            m_cosines.resize(m_size * m_size);
+            for(std::size_t u = 0; u < m_size; ++u)
+            {
+                for(std::size_t x = 0; x < m_size; ++x)
+                {
+                    m_cosines[u * m_size + x] = std::cos(pi * u * (2 * x + 1) / (2.0 * m_size));
+                }
+            }
+        }
+#endif
+    }
+
+    CosineTransform::~CosineTransform() = default;
+
+    std::size_t CosineTransform::size() const noexcept
+    {
+        return m_size;
+    }
+
+    void CosineTransform::dct(double * data, CosineTransform::Workspace & workspace) const
+    {
+        auto & real = workspace.real;
+        real.resize(m_size);
+#ifdef OPHIDIAN_USE_FFTW
+        fftw_execute_r2r(m_plans->dct, data, real.data());
+        for(std::size_t u = 0; u < m_size; ++u)
+        {
+            data[u] = real[u] / 2.0;
+        }
+#else
+        if(m_power_of_two)
+        {
+            // Makhoul: even samples forward, odd samples backward, then one complex FFT
+            auto & c = workspace.complex;
+            c.resize(m_size);
+            for(std::size_t k = 0; 2 * k < m_size; ++k)
+            {
+                c[k] = data[2 * k];
+            }
+            for(std::size_t k = 0; 2 * k + 1 < m_size; ++k)
+            {
+                c[m_size - 1 - k] = data[2 * k + 1];
+            }
+            fft(c.data(), false);
+            for(std::size_t u = 0; u < m_size; ++u)
+            {
+                data[u] = (c[u] * m_shifts[u]).real();
+            }
+            return;
+        }
+
+        for(std::size_t u = 0; u < m_size; ++u)
+        {
+            auto sum = 0.0;
+            for(std::size_t x = 0; x < m_size; ++x)
+            {
+                sum += data[x] * m_cosines[u * m_size + x];
+            }
+            real[u] = sum;
+        }
+        std::copy(real.begin(), real.end(), data);
+#endif
+    }
+
+    void CosineTransform::idct(double * data, CosineTransform::Workspace & workspace) const
+    {
+        auto & real = workspace.real;
+        real.resize(m_size);
+#ifdef OPHIDIAN_USE_FFTW
+        fftw_execute_r2r(m_plans->idct, data, real.data());
+        for(std::size_t x = 0; x < m_size; ++x)
+        {
+            data[x] = real[x] / 2.0;
+        }
+#else
+        if(m_power_of_two)
+        {
+            auto & c = workspace.complex;
+            c.resize(m_size);
+            for(std::size_t u = 0; u < m_size; ++u)
+            {
+                auto mirrored = u == 0 ? 0.0 : data[m_size - u];
+                c[u] = std::conj(m_shifts[u]) * std::complex<double>{data[u], -mirrored};
+            }
+            fft(c.data(), true);
+            for(std::size_t k = 0; 2 * k < m_size; ++k)
+            {
+                data[2 * k] = c[k].real() / 2.0;
+            }
+            for(std::size_t k = 0; 2 * k + 1 < m_size; ++k)
+            {
+                data[2 * k + 1] = c[m_size - 1 - k].real() / 2.0;
+            }
+            return;
+        }
+
+        for(std::size_t x = 0; x < m_size; ++x)
+        {
+            auto sum = data[0] / 2.0;
+            for(std::size_t u = 1; u < m_size; ++u)
+            {
+                sum += data[u] * m_cosines[u * m_size + x];
+            }
+            real[x] = sum;
+        }
+        std::copy(real.begin(), real.end(), data);
+#endif
+    }
+
+    void CosineTransform::idxst(double * data, CosineTransform::Workspace & workspace) const
+    {
+        // sin(theta(u, x)) = (-1)^x cos(theta(n - u, x)), so reversing the coefficients gives a cosine sum
+        if(m_size == 0)
+        {
+            return;
+        }
+        std::reverse(data + 1, data + m_size);
+        data[0] = 0.0;
+        idct(data, workspace);
+        for(std::size_t x = 1; x < m_size; x += 2)
+        {
+            data[x] = -data[x];
+        }
+    }
+
+    void CosineTransform::fft(std::complex<double> * data, bool inverse) const
+    {
+        for(std::size_t i = 0; i < m_size; ++i)
+        {
+            auto j = m_bit_reversal[i];
+            if(i < j)
+            {
+                std::swap(data[i], data[j]);
+            }
+        }
+        for(std::size_t length = 2; length <= m_size; length <<= 1)
+        {
+            auto half = length / 2;
+            auto step = m_size / length;
+            for(std::size_t i = 0; i < m_size; i += length)
+            {
+                for(std::size_t k = 0; k < half; ++k)
+                {
+                    auto w = inverse ? std::conj(m_twiddles[k * step]) : m_twiddles[k * step];
+                    auto even = data[i + k];
+                    auto odd = data[i + k + half] * w;
+                    data[i + k] = even + odd;
+                    data[i + k + half] = even - odd;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_COSINE_TRANSFORM_H
+#define OPHIDIAN_PLACEMENT_COSINE_TRANSFORM_H
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ophidian::placement
+{
+    //! Unnormalized cosine and sine transforms of one length
+
+    /*!
+       \brief Transforms used by spectral Poisson solvers over a grid of n cells, with angles
+       theta(u, x) = pi * u * (2x + 1) / (2n):
+         - dct: X[u] = sum_x f[x] cos(theta(u, x))
+         - idct: f[x] = X[0] / 2 + sum_{u > 0} X[u] cos(theta(u, x)), so idct(dct(f)) = n / 2 * f
+         - idxst: f[x] = sum_u X[u] sin(theta(u, x))
+
+       Built with FFTW when ophidian finds it. Otherwise power of two lengths go through a bundled
+       radix-2 FFT of length n and other lengths through a precomputed O(n^2) cosine table.
+       A transform is immutable once constructed and can be shared by threads, each one passing
+       its own workspace.
+     */
+    class CosineTransform
+    {
+    public:
+        //! Per thread scratch memory
+        struct Workspace
+        {
+            std::vector<std::complex<double>> complex;
+            std::vector<double> real;
+        };
+
+        // Constructors
+        CosineTransform() = delete;
+
+        CosineTransform(const CosineTransform &) = delete;
+        CosineTransform & operator=(const CosineTransform &) = delete;
+
+        explicit CosineTransform(std::size_t size);
+
+        ~CosineTransform();
+
+        // Capacity
+        std::size_t size() const noexcept;
+
+        // Transforms, in place over size() values
+        void dct(double * data, Workspace & workspace) const;
+
+        void idct(double * data, Workspace & workspace) const;
+
+        void idxst(double * data, Workspace & workspace) const;
+
+    private:
+        struct Plans;
+
+        void fft(std::complex<double> * data, bool inverse) const;
+
+        std::size_t                         m_size;
+        bool                                m_power_of_two;
+        std::vector<std::complex<double>>   m_twiddles;
+        std::vector<std::complex<double>>   m_shifts;
+        std::vector<std::size_t>            m_bit_reversal;
+        std::vector<double>                 m_cosines;
+        std::unique_ptr<Plans>              m_plans;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_COSINE_TRANSFORM_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "DensityMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::placement
+{
+    DensityMap::DensityMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y, std::size_t number_of_threads):
+        Subscription(placement, *this),
+        m_netlist(netlist),
+        m_placement(placement),
+        m_number_of_threads(number_of_threads),
+        m_width(std::max<std::size_t>(1, bins_x)),
+        m_height(std::max<std::size_t>(1, bins_y)),
+        m_x(units::unit_cast<double>(floorplan.chip_origin().x())),
+        m_y(units::unit_cast<double>(floorplan.chip_origin().y())),
+        m_bin_width((units::unit_cast<double>(floorplan.chip_upper_right_corner().x()) - m_x) / m_width),
+        m_bin_height((units::unit_cast<double>(floorplan.chip_upper_right_corner().y()) - m_y) / m_height),
+        m_bin_area(m_bin_width * m_bin_height),
+        m_contributions(netlist.make_property_cell_instance<Contribution>())
+    {
+        build();
+    }
+
+    std::size_t DensityMap::width() const noexcept
+    {
+        return m_width;
+    }
+
+    std::size_t DensityMap::height() const noexcept
+    {
+        return m_height;
+    }
+
+    DensityMap::unit_type DensityMap::bin_width() const noexcept
+    {
+        return unit_type{m_bin_width};
+    }
+
+    DensityMap::unit_type DensityMap::bin_height() const noexcept
+    {
+        return unit_type{m_bin_height};
+    }
+
+    DensityMap::box_type DensityMap::box(std::size_t x, std::size_t y) const
+    {
+        return box_type{
+            point_type{unit_type{m_x + x * m_bin_width}, unit_type{m_y + y * m_bin_height}},
+            point_type{unit_type{m_x + (x + 1) * m_bin_width}, unit_type{m_y + (y + 1) * m_bin_height}}
+        };
+    }
+
+    std::pair<std::size_t, std::size_t> DensityMap::bin(const DensityMap::point_type & point) const
+    {
+        auto x = std::floor((units::unit_cast<double>(point.x()) - m_x) / m_bin_width);
+        auto y = std::floor((units::unit_cast<double>(point.y()) - m_y) / m_bin_height);
+        return {
+            static_cast<std::size_t>(std::clamp(x, 0.0, static_cast<double>(m_width - 1))),
+            static_cast<std::size_t>(std::clamp(y, 0.0, static_cast<double>(m_height - 1)))
+        };
+    }
+
+    double DensityMap::movable_area(std::size_t x, std::size_t y) const
+    {
+        return m_movable_area[y * m_width + x];
+    }
+
+    double DensityMap::fixed_area(std::size_t x, std::size_t y) const
+    {
+        return m_fixed_area[y * m_width + x];
+    }
+
+    double DensityMap::density(std::size_t x, std::size_t y) const
+    {
+        return (m_movable_area[y * m_width + x] + m_fixed_area[y * m_width + x]) / m_bin_area;
+    }
+
+    const DensityMap::grid_type & DensityMap::movable_density() const noexcept
+    {
+        return m_movable_density;
+    }
+
+    const DensityMap::grid_type & DensityMap::fixed_density() const noexcept
+    {
+        return m_fixed_density;
+    }
+
+    double DensityMap::total_movable_area() const noexcept
+    {
+        return m_total_movable_area;
+    }
+
+    double DensityMap::overflow_area(double target_density) const
+    {
+        auto overflow = 0.0;
+        for(std::size_t i = 0; i < m_movable_area.size(); ++i)
+        {
+            auto capacity = target_density * std::max(0.0, m_bin_area - m_fixed_area[i]);
+            overflow += std::max(0.0, m_movable_area[i] - capacity);
+        }
+        return overflow;
+    }
+
+    double DensityMap::overflow(double target_density) const
+    {
+        return m_total_movable_area > 0.0 ? overflow_area(target_density) / m_total_movable_area : 0.0;
+    }
+
+    double DensityMap::max_density() const
+    {
+        auto maximum = 0.0;
+        for(std::size_t i = 0; i < m_movable_area.size(); ++i)
+        {
+            maximum = std::max(maximum, m_movable_area[i] + m_fixed_area[i]);
+        }
+        return maximum / m_bin_area;
+    }
+
+    void DensityMap::build()
+    {
+        auto cells = std::vector<cell_type>(m_netlist.begin_cell_instance(), m_netlist.end_cell_instance());
+        util::parallel_for(0, cells.size(), [&](std::size_t i){
+            m_contributions[cells[i]] = Contribution{m_placement.geometry(cells[i]), m_placement.fixed(cells[i])};
+        }, m_number_of_threads, 1024);
+
+        // boxes are bucketed by bin row so that each thread owns whole rows
+        auto buckets = std::vector<std::vector<const box_type *>>(m_height);
+        auto bucket_fixed = std::vector<std::vector<char>>(m_height);
+        for(auto cell : cells)
+        {
+            const auto & contribution = m_contributions[cell];
+            for(const auto & box : contribution.geometry)
+            {
+                auto [first, last] = rows(box);
+                for(auto row = first; row < last; ++row)
+                {
+                    buckets[row].push_back(&box);
+                    bucket_fixed[row].push_back(contribution.fixed);
+                }
+            }
+        }
+
+        m_movable_area.assign(m_width * m_height, 0.0);
+        m_fixed_area.assign(m_width * m_height, 0.0);
+        m_movable_density.assign(m_width * m_height, 0.0f);
+        m_fixed_density.assign(m_width * m_height, 0.0f);
+        util::parallel_for(0, m_height, [&](std::size_t row){
+            for(std::size_t i = 0; i < buckets[row].size(); ++i)
+            {
+                add(*buckets[row][i], bucket_fixed[row][i], 1.0, row, row + 1);
+            }
+        }, m_number_of_threads, 1);
+
+        m_total_movable_area = 0.0;
+        for(auto area : m_movable_area)
+        {
+            m_total_movable_area += area;
+        }
+    }
+
+    void DensityMap::place(const DensityMap::cell_type & cell, const DensityMap::point_type & location)
+    {
+        m_placement.place(cell, location);
+        if(!attached())
+        {
+            update(cell);
+        }
+    }
+
+    void DensityMap::fix(const DensityMap::cell_type & cell, bool fixed)
+    {
+        m_placement.fix(cell, fixed);
+        if(!attached())
+        {
+            update(cell);
+        }
+    }
+
+    void DensityMap::update(const DensityMap::cell_type & cell)
+    {
+        auto & contribution = m_contributions[cell];
+        add(contribution, -1.0);
+        contribution = Contribution{m_placement.geometry(cell), m_placement.fixed(cell)};
+        add(contribution, 1.0);
+    }
+
+    void DensityMap::moved(const Placement::move_container_type & moves)
+    {
+        if(rebuild(moves))
+        {
+            build();
+            return;
+        }
+        for(const auto & move : moves)
+        {
+            update(move.cell);
+        }
+    }
+
+    void DensityMap::fixed(const DensityMap::cell_type & cell)
+    {
+        update(cell);
+    }
+
+    void DensityMap::oriented(const DensityMap::cell_type & cell)
+    {
+        update(cell);
+    }
+
+    std::pair<std::size_t, std::size_t> DensityMap::rows(const DensityMap::box_type & box) const
+    {
+        auto first = std::floor((units::unit_cast<double>(box.min_corner().y()) - m_y) / m_bin_height);
+        auto last = std::ceil((units::unit_cast<double>(box.max_corner().y()) - m_y) / m_bin_height);
+        auto height = static_cast<double>(m_height);
+        return {static_cast<std::size_t>(std::clamp(first, 0.0, height)), static_cast<std::size_t>(std::clamp(last, 0.0, height))};
+    }
+
+    void DensityMap::add(const DensityMap::Contribution & contribution, double sign)
+    {
+        for(const auto & box : contribution.geometry)
+        {
+            auto [first, last] = rows(box);
+            auto area = add(box, contribution.fixed, sign, first, last);
+            if(!contribution.fixed)
+            {
+                m_total_movable_area += area;
+            }
+        }
+    }
+
+    double DensityMap::add(const DensityMap::box_type & box, bool fixed, double sign, std::size_t first_row, std::size_t last_row)
+    {
+        auto x_low = units::unit_cast<double>(box.min_corner().x());
+        auto x_high = units::unit_cast<double>(box.max_corner().x());
+        auto y_low = units::unit_cast<double>(box.min_corner().y());
+        auto y_high = units::unit_cast<double>(box.max_corner().y());
+
+        auto first_column = static_cast<std::size_t>(std::clamp(std::floor((x_low - m_x) / m_bin_width), 0.0, static_cast<double>(m_width)));
+        auto last_column = static_cast<std::size_t>(std::clamp(std::ceil((x_high - m_x) / m_bin_width), 0.0, static_cast<double>(m_width)));
+
+        auto & areas = fixed ? m_fixed_area : m_movable_area;
+        auto & densities = fixed ? m_fixed_density : m_movable_density;
+        auto added = 0.0;
+        for(auto row = first_row; row < last_row; ++row)
+        {
+            auto bin_y = m_y + row * m_bin_height;
+            auto overlap_y = std::min(y_high, bin_y + m_bin_height) - std::max(y_low, bin_y);
+            if(overlap_y <= 0.0)
+            {
+                continue;
+            }
+            for(auto column = first_column; column < last_column; ++column)
+            {
+                auto bin_x = m_x + column * m_bin_width;
+                auto overlap_x = std::min(x_high, bin_x + m_bin_width) - std::max(x_low, bin_x);
+                if(overlap_x <= 0.0)
+                {
+                    continue;
+                }
+                auto index = row * m_width + column;
+                areas[index] += sign * overlap_x * overlap_y;
+                densities[index] = static_cast<float>(areas[index] / m_bin_area);
+                added += sign * overlap_x * overlap_y;
+            }
+        }
+        return added;
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_DENSITY_MAP_H
+#define OPHIDIAN_PLACEMENT_DENSITY_MAP_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+
+namespace ophidian::placement
+{
+    //! Bin density map
+
+    /*!
+       \brief Splits the chip area of the floorplan into a uniform grid of bins and keeps, for
+       every bin, the area covered by movable cells and by fixed cells. Areas are accumulated in
+       double precision and mirrored as utilizations (area over bin area) in flat row-major float
+       grids, bin (x, y) being at index y * width() + x, which can be handed to numerical solvers.
+
+       The map is built in parallel, each thread summing the cells of whole bin rows in netlist
+       order, so the result does not depend on the number of threads. Moving a cell only
+       touches the bins under its old and new geometries: move it through place() or fix(), or
+       call update() after changing the placement directly. An attached map listens to the
+       placement instead and follows every move, fix and orientation change, rebuilding itself
+       when a batch moves more than rebuild_fraction() of the cells.
+     */
+    class DensityMap :
+        private Placement::Listener,
+        public Placement::Subscription
+    {
+    public:
+        using unit_type             = util::database_unit_t;
+        using point_type            = util::LocationDbu;
+        using box_type              = geometry::Box<unit_type>;
+        using cell_type             = Placement::cell_type;
+        using grid_type             = std::vector<float>;
+
+        // Constructors
+        DensityMap() = delete;
+
+        DensityMap(const DensityMap &) = delete;
+        DensityMap & operator=(const DensityMap &) = delete;
+
+        //! Construct and build the map
+        /*!
+           \param netlist Netlist owning the cells
+           \param floorplan Floorplan whose chip area is binned
+           \param placement Placement of the cells, modified by place() and fix()
+           \param bins_x Number of bins along x
+           \param bins_y Number of bins along y
+           \param number_of_threads Threads used by build(), 0 for one per hardware thread
+         */
+        DensityMap(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, std::size_t bins_x, std::size_t bins_y, std::size_t number_of_threads = 0);
+
+        // Element access
+        std::size_t width() const noexcept;
+
+        std::size_t height() const noexcept;
+
+        unit_type bin_width() const noexcept;
+
+        unit_type bin_height() const noexcept;
+
+        box_type box(std::size_t x, std::size_t y) const;
+
+        //! Bin containing a point, clamped to the grid
+        std::pair<std::size_t, std::size_t> bin(const point_type & point) const;
+
+        double movable_area(std::size_t x, std::size_t y) const;
+
+        double fixed_area(std::size_t x, std::size_t y) const;
+
+        //! Covered area over bin area
+        double density(std::size_t x, std::size_t y) const;
+
+        //! Movable area over bin area of every bin
+        const grid_type & movable_density() const noexcept;
+
+        //! Fixed area over bin area of every bin
+        const grid_type & fixed_density() const noexcept;
+
+        //! Total area of the movable cells inside the chip area
+        double total_movable_area() const noexcept;
+
+        //! Movable area exceeding the target density
+        /*!
+           \brief Sum over the bins of the movable area above target_density times the bin area
+           not covered by fixed cells.
+         */
+        double overflow_area(double target_density) const;
+
+        //! Overflow area over total movable area
+        double overflow(double target_density) const;
+
+        //! Highest bin density
+        double max_density() const;
+
+        // Modifiers
+
+        //! Rebuild the map from the placement
+        void build();
+
+        //! Move a cell through the placement and update its bins
+        void place(const cell_type & cell, const point_type & location);
+
+        //! Fix or release a cell through the placement and update its bins
+        void fix(const cell_type & cell, bool fixed);
+
+        //! Update the bins of a cell after its location or fixed state changed
+        void update(const cell_type & cell);
+
+    private:
+        struct Contribution
+        {
+            Placement::cell_geometry_type geometry;
+            bool fixed{false};
+        };
+
+        double add(const box_type & box, bool fixed, double sign, std::size_t first_row, std::size_t last_row);
+        std::pair<std::size_t, std::size_t> rows(const box_type & box) const;
+        void add(const Contribution & contribution, double sign);
+        void moved(const Placement::move_container_type & moves) override;
+        void fixed(const cell_type & cell) override;
+        void oriented(const cell_type & cell) override;
+
+        const circuit::Netlist &    m_netlist;
+        Placement &                 m_placement;
+        std::size_t                 m_number_of_threads;
+
+        std::size_t m_width;
+        std::size_t m_height;
+        double      m_x;
+        double      m_y;
+        double      m_bin_width;
+        double      m_bin_height;
+        double      m_bin_area;
+
+        std::vector<double> m_movable_area;
+        std::vector<double> m_fixed_area;
+        grid_type           m_movable_density;
+        grid_type           m_fixed_density;
+        double              m_total_movable_area{0.0};
+
+        entity_system::Property<cell_type, Contribution> m_contributions;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_DENSITY_MAP_H
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "ElectrostaticDensity.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::placement
+{
+    namespace
+    {
+        constexpr double pi = 3.14159265358979323846;
+
+        // edge of the square tiles used to transpose the grids
+        constexpr std::size_t transpose_block = 32;
+    }
+
+    ElectrostaticDensity::ElectrostaticDensity(const circuit::Netlist & netlist, const Placement & placement, const DensityMap & density_map, const ElectrostaticDensity::Parameters & parameters):
+        m_netlist(netlist),
+        m_placement(placement),
+        m_density_map(density_map),
+        m_parameters(parameters),
+        m_number_of_threads(util::number_of_threads(parameters.number_of_threads)),
+        m_x_transform(density_map.width()),
+        m_y_transform(density_map.height()),
+        m_workspaces(m_number_of_threads),
+        m_gradients(netlist.make_property_cell_instance<Gradient>())
+    {
+    }
+
+    ElectrostaticDensity::ElectrostaticDensity(const circuit::Netlist & netlist, const Placement & placement, const DensityMap & density_map):
+        ElectrostaticDensity(netlist, placement, density_map, Parameters{})
+    {
+    }
+
+    double ElectrostaticDensity::energy() const noexcept
+    {
+        return m_energy;
+    }
+
+    const ElectrostaticDensity::grid_type & ElectrostaticDensity::potential() const noexcept
+    {
+        return m_potential;
+    }
+
+    const ElectrostaticDensity::grid_type & ElectrostaticDensity::field_x() const noexcept
+    {
+        return m_field_x;
+    }
+
+    const ElectrostaticDensity::grid_type & ElectrostaticDensity::field_y() const noexcept
+    {
+        return m_field_y;
+    }
+
+    const ElectrostaticDensity::Gradient & ElectrostaticDensity::gradient(const ElectrostaticDensity::cell_type & cell) const
+    {
+        return m_gradients[cell];
+    }
+
+    void ElectrostaticDensity::update()
+    {
+        auto width = m_density_map.width();
+        auto height = m_density_map.height();
+        auto size = width * height;
+        auto bin_width = units::unit_cast<double>(m_density_map.bin_width());
+        auto bin_height = units::unit_cast<double>(m_density_map.bin_height());
+        const auto & movable = m_density_map.movable_density();
+        const auto & fixed = m_density_map.fixed_density();
+
+        m_density.resize(size);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            m_density[i] = movable[i] + m_parameters.fixed_area_weight * fixed[i];
+        }
+
+        // forward 2D DCT, x along the rows of the grid then y along the rows of its transpose
+        m_potential.assign(m_density.begin(), m_density.end());
+        util::parallel_for(0, height, [&](std::size_t y, std::size_t thread){
+            m_x_transform.dct(&m_potential[y * width], m_workspaces[thread]);
+        }, m_number_of_threads, 8);
+        m_coefficients.resize(size);
+        transpose(m_potential, m_coefficients, height, width);
+        util::parallel_for(0, width, [&](std::size_t u, std::size_t thread){
+            m_y_transform.dct(&m_coefficients[u * height], m_workspaces[thread]);
+        }, m_number_of_threads, 8);
+
+        // coefficients of the potential and of the field, indexed [u][v]
+        m_potential_coefficients.resize(size);
+        m_field_x_coefficients.resize(size);
+        m_field_y_coefficients.resize(size);
+        auto scale = 4.0 / static_cast<double>(size);
+        util::parallel_for(0, width, [&](std::size_t u){
+            auto w_u = pi * u / (width * bin_width);
+            for(std::size_t v = 0; v < height; ++v)
+            {
+                auto index = u * height + v;
+                auto w_v = pi * v / (height * bin_height);
+                auto w2 = w_u * w_u + w_v * w_v;
+                auto a = w2 > 0.0 ? scale * m_coefficients[index] / w2 : 0.0;
+                m_potential_coefficients[index] = a;
+                m_field_x_coefficients[index] = a * w_u;
+                m_field_y_coefficients[index] = a * w_v;
+            }
+        }, m_number_of_threads, 8);
+
+        // inverse transforms along y, then along x after transposing back to [y][x]
+        util::parallel_for(0, width, [&](std::size_t u, std::size_t thread){
+            auto & workspace = m_workspaces[thread];
+            m_y_transform.idct(&m_potential_coefficients[u * height], workspace);
+            m_y_transform.idct(&m_field_x_coefficients[u * height], workspace);
+            m_y_transform.idxst(&m_field_y_coefficients[u * height], workspace);
+        }, m_number_of_threads, 8);
+
+        m_potential.resize(size);
+        m_field_x.resize(size);
+        m_field_y.resize(size);
+        transpose(m_potential_coefficients, m_potential, width, height);
+        transpose(m_field_x_coefficients, m_field_x, width, height);
+        transpose(m_field_y_coefficients, m_field_y, width, height);
+        util::parallel_for(0, height, [&](std::size_t y, std::size_t thread){
+            auto & workspace = m_workspaces[thread];
+            m_x_transform.idct(&m_potential[y * width], workspace);
+            m_x_transform.idxst(&m_field_x[y * width], workspace);
+            m_x_transform.idct(&m_field_y[y * width], workspace);
+        }, m_number_of_threads, 8);
+
+        m_energy = 0.0;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            m_energy += m_density[i] * m_potential[i];
+        }
+        m_energy *= 0.5 * bin_width * bin_height;
+
+        // cell gradients, the field of each bin weighted by its overlap with the cell
+        auto origin = m_density_map.box(0, 0).min_corner();
+        auto x0 = units::unit_cast<double>(origin.x());
+        auto y0 = units::unit_cast<double>(origin.y());
+        auto cells = std::vector<cell_type>(m_netlist.begin_cell_instance(), m_netlist.end_cell_instance());
+        util::parallel_for(0, cells.size(), [&](std::size_t i){
+            auto gradient = Gradient{};
+            if(!m_placement.fixed(cells[i]))
+            {
+                for(const auto & box : m_placement.geometry(cells[i]))
+                {
+                    auto x_low = units::unit_cast<double>(box.min_corner().x()) - x0;
+                    auto x_high = units::unit_cast<double>(box.max_corner().x()) - x0;
+                    auto y_low = units::unit_cast<double>(box.min_corner().y()) - y0;
+                    auto y_high = units::unit_cast<double>(box.max_corner().y()) - y0;
+                    auto first_x = static_cast<std::size_t>(std::clamp(std::floor(x_low / bin_width), 0.0, static_cast<double>(width)));
+                    auto last_x = static_cast<std::size_t>(std::clamp(std::ceil(x_high / bin_width), 0.0, static_cast<double>(width)));
+                    auto first_y = static_cast<std::size_t>(std::clamp(std::floor(y_low / bin_height), 0.0, static_cast<double>(height)));
+                    auto last_y = static_cast<std::size_t>(std::clamp(std::ceil(y_high / bin_height), 0.0, static_cast<double>(height)));
+                    for(auto y = first_y; y < last_y; ++y)
+                    {
+                        auto overlap_y = std::min(y_high, (y + 1) * bin_height) - std::max(y_low, y * bin_height);
+                        for(auto x = first_x; x < last_x; ++x)
+                        {
+                            auto overlap = overlap_y * (std::min(x_high, (x + 1) * bin_width) - std::max(x_low, x * bin_width));
+                            if(overlap_y > 0.0 && overlap > 0.0)
+                            {
+                                gradient.x -= overlap * m_field_x[y * width + x];
+                                gradient.y -= overlap * m_field_y[y * width + x];
+                            }
+                        }
+                    }
+                }
+            }
+            m_gradients[cells[i]] = gradient;
+        }, m_number_of_threads, 1024);
+    }
+
+    void ElectrostaticDensity::transpose(const ElectrostaticDensity::grid_type & in, ElectrostaticDensity::grid_type & out, std::size_t rows, std::size_t columns) const
+    {
+        auto row_blocks = (rows + transpose_block - 1) / transpose_block;
+        util::parallel_for(0, row_blocks, [&](std::size_t block){
+            auto first_row = block * transpose_block;
+            auto last_row = std::min(rows, first_row + transpose_block);
+            for(std::size_t first_column = 0; first_column < columns; first_column += transpose_block)
+            {
+                auto last_column = std::min(columns, first_column + transpose_block);
+                for(auto r = first_row; r < last_row; ++r)
+                {
+                    for(auto c = first_column; c < last_column; ++c)
+                    {
+                        out[c * rows + r] = in[r * columns + c];
+                    }
+                }
+            }
+        }, m_number_of_threads);
+    }
+}
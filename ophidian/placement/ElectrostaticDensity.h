@@ -0,0 +1,134 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_ELECTROSTATIC_DENSITY_H
+#define OPHIDIAN_PLACEMENT_ELECTROSTATIC_DENSITY_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/placement/Placement.h>
+#include <ophidian/placement/DensityMap.h>
+#include <ophidian/placement/CosineTransform.h>
+
+namespace ophidian::placement
+{
+    //! Electrostatic density penalty
+
+    /*!
+       \brief Density model of ePlace: the cells are positive charges, the bin densities of a
+       DensityMap are the charge density rho and the potential psi solves the Poisson equation
+       laplacian(psi) = -rho with zero gradient on the chip boundary. The solution is a cosine
+       series whose coefficients are the 2D DCT of rho, so solving costs a forward transform and
+       the inverse transforms of the potential and of both field components. The 2D transforms
+       run the 1D ones over contiguous grid rows in parallel and transpose the grid between the
+       x and the y passes.
+
+       The density penalty is N = 1/2 sum_b rho_b psi_b A_b and its gradient with respect to the
+       position of a movable cell is minus the field integrated over the cell area, which points
+       away from the dense regions.
+     */
+    class ElectrostaticDensity
+    {
+    public:
+        using cell_type     = Placement::cell_type;
+        using grid_type     = std::vector<double>;
+
+        //! Gradient of the density penalty with respect to a cell position
+        struct Gradient
+        {
+            double x{0.0};
+            double y{0.0};
+        };
+
+        //! Density model parameters
+        struct Parameters
+        {
+            //! Weight of the fixed cell area in the charge density, ePlace sets it to the target density
+            double fixed_area_weight{1.0};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        ElectrostaticDensity() = delete;
+
+        ElectrostaticDensity(const ElectrostaticDensity &) = delete;
+        ElectrostaticDensity & operator=(const ElectrostaticDensity &) = delete;
+
+        //! Construct the solver for the grid of a density map
+        /*!
+           \param netlist Netlist owning the cells
+           \param placement Placement of the cells
+           \param density_map Bin densities, the grid size must not change afterwards
+           \param parameters Model parameters
+         */
+        ElectrostaticDensity(const circuit::Netlist & netlist, const Placement & placement, const DensityMap & density_map, const Parameters & parameters);
+
+        ElectrostaticDensity(const circuit::Netlist & netlist, const Placement & placement, const DensityMap & density_map);
+
+        //! Solve the potential of the current densities and update the cell gradients
+        void update();
+
+        // Element access
+
+        //! Density penalty of the last update
+        double energy() const noexcept;
+
+        //! Potential of every bin, row-major as the density map grids
+        const grid_type & potential() const noexcept;
+
+        //! x component of the electric field of every bin
+        const grid_type & field_x() const noexcept;
+
+        //! y component of the electric field of every bin
+        const grid_type & field_y() const noexcept;
+
+        //! Gradient of the density penalty of a cell, zero for fixed cells
+        const Gradient & gradient(const cell_type & cell) const;
+
+    private:
+        void transpose(const grid_type & in, grid_type & out, std::size_t rows, std::size_t columns) const;
+
+        const circuit::Netlist &    m_netlist;
+        const Placement &           m_placement;
+        const DensityMap &          m_density_map;
+        Parameters                  m_parameters;
+        std::size_t                 m_number_of_threads;
+
+        CosineTransform m_x_transform;
+        CosineTransform m_y_transform;
+        std::vector<CosineTransform::Workspace> m_workspaces;
+
+        grid_type m_density;
+        grid_type m_coefficients;
+        grid_type m_potential_coefficients;
+        grid_type m_field_x_coefficients;
+        grid_type m_field_y_coefficients;
+        grid_type m_potential;
+        grid_type m_field_x;
+        grid_type m_field_y;
+        double    m_energy{0.0};
+
+        entity_system::Property<cell_type, Gradient> m_gradients;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_ELECTROSTATIC_DENSITY_H
@@ -18,11 +18,86 @@
 
 #include "Library.h"
 
+#include <algorithm>
+
 namespace ophidian::placement
 {
+    namespace
+    {
+        using unit_type = Library::unit_type;
+        using point_type = geometry::CellGeometry::point_type;
+        using box_type = geometry::CellGeometry::box_type;
+
+        box_type bounds(const geometry::CellGeometry & geometry)
+        {
+            if(geometry.begin() == geometry.end())
+            {
+                return box_type{point_type{unit_type{0}, unit_type{0}}, point_type{unit_type{0}, unit_type{0}}};
+            }
+            auto result = geometry.front();
+            for(const auto & box : geometry)
+            {
+                result.min_corner().x(std::min(result.min_corner().x(), box.min_corner().x()));
+                result.min_corner().y(std::min(result.min_corner().y(), box.min_corner().y()));
+                result.max_corner().x(std::max(result.max_corner().x(), box.max_corner().x()));
+                result.max_corner().y(std::max(result.max_corner().y(), box.max_corner().y()));
+            }
+            return result;
+        }
+
+        // DEF orientations: rotations counterclockwise, F mirrors about the y axis first
+        point_type orient(const point_type & point, Orientation orientation, const box_type & bounds)
+        {
+            auto x = point.x() - bounds.min_corner().x();
+            auto y = point.y() - bounds.min_corner().y();
+            auto w = bounds.max_corner().x() - bounds.min_corner().x();
+            auto h = bounds.max_corner().y() - bounds.min_corner().y();
+            auto result = point_type{x, y};
+            switch(orientation)
+            {
+            case Orientation::N:
+                break;
+            case Orientation::S:
+                result = point_type{w - x, h - y};
+                break;
+            case Orientation::W:
+                result = point_type{h - y, x};
+                break;
+            case Orientation::E:
+                result = point_type{y, w - x};
+                break;
+            case Orientation::FN:
+                result = point_type{w - x, y};
+                break;
+            case Orientation::FS:
+                result = point_type{x, h - y};
+                break;
+            case Orientation::FW:
+                result = point_type{h - y, w - x};
+                break;
+            case Orientation::FE:
+                result = point_type{y, x};
+                break;
+            }
+            return point_type{result.x() + bounds.min_corner().x(), result.y() + bounds.min_corner().y()};
+        }
+
+        box_type orient(const box_type & box, Orientation orientation, const box_type & bounds)
+        {
+            auto a = orient(box.min_corner(), orientation, bounds);
+            auto b = orient(box.max_corner(), orientation, bounds);
+            return box_type{
+                point_type{std::min(a.x(), b.x()), std::min(a.y(), b.y())},
+                point_type{std::max(a.x(), b.x()), std::max(a.y(), b.y())}
+            };
+        }
+    }
+
     Library::Library(const circuit::StandardCells & std_cells):
             m_geometries{std_cells.make_property_cell<Library::std_cell_geometry_type>()},
-            m_pin_offsets{std_cells.make_property_pin<Library::offset_type>()}
+            m_pin_offsets{std_cells.make_property_pin<Library::offset_type>()},
+            m_oriented_geometries{std_cells.make_property_cell<Library::oriented_geometries_type>()},
+            m_oriented_pin_offsets{std_cells.make_property_pin<Library::oriented_offsets_type>()}
     {}
 
     Library::std_cell_geometry_type& Library::geometry(const Library::std_cell_type& cell)
@@ -44,4 +119,57 @@ namespace ophidian::placement
     {
         return m_pin_offsets[pin];
     }
+
+    const Library::std_cell_geometry_type& Library::geometry(const Library::std_cell_type& cell, Library::orientation_type orientation) const
+    {
+        const auto & oriented = m_oriented_geometries[cell];
+        if(orientation == Orientation::N || oriented.empty())
+        {
+            return m_geometries[cell];
+        }
+        return oriented[static_cast<std::size_t>(orientation) - 1];
+    }
+
+    const Library::offset_type& Library::offset(const Library::std_cell_pin_type& pin, Library::orientation_type orientation) const
+    {
+        const auto & oriented = m_oriented_pin_offsets[pin];
+        if(orientation == Orientation::N || oriented.empty())
+        {
+            return m_pin_offsets[pin];
+        }
+        return oriented[static_cast<std::size_t>(orientation) - 1];
+    }
+
+    // Modifiers
+    void Library::update_orientations(const circuit::StandardCells & std_cells)
+    {
+        for(auto cell : std_cells.range_cell())
+        {
+            const auto & geometry = m_geometries[cell];
+            auto cell_bounds = bounds(geometry);
+            auto & oriented = m_oriented_geometries[cell];
+            oriented.resize(number_of_orientations);
+            for(std::size_t i = 0; i < number_of_orientations; ++i)
+            {
+                auto orientation = static_cast<Orientation>(i + 1);
+                auto boxes = std_cell_geometry_type::box_container_type{};
+                for(const auto & box : geometry)
+                {
+                    boxes.push_back(orient(box, orientation, cell_bounds));
+                }
+                oriented[i] = std_cell_geometry_type{std::move(boxes)};
+            }
+
+            for(auto pin : std_cells.pins(cell))
+            {
+                const auto & offset = m_pin_offsets[pin];
+                auto & oriented_offsets = m_oriented_pin_offsets[pin];
+                oriented_offsets.resize(number_of_orientations);
+                for(std::size_t i = 0; i < number_of_orientations; ++i)
+                {
+                    oriented_offsets[i] = orient(offset, static_cast<Orientation>(i + 1), cell_bounds);
+                }
+            }
+        }
+    }
 }
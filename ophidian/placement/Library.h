@@ -24,9 +24,23 @@
 #include <ophidian/geometry/CellGeometry.h>
 #include <ophidian/util/Units.h>
 #include <ophidian/circuit/StandardCells.h>
+#include <vector>
 
 namespace ophidian::placement
 {
+    //! Orientation of a placed cell, in the order of the DEF orientations
+    enum class Orientation : int {
+        N, S, W, E, FN, FS, FW, FE
+    };
+
+    //! Geometries and pin offsets of the standard cells
+
+    /*!
+       \brief Cells are described in the N orientation. update_orientations() precomputes the
+       seven other orientations of every cell geometry and pin offset, rotated or mirrored about
+       the bounding box of the cell and moved back to its lower left corner, as DEF places them,
+       so oriented queries are a table lookup.
+     */
     class Library
     {
     public:
@@ -40,6 +54,8 @@ namespace ophidian::placement
 
         using std_cell_geometry_type = geometry::CellGeometry;
 
+        using orientation_type = Orientation;
+
         // Constructors
         Library() = delete;
 
@@ -58,15 +74,42 @@ namespace ophidian::placement
         offset_type& offset(const std_cell_pin_type& pin);
         const offset_type& offset(const std_cell_pin_type& pin) const;
 
+        //! Geometry of a cell placed with an orientation
+        /*!
+           \brief Built by update_orientations(), the N geometry until then.
+         */
+        const std_cell_geometry_type& geometry(const std_cell_type& cell, orientation_type orientation) const;
+
+        //! Offset of a pin of a cell placed with an orientation
+        /*!
+           \brief Built by update_orientations(), the N offset until then.
+         */
+        const offset_type& offset(const std_cell_pin_type& pin, orientation_type orientation) const;
+
         // Iterators
 
         // Capacity
 
         // Modifiers
 
+        //! Precompute the oriented geometries and pin offsets
+        /*!
+           \brief Must be called again after changing a geometry or an offset.
+           \param std_cells Standard cells owning the pins
+         */
+        void update_orientations(const circuit::StandardCells & std_cells);
+
     private:
+        // every orientation but N
+        static constexpr std::size_t number_of_orientations = 7;
+
+        using oriented_geometries_type = std::vector<std_cell_geometry_type>;
+        using oriented_offsets_type = std::vector<offset_type>;
+
         entity_system::Property<std_cell_type, std_cell_geometry_type> m_geometries;
         entity_system::Property<std_cell_pin_type, offset_type>        m_pin_offsets;
+        entity_system::Property<std_cell_type, oriented_geometries_type> m_oriented_geometries;
+        entity_system::Property<std_cell_pin_type, oriented_offsets_type> m_oriented_pin_offsets;
     };
 }
 
@@ -55,5 +55,6 @@ namespace ophidian::placement::factory
                 }
             }
         }
+        library.update_orientations(stdCells);
     }
 }
@@ -18,6 +18,9 @@
 
 #include "Placement.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace ophidian::placement
 {
     Placement::Placement(const circuit::Netlist & netlist, const Library &library):
@@ -25,8 +28,10 @@ namespace ophidian::placement
             m_library(library),
             m_cell_locations(netlist.make_property_cell_instance<util::LocationDbu>()),
             m_cell_fixed(netlist.make_property_cell_instance<bool>()),
+            m_cell_orientations(netlist.make_property_cell_instance<orientation_type>()),
             m_input_pad_locations(netlist.make_property_input_pad<util::LocationDbu>()),
-            m_output_pad_locations(netlist.make_property_output_pad<util::LocationDbu>())
+            m_output_pad_locations(netlist.make_property_output_pad<util::LocationDbu>()),
+            m_undo_index(netlist.make_property_cell_instance<std::uint32_t>())
     {
     }
 
@@ -41,7 +46,7 @@ namespace ophidian::placement
         auto stdCellPin = m_netlist.std_cell_pin(pin);
         auto pinOwner = m_netlist.cell(pin);
         auto cell_location = location(pinOwner);
-        auto pinOffset = m_library.offset(stdCellPin);
+        auto pinOffset = m_library.offset(stdCellPin, m_cell_orientations[pinOwner]);
 
         auto pin_location = Placement::point_type{
             cell_location.x() + pinOffset.x(),
@@ -65,7 +70,7 @@ namespace ophidian::placement
     Placement::cell_geometry_type Placement::geometry(const Placement::cell_type& cell) const
     {
         auto stdCell = m_netlist.std_cell(cell);
-        auto stdCellGeometry = m_library.geometry(stdCell);
+        const auto & stdCellGeometry = m_library.geometry(stdCell, m_cell_orientations[cell]);
         auto cell_location = location(cell);
 
         auto cellGeometry = geometry::translate(stdCellGeometry, cell_location);
@@ -78,10 +83,30 @@ namespace ophidian::placement
         return m_cell_fixed[cell];
     }
 
+    Placement::orientation_type Placement::orientation(const Placement::cell_type& cell) const
+    {
+        return m_cell_orientations[cell];
+    }
+
     // Modifiers
     void Placement::place(const Placement::cell_type& cell, const Placement::point_type& location)
     {
+        if(m_in_transaction)
+        {
+            record(cell);
+            m_cell_locations[cell] = location;
+            return;
+        }
+
+        if(m_listeners.empty())
+        {
+            m_cell_locations[cell] = location;
+            return;
+        }
+
+        m_batch.assign(1, Move{cell, m_cell_locations[cell], location});
         m_cell_locations[cell] = location;
+        notify(m_batch);
     }
 
     void Placement::place(const Placement::input_pad_type& input, const Placement::point_type & location)
@@ -96,6 +121,249 @@ namespace ophidian::placement
 
     void Placement::fix(const Placement::cell_type& cell, bool fixed)
     {
+        if(m_in_transaction)
+        {
+            record(cell);
+            m_cell_fixed[cell] = fixed;
+            return;
+        }
+        if(m_listeners.empty() || m_cell_fixed[cell] == fixed)
+        {
+            m_cell_fixed[cell] = fixed;
+            return;
+        }
+
         m_cell_fixed[cell] = fixed;
+        for(auto listener : m_listeners)
+        {
+            listener->fixed(cell);
+        }
+    }
+
+    void Placement::orient(const Placement::cell_type& cell, Placement::orientation_type orientation)
+    {
+        if(m_in_transaction)
+        {
+            record(cell);
+            m_cell_orientations[cell] = orientation;
+            return;
+        }
+        if(m_listeners.empty() || m_cell_orientations[cell] == orientation)
+        {
+            m_cell_orientations[cell] = orientation;
+            return;
+        }
+
+        m_cell_orientations[cell] = orientation;
+        for(auto listener : m_listeners)
+        {
+            listener->oriented(cell);
+        }
+    }
+
+    // Listeners
+    void Placement::add_listener(Placement::Listener & listener)
+    {
+        m_listeners.push_back(&listener);
+    }
+
+    void Placement::remove_listener(Placement::Listener & listener)
+    {
+        m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), &listener), m_listeners.end());
+    }
+
+    Placement::Subscription::Subscription(Placement & placement, Placement::Listener & listener):
+        m_placement(placement),
+        m_listener(listener)
+    {
+    }
+
+    Placement::Subscription::~Subscription()
+    {
+        detach();
+    }
+
+    void Placement::Subscription::attach()
+    {
+        if(!m_attached)
+        {
+            m_placement.add_listener(m_listener);
+            m_attached = true;
+        }
+    }
+
+    void Placement::Subscription::detach()
+    {
+        if(m_attached)
+        {
+            m_placement.remove_listener(m_listener);
+            m_attached = false;
+        }
+    }
+
+    bool Placement::Subscription::attached() const noexcept
+    {
+        return m_attached;
+    }
+
+    double Placement::Subscription::rebuild_fraction() const noexcept
+    {
+        return m_rebuild_fraction;
+    }
+
+    void Placement::Subscription::rebuild_fraction(double fraction) noexcept
+    {
+        m_rebuild_fraction = fraction;
+    }
+
+    bool Placement::Subscription::rebuild(const Placement::move_container_type & moves) const noexcept
+    {
+        return moves.size() > m_rebuild_fraction * m_placement.m_netlist.size_cell_instance();
+    }
+
+    // Transactions
+    void Placement::begin()
+    {
+        m_in_transaction = true;
+    }
+
+    void Placement::flush()
+    {
+        m_batch.clear();
+        for(auto index : m_pending)
+        {
+            auto & entry = m_undo_log[index];
+            const auto & location = m_cell_locations[entry.cell];
+            entry.pending = false;
+            if(location.x() != entry.delivered.x() || location.y() != entry.delivered.y())
+            {
+                m_batch.push_back(Move{entry.cell, entry.delivered, location});
+                entry.delivered = location;
+            }
+        }
+        notify(m_batch);
+
+        // the other changes follow the moves, so listeners see them on up to date locations
+        for(auto index : m_pending)
+        {
+            auto & entry = m_undo_log[index];
+            notify(entry, m_cell_fixed[entry.cell], m_cell_orientations[entry.cell]);
+        }
+        m_pending.clear();
+    }
+
+    void Placement::commit()
+    {
+        if(!m_in_transaction)
+        {
+            return;
+        }
+
+        flush();
+        for(const auto & entry : m_undo_log)
+        {
+            m_undo_index[entry.cell] = 0;
+        }
+        m_undo_log.clear();
+        m_in_transaction = false;
+    }
+
+    void Placement::rollback()
+    {
+        if(!m_in_transaction)
+        {
+            return;
+        }
+
+        // only what was flushed has to be undone by the listeners
+        m_batch.clear();
+        auto log = std::move(m_undo_log);
+        m_undo_log.clear();
+        m_pending.clear();
+        m_in_transaction = false;
+        for(const auto & entry : log)
+        {
+            m_cell_locations[entry.cell] = entry.original;
+            m_cell_fixed[entry.cell] = entry.fixed;
+            m_cell_orientations[entry.cell] = entry.orientation;
+            m_undo_index[entry.cell] = 0;
+            if(entry.original.x() != entry.delivered.x() || entry.original.y() != entry.delivered.y())
+            {
+                m_batch.push_back(Move{entry.cell, entry.delivered, entry.original});
+            }
+        }
+        notify(m_batch);
+        for(auto & entry : log)
+        {
+            notify(entry, entry.fixed, entry.orientation);
+        }
+        if(m_undo_log.empty())
+        {
+            // keep the capacity for the next transaction
+            log.clear();
+            m_undo_log.swap(log);
+        }
+    }
+
+    bool Placement::in_transaction() const noexcept
+    {
+        return m_in_transaction;
+    }
+
+    Placement::UndoEntry & Placement::undo_entry(const Placement::cell_type & cell)
+    {
+        // the undo log keeps one entry per cell, indexed from one
+        auto & index = m_undo_index[cell];
+        if(index == 0)
+        {
+            const auto & location = m_cell_locations[cell];
+            const auto fixed = static_cast<bool>(m_cell_fixed[cell]);
+            const auto orientation = m_cell_orientations[cell];
+            m_undo_log.push_back(UndoEntry{cell, location, location, false, fixed, orientation, fixed, orientation});
+            index = static_cast<std::uint32_t>(m_undo_log.size());
+        }
+        return m_undo_log[index - 1];
+    }
+
+    void Placement::record(const Placement::cell_type & cell)
+    {
+        auto & entry = undo_entry(cell);
+        if(!entry.pending)
+        {
+            entry.pending = true;
+            m_pending.push_back(static_cast<std::uint32_t>(m_undo_index[cell] - 1));
+        }
+    }
+
+    void Placement::notify(Placement::UndoEntry & entry, bool fixed, Placement::orientation_type orientation)
+    {
+        if(fixed != entry.delivered_fixed)
+        {
+            entry.delivered_fixed = fixed;
+            for(auto listener : m_listeners)
+            {
+                listener->fixed(entry.cell);
+            }
+        }
+        if(orientation != entry.delivered_orientation)
+        {
+            entry.delivered_orientation = orientation;
+            for(auto listener : m_listeners)
+            {
+                listener->oriented(entry.cell);
+            }
+        }
+    }
+
+    void Placement::notify(const Placement::move_container_type & moves)
+    {
+        if(moves.empty())
+        {
+            return;
+        }
+        for(auto listener : m_listeners)
+        {
+            listener->moved(moves);
+        }
     }
 }
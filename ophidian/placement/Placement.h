@@ -26,9 +26,27 @@
 #include <ophidian/circuit/Netlist.h>
 #include <ophidian/placement/Library.h>
 #include <ophidian/geometry/CellGeometry.h>
+#include <cstdint>
+#include <vector>
 
 namespace ophidian::placement
 {
+    //! Locations of the cells and pads
+
+    /*!
+       \brief Listeners are told about the cell moves in batches of Move events. Outside a
+       transaction every place() is a batch of one. Between begin() and commit() or rollback()
+       the moves are only recorded, in an undo log holding the first location of every moved
+       cell, and flush() delivers them, one event per cell from the location its listeners saw
+       last, so engines can evaluate a tentative set of moves. commit() delivers the remaining
+       moves and rollback() puts the cells back, delivering the reverse of what was flushed.
+       Outside a transaction fixed state and orientation changes are told right away. Inside one
+       they are recorded with the moves: flush() and rollback() deliver the batch of moves first
+       and then the fixed and oriented events, so listeners always see them on current locations.
+       Without listeners and outside a transaction place(), fix() and orient() only write the
+       property. The pin locations and the geometry of a cell follow its orientation through the
+       oriented tables of the Library, which must be up to date.
+     */
     class Placement
     {
     public:
@@ -46,6 +64,80 @@ namespace ophidian::placement
 
         using cell_geometry_type = geometry::CellGeometry;
 
+        using orientation_type = Library::orientation_type;
+
+        //! Move of a cell
+        struct Move
+        {
+            cell_type cell;
+            point_type from;
+            point_type to;
+        };
+
+        using move_container_type = std::vector<Move>;
+
+        //! Receives the moves of the cells
+        class Listener
+        {
+        public:
+            virtual ~Listener() = default;
+
+            //! Cells moved, each cell at most once per batch
+            virtual void moved(const move_container_type & moves) = 0;
+
+            //! A cell was fixed or released, told after the moves of the same flush() or rollback()
+            virtual void fixed(const cell_type &)
+            {
+            }
+
+            //! The orientation of a cell changed, told after the moves of the same flush() or rollback()
+            virtual void oriented(const cell_type &)
+            {
+            }
+        };
+
+        //! Subscription of a listener to the placement
+
+        /*!
+           \brief Base of the classes that may follow a placement: attach() registers their
+           listener, detach() and the destructor remove it. Followers keeping a per cell state
+           update the moved cells one by one, unless rebuild() tells them a batch moved so many
+           cells that building the state again is cheaper.
+         */
+        class Subscription
+        {
+        public:
+            Subscription(const Subscription &) = delete;
+            Subscription & operator=(const Subscription &) = delete;
+
+            //! Follow the changes of the placement, does nothing when already attached
+            void attach();
+
+            //! Stop following the placement
+            void detach();
+
+            bool attached() const noexcept;
+
+            //! Fraction of the cells a batch must move for rebuild() to hold, an eighth by default
+            double rebuild_fraction() const noexcept;
+
+            void rebuild_fraction(double fraction) noexcept;
+
+        protected:
+            Subscription(Placement & placement, Listener & listener);
+
+            ~Subscription();
+
+            //! True when a batch moves more than rebuild_fraction() of the cells
+            bool rebuild(const move_container_type & moves) const noexcept;
+
+        private:
+            Placement &         m_placement;
+            Listener &          m_listener;
+            double              m_rebuild_fraction{0.125};
+            bool                m_attached{false};
+        };
+
         // Constructors
         Placement() = delete;
 
@@ -70,6 +162,8 @@ namespace ophidian::placement
 
         bool fixed(const cell_type& cell) const;
 
+        orientation_type orientation(const cell_type& cell) const;
+
         // Iterators
 
         // Capacity
@@ -83,14 +177,67 @@ namespace ophidian::placement
 
         void fix(const cell_type& cell, bool fixed);
 
+        void orient(const cell_type& cell, orientation_type orientation);
+
+        // Listeners
+        void add_listener(Listener & listener);
+
+        void remove_listener(Listener & listener);
+
+        // Transactions
+        //! Start recording the cell changes, does nothing inside a transaction
+        void begin();
+
+        //! Deliver the moves recorded since begin() or the last flush() to the listeners
+        void flush();
+
+        //! Deliver the remaining moves and end the transaction
+        void commit();
+
+        //! Put every cell back to its location, fixed state and orientation at begin() and end the transaction
+        void rollback();
+
+        bool in_transaction() const noexcept;
+
     private:
+        //! State of a cell changed in the transaction at begin() and the last state delivered
+        struct UndoEntry
+        {
+            cell_type cell;
+            point_type original;
+            point_type delivered;
+            bool pending;
+            bool fixed;
+            orientation_type orientation;
+            bool delivered_fixed;
+            orientation_type delivered_orientation;
+        };
+
+        UndoEntry & undo_entry(const cell_type & cell);
+
+        //! Log a change of a cell in the transaction, to be delivered by the next flush()
+        void record(const cell_type & cell);
+
+        void notify(const move_container_type & moves);
+
+        //! Tell the fixed state and orientation of an entry that differ from what was delivered
+        void notify(UndoEntry & entry, bool fixed, orientation_type orientation);
+
         const circuit::Netlist & m_netlist;
         const Library & m_library;
 
         entity_system::Property<cell_type, point_type>   m_cell_locations;
         entity_system::Property<cell_type, bool> m_cell_fixed;
+        entity_system::Property<cell_type, orientation_type> m_cell_orientations;
         entity_system::Property<input_pad_type, point_type>  m_input_pad_locations;
         entity_system::Property<output_pad_type, point_type> m_output_pad_locations;
+
+        std::vector<Listener *> m_listeners;
+        bool m_in_transaction{false};
+        std::vector<UndoEntry> m_undo_log;
+        std::vector<std::uint32_t> m_pending;
+        entity_system::Property<cell_type, std::uint32_t> m_undo_index;
+        move_container_type m_batch;
     };
 }
 
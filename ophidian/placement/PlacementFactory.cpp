@@ -27,6 +27,8 @@ namespace ophidian::placement::factory
             auto cell = netlist.find_cell_instance(component.name());
             placement.place(cell, component.position());
             placement.fix(cell, component.fixed());
+            // both enumerations follow the DEF order
+            placement.orient(cell, static_cast<Placement::orientation_type>(component.orientation()));
         }
     }
 }
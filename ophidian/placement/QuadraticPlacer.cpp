@@ -0,0 +1,449 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "QuadraticPlacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::placement
+{
+    namespace
+    {
+        // damping of the bin boundary shifts, from FastPlace
+        constexpr double shift_damping = 1.5;
+
+        // weight pulling every cell to its current position, relative to the mean net weight,
+        // keeps the systems positive definite when cells are not connected to fixed pins
+        constexpr double regularization = 1e-6;
+    }
+
+    QuadraticPlacer::QuadraticPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, const QuadraticPlacer::Parameters & parameters):
+        m_netlist(netlist),
+        m_floorplan(floorplan),
+        m_placement(placement),
+        m_parameters(parameters)
+    {
+    }
+
+    QuadraticPlacer::QuadraticPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement):
+        QuadraticPlacer(netlist, floorplan, placement, Parameters{})
+    {
+    }
+
+    QuadraticPlacer::Statistics QuadraticPlacer::place()
+    {
+        load();
+
+        auto statistics = Statistics{};
+        if(m_cells.empty())
+        {
+            statistics.wirelength = wirelength();
+            return statistics;
+        }
+
+        for(std::size_t i = 0; i < std::max<std::size_t>(1, m_parameters.initial_iterations); ++i)
+        {
+            solve(0.0);
+        }
+        auto anchor_weight = m_parameters.anchor_weight;
+        while(statistics.iterations < m_parameters.max_iterations && overflow() > m_parameters.target_overflow)
+        {
+            spread();
+            solve(anchor_weight);
+            anchor_weight *= m_parameters.anchor_growth;
+            ++statistics.iterations;
+        }
+
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            m_placement.place(m_cells[i], point_type{unit_type{m_x.positions[i]}, unit_type{m_y.positions[i]}});
+        }
+
+        statistics.wirelength = wirelength();
+        statistics.overflow = overflow();
+        return statistics;
+    }
+
+    void QuadraticPlacer::load()
+    {
+        m_x_low = units::unit_cast<double>(m_floorplan.chip_origin().x());
+        m_y_low = units::unit_cast<double>(m_floorplan.chip_origin().y());
+        m_x_high = units::unit_cast<double>(m_floorplan.chip_upper_right_corner().x());
+        m_y_high = units::unit_cast<double>(m_floorplan.chip_upper_right_corner().y());
+
+        m_cells.clear();
+        m_widths.clear();
+        m_heights.clear();
+        m_x.positions.clear();
+        m_y.positions.clear();
+        auto index = m_netlist.make_property_cell_instance<std::size_t>();
+        for(auto it = m_netlist.begin_cell_instance(); it != m_netlist.end_cell_instance(); ++it)
+        {
+            auto cell = *it;
+            index[cell] = fixed_pin;
+            if(m_placement.fixed(cell))
+            {
+                continue;
+            }
+
+            auto location = m_placement.location(cell);
+            auto x = units::unit_cast<double>(location.x());
+            auto y = units::unit_cast<double>(location.y());
+            auto width = 0.0;
+            auto height = 0.0;
+            for(const auto & box : m_placement.geometry(cell))
+            {
+                width = std::max(width, units::unit_cast<double>(box.max_corner().x()) - x);
+                height = std::max(height, units::unit_cast<double>(box.max_corner().y()) - y);
+            }
+
+            index[cell] = m_cells.size();
+            m_cells.push_back(cell);
+            m_widths.push_back(width);
+            m_heights.push_back(height);
+            m_x.positions.push_back(x);
+            m_y.positions.push_back(y);
+        }
+
+        // pins of movable cells keep their offset, the other ones their position
+        m_pins.clear();
+        m_net_begins.assign(1, 0);
+        for(auto net = m_netlist.begin_net(); net != m_netlist.end_net(); ++net)
+        {
+            auto first = m_pins.size();
+            for(auto pin : m_netlist.pins(*net))
+            {
+                auto cell = m_netlist.cell(pin);
+                if(cell != circuit::CellInstance{})
+                {
+                    auto location = m_placement.location(pin);
+                    auto x = units::unit_cast<double>(location.x());
+                    auto y = units::unit_cast<double>(location.y());
+                    auto i = index[cell];
+                    if(i != fixed_pin)
+                    {
+                        x -= m_x.positions[i];
+                        y -= m_y.positions[i];
+                    }
+                    m_pins.push_back(Pin{i, x, y});
+                }
+                else if(m_netlist.input(pin) != circuit::Input{})
+                {
+                    auto location = m_placement.location(m_netlist.input(pin));
+                    m_pins.push_back(Pin{fixed_pin, units::unit_cast<double>(location.x()), units::unit_cast<double>(location.y())});
+                }
+                else if(m_netlist.output(pin) != circuit::Output{})
+                {
+                    auto location = m_placement.location(m_netlist.output(pin));
+                    m_pins.push_back(Pin{fixed_pin, units::unit_cast<double>(location.x()), units::unit_cast<double>(location.y())});
+                }
+            }
+            if(m_pins.size() - first < 2)
+            {
+                m_pins.resize(first);
+                continue;
+            }
+            m_net_begins.push_back(m_pins.size());
+        }
+
+        m_bins = m_parameters.bins > 0 ? m_parameters.bins : static_cast<std::size_t>(std::ceil(std::sqrt(m_cells.size() / 4.0)));
+        m_bins = std::max<std::size_t>(1, m_bins);
+
+        for(auto dimension : {&m_x, &m_y})
+        {
+            dimension->matrix = SparseMatrix{m_cells.size()};
+            dimension->targets = dimension->positions;
+            dimension->solver = ConjugateGradient{ConjugateGradient::Parameters{
+                m_parameters.tolerance,
+                m_parameters.max_solver_iterations,
+                m_parameters.number_of_threads
+            }};
+        }
+    }
+
+    void QuadraticPlacer::assemble(QuadraticPlacer::Dimension & dimension, bool x, double anchor_weight)
+    {
+        auto & matrix = dimension.matrix;
+        auto & rhs = dimension.rhs;
+        const auto & positions = dimension.positions;
+        auto offset = [&](const Pin & pin){
+            return x ? pin.x : pin.y;
+        };
+        auto coordinate = [&](const Pin & pin){
+            return pin.cell == fixed_pin ? offset(pin) : positions[pin.cell] + offset(pin);
+        };
+
+        // the pattern is extended with the cell pairs it misses and the values assembled again
+        for(auto pass = 0; pass < 2; ++pass)
+        {
+            matrix.clear_values();
+            rhs.assign(m_cells.size(), 0.0);
+            dimension.missing.clear();
+
+            auto connect = [&](const Pin & a, const Pin & b, double weight){
+                if(a.cell == fixed_pin && b.cell == fixed_pin)
+                {
+                    return;
+                }
+                if(a.cell == fixed_pin || b.cell == fixed_pin)
+                {
+                    const auto & movable = a.cell == fixed_pin ? b : a;
+                    const auto & fixed = a.cell == fixed_pin ? a : b;
+                    matrix.add(movable.cell, movable.cell, weight);
+                    rhs[movable.cell] += weight * (offset(fixed) - offset(movable));
+                    return;
+                }
+                if(a.cell == b.cell)
+                {
+                    return;
+                }
+                matrix.add(a.cell, a.cell, weight);
+                matrix.add(b.cell, b.cell, weight);
+                if(matrix.contains(a.cell, b.cell))
+                {
+                    matrix.add(a.cell, b.cell, -weight);
+                    matrix.add(b.cell, a.cell, -weight);
+                }
+                else
+                {
+                    dimension.missing.emplace_back(a.cell, b.cell);
+                    dimension.missing.emplace_back(b.cell, a.cell);
+                }
+                auto difference = offset(a) - offset(b);
+                rhs[a.cell] -= weight * difference;
+                rhs[b.cell] += weight * difference;
+            };
+
+            // bound-to-bound model
+            for(std::size_t net = 0; net + 1 < m_net_begins.size(); ++net)
+            {
+                auto first = m_net_begins[net];
+                auto last = m_net_begins[net + 1];
+                auto low = first;
+                auto high = first;
+                for(auto i = first; i < last; ++i)
+                {
+                    if(coordinate(m_pins[i]) < coordinate(m_pins[low]))
+                    {
+                        low = i;
+                    }
+                    if(coordinate(m_pins[i]) > coordinate(m_pins[high]))
+                    {
+                        high = i;
+                    }
+                }
+                if(low == high)
+                {
+                    high = low == first ? first + 1 : first;
+                }
+
+                auto weight = 2.0 / (last - first - 1);
+                auto link = [&](std::size_t i, std::size_t bound){
+                    auto distance = std::max(std::abs(coordinate(m_pins[i]) - coordinate(m_pins[bound])), m_parameters.minimum_distance);
+                    connect(m_pins[i], m_pins[bound], weight / distance);
+                };
+                for(auto i = first; i < last; ++i)
+                {
+                    if(i != low)
+                    {
+                        link(i, low);
+                    }
+                    if(i != low && i != high)
+                    {
+                        link(i, high);
+                    }
+                }
+            }
+
+            if(dimension.missing.empty())
+            {
+                break;
+            }
+            matrix.extend_pattern(dimension.missing);
+        }
+
+        // anchors to the spread positions, and a weak one to the current position
+        auto mean = 0.0;
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            mean += matrix.diagonal(i);
+        }
+        mean = mean > 0.0 ? mean / m_cells.size() : 1.0;
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            auto anchor = anchor_weight * mean;
+            auto keep = regularization * mean;
+            matrix.add(i, i, anchor + keep);
+            rhs[i] += anchor * dimension.targets[i] + keep * positions[i];
+        }
+    }
+
+    void QuadraticPlacer::solve(double anchor_weight)
+    {
+        // the solvers are parallel, solving the axes concurrently would nest the thread pool
+        for(std::size_t d = 0; d < 2; ++d)
+        {
+            auto & dimension = d == 0 ? m_x : m_y;
+            assemble(dimension, d == 0, anchor_weight);
+            dimension.solver.solve(dimension.matrix, dimension.rhs, dimension.positions);
+
+            auto low = d == 0 ? m_x_low : m_y_low;
+            auto high = d == 0 ? m_x_high : m_y_high;
+            const auto & sizes = d == 0 ? m_widths : m_heights;
+            for(std::size_t i = 0; i < m_cells.size(); ++i)
+            {
+                dimension.positions[i] = std::clamp(dimension.positions[i], low, std::max(low, high - sizes[i]));
+            }
+        }
+    }
+
+    void QuadraticPlacer::spread()
+    {
+        auto bins = m_bins;
+        auto bin_width = (m_x_high - m_x_low) / bins;
+        auto bin_height = (m_y_high - m_y_low) / bins;
+        auto capacity = bin_width * bin_height * m_parameters.target_density;
+
+        auto column_of = [&](double x){
+            return static_cast<std::size_t>(std::clamp(std::floor((x - m_x_low) / bin_width), 0.0, static_cast<double>(bins - 1)));
+        };
+        auto row_of = [&](double y){
+            return static_cast<std::size_t>(std::clamp(std::floor((y - m_y_low) / bin_height), 0.0, static_cast<double>(bins - 1)));
+        };
+
+        // utilization of the bins holding the cell centers
+        auto utilization = std::vector<double>(bins * bins, 0.0);
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            auto column = column_of(m_x.positions[i] + m_widths[i] / 2);
+            auto row = row_of(m_y.positions[i] + m_heights[i] / 2);
+            utilization[row * bins + column] += m_widths[i] * m_heights[i] / capacity;
+        }
+
+        // shifted bin boundaries, rows for x and columns for y
+        auto x_boundaries = std::vector<double>(bins * (bins + 1));
+        auto y_boundaries = std::vector<double>(bins * (bins + 1));
+        util::parallel_for(0, bins, [&](std::size_t line){
+            auto * x_bounds = &x_boundaries[line * (bins + 1)];
+            auto * y_bounds = &y_boundaries[line * (bins + 1)];
+            x_bounds[0] = m_x_low;
+            x_bounds[bins] = m_x_high;
+            y_bounds[0] = m_y_low;
+            y_bounds[bins] = m_y_high;
+            for(std::size_t j = 1; j < bins; ++j)
+            {
+                auto left = utilization[line * bins + j - 1];
+                auto right = utilization[line * bins + j];
+                auto left_center = m_x_low + (j - 0.5) * bin_width;
+                x_bounds[j] = (left_center * (right + shift_damping) + (left_center + bin_width) * (left + shift_damping)) / (left + right + 2 * shift_damping);
+
+                auto below = utilization[(j - 1) * bins + line];
+                auto above = utilization[j * bins + line];
+                auto below_center = m_y_low + (j - 0.5) * bin_height;
+                y_bounds[j] = (below_center * (above + shift_damping) + (below_center + bin_height) * (below + shift_damping)) / (below + above + 2 * shift_damping);
+            }
+        }, m_parameters.number_of_threads);
+
+        util::parallel_for(0, m_cells.size(), [&](std::size_t i){
+            auto x = m_x.positions[i] + m_widths[i] / 2;
+            auto y = m_y.positions[i] + m_heights[i] / 2;
+            auto column = column_of(x);
+            auto row = row_of(y);
+
+            const auto * x_bounds = &x_boundaries[row * (bins + 1)];
+            auto x_old = m_x_low + column * bin_width;
+            auto x_new = x_bounds[column] + (x - x_old) * (x_bounds[column + 1] - x_bounds[column]) / bin_width;
+            m_x.targets[i] = std::clamp(x_new - m_widths[i] / 2, m_x_low, std::max(m_x_low, m_x_high - m_widths[i]));
+
+            const auto * y_bounds = &y_boundaries[column * (bins + 1)];
+            auto y_old = m_y_low + row * bin_height;
+            auto y_new = y_bounds[row] + (y - y_old) * (y_bounds[row + 1] - y_bounds[row]) / bin_height;
+            m_y.targets[i] = std::clamp(y_new - m_heights[i] / 2, m_y_low, std::max(m_y_low, m_y_high - m_heights[i]));
+        }, m_parameters.number_of_threads, 1024);
+    }
+
+    double QuadraticPlacer::overflow() const
+    {
+        auto bins = m_bins;
+        auto bin_width = (m_x_high - m_x_low) / bins;
+        auto bin_height = (m_y_high - m_y_low) / bins;
+        auto capacity = bin_width * bin_height * m_parameters.target_density;
+
+        auto area = std::vector<double>(bins * bins, 0.0);
+        auto total = 0.0;
+        for(std::size_t i = 0; i < m_cells.size(); ++i)
+        {
+            auto x_low = m_x.positions[i] - m_x_low;
+            auto y_low = m_y.positions[i] - m_y_low;
+            auto x_high = x_low + m_widths[i];
+            auto y_high = y_low + m_heights[i];
+            auto first_column = static_cast<std::size_t>(std::clamp(std::floor(x_low / bin_width), 0.0, static_cast<double>(bins)));
+            auto last_column = static_cast<std::size_t>(std::clamp(std::ceil(x_high / bin_width), 0.0, static_cast<double>(bins)));
+            auto first_row = static_cast<std::size_t>(std::clamp(std::floor(y_low / bin_height), 0.0, static_cast<double>(bins)));
+            auto last_row = static_cast<std::size_t>(std::clamp(std::ceil(y_high / bin_height), 0.0, static_cast<double>(bins)));
+            for(auto row = first_row; row < last_row; ++row)
+            {
+                auto overlap_y = std::min(y_high, (row + 1) * bin_height) - std::max(y_low, row * bin_height);
+                for(auto column = first_column; column < last_column; ++column)
+                {
+                    auto overlap_x = std::min(x_high, (column + 1) * bin_width) - std::max(x_low, column * bin_width);
+                    if(overlap_x > 0.0 && overlap_y > 0.0)
+                    {
+                        area[row * bins + column] += overlap_x * overlap_y;
+                    }
+                }
+            }
+            total += m_widths[i] * m_heights[i];
+        }
+
+        auto overflow = 0.0;
+        for(auto bin : area)
+        {
+            overflow += std::max(0.0, bin - capacity);
+        }
+        return total > 0.0 ? overflow / total : 0.0;
+    }
+
+    double QuadraticPlacer::wirelength() const
+    {
+        auto total = 0.0;
+        for(std::size_t net = 0; net + 1 < m_net_begins.size(); ++net)
+        {
+            auto x_low = std::numeric_limits<double>::max();
+            auto y_low = std::numeric_limits<double>::max();
+            auto x_high = std::numeric_limits<double>::lowest();
+            auto y_high = std::numeric_limits<double>::lowest();
+            for(auto i = m_net_begins[net]; i < m_net_begins[net + 1]; ++i)
+            {
+                const auto & pin = m_pins[i];
+                auto x = pin.cell == fixed_pin ? pin.x : m_x.positions[pin.cell] + pin.x;
+                auto y = pin.cell == fixed_pin ? pin.y : m_y.positions[pin.cell] + pin.y;
+                x_low = std::min(x_low, x);
+                y_low = std::min(y_low, y);
+                x_high = std::max(x_high, x);
+                y_high = std::max(y_high, y);
+            }
+            total += x_high - x_low + y_high - y_low;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_QUADRATIC_PLACER_H
+#define OPHIDIAN_PLACEMENT_QUADRATIC_PLACER_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/floorplan/Floorplan.h>
+#include <ophidian/placement/Placement.h>
+#include <ophidian/placement/SparseMatrix.h>
+
+namespace ophidian::placement
+{
+    //! Quadratic global placer
+
+    /*!
+       \brief Minimizes the quadratic wirelength of the bound-to-bound net model: in each
+       dimension the pins of a net are connected to the two extreme pins of the net, with
+       weights 2 / ((p - 1) |distance|) that make the quadratic length of the net equal its
+       half perimeter at the current positions. The x and y Laplacians are assembled into
+       compressed sparse row matrices whose patterns are only extended when a new pair of cells
+       appears, and the two systems are solved one after the other by preconditioned conjugate
+       gradient, whose products use every thread.
+
+       Spreading follows the cell shifting of FastPlace: the solution is binned, bin boundaries
+       move toward emptier neighbours row by row in x and column by column in y, and cells are
+       mapped linearly into their stretched bin. The shifted positions become anchors pulling
+       the cells, with a weight growing every iteration, until the bin overflow reaches the
+       target. Pads and fixed cells are fixed points; the result is written back through
+       Placement::place.
+     */
+    class QuadraticPlacer
+    {
+    public:
+        using unit_type     = util::database_unit_t;
+        using point_type    = util::LocationDbu;
+        using cell_type     = Placement::cell_type;
+
+        //! Placer parameters
+        struct Parameters
+        {
+            //! Number of wirelength only solves relinearizing the net model before spreading
+            std::size_t initial_iterations{8};
+            //! Maximum number of spreading iterations
+            std::size_t max_iterations{50};
+            //! Stop when the overflow of the spreading bins is below this fraction of the cell area
+            double target_overflow{0.1};
+            //! Target utilization of the spreading bins
+            double target_density{1.0};
+            //! Number of spreading bins along each axis, 0 to choose from the number of cells
+            std::size_t bins{0};
+            //! Anchor weight of the first spreading iteration, relative to the mean net weight
+            double anchor_weight{0.01};
+            //! Growth of the anchor weight between iterations
+            double anchor_growth{1.5};
+            //! Shortest distance used by the bound-to-bound weights, in dbu
+            double minimum_distance{1.0};
+            //! Conjugate gradient tolerance and iteration limit
+            double tolerance{1e-6};
+            std::size_t max_solver_iterations{1000};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        //! Result of a placement
+        struct Statistics
+        {
+            std::size_t iterations{0};
+            //! Half perimeter wirelength of the final solution, in dbu
+            double wirelength{0.0};
+            //! Overflow of the spreading bins of the final solution
+            double overflow{0.0};
+        };
+
+        // Constructors
+        QuadraticPlacer() = delete;
+
+        QuadraticPlacer(const QuadraticPlacer &) = delete;
+        QuadraticPlacer & operator=(const QuadraticPlacer &) = delete;
+
+        QuadraticPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement, const Parameters & parameters);
+
+        QuadraticPlacer(const circuit::Netlist & netlist, const floorplan::Floorplan & floorplan, Placement & placement);
+
+        //! Place every movable cell, starting from their current locations
+        Statistics place();
+
+    private:
+        //! Net pin, either on a movable cell or at a fixed position
+        struct Pin
+        {
+            std::size_t cell;
+            double x;
+            double y;
+        };
+
+        //! One of the two independent systems
+        struct Dimension
+        {
+            SparseMatrix matrix;
+            ConjugateGradient solver;
+            SparseMatrix::entry_container_type missing;
+            std::vector<double> rhs;
+            std::vector<double> positions;
+            std::vector<double> targets;
+        };
+
+        static constexpr std::size_t fixed_pin = static_cast<std::size_t>(-1);
+
+        void load();
+        void assemble(Dimension & dimension, bool x, double anchor_weight);
+        void solve(double anchor_weight);
+        void spread();
+        double overflow() const;
+        double wirelength() const;
+
+        const circuit::Netlist &    m_netlist;
+        const floorplan::Floorplan & m_floorplan;
+        Placement &                 m_placement;
+        Parameters                  m_parameters;
+
+        std::vector<cell_type>      m_cells;
+        std::vector<double>         m_widths;
+        std::vector<double>         m_heights;
+        std::vector<Pin>            m_pins;
+        std::vector<std::size_t>    m_net_begins;
+        double                      m_x_low{0.0};
+        double                      m_y_low{0.0};
+        double                      m_x_high{0.0};
+        double                      m_y_high{0.0};
+        std::size_t                 m_bins{1};
+
+        Dimension m_x;
+        Dimension m_y;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_QUADRATIC_PLACER_H
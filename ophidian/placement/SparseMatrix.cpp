@@ -0,0 +1,264 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::placement
+{
+    namespace
+    {
+        // rows of a parallel chunk, also the size of the chunks summed by dot products
+        constexpr std::size_t chunk = 4096;
+    }
+
+    SparseMatrix::SparseMatrix(SparseMatrix::index_type size):
+        m_size(size)
+    {
+        set_pattern({});
+    }
+
+    SparseMatrix::index_type SparseMatrix::size() const noexcept
+    {
+        return m_size;
+    }
+
+    SparseMatrix::index_type SparseMatrix::non_zeros() const noexcept
+    {
+        return m_columns.size();
+    }
+
+    bool SparseMatrix::contains(SparseMatrix::index_type row, SparseMatrix::index_type column) const
+    {
+        return position(row, column) != m_columns.size();
+    }
+
+    double SparseMatrix::value(SparseMatrix::index_type row, SparseMatrix::index_type column) const
+    {
+        auto index = position(row, column);
+        return index == m_columns.size() ? 0.0 : m_values[index];
+    }
+
+    double SparseMatrix::diagonal(SparseMatrix::index_type row) const
+    {
+        return m_values[m_diagonals[row]];
+    }
+
+    void SparseMatrix::multiply(const SparseMatrix::vector_type & x, SparseMatrix::vector_type & y, std::size_t number_of_threads) const
+    {
+        y.resize(m_size);
+        auto chunks = (m_size + chunk - 1) / chunk;
+        util::parallel_for(0, chunks, [&](std::size_t c){
+            auto last = std::min(m_size, (c + 1) * chunk);
+            for(auto row = c * chunk; row < last; ++row)
+            {
+                auto sum = 0.0;
+                for(auto i = m_row_begins[row]; i < m_row_begins[row + 1]; ++i)
+                {
+                    sum += m_values[i] * x[m_columns[i]];
+                }
+                y[row] = sum;
+            }
+        }, number_of_threads);
+    }
+
+    void SparseMatrix::set_pattern(const SparseMatrix::entry_container_type & entries)
+    {
+        m_row_begins.assign(m_size + 1, 0);
+        m_columns.clear();
+        extend_pattern(entries);
+    }
+
+    void SparseMatrix::extend_pattern(const SparseMatrix::entry_container_type & entries)
+    {
+        // counting sort of the old and new entries by row, then sort and unique each row
+        auto counts = std::vector<index_type>(m_size + 1, 0);
+        for(index_type row = 0; row < m_size; ++row)
+        {
+            counts[row + 1] += m_row_begins[row + 1] - m_row_begins[row] + 1;
+        }
+        for(const auto & entry : entries)
+        {
+            ++counts[entry.first + 1];
+        }
+        for(index_type row = 0; row < m_size; ++row)
+        {
+            counts[row + 1] += counts[row];
+        }
+
+        auto columns = std::vector<index_type>(counts[m_size]);
+        auto next = std::vector<index_type>(counts.begin(), counts.end() - 1);
+        for(index_type row = 0; row < m_size; ++row)
+        {
+            columns[next[row]++] = row;
+            for(auto i = m_row_begins[row]; i < m_row_begins[row + 1]; ++i)
+            {
+                columns[next[row]++] = m_columns[i];
+            }
+        }
+        for(const auto & entry : entries)
+        {
+            columns[next[entry.first]++] = entry.second;
+        }
+
+        m_columns.clear();
+        m_columns.reserve(columns.size());
+        m_diagonals.resize(m_size);
+        for(index_type row = 0; row < m_size; ++row)
+        {
+            auto first = columns.begin() + counts[row];
+            auto last = columns.begin() + counts[row + 1];
+            std::sort(first, last);
+            last = std::unique(first, last);
+            m_row_begins[row] = m_columns.size();
+            for(auto it = first; it != last; ++it)
+            {
+                if(*it == row)
+                {
+                    m_diagonals[row] = m_columns.size();
+                }
+                m_columns.push_back(*it);
+            }
+        }
+        m_row_begins[m_size] = m_columns.size();
+        m_values.assign(m_columns.size(), 0.0);
+    }
+
+    void SparseMatrix::clear_values()
+    {
+        std::fill(m_values.begin(), m_values.end(), 0.0);
+    }
+
+    void SparseMatrix::add(SparseMatrix::index_type row, SparseMatrix::index_type column, double value)
+    {
+        m_values[position(row, column)] += value;
+    }
+
+    SparseMatrix::index_type SparseMatrix::position(SparseMatrix::index_type row, SparseMatrix::index_type column) const
+    {
+        auto first = m_columns.begin() + m_row_begins[row];
+        auto last = m_columns.begin() + m_row_begins[row + 1];
+        auto it = std::lower_bound(first, last, column);
+        return it != last && *it == column ? static_cast<index_type>(it - m_columns.begin()) : m_columns.size();
+    }
+
+    ConjugateGradient::ConjugateGradient(const ConjugateGradient::Parameters & parameters):
+        m_parameters(parameters)
+    {
+    }
+
+    double ConjugateGradient::residual() const noexcept
+    {
+        return m_residual;
+    }
+
+    double ConjugateGradient::dot(const ConjugateGradient::vector_type & a, const ConjugateGradient::vector_type & b)
+    {
+        auto chunks = (a.size() + chunk - 1) / chunk;
+        m_partial_sums.assign(chunks, 0.0);
+        util::parallel_for(0, chunks, [&](std::size_t c){
+            auto last = std::min(a.size(), (c + 1) * chunk);
+            auto sum = 0.0;
+            for(auto i = c * chunk; i < last; ++i)
+            {
+                sum += a[i] * b[i];
+            }
+            m_partial_sums[c] = sum;
+        }, m_parameters.number_of_threads);
+
+        auto sum = 0.0;
+        for(auto partial : m_partial_sums)
+        {
+            sum += partial;
+        }
+        return sum;
+    }
+
+    std::size_t ConjugateGradient::solve(const SparseMatrix & matrix, const ConjugateGradient::vector_type & b, ConjugateGradient::vector_type & x)
+    {
+        auto n = matrix.size();
+        auto threads = m_parameters.number_of_threads;
+        auto chunks = (n + chunk - 1) / chunk;
+        auto for_each = [&](auto && function){
+            util::parallel_for(0, chunks, [&](std::size_t c){
+                auto last = std::min(n, (c + 1) * chunk);
+                for(auto i = c * chunk; i < last; ++i)
+                {
+                    function(i);
+                }
+            }, threads);
+        };
+
+        x.resize(n, 0.0);
+        m_r.resize(n);
+        m_z.resize(n);
+        m_p.resize(n);
+        m_inverse_diagonal.resize(n);
+        for_each([&](std::size_t i){
+            auto diagonal = matrix.diagonal(i);
+            m_inverse_diagonal[i] = diagonal != 0.0 ? 1.0 / diagonal : 1.0;
+        });
+
+        matrix.multiply(x, m_q, threads);
+        for_each([&](std::size_t i){
+            m_r[i] = b[i] - m_q[i];
+            m_z[i] = m_inverse_diagonal[i] * m_r[i];
+            m_p[i] = m_z[i];
+        });
+
+        auto b_norm = std::sqrt(dot(b, b));
+        if(b_norm == 0.0)
+        {
+            b_norm = 1.0;
+        }
+        auto rz = dot(m_r, m_z);
+        m_residual = std::sqrt(dot(m_r, m_r)) / b_norm;
+
+        auto iteration = std::size_t{0};
+        while(iteration < m_parameters.max_iterations && m_residual > m_parameters.tolerance)
+        {
+            matrix.multiply(m_p, m_q, threads);
+            auto pq = dot(m_p, m_q);
+            if(pq <= 0.0)
+            {
+                break;
+            }
+            auto alpha = rz / pq;
+            for_each([&](std::size_t i){
+                x[i] += alpha * m_p[i];
+                m_r[i] -= alpha * m_q[i];
+                m_z[i] = m_inverse_diagonal[i] * m_r[i];
+            });
+
+            auto next_rz = dot(m_r, m_z);
+            auto beta = next_rz / rz;
+            rz = next_rz;
+            for_each([&](std::size_t i){
+                m_p[i] = m_z[i] + beta * m_p[i];
+            });
+
+            m_residual = std::sqrt(dot(m_r, m_r)) / b_norm;
+            ++iteration;
+        }
+        return iteration;
+    }
+}
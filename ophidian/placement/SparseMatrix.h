@@ -0,0 +1,141 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_SPARSE_MATRIX_H
+#define OPHIDIAN_PLACEMENT_SPARSE_MATRIX_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ophidian::placement
+{
+    //! Square sparse matrix in compressed sparse row format
+
+    /*!
+       \brief The sparsity pattern is set once and the values are accumulated into it, so a
+       system whose pattern does not change between iterations reuses the same storage and only
+       clears and refills the values. Columns of each row are sorted and the diagonal is always
+       part of the pattern.
+     */
+    class SparseMatrix
+    {
+    public:
+        using index_type            = std::size_t;
+        using entry_type            = std::pair<index_type, index_type>;
+        using entry_container_type  = std::vector<entry_type>;
+        using vector_type           = std::vector<double>;
+
+        // Constructors
+        SparseMatrix() = default;
+
+        explicit SparseMatrix(index_type size);
+
+        // Capacity
+        index_type size() const noexcept;
+
+        index_type non_zeros() const noexcept;
+
+        // Element access
+        bool contains(index_type row, index_type column) const;
+
+        double value(index_type row, index_type column) const;
+
+        double diagonal(index_type row) const;
+
+        //! y = A x, rows computed in parallel
+        void multiply(const vector_type & x, vector_type & y, std::size_t number_of_threads = 0) const;
+
+        // Modifiers
+
+        //! Replace the pattern by the diagonal and the given entries, values are cleared
+        void set_pattern(const entry_container_type & entries);
+
+        //! Add the given entries to the pattern, values are cleared
+        void extend_pattern(const entry_container_type & entries);
+
+        //! Set every value of the pattern to zero
+        void clear_values();
+
+        //! Accumulate a value into an entry of the pattern
+        void add(index_type row, index_type column, double value);
+
+    private:
+        index_type position(index_type row, index_type column) const;
+
+        index_type              m_size{0};
+        std::vector<index_type> m_row_begins{0};
+        std::vector<index_type> m_columns;
+        std::vector<index_type> m_diagonals;
+        vector_type             m_values;
+    };
+
+    //! Jacobi preconditioned conjugate gradient
+
+    /*!
+       \brief Solves A x = b for a symmetric positive definite SparseMatrix, starting from the
+       given x. Matrix products and vector updates run in parallel; dot products are summed per
+       fixed size chunk and the chunks in order, so the result does not depend on the number of
+       threads. The work vectors are kept between calls.
+     */
+    class ConjugateGradient
+    {
+    public:
+        using vector_type = SparseMatrix::vector_type;
+
+        //! Solver parameters
+        struct Parameters
+        {
+            //! Stop when the residual norm is below tolerance times the norm of b
+            double tolerance{1e-6};
+            std::size_t max_iterations{1000};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        ConjugateGradient() = default;
+
+        explicit ConjugateGradient(const Parameters & parameters);
+
+        //! Solve the system
+        /*!
+           \param matrix Symmetric positive definite matrix
+           \param b Right hand side
+           \param x Initial guess, replaced by the solution
+           \return Number of iterations
+         */
+        std::size_t solve(const SparseMatrix & matrix, const vector_type & b, vector_type & x);
+
+        //! Relative residual norm of the last solve
+        double residual() const noexcept;
+
+    private:
+        double dot(const vector_type & a, const vector_type & b);
+
+        Parameters  m_parameters{};
+        double      m_residual{0.0};
+        vector_type m_r;
+        vector_type m_z;
+        vector_type m_p;
+        vector_type m_q;
+        vector_type m_inverse_diagonal;
+        vector_type m_partial_sums;
+    };
+}
+
+#endif // OPHIDIAN_PLACEMENT_SPARSE_MATRIX_H
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "DetailedRouter.h"
+#include "NetBatches.h"
+#include <ophidian/util/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace ophidian::routing
+{
+    namespace
+    {
+        // the occupancy and the batches share a tiles x tiles partition of the routed area
+        constexpr int tiles = 64;
+
+        double box_area(const Library::via_geometry_type & box)
+        {
+            return units::unit_cast<double>(box.max_corner().x() - box.min_corner().x())
+                   * units::unit_cast<double>(box.max_corner().y() - box.min_corner().y());
+        }
+
+        std::vector<char> on_track(const std::vector<double> & coordinates, const TrackAxis & axis)
+        {
+            auto result = std::vector<char>(coordinates.size(), 0);
+            for(TrackAxis::scalar_type i = 0; i < axis.size(); ++i){
+                auto c = units::unit_cast<double>(axis.coordinate(i));
+                result[std::lower_bound(coordinates.begin(), coordinates.end(), c) - coordinates.begin()] = 1;
+            }
+            return result;
+        }
+
+        int nearest_index(const std::vector<double> & coordinates, double c)
+        {
+            auto next = std::lower_bound(coordinates.begin(), coordinates.end(), c);
+            if(next == coordinates.end()){
+                return static_cast<int>(coordinates.size()) - 1;
+            }
+            if(next != coordinates.begin() && c - *(next - 1) < *next - c){
+                --next;
+            }
+            return static_cast<int>(next - coordinates.begin());
+        }
+    }
+
+    DetailedRouter::DetailedRouter(const Library & library, const GlobalRouting & global_routing, const circuit::Netlist & netlist, const DetailedRouter::Parameters & parameters) :
+        m_parameters{parameters},
+        m_library{library},
+        m_global_routing{global_routing},
+        m_layer_index{library.make_property_layer<scalar_type>()},
+        m_occupied(tiles * tiles),
+        m_wires{netlist.make_property_net<wire_container_type>()},
+        m_routed_vias{netlist.make_property_net<via_container_type>()},
+        m_routed{netlist.make_property_net<char>()}
+    {
+        auto stack = std::vector<layer_type>{};
+        for(auto layer_it = library.begin_layer(); layer_it != library.end_layer(); ++layer_it){
+            auto layer = *layer_it;
+            stack.push_back(layer);
+            m_layer_index[layer] = -1;
+            if(library.type(layer) == LayerType::ROUTING && library.direction(layer) != LayerDirection::NA){
+                m_layer_index[layer] = static_cast<scalar_type>(m_layers.size());
+                m_layers.push_back(layer);
+                m_horizontal.push_back(library.direction(layer) == LayerDirection::HORIZONTAL);
+            }
+        }
+
+        // the via between two routing layers is the one with the smallest metal enclosures
+        for(std::size_t layer = 0; layer + 1 < m_layers.size(); ++layer){
+            auto best = via_type{};
+            auto best_area = std::numeric_limits<double>::max();
+            for(const auto & cut : stack){
+                if(library.type(cut) != LayerType::CUT){
+                    continue;
+                }
+                for(const auto & enclosure : library.via_enclosures(cut)){
+                    auto area = box_area(enclosure.bottom) + box_area(enclosure.top);
+                    if(enclosure.bottom_layer == m_layers[layer] && enclosure.top_layer == m_layers[layer + 1] && area < best_area){
+                        best = enclosure.via;
+                        best_area = area;
+                    }
+                }
+            }
+            auto pitch = units::unit_cast<double>(library.pitch(m_layers[layer + 1]));
+            m_vias.push_back(best);
+            m_has_via.push_back(best_area != std::numeric_limits<double>::max());
+            m_via_costs.push_back(m_parameters.via_cost * std::max(pitch, 1.0));
+        }
+
+        for(const auto & layer : m_layers){
+            const auto & grid = library.track_grid(layer);
+            for(auto orientation : {TrackOrientation::X, TrackOrientation::Y}){
+                auto & coordinates = orientation == TrackOrientation::X ? m_x : m_y;
+                const auto & axis = grid.axis(orientation);
+                for(TrackAxis::scalar_type i = 0; i < axis.size(); ++i){
+                    coordinates.push_back(units::unit_cast<double>(axis.coordinate(i)));
+                }
+            }
+        }
+        for(auto coordinates : {&m_x, &m_y}){
+            std::sort(coordinates->begin(), coordinates->end());
+            coordinates->erase(std::unique(coordinates->begin(), coordinates->end()), coordinates->end());
+        }
+
+        for(const auto & layer : m_layers){
+            const auto & grid = library.track_grid(layer);
+            m_on_x_track.push_back(on_track(m_x, grid.axis(TrackOrientation::X)));
+            m_on_y_track.push_back(on_track(m_y, grid.axis(TrackOrientation::Y)));
+        }
+    }
+
+    DetailedRouter::DetailedRouter(const Library & library, const GlobalRouting & global_routing, const circuit::Netlist & netlist) :
+        DetailedRouter(library, global_routing, netlist, Parameters{})
+    {
+    }
+
+    DetailedRouter::scalar_type DetailedRouter::tile_x(DetailedRouter::scalar_type x) const noexcept
+    {
+        auto extent = m_x.back() - m_x.front();
+        return extent > 0.0 ? std::min(tiles - 1, static_cast<scalar_type>((m_x[x] - m_x.front()) / extent * tiles)) : 0;
+    }
+
+    DetailedRouter::scalar_type DetailedRouter::tile_y(DetailedRouter::scalar_type y) const noexcept
+    {
+        auto extent = m_y.back() - m_y.front();
+        return extent > 0.0 ? std::min(tiles - 1, static_cast<scalar_type>((m_y[y] - m_y.front()) / extent * tiles)) : 0;
+    }
+
+    DetailedRouter::key_type DetailedRouter::access_node(const DetailedRouter::point_type & pin) const
+    {
+        // the lowest layer's nearest preferred track, crossed where the layer above can take a via
+        auto px = units::unit_cast<double>(pin.x());
+        auto py = units::unit_cast<double>(pin.y());
+        auto along = [&](bool x_axis, std::size_t layer){
+            const auto & coordinates = x_axis ? m_x : m_y;
+            auto c = x_axis ? px : py;
+            auto orientation = x_axis ? TrackOrientation::X : TrackOrientation::Y;
+            const auto & grid = m_library.track_grid(m_layers[layer]);
+            auto track = grid.nearest_track(orientation, unit_type{c});
+            if(track == TrackAxis::npos){
+                return nearest_index(coordinates, c);
+            }
+            auto coordinate = units::unit_cast<double>(grid.track_coordinate(orientation, track));
+            return static_cast<int>(std::lower_bound(coordinates.begin(), coordinates.end(), coordinate) - coordinates.begin());
+        };
+
+        auto upper = m_layers.size() > 1 ? 1 : 0;
+        auto x = m_horizontal[0] ? along(true, upper) : along(true, 0);
+        auto y = m_horizontal[0] ? along(false, 0) : along(false, upper);
+        return key(0, x, y);
+    }
+
+    void DetailedRouter::add_net(const DetailedRouter::net_type & net, const DetailedRouter::pin_container_type & pins)
+    {
+        if(m_layers.empty() || m_x.empty() || m_y.empty()){
+            return;
+        }
+
+        auto data = NetData{};
+        data.net = net;
+        data.pins = pins;
+        data.guides.resize(m_layers.size());
+
+        auto min_x = std::numeric_limits<double>::max(), min_y = min_x;
+        auto max_x = std::numeric_limits<double>::lowest(), max_y = max_x;
+        auto extend = [&](double x, double y){
+            min_x = std::min(min_x, x);
+            min_y = std::min(min_y, y);
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+        };
+
+        for(auto region : m_global_routing.regions(net)){
+            auto layer = m_layer_index[m_global_routing.layer(region)];
+            if(layer < 0){
+                continue;
+            }
+            const auto & box = m_global_routing.geometry(region);
+            data.guides[layer].push_back(box);
+            extend(units::unit_cast<double>(box.min_corner().x()), units::unit_cast<double>(box.min_corner().y()));
+            extend(units::unit_cast<double>(box.max_corner().x()), units::unit_cast<double>(box.max_corner().y()));
+        }
+
+        for(const auto & pin : pins){
+            auto node = access_node(pin);
+            if(data.access_set.insert(node).second){
+                data.access.push_back(node);
+            }
+            extend(units::unit_cast<double>(pin.x()), units::unit_cast<double>(pin.y()));
+            extend(m_x[key_x(node)], m_y[key_y(node)]);
+        }
+
+        if(data.access.empty()){
+            return;
+        }
+
+        data.x_low = static_cast<scalar_type>(std::lower_bound(m_x.begin(), m_x.end(), min_x) - m_x.begin());
+        data.x_high = static_cast<scalar_type>(std::upper_bound(m_x.begin(), m_x.end(), max_x) - m_x.begin()) - 1;
+        data.y_low = static_cast<scalar_type>(std::lower_bound(m_y.begin(), m_y.end(), min_y) - m_y.begin());
+        data.y_high = static_cast<scalar_type>(std::upper_bound(m_y.begin(), m_y.end(), max_y) - m_y.begin()) - 1;
+
+        m_routed[net] = 0;
+        m_nets.push_back(std::move(data));
+    }
+
+    bool DetailedRouter::allowed(const DetailedRouter::NetData & net, DetailedRouter::key_type node) const
+    {
+        auto layer = key_layer(node);
+        auto x = key_x(node);
+        auto y = key_y(node);
+        if(x < net.x_low || x > net.x_high || y < net.y_low || y > net.y_high || !has_node(layer, x, y)){
+            return false;
+        }
+        if(net.access_set.count(node)){
+            return true;
+        }
+        auto px = m_x[x];
+        auto py = m_y[y];
+        return std::any_of(net.guides[layer].begin(), net.guides[layer].end(), [&](const auto & box){
+            return px >= units::unit_cast<double>(box.min_corner().x()) && px <= units::unit_cast<double>(box.max_corner().x())
+                   && py >= units::unit_cast<double>(box.min_corner().y()) && py <= units::unit_cast<double>(box.max_corner().y());
+        });
+    }
+
+    bool DetailedRouter::occupied(DetailedRouter::key_type node) const
+    {
+        const auto & shard = m_occupied[tile_y(key_y(node)) * tiles + tile_x(key_x(node))];
+        return shard.count(node) != 0;
+    }
+
+    bool DetailedRouter::search(const DetailedRouter::NetData & net, DetailedRouter::SearchArena & arena, DetailedRouter::key_type source) const
+    {
+        arena.nodes.clear();
+        arena.open.clear();
+        arena.path.clear();
+
+        auto min_x = std::numeric_limits<double>::max(), min_y = min_x;
+        auto max_x = std::numeric_limits<double>::lowest(), max_y = max_x;
+        for(auto node : arena.tree){
+            min_x = std::min(min_x, m_x[key_x(node)]);
+            max_x = std::max(max_x, m_x[key_x(node)]);
+            min_y = std::min(min_y, m_y[key_y(node)]);
+            max_y = std::max(max_y, m_y[key_y(node)]);
+        }
+
+        // Manhattan distance to the bounding box of the routed tree never overestimates
+        auto heuristic = [&](key_type node){
+            auto x = m_x[key_x(node)];
+            auto y = m_y[key_y(node)];
+            return std::max({0.0, min_x - x, x - max_x}) + std::max({0.0, min_y - y, y - max_y});
+        };
+
+        auto push = [&](key_type node, key_type parent, double cost){
+            auto found = arena.nodes.find(node);
+            if(found != arena.nodes.end() && (found->second.closed || found->second.cost <= cost)){
+                return;
+            }
+            arena.nodes[node] = NodeState{cost, parent, false};
+            arena.open.emplace_back(cost + heuristic(node), node);
+            std::push_heap(arena.open.begin(), arena.open.end(), std::greater<>{});
+        };
+
+        auto relax = [&](key_type from, key_type to, double cost){
+            if(allowed(net, to) && (arena.tree.count(to) || !occupied(to))){
+                push(to, from, cost);
+            }
+        };
+
+        push(source, source, 0.0);
+        while(!arena.open.empty()){
+            std::pop_heap(arena.open.begin(), arena.open.end(), std::greater<>{});
+            auto node = arena.open.back().second;
+            arena.open.pop_back();
+
+            auto & state = arena.nodes[node];
+            if(state.closed){
+                continue;
+            }
+            state.closed = true;
+            auto cost = state.cost;
+
+            if(arena.tree.count(node)){
+                for(auto current = node; ; current = arena.nodes[current].parent){
+                    arena.path.push_back(current);
+                    if(current == source){
+                        break;
+                    }
+                }
+                std::reverse(arena.path.begin(), arena.path.end());
+                return true;
+            }
+
+            auto layer = key_layer(node);
+            auto x = key_x(node);
+            auto y = key_y(node);
+            if(m_horizontal[layer]){
+                if(x > net.x_low){
+                    relax(node, key(layer, x - 1, y), cost + m_x[x] - m_x[x - 1]);
+                }
+                if(x < net.x_high){
+                    relax(node, key(layer, x + 1, y), cost + m_x[x + 1] - m_x[x]);
+                }
+            }else{
+                if(y > net.y_low){
+                    relax(node, key(layer, x, y - 1), cost + m_y[y] - m_y[y - 1]);
+                }
+                if(y < net.y_high){
+                    relax(node, key(layer, x, y + 1), cost + m_y[y + 1] - m_y[y]);
+                }
+            }
+            if(layer + 1 < m_layers.size() && m_has_via[layer]){
+                relax(node, key(layer + 1, x, y), cost + m_via_costs[layer]);
+            }
+            if(layer > 0 && m_has_via[layer - 1]){
+                relax(node, key(layer - 1, x, y), cost + m_via_costs[layer - 1]);
+            }
+        }
+        return false;
+    }
+
+    void DetailedRouter::route_net(DetailedRouter::NetData & net, DetailedRouter::SearchArena & arena)
+    {
+        auto wires = wire_container_type{};
+        auto vias = via_container_type{};
+        auto point = [this](key_type node){
+            return point_type{unit_type{m_x[key_x(node)]}, unit_type{m_y[key_y(node)]}};
+        };
+
+        arena.tree.clear();
+        arena.tree.insert(net.access.front());
+
+        auto remaining = std::vector<key_type>(net.access.begin() + 1, net.access.end());
+        auto success = true;
+        while(success && !remaining.empty()){
+            // the pin closest to the first one goes next, keeping the order deterministic
+            auto next = std::min_element(remaining.begin(), remaining.end(), [&](key_type a, key_type b){
+                auto first = net.access.front();
+                auto distance = [&](key_type node){
+                    return std::abs(m_x[key_x(node)] - m_x[key_x(first)]) + std::abs(m_y[key_y(node)] - m_y[key_y(first)]);
+                };
+                return distance(a) < distance(b);
+            });
+            auto source = *next;
+            remaining.erase(next);
+
+            success = search(net, arena, source);
+            if(!success){
+                break;
+            }
+
+            const auto & path = arena.path;
+            auto run_start = path.front();
+            for(std::size_t i = 1; i <= path.size(); ++i){
+                if(i < path.size() && key_layer(path[i]) == key_layer(path[i - 1])){
+                    continue;
+                }
+                if(run_start != path[i - 1]){
+                    wires.push_back(Wire{m_layers[key_layer(run_start)], point(run_start), point(path[i - 1])});
+                }
+                if(i < path.size()){
+                    auto lower = std::min(key_layer(path[i]), key_layer(path[i - 1]));
+                    vias.push_back(ViaInstance{m_vias[lower], point(path[i - 1])});
+                    run_start = path[i];
+                }
+            }
+            arena.tree.insert(path.begin(), path.end());
+        }
+
+        if(!success){
+            return;
+        }
+
+        // stubs from each pin to its access node on the lowest layer
+        for(const auto & pin : net.pins){
+            auto access = point(access_node(pin));
+            auto corner = point_type{access.x(), pin.y()};
+            if(pin.x() != access.x()){
+                wires.push_back(Wire{m_layers.front(), pin, corner});
+            }
+            if(pin.y() != access.y()){
+                wires.push_back(Wire{m_layers.front(), corner, access});
+            }
+        }
+
+        for(auto node : arena.tree){
+            m_occupied[tile_y(key_y(node)) * tiles + tile_x(key_x(node))].insert(node);
+        }
+        m_wires[net.net] = std::move(wires);
+        m_routed_vias[net.net] = std::move(vias);
+        m_routed[net.net] = 1;
+    }
+
+    void DetailedRouter::route()
+    {
+        auto arenas = std::vector<SearchArena>(util::number_of_threads(m_parameters.number_of_threads));
+
+        auto nets = std::vector<std::size_t>(m_nets.size());
+        for(std::size_t i = 0; i < nets.size(); ++i){
+            nets[i] = i;
+        }
+
+        route_in_batches(std::move(nets), tiles, m_parameters.batch_size, [&](std::size_t index){
+            const auto & net = m_nets[index];
+            return TileBox{tile_x(net.x_low), tile_y(net.y_low), tile_x(net.x_high), tile_y(net.y_high)};
+        }, [&](const std::vector<std::size_t> & batch){
+            util::parallel_for(0, batch.size(), [&](std::size_t i, std::size_t thread){
+                route_net(m_nets[batch[i]], arenas[thread]);
+            }, arenas.size());
+        });
+    }
+
+    bool DetailedRouter::routed(const DetailedRouter::net_type & net) const
+    {
+        return m_routed[net] != 0;
+    }
+
+    const DetailedRouter::wire_container_type & DetailedRouter::wires(const DetailedRouter::net_type & net) const
+    {
+        return m_wires[net];
+    }
+
+    const DetailedRouter::via_container_type & DetailedRouter::vias(const DetailedRouter::net_type & net) const
+    {
+        return m_routed_vias[net];
+    }
+
+    std::vector<DetailedRouter::net_type> DetailedRouter::unrouted() const
+    {
+        auto result = std::vector<net_type>{};
+        for(const auto & net : m_nets){
+            if(!m_routed[net.net]){
+                result.push_back(net.net);
+            }
+        }
+        return result;
+    }
+}
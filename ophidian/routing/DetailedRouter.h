@@ -0,0 +1,191 @@
+#ifndef OPHIDIAN_ROUTING_DETAILED_ROUTER_H
+#define OPHIDIAN_ROUTING_DETAILED_ROUTER_H
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/routing/Library.h>
+#include <ophidian/routing/GlobalRouting.h>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ophidian::routing
+{
+    //! Track grid maze router
+
+    /*!
+       \brief Connects the pins of each net with A* over the 3D graph of track intersections.
+
+       Nodes are the crossings of the x and y track coordinates of every routing layer; a layer
+       only has the nodes on its preferred direction tracks, wires move along those tracks and
+       vias move between neighbour layers where both have a node. The graph is implicit, nodes
+       are (layer, x index, y index) keys expanded on demand, and the search of a net only visits
+       nodes inside its GlobalRouting guides on the node's layer. Nodes used by a routed net
+       block the following ones. Nets whose guide bounding boxes do not overlap are routed
+       concurrently, each worker thread reusing its own search arena.
+     */
+    class DetailedRouter
+    {
+    public:
+        using scalar_type           = int;
+        using unit_type             = util::database_unit_t;
+        using point_type            = geometry::Point<unit_type>;
+        using box_type              = geometry::Box<unit_type>;
+        using net_type              = circuit::Net;
+        using layer_type            = Library::layer_type;
+        using via_type              = Library::via_type;
+        using pin_container_type    = std::vector<point_type>;
+
+        //! Routed wire, a straight segment on a layer
+        struct Wire
+        {
+            layer_type layer;
+            point_type start;
+            point_type end;
+        };
+
+        //! Routed via
+        struct ViaInstance
+        {
+            via_type via;
+            point_type position;
+        };
+
+        using wire_container_type   = std::vector<Wire>;
+        using via_container_type    = std::vector<ViaInstance>;
+
+        //! Detailed router parameters
+        struct Parameters
+        {
+            //! Cost of a via, in pitches of the layer above it
+            double via_cost{4.0};
+            //! Maximum number of nets in a batch, 0 counts as 1
+            std::size_t batch_size{1024};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        //! Construct the router
+        /*!
+           \param library Routing library, its track grids must be up to date
+           \param global_routing Guides of the nets
+           \param netlist Netlist owning the nets
+           \param parameters Router parameters
+         */
+        DetailedRouter(const Library & library, const GlobalRouting & global_routing, const circuit::Netlist & netlist, const Parameters & parameters);
+
+        DetailedRouter(const Library & library, const GlobalRouting & global_routing, const circuit::Netlist & netlist);
+
+        DetailedRouter(const DetailedRouter &) = delete;
+        DetailedRouter & operator=(const DetailedRouter &) = delete;
+
+        //! Add a net to route
+        /*!
+           \param net The net
+           \param pins Pin positions, accessed from the lowest routing layer
+         */
+        void add_net(const net_type & net, const pin_container_type & pins);
+
+        //! Route every added net
+        void route();
+
+        //! True when every pin of the net was connected
+        bool routed(const net_type & net) const;
+
+        const wire_container_type & wires(const net_type & net) const;
+
+        const via_container_type & vias(const net_type & net) const;
+
+        //! Nets that could not be connected inside their guides
+        std::vector<net_type> unrouted() const;
+
+    private:
+        using key_type              = std::uint64_t;
+
+        struct NodeState
+        {
+            double cost;
+            key_type parent;
+            bool closed;
+        };
+
+        //! Per thread search storage, kept between nets
+        struct SearchArena
+        {
+            std::unordered_map<key_type, NodeState> nodes;
+            std::vector<std::pair<double, key_type>> open;
+            std::unordered_set<key_type> tree;
+            std::vector<key_type> path;
+        };
+
+        struct NetData
+        {
+            net_type net;
+            pin_container_type pins;
+            std::vector<std::vector<box_type>> guides;
+            std::vector<key_type> access;
+            std::unordered_set<key_type> access_set;
+            scalar_type x_low, x_high, y_low, y_high;
+        };
+
+        static key_type key(std::size_t layer, scalar_type x, scalar_type y) noexcept
+        {
+            return (static_cast<key_type>(layer) << 48) | (static_cast<key_type>(y) << 24) | static_cast<key_type>(x);
+        }
+
+        static std::size_t key_layer(key_type node) noexcept
+        {
+            return static_cast<std::size_t>(node >> 48);
+        }
+
+        static scalar_type key_y(key_type node) noexcept
+        {
+            return static_cast<scalar_type>((node >> 24) & 0xFFFFFF);
+        }
+
+        static scalar_type key_x(key_type node) noexcept
+        {
+            return static_cast<scalar_type>(node & 0xFFFFFF);
+        }
+
+        bool has_node(std::size_t layer, scalar_type x, scalar_type y) const noexcept
+        {
+            return m_horizontal[layer] ? m_on_y_track[layer][y] : m_on_x_track[layer][x];
+        }
+
+        scalar_type tile_x(scalar_type x) const noexcept;
+        scalar_type tile_y(scalar_type y) const noexcept;
+        key_type access_node(const point_type & pin) const;
+        bool allowed(const NetData & net, key_type node) const;
+        bool occupied(key_type node) const;
+        bool search(const NetData & net, SearchArena & arena, key_type source) const;
+        void route_net(NetData & net, SearchArena & arena);
+
+        Parameters m_parameters;
+        const Library & m_library;
+        const GlobalRouting & m_global_routing;
+
+        std::vector<layer_type> m_layers;
+        entity_system::Property<layer_type, scalar_type> m_layer_index;
+        std::vector<bool> m_horizontal;
+        std::vector<via_type> m_vias;
+        std::vector<bool> m_has_via;
+        std::vector<double> m_via_costs;
+        std::vector<double> m_x;
+        std::vector<double> m_y;
+        std::vector<std::vector<char>> m_on_x_track;
+        std::vector<std::vector<char>> m_on_y_track;
+
+        std::vector<std::unordered_set<key_type>> m_occupied;
+        std::vector<NetData> m_nets;
+
+        entity_system::Property<net_type, wire_container_type> m_wires;
+        entity_system::Property<net_type, via_container_type> m_routed_vias;
+        entity_system::Property<net_type, char> m_routed;
+    };
+}
+
+#endif // OPHIDIAN_ROUTING_DETAILED_ROUTER_H
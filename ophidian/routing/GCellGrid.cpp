@@ -0,0 +1,109 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "GCellGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ophidian::routing
+{
+    namespace
+    {
+        bool is_routing_layer(const Library & library, const Library::layer_type & layer)
+        {
+            return library.type(layer) == LayerType::ROUTING && library.direction(layer) != LayerDirection::NA;
+        }
+    }
+
+    GCellGrid::unit_type GCellGrid::default_gcell_size(const Library & library, GCellGrid::scalar_type tracks_per_gcell)
+    {
+        auto pitch = unit_type{0};
+        for(auto layer_it = library.begin_layer(); layer_it != library.end_layer(); ++layer_it){
+            auto layer_pitch = library.pitch(*layer_it);
+            if(is_routing_layer(library, *layer_it) && layer_pitch > unit_type{0} && (pitch == unit_type{0} || layer_pitch < pitch)){
+                pitch = layer_pitch;
+            }
+        }
+        return pitch * static_cast<double>(std::max(1, tracks_per_gcell));
+    }
+
+    GCellGrid::GCellGrid(const Library & library, const GCellGrid::box_type & area, const GCellGrid::unit_type & gcell_size) :
+        m_origin_x{area.min_corner().x()},
+        m_origin_y{area.min_corner().y()},
+        m_upper_x{area.max_corner().x()},
+        m_upper_y{area.max_corner().y()},
+        m_gcell_size{gcell_size}
+    {
+        auto size = units::unit_cast<double>(m_gcell_size);
+        m_width = std::max(1, static_cast<scalar_type>(std::ceil(units::unit_cast<double>(m_upper_x - m_origin_x) / size)));
+        m_height = std::max(1, static_cast<scalar_type>(std::ceil(units::unit_cast<double>(m_upper_y - m_origin_y) / size)));
+
+        for(auto layer_it = library.begin_layer(); layer_it != library.end_layer(); ++layer_it){
+            auto layer = *layer_it;
+            if(!is_routing_layer(library, layer)){
+                continue;
+            }
+
+            auto horizontal = library.direction(layer) == LayerDirection::HORIZONTAL;
+            auto& grid = library.track_grid(layer);
+            auto count = horizontal ? m_height : m_width;
+
+            auto capacities = std::vector<scalar_type>(count);
+            for(scalar_type i = 0; i < count; ++i){
+                // horizontal wires run on the Y tracks of a GCell row, vertical ones on the X tracks of a column
+                auto cell = horizontal ? box(gcell_type{0, i}) : box(gcell_type{i, 0});
+                auto low = horizontal ? cell.min_corner().y() : cell.min_corner().x();
+                auto high = horizontal ? cell.max_corner().y() : cell.max_corner().x();
+                auto last = (horizontal ? i == m_height - 1 : i == m_width - 1);
+                auto orientation = horizontal ? TrackOrientation::Y : TrackOrientation::X;
+                capacities[i] = grid.axis(orientation).count(low, last ? high : high - unit_type{1});
+            }
+
+            m_layers.push_back(layer);
+            m_horizontal.push_back(horizontal);
+            m_capacities.push_back(std::move(capacities));
+        }
+    }
+
+    GCellGrid::gcell_type GCellGrid::gcell(const GCellGrid::point_type & point) const
+    {
+        auto size = units::unit_cast<double>(m_gcell_size);
+        auto x = static_cast<scalar_type>(std::floor(units::unit_cast<double>(point.x() - m_origin_x) / size));
+        auto y = static_cast<scalar_type>(std::floor(units::unit_cast<double>(point.y() - m_origin_y) / size));
+        return gcell_type{std::clamp(x, 0, m_width - 1), std::clamp(y, 0, m_height - 1)};
+    }
+
+    GCellGrid::box_type GCellGrid::box(const GCellGrid::gcell_type & gcell) const
+    {
+        return box(gcell, gcell);
+    }
+
+    GCellGrid::box_type GCellGrid::box(const GCellGrid::gcell_type & a, const GCellGrid::gcell_type & b) const
+    {
+        auto size = units::unit_cast<double>(m_gcell_size);
+        auto min_x = std::min(a.x, b.x);
+        auto min_y = std::min(a.y, b.y);
+        auto max_x = std::max(a.x, b.x) + 1;
+        auto max_y = std::max(a.y, b.y) + 1;
+
+        return box_type{
+            point_type{m_origin_x + unit_type{min_x * size}, m_origin_y + unit_type{min_y * size}},
+            point_type{std::min(m_upper_x, m_origin_x + unit_type{max_x * size}), std::min(m_upper_y, m_origin_y + unit_type{max_y * size})}
+        };
+    }
+}
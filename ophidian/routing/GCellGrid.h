@@ -0,0 +1,117 @@
+#ifndef OPHIDIAN_ROUTING_GCELL_GRID_H
+#define OPHIDIAN_ROUTING_GCELL_GRID_H
+
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/routing/Library.h>
+#include <vector>
+
+namespace ophidian::routing
+{
+    //! Global routing cell index
+    struct GCell
+    {
+        int x;
+        int y;
+
+        bool operator==(const GCell & other) const noexcept
+        {
+            return x == other.x && y == other.y;
+        }
+
+        bool operator!=(const GCell & other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    //! GCell grid
+
+    /*!
+       \brief Uniform grid of global routing cells over an area, with the routing layers of a
+       Library in stack order. The capacity of an edge between two neighbour GCells on a layer is
+       the number of tracks of the layer's preferred direction running through the GCells.
+     */
+    class GCellGrid
+    {
+    public:
+        using scalar_type           = int;
+        using unit_type             = util::database_unit_t;
+        using point_type            = geometry::Point<unit_type>;
+        using box_type              = geometry::Box<unit_type>;
+        using gcell_type            = GCell;
+        using layer_type            = Library::layer_type;
+        using layer_container_type  = std::vector<layer_type>;
+
+        //! Default GCell size
+        /*!
+           \brief tracks_per_gcell times the smallest routing layer pitch of the library.
+         */
+        static unit_type default_gcell_size(const Library & library, scalar_type tracks_per_gcell);
+
+        //! Construct the grid
+        /*!
+           \param library Routing library, its track grids must be up to date
+           \param area Routed area, usually the die area
+           \param gcell_size Width and height of a GCell
+         */
+        GCellGrid(const Library & library, const box_type & area, const unit_type & gcell_size);
+
+        //! Number of GCell columns
+        scalar_type width() const noexcept
+        {
+            return m_width;
+        }
+
+        //! Number of GCell rows
+        scalar_type height() const noexcept
+        {
+            return m_height;
+        }
+
+        //! GCell containing a point, points outside the area are clamped to the border GCells
+        gcell_type gcell(const point_type & point) const;
+
+        //! Area of a GCell
+        box_type box(const gcell_type & gcell) const;
+
+        //! Area spanned by the GCells between two corners
+        box_type box(const gcell_type & a, const gcell_type & b) const;
+
+        //! Routing layers, bottom up
+        const layer_container_type & layers() const noexcept
+        {
+            return m_layers;
+        }
+
+        //! True when the routing layer at this stack index prefers horizontal wires
+        bool horizontal(std::size_t layer_index) const
+        {
+            return m_horizontal[layer_index];
+        }
+
+        //! Capacity of the edges leaving a GCell along a layer's preferred direction
+        /*!
+           \param layer_index Stack index of a routing layer
+           \param gcell The GCell, only its row (horizontal layers) or column (vertical layers) matters
+         */
+        scalar_type capacity(std::size_t layer_index, const gcell_type & gcell) const
+        {
+            return m_capacities[layer_index][m_horizontal[layer_index] ? gcell.y : gcell.x];
+        }
+
+    private:
+        unit_type m_origin_x;
+        unit_type m_origin_y;
+        unit_type m_upper_x;
+        unit_type m_upper_y;
+        unit_type m_gcell_size;
+        scalar_type m_width;
+        scalar_type m_height;
+        layer_container_type m_layers;
+        std::vector<bool> m_horizontal;
+        std::vector<std::vector<scalar_type>> m_capacities;
+    };
+}
+
+#endif // OPHIDIAN_ROUTING_GCELL_GRID_H
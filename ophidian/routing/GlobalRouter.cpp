@@ -0,0 +1,424 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "GlobalRouter.h"
+#include "NetBatches.h"
+#include <ophidian/interconnection/Flute.h>
+#include <ophidian/interconnection/SteinerTree.h>
+#include <ophidian/util/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace ophidian::routing
+{
+    namespace
+    {
+        bool gcell_less(const GCell & a, const GCell & b)
+        {
+            return std::tie(a.x, a.y) < std::tie(b.x, b.y);
+        }
+
+        GCellGrid::unit_type gcell_size(const Library & library, const GCellGrid::box_type & area, int tracks_per_gcell)
+        {
+            auto size = GCellGrid::default_gcell_size(library, tracks_per_gcell);
+            if(size > GCellGrid::unit_type{0}){
+                return size;
+            }
+            // no routing pitch in the library, fall back to a 64 x 64 grid
+            auto extent = std::max(area.max_corner().x() - area.min_corner().x(), area.max_corner().y() - area.min_corner().y());
+            return std::max(extent / 64.0, GCellGrid::unit_type{1});
+        }
+    }
+
+    GlobalRouter::GlobalRouter(const Library & library, const GlobalRouter::box_type & area, const GlobalRouter::Parameters & parameters) :
+        m_parameters{parameters},
+        m_grid{library, area, gcell_size(library, area, parameters.tracks_per_gcell)},
+        m_number_of_horizontal_edges{static_cast<edge_type>(m_grid.width() - 1) * m_grid.height()},
+        m_present_factor{parameters.present_factor}
+    {
+        auto number_of_edges = m_number_of_horizontal_edges + static_cast<edge_type>(m_grid.height() - 1) * m_grid.width();
+        m_capacity.assign(number_of_edges, 0);
+        m_demand.assign(number_of_edges, 0);
+        m_history.assign(number_of_edges, 0.0);
+
+        for(std::size_t layer = m_parameters.lowest_wire_layer; layer < m_grid.layers().size(); ++layer){
+            for(scalar_type y = 0; y < m_grid.height(); ++y){
+                for(scalar_type x = 0; x < m_grid.width(); ++x){
+                    auto capacity = m_grid.capacity(layer, gcell_type{x, y});
+                    if(m_grid.horizontal(layer) && x + 1 < m_grid.width()){
+                        m_capacity[horizontal_edge(x, y)] += capacity;
+                    }else if(!m_grid.horizontal(layer) && y + 1 < m_grid.height()){
+                        m_capacity[vertical_edge(x, y)] += capacity;
+                    }
+                }
+            }
+        }
+    }
+
+    GlobalRouter::GlobalRouter(const Library & library, const GlobalRouter::box_type & area) :
+        GlobalRouter(library, area, Parameters{})
+    {
+    }
+
+    void GlobalRouter::add_net(const GlobalRouter::net_type & net, const GlobalRouter::pin_container_type & pins)
+    {
+        auto route = NetRoute{};
+        route.net = net;
+        route.pins.reserve(pins.size());
+        for(const auto & pin : pins){
+            route.pins.push_back(m_grid.gcell(pin));
+        }
+        std::sort(route.pins.begin(), route.pins.end(), gcell_less);
+        route.pins.erase(std::unique(route.pins.begin(), route.pins.end()), route.pins.end());
+
+        if(route.pins.empty()){
+            return;
+        }
+
+        route.lower = route.pins.front();
+        route.upper = route.pins.front();
+        for(const auto & pin : route.pins){
+            route.lower = gcell_type{std::min(route.lower.x, pin.x), std::min(route.lower.y, pin.y)};
+            route.upper = gcell_type{std::max(route.upper.x, pin.x), std::max(route.upper.y, pin.y)};
+        }
+
+        decompose(route);
+        m_nets.push_back(std::move(route));
+    }
+
+    void GlobalRouter::decompose(GlobalRouter::NetRoute & net)
+    {
+        if(net.pins.size() < 2){
+            return;
+        }
+        if(net.pins.size() == 2){
+            net.segments.emplace_back(net.pins.front(), net.pins.back());
+            return;
+        }
+
+        // FLUTE runs on GCell coordinates, its Steiner points stay inside the pins' bounding box
+        using flute_point = interconnection::Flute::Point;
+        auto points = std::vector<flute_point>{};
+        points.reserve(net.pins.size());
+        for(const auto & pin : net.pins){
+            points.push_back(flute_point{interconnection::Flute::dbu_t{static_cast<double>(pin.x)}, interconnection::Flute::dbu_t{static_cast<double>(pin.y)}});
+        }
+
+        auto tree = interconnection::Flute::instance().create(points);
+        auto to_gcell = [](const auto & position){
+            return gcell_type{
+                static_cast<scalar_type>(std::lround(units::unit_cast<double>(position.x()))),
+                static_cast<scalar_type>(std::lround(units::unit_cast<double>(position.y())))
+            };
+        };
+
+        auto segments = tree->segments();
+        for(auto segment_it = segments.first; segment_it != segments.second; ++segment_it){
+            auto a = to_gcell(tree->position(tree->u(*segment_it)));
+            auto b = to_gcell(tree->position(tree->v(*segment_it)));
+            if(a != b){
+                net.segments.emplace_back(a, b);
+            }
+        }
+    }
+
+    template <class Visitor>
+    void GlobalRouter::for_each_edge(const GlobalRouter::path_type & path, Visitor && visitor) const
+    {
+        for(std::size_t i = 1; i < path.size(); ++i){
+            const auto & p = path[i - 1];
+            const auto & q = path[i];
+            if(p.y == q.y){
+                for(auto x = std::min(p.x, q.x); x < std::max(p.x, q.x); ++x){
+                    visitor(horizontal_edge(x, p.y));
+                }
+            }else{
+                for(auto y = std::min(p.y, q.y); y < std::max(p.y, q.y); ++y){
+                    visitor(vertical_edge(p.x, y));
+                }
+            }
+        }
+    }
+
+    GlobalRouter::path_type GlobalRouter::route_segment(const GlobalRouter::gcell_type & a, const GlobalRouter::gcell_type & b) const
+    {
+        if(a.x == b.x || a.y == b.y){
+            return path_type{a, b};
+        }
+
+        auto horizontal_cost = [this](scalar_type y, scalar_type x0, scalar_type x1){
+            auto cost = 0.0;
+            for(auto x = std::min(x0, x1); x < std::max(x0, x1); ++x){
+                cost += edge_cost(horizontal_edge(x, y));
+            }
+            return cost;
+        };
+        auto vertical_cost = [this](scalar_type x, scalar_type y0, scalar_type y1){
+            auto cost = 0.0;
+            for(auto y = std::min(y0, y1); y < std::max(y0, y1); ++y){
+                cost += edge_cost(vertical_edge(x, y));
+            }
+            return cost;
+        };
+
+        auto best_cost = std::numeric_limits<double>::max();
+        auto best = path_type{};
+
+        // horizontal, vertical, horizontal; the two L shapes are the columns of a and b
+        for(auto c = std::min(a.x, b.x); c <= std::max(a.x, b.x); ++c){
+            auto bends = (c == a.x || c == b.x) ? 1 : 2;
+            auto cost = horizontal_cost(a.y, a.x, c) + vertical_cost(c, a.y, b.y) + horizontal_cost(b.y, c, b.x)
+                        + bends * m_parameters.bend_cost;
+            if(cost < best_cost){
+                best_cost = cost;
+                best = path_type{a, gcell_type{c, a.y}, gcell_type{c, b.y}, b};
+            }
+        }
+
+        // vertical, horizontal, vertical
+        for(auto r = std::min(a.y, b.y) + 1; r < std::max(a.y, b.y); ++r){
+            auto cost = vertical_cost(a.x, a.y, r) + horizontal_cost(r, a.x, b.x) + vertical_cost(b.x, r, b.y)
+                        + 2 * m_parameters.bend_cost;
+            if(cost < best_cost){
+                best_cost = cost;
+                best = path_type{a, gcell_type{a.x, r}, gcell_type{b.x, r}, b};
+            }
+        }
+
+        best.erase(std::unique(best.begin(), best.end()), best.end());
+        return best;
+    }
+
+    void GlobalRouter::route_net(GlobalRouter::NetRoute & net)
+    {
+        net.paths.clear();
+        net.edges.clear();
+        for(const auto & segment : net.segments){
+            net.paths.push_back(route_segment(segment.first, segment.second));
+            for_each_edge(net.paths.back(), [&](edge_type edge){ net.edges.push_back(edge); });
+        }
+        std::sort(net.edges.begin(), net.edges.end());
+        net.edges.erase(std::unique(net.edges.begin(), net.edges.end()), net.edges.end());
+    }
+
+    void GlobalRouter::rip_up(GlobalRouter::NetRoute & net)
+    {
+        for(auto edge : net.edges){
+            --m_demand[edge];
+        }
+        net.edges.clear();
+    }
+
+    void GlobalRouter::commit(GlobalRouter::NetRoute & net)
+    {
+        for(auto edge : net.edges){
+            ++m_demand[edge];
+        }
+    }
+
+    void GlobalRouter::route_batches(const std::vector<std::size_t> & nets)
+    {
+        // nets of a batch must not share GCells; the check runs on a coarse tile grid,
+        // which may defer a net that would fit but never lets two overlapping nets through
+        constexpr scalar_type tiles = 64;
+        auto tile_width = (m_grid.width() + tiles - 1) / tiles;
+        auto tile_height = (m_grid.height() + tiles - 1) / tiles;
+
+        route_in_batches(nets, tiles, m_parameters.batch_size, [&](std::size_t index){
+            const auto & net = m_nets[index];
+            return TileBox{net.lower.x / tile_width, net.lower.y / tile_height, net.upper.x / tile_width, net.upper.y / tile_height};
+        }, [&](const std::vector<std::size_t> & batch){
+            util::parallel_for(0, batch.size(), [&](std::size_t i){
+                auto & net = m_nets[batch[i]];
+                rip_up(net);
+                route_net(net);
+                commit(net);
+            }, m_parameters.number_of_threads);
+        });
+    }
+
+    void GlobalRouter::update_history()
+    {
+        for(std::size_t edge = 0; edge < m_demand.size(); ++edge){
+            if(m_demand[edge] > m_capacity[edge]){
+                m_history[edge] += m_parameters.history_increment * (m_demand[edge] - m_capacity[edge]);
+            }
+        }
+    }
+
+    void GlobalRouter::route(GlobalRouting & global_routing)
+    {
+        auto routed = std::vector<std::size_t>{};
+        for(std::size_t index = 0; index < m_nets.size(); ++index){
+            if(!m_nets[index].segments.empty()){
+                routed.push_back(index);
+            }
+        }
+
+        auto total_overflow = [this](){
+            scalar_type overflow = 0;
+            for(std::size_t edge = 0; edge < m_demand.size(); ++edge){
+                overflow += std::max(0, m_demand[edge] - m_capacity[edge]);
+            }
+            return overflow;
+        };
+
+        route_batches(routed);
+        m_overflow = total_overflow();
+
+        for(m_iterations = 0; m_iterations < m_parameters.max_iterations && m_overflow > 0; ++m_iterations){
+            update_history();
+            m_present_factor *= m_parameters.present_factor_growth;
+
+            auto congested = std::vector<std::size_t>{};
+            for(auto index : routed){
+                const auto & edges = m_nets[index].edges;
+                if(std::any_of(edges.begin(), edges.end(), [this](edge_type edge){ return m_demand[edge] > m_capacity[edge]; })){
+                    congested.push_back(index);
+                }
+            }
+
+            route_batches(congested);
+            m_overflow = total_overflow();
+        }
+
+        m_wirelength = 0;
+        for(const auto & net : m_nets){
+            m_wirelength += net.edges.size();
+        }
+
+        assign_layers(global_routing);
+    }
+
+    void GlobalRouter::assign_layers(GlobalRouting & global_routing)
+    {
+        const auto & layers = m_grid.layers();
+        if(layers.empty()){
+            return;
+        }
+
+        auto lowest_wire_layer = std::min<std::size_t>(m_parameters.lowest_wire_layer, layers.size() - 1);
+        auto horizontal_layers = std::vector<std::size_t>{};
+        auto vertical_layers = std::vector<std::size_t>{};
+        for(auto layer = lowest_wire_layer; layer < layers.size(); ++layer){
+            (m_grid.horizontal(layer) ? horizontal_layers : vertical_layers).push_back(layer);
+        }
+        if(horizontal_layers.empty()){
+            horizontal_layers.push_back(lowest_wire_layer);
+        }
+        if(vertical_layers.empty()){
+            vertical_layers.push_back(lowest_wire_layer);
+        }
+
+        auto number_of_vertical_edges = static_cast<edge_type>(m_demand.size()) - m_number_of_horizontal_edges;
+        auto layer_demand = std::vector<std::vector<scalar_type>>(layers.size());
+        for(std::size_t layer = 0; layer < layers.size(); ++layer){
+            layer_demand[layer].assign(m_grid.horizontal(layer) ? m_number_of_horizontal_edges : number_of_vertical_edges, 0);
+        }
+        auto local_edge = [this](edge_type edge){
+            return edge < m_number_of_horizontal_edges ? edge : edge - m_number_of_horizontal_edges;
+        };
+        auto edge_gcell = [this](edge_type edge){
+            if(edge < m_number_of_horizontal_edges){
+                return gcell_type{static_cast<scalar_type>(edge % (m_grid.width() - 1)), static_cast<scalar_type>(edge / (m_grid.width() - 1))};
+            }
+            edge -= m_number_of_horizontal_edges;
+            return gcell_type{static_cast<scalar_type>(edge % m_grid.width()), static_cast<scalar_type>(edge / m_grid.width())};
+        };
+
+        // (layer, lower GCell, upper GCell) boxes and (GCell, layer) via stack ends of a net
+        using guide_type = std::tuple<std::size_t, scalar_type, scalar_type, scalar_type, scalar_type>;
+        using stack_type = std::tuple<scalar_type, scalar_type, std::size_t>;
+        auto guides = std::vector<guide_type>{};
+        auto stacks = std::vector<stack_type>{};
+        auto run_edges = std::vector<edge_type>{};
+
+        for(const auto & net : m_nets){
+            guides.clear();
+            stacks.clear();
+
+            for(const auto & path : net.paths){
+                for(std::size_t i = 1; i < path.size(); ++i){
+                    const auto & p = path[i - 1];
+                    const auto & q = path[i];
+                    run_edges.clear();
+                    for_each_edge(path_type{p, q}, [&](edge_type edge){ run_edges.push_back(edge); });
+
+                    // fewest overflowed edges, then most slack, then the lowest layer
+                    const auto & candidates = p.y == q.y ? horizontal_layers : vertical_layers;
+                    auto best = candidates.front();
+                    auto best_overflow = std::numeric_limits<scalar_type>::max();
+                    auto best_slack = std::numeric_limits<scalar_type>::min();
+                    for(auto layer : candidates){
+                        scalar_type overflow = 0;
+                        auto slack = std::numeric_limits<scalar_type>::max();
+                        for(auto edge : run_edges){
+                            auto remaining = m_grid.capacity(layer, edge_gcell(edge)) - layer_demand[layer][local_edge(edge)];
+                            overflow += remaining <= 0 ? 1 : 0;
+                            slack = std::min(slack, remaining);
+                        }
+                        if(overflow < best_overflow || (overflow == best_overflow && slack > best_slack)){
+                            best = layer;
+                            best_overflow = overflow;
+                            best_slack = slack;
+                        }
+                    }
+
+                    for(auto edge : run_edges){
+                        ++layer_demand[best][local_edge(edge)];
+                    }
+                    guides.emplace_back(best, std::min(p.x, q.x), std::min(p.y, q.y), std::max(p.x, q.x), std::max(p.y, q.y));
+                    stacks.emplace_back(p.x, p.y, best);
+                    stacks.emplace_back(q.x, q.y, best);
+                }
+            }
+
+            for(const auto & pin : net.pins){
+                stacks.emplace_back(pin.x, pin.y, 0);
+                if(net.paths.empty()){
+                    stacks.emplace_back(pin.x, pin.y, lowest_wire_layer);
+                }
+            }
+
+            // every GCell where wires or pins meet gets the layers between its lowest and highest end
+            std::sort(stacks.begin(), stacks.end());
+            for(std::size_t first = 0; first < stacks.size();){
+                auto last = first;
+                while(last + 1 < stacks.size() && std::get<0>(stacks[last + 1]) == std::get<0>(stacks[first])
+                      && std::get<1>(stacks[last + 1]) == std::get<1>(stacks[first])){
+                    ++last;
+                }
+                auto x = std::get<0>(stacks[first]);
+                auto y = std::get<1>(stacks[first]);
+                for(auto layer = std::get<2>(stacks[first]); layer <= std::get<2>(stacks[last]); ++layer){
+                    guides.emplace_back(layer, x, y, x, y);
+                }
+                first = last + 1;
+            }
+
+            std::sort(guides.begin(), guides.end());
+            guides.erase(std::unique(guides.begin(), guides.end()), guides.end());
+            for(const auto & guide : guides){
+                auto box = m_grid.box(gcell_type{std::get<1>(guide), std::get<2>(guide)}, gcell_type{std::get<3>(guide), std::get<4>(guide)});
+                global_routing.add_region(box, layers[std::get<0>(guide)], net.net);
+            }
+        }
+    }
+}
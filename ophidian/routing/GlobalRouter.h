@@ -0,0 +1,168 @@
+#ifndef OPHIDIAN_ROUTING_GLOBAL_ROUTER_H
+#define OPHIDIAN_ROUTING_GLOBAL_ROUTER_H
+
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/routing/Library.h>
+#include <ophidian/routing/GlobalRouting.h>
+#include <ophidian/routing/GCellGrid.h>
+#include <cstdint>
+#include <vector>
+
+namespace ophidian::routing
+{
+    //! Pattern global router
+
+    /*!
+       \brief Routes nets on a GCellGrid and writes the result as GlobalRouting regions.
+
+       Each net is decomposed into two pin segments with FLUTE, and each segment takes the
+       cheapest L or Z shape on the 2D grid. Negotiated rip-up and reroute then raises a history
+       cost on overflowed edges and reroutes the nets crossing them. Nets are routed in batches
+       whose GCell bounding boxes do not overlap, so the nets of a batch touch disjoint edges
+       and can be routed in parallel with a result that does not depend on the number of threads.
+       Finally wires are assigned to layers of their direction and emitted with their via stacks.
+     */
+    class GlobalRouter
+    {
+    public:
+        using scalar_type           = int;
+        using unit_type             = util::database_unit_t;
+        using point_type            = geometry::Point<unit_type>;
+        using box_type              = geometry::Box<unit_type>;
+        using net_type              = circuit::Net;
+        using gcell_type            = GCell;
+        using grid_type             = GCellGrid;
+        using pin_container_type    = std::vector<point_type>;
+
+        //! Global router parameters
+        struct Parameters
+        {
+            //! GCell side in tracks of the smallest routing pitch
+            scalar_type tracks_per_gcell{15};
+            //! Stack index of the lowest routing layer used for wires, lower layers only hold pin access
+            scalar_type lowest_wire_layer{1};
+            //! Maximum number of rip-up and reroute iterations
+            scalar_type max_iterations{20};
+            //! Cost of a bend, in GCell edges
+            double bend_cost{2.0};
+            //! Initial cost of each unit of overflow an edge would get
+            double present_factor{1.0};
+            //! Growth of the present factor per iteration
+            double present_factor_growth{1.5};
+            //! History cost added per unit of overflow per iteration
+            double history_increment{1.0};
+            //! Maximum number of nets in a batch, 0 counts as 1
+            std::size_t batch_size{1024};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        //! Construct the router
+        /*!
+           \param library Routing library, its track grids must be up to date
+           \param area Routed area, usually the die area
+           \param parameters Router parameters
+         */
+        GlobalRouter(const Library & library, const box_type & area, const Parameters & parameters);
+
+        GlobalRouter(const Library & library, const box_type & area);
+
+        GlobalRouter(const GlobalRouter &) = delete;
+        GlobalRouter & operator=(const GlobalRouter &) = delete;
+
+        //! Add a net to route
+        /*!
+           \param net The net
+           \param pins Pin positions of the net
+         */
+        void add_net(const net_type & net, const pin_container_type & pins);
+
+        //! Route every net
+        /*!
+           \brief Routes the nets and adds their guides to global_routing. Existing regions are kept.
+         */
+        void route(GlobalRouting & global_routing);
+
+        const grid_type & grid() const noexcept
+        {
+            return m_grid;
+        }
+
+        //! Total 2D edge overflow after routing
+        scalar_type overflow() const noexcept
+        {
+            return m_overflow;
+        }
+
+        //! Total 2D wirelength after routing, in GCell edges
+        std::int64_t wirelength() const noexcept
+        {
+            return m_wirelength;
+        }
+
+        //! Number of rip-up and reroute iterations run
+        scalar_type iterations() const noexcept
+        {
+            return m_iterations;
+        }
+
+    private:
+        using edge_type             = std::int64_t;
+        using path_type             = std::vector<gcell_type>;
+
+        struct NetRoute
+        {
+            net_type net;
+            std::vector<gcell_type> pins;
+            std::vector<std::pair<gcell_type, gcell_type>> segments;
+            gcell_type lower;
+            gcell_type upper;
+            std::vector<path_type> paths;
+            std::vector<edge_type> edges;
+        };
+
+        void decompose(NetRoute & net);
+        void route_batches(const std::vector<std::size_t> & nets);
+        void route_net(NetRoute & net);
+        path_type route_segment(const gcell_type & a, const gcell_type & b) const;
+        void rip_up(NetRoute & net);
+        void commit(NetRoute & net);
+        void update_history();
+        void assign_layers(GlobalRouting & global_routing);
+
+        edge_type horizontal_edge(scalar_type x, scalar_type y) const noexcept
+        {
+            return static_cast<edge_type>(y) * (m_grid.width() - 1) + x;
+        }
+
+        edge_type vertical_edge(scalar_type x, scalar_type y) const noexcept
+        {
+            return m_number_of_horizontal_edges + static_cast<edge_type>(y) * m_grid.width() + x;
+        }
+
+        double edge_cost(edge_type edge) const noexcept
+        {
+            auto over = m_demand[edge] + 1 - m_capacity[edge];
+            return 1.0 + m_history[edge] + (over > 0 ? m_present_factor * over : 0.0);
+        }
+
+        template <class Visitor>
+        void for_each_edge(const path_type & path, Visitor && visitor) const;
+
+        Parameters m_parameters;
+        grid_type m_grid;
+        edge_type m_number_of_horizontal_edges;
+        std::vector<scalar_type> m_capacity;
+        std::vector<scalar_type> m_demand;
+        std::vector<double> m_history;
+        double m_present_factor;
+        std::vector<NetRoute> m_nets;
+        scalar_type m_overflow{0};
+        std::int64_t m_wirelength{0};
+        scalar_type m_iterations{0};
+    };
+}
+
+#endif // OPHIDIAN_ROUTING_GLOBAL_ROUTER_H
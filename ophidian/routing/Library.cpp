@@ -17,6 +17,7 @@
  */
 
 #include "Library.h"
+#include <algorithm>
 
 namespace ophidian::routing
 {
@@ -160,6 +161,26 @@ namespace ophidian::routing
         return m_layer_spacing_tables[layer];
     }
 
+    Library::resistance_type& Library::resistance(const Library::layer_type& layer)
+    {
+        return m_layer_resistances[layer];
+    }
+
+    const Library::resistance_type& Library::resistance(const Library::layer_type& layer) const
+    {
+        return m_layer_resistances[layer];
+    }
+
+    Library::capacitance_type& Library::capacitance(const Library::layer_type& layer)
+    {
+        return m_layer_capacitances[layer];
+    }
+
+    const Library::capacitance_type& Library::capacitance(const Library::layer_type& layer) const
+    {
+        return m_layer_capacitances[layer];
+    }
+
     Library::via_name_type& Library::name(const Library::via_type &via)
     {
         return m_via_names[via];
@@ -172,12 +193,34 @@ namespace ophidian::routing
 
     Library::via_geometry_type& Library::geometry(const Library::via_type &via, const Library::layer_name_type& layer)
     {
-        return  m_via_layers_names_to_via_geometries[via].find(layer)->second;
+        return geometry(via, m_name_to_layer.at(layer));
     }
 
     const Library::via_geometry_type& Library::geometry(const Library::via_type &via, const Library::layer_name_type& layer) const
     {
-        return  m_via_layers_names_to_via_geometries[via].find(layer)->second;
+        return geometry(via, m_name_to_layer.at(layer));
+    }
+
+    Library::via_geometry_type& Library::geometry(const Library::via_type &via, const Library::layer_type& layer)
+    {
+        auto& geometries = m_via_layer_geometries[via];
+        return std::find_if(geometries.begin(), geometries.end(), [&](const auto& entry){ return entry.first == layer; })->second;
+    }
+
+    const Library::via_geometry_type& Library::geometry(const Library::via_type &via, const Library::layer_type& layer) const
+    {
+        const auto& geometries = m_via_layer_geometries[via];
+        return std::find_if(geometries.begin(), geometries.end(), [&](const auto& entry){ return entry.first == layer; })->second;
+    }
+
+    const Library::via_layer_geometries_type& Library::geometries(const Library::via_type &via) const
+    {
+        return m_via_layer_geometries[via];
+    }
+
+    const Library::via_enclosure_container_type& Library::via_enclosures(const Library::layer_type &cut_layer) const
+    {
+        return m_cut_layer_via_enclosures[cut_layer];
     }
 
     Library::track_orientation_type& Library::orientation(const Library::track_type &track)
@@ -230,6 +273,11 @@ namespace ophidian::routing
         return m_layer_tracks[track];
     }
 
+    const Library::track_grid_type& Library::track_grid(const Library::layer_type& layer) const
+    {
+        return m_layer_track_grids[layer];
+    }
+
     Library::layer_container_type::const_iterator Library::begin_layer() const noexcept
     {
         return m_layers.begin();
@@ -322,7 +370,35 @@ namespace ophidian::routing
 
             m_via_names[via] = viaName;
             m_name_to_via[viaName] = via;
-            m_via_layers_names_to_via_geometries[via] = layers;
+
+            auto geometries = via_layer_geometries_type{};
+            geometries.reserve(layers.size());
+            for(auto& layer_geometry : layers){
+                auto layer = m_name_to_layer.find(layer_geometry.first);
+                if(layer != m_name_to_layer.end()){
+                    geometries.emplace_back(layer->second, layer_geometry.second);
+                }
+            }
+
+            // layers are added bottom up, so their ids follow the stack order
+            std::sort(geometries.begin(), geometries.end(), [&](const auto& a, const auto& b){
+                return m_layers.id(a.first) < m_layers.id(b.first);
+            });
+
+            for(std::size_t i = 1; i + 1 < geometries.size(); ++i){
+                if(m_layer_types[geometries[i].first] == layer_type_type::CUT){
+                    m_cut_layer_via_enclosures[geometries[i].first].push_back(via_enclosure_type{
+                        via,
+                        geometries[i].second,
+                        geometries[i - 1].first,
+                        geometries[i - 1].second,
+                        geometries[i + 1].first,
+                        geometries[i + 1].second
+                    });
+                }
+            }
+
+            m_via_layer_geometries[via] = std::move(geometries);
             return via;
         }else{
             return m_name_to_via[viaName];
@@ -346,6 +422,28 @@ namespace ophidian::routing
         return track;
     }
 
+    void Library::update_track_grids()
+    {
+        auto x_patterns = make_property_layer<std::vector<TrackPattern>>();
+        auto y_patterns = make_property_layer<std::vector<TrackPattern>>();
+
+        for(auto track : m_tracks){
+            auto pattern = TrackPattern{m_track_starts[track], m_number_of_tracks[track], m_track_spaces[track]};
+            if(m_track_orientations[track] == track_orientation_type::X){
+                x_patterns[m_layer_tracks[track]].push_back(pattern);
+            }else{
+                y_patterns[m_layer_tracks[track]].push_back(pattern);
+            }
+        }
+
+        for(auto layer : m_layers){
+            m_layer_track_grids[layer] = track_grid_type{
+                TrackAxis{std::move(x_patterns[layer])},
+                TrackAxis{std::move(y_patterns[layer])}
+            };
+        }
+    }
+
     entity_system::EntitySystem<Library::layer_type>::NotifierType * Library::notifier_layer() const noexcept
     {
         return m_layers.notifier();
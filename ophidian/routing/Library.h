@@ -6,7 +6,10 @@
 #include <ophidian/entity_system/Aggregation.h>
 #include <ophidian/util/Units.h>
 #include <ophidian/util/LookupTable.h>
+#include <ophidian/routing/TrackGrid.h>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ophidian::routing
 {
@@ -32,6 +35,21 @@ namespace ophidian::routing
         using entity_system::EntityBase::EntityBase;
     };
 
+    //! Via enclosure
+
+    /*!
+       \brief Geometries of a via around its cut layer: the cut box and the metal boxes on the layers below and above.
+     */
+    struct ViaEnclosure
+    {
+        Via via;
+        geometry::Box<util::database_unit_t> cut;
+        Layer bottom_layer;
+        geometry::Box<util::database_unit_t> bottom;
+        Layer top_layer;
+        geometry::Box<util::database_unit_t> top;
+    };
+
     class Track :
         public entity_system::EntityBase
     {
@@ -39,18 +57,17 @@ namespace ophidian::routing
         using entity_system::EntityBase::EntityBase;
     };
 
-    enum class TrackOrientation {
-        X, Y
-    };
-
     class Library
     {
     public:
         using scalar_type           = int;
         using unit_type             = util::database_unit_t;
         using table_strategy_type   = util::FloorStrategy<unit_type, unit_type, unit_type>;
-        using spacing_table_type    = util::LookupTable<unit_type, unit_type, unit_type, table_strategy_type>;
+        //! Parallel run length tables are small, they are stored inline when at most 8 x 8
+        using spacing_table_type    = util::LookupTable<unit_type, unit_type, unit_type, util::FixedSize<table_strategy_type, 8, 8>>;
         using spacing_table_content_type = util::TableContents<unit_type, unit_type, unit_type>;
+        using resistance_type       = util::kiloohm_t;
+        using capacitance_type      = util::femtofarad_t;
 
         using layer_type            = Layer;
         using layer_container_type  = entity_system::EntitySystem<layer_type>;
@@ -66,11 +83,16 @@ namespace ophidian::routing
         using via_geometry_type     = geometry::Box<unit_type>;
 
         using layer_name_to_via_geometry_type = std::unordered_map<layer_name_type, via_geometry_type>;
+        using via_layer_geometry_type   = std::pair<Layer, via_geometry_type>;
+        using via_layer_geometries_type = std::vector<via_layer_geometry_type>;
+        using via_enclosure_type        = ViaEnclosure;
+        using via_enclosure_container_type = std::vector<via_enclosure_type>;
 
         using track_type            = Track;
         using track_container_type  = entity_system::EntitySystem<track_type>;
 
         using track_orientation_type = TrackOrientation;
+        using track_grid_type       = TrackGrid;
 
         // Constructors
         //! Construct Netlist
@@ -128,12 +150,39 @@ namespace ophidian::routing
         spacing_table_type& spacing_table(const layer_type& layer);
         const spacing_table_type& spacing_table(const layer_type& layer) const;
 
+        //! Wire resistance of a database unit of length on a layer, zero until set
+        resistance_type& resistance(const layer_type& layer);
+        const resistance_type& resistance(const layer_type& layer) const;
+
+        //! Wire capacitance of a database unit of length on a layer, zero until set
+        capacitance_type& capacitance(const layer_type& layer);
+        const capacitance_type& capacitance(const layer_type& layer) const;
+
         via_name_type& name(const via_type& via);
         const via_name_type& name(const via_type& via) const;
 
         via_geometry_type& geometry(const via_type& via, const layer_name_type& layer_name);
         const via_geometry_type& geometry(const via_type& via, const layer_name_type& layer_name) const;
 
+        //! Via geometry on a layer
+        /*!
+           \brief Scans the few (layer, box) pairs of the via, no string hashing involved.
+           \param via A via
+           \param layer A layer of the via
+         */
+        via_geometry_type& geometry(const via_type& via, const layer_type& layer);
+        const via_geometry_type& geometry(const via_type& via, const layer_type& layer) const;
+
+        //! All (layer, box) pairs of a via, sorted by layer
+        const via_layer_geometries_type& geometries(const via_type& via) const;
+
+        //! Via enclosures of a cut layer
+        /*!
+           \brief Every via crossing the cut layer, stored contiguously with its cut, bottom and top boxes.
+           \param cut_layer A cut layer
+         */
+        const via_enclosure_container_type& via_enclosures(const layer_type& cut_layer) const;
+
         track_orientation_type& orientation(const track_type& track);
         const track_orientation_type& orientation(const track_type& track) const;
 
@@ -149,6 +198,14 @@ namespace ophidian::routing
         layer_type& layer(const track_type& track);
         const layer_type& layer(const track_type& track) const;
 
+        //! Track grid of a layer
+        /*!
+           \brief Answers nearest track, tracks crossing an interval and track count queries
+           in constant time. Built by update_track_grids().
+           \param layer A layer
+         */
+        const track_grid_type& track_grid(const layer_type& layer) const;
+
         // Iterators
         layer_container_type::const_iterator begin_layer() const noexcept;
         layer_container_type::const_iterator end_layer() const noexcept;
@@ -175,6 +232,12 @@ namespace ophidian::routing
 
         track_type add_track(const track_orientation_type& orientation, const Library::unit_type& start, const Library::scalar_type& num_tracks, const Library::unit_type& space, const layer_name_type& layer);
 
+        //! Rebuild the track grids
+        /*!
+           \brief Precomputes the per layer, per orientation track axes. Must be called again after adding tracks.
+         */
+        void update_track_grids();
+
         template <typename Value>
         entity_system::Property<layer_type, Value> make_property_layer() const noexcept
         {
@@ -223,9 +286,13 @@ namespace ophidian::routing
         entity_system::Property<layer_type, unit_type>            m_layer_end_of_line_widths{m_layers};
         entity_system::Property<layer_type, unit_type>            m_layer_end_of_line_withins{m_layers};
         entity_system::Property<layer_type, spacing_table_type>   m_layer_spacing_tables{m_layers};
+        entity_system::Property<layer_type, resistance_type>      m_layer_resistances{m_layers, resistance_type{0.0}};
+        entity_system::Property<layer_type, capacitance_type>     m_layer_capacitances{m_layers, capacitance_type{0.0}};
+        entity_system::Property<layer_type, track_grid_type>      m_layer_track_grids{m_layers};
+        entity_system::Property<layer_type, via_enclosure_container_type> m_cut_layer_via_enclosures{m_layers};
 
         entity_system::Property<via_type, via_name_type>          m_via_names{m_vias};
-        entity_system::Property<via_type, layer_name_to_via_geometry_type> m_via_layers_names_to_via_geometries{m_vias};
+        entity_system::Property<via_type, via_layer_geometries_type> m_via_layer_geometries{m_vias};
 
         entity_system::Property<track_type, track_orientation_type> m_track_orientations{m_tracks};
         entity_system::Property<track_type, unit_type>              m_track_starts{m_tracks};
@@ -140,5 +140,7 @@ namespace ophidian::routing::factory
 
             library.add_track(orientation, track.start(), track.number_of_tracks(), track.space(), track.layer_name());
         }
+
+        library.update_track_grids();
     }
 }
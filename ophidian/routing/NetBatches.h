@@ -0,0 +1,90 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_ROUTING_NET_BATCHES_H
+#define OPHIDIAN_ROUTING_NET_BATCHES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ophidian::routing
+{
+    //! Tiles covered by a net, both ends included
+    struct TileBox
+    {
+        int x_low, y_low, x_high, y_high;
+    };
+
+    //! Route nets in batches of disjoint nets
+
+    /*!
+       \brief Each round walks the pending nets in order and adds a net to the batch when
+       its tiles are not covered by the nets already in it; the other nets wait for the
+       next round. Nets of a batch never share a tile, so route_batch may route them
+       concurrently.
+       \param nets Indices of the nets, in routing order
+       \param tiles Side of the tiles x tiles partition of the routed area
+       \param batch_size Maximum number of nets in a batch, 0 counts as 1
+       \param tile_box Callable returning the TileBox of a net index, inside the partition
+       \param route_batch Callable routing a const std::vector<std::size_t> & of net indices
+     */
+    template <class TileBoxOf, class RouteBatch>
+    void route_in_batches(std::vector<std::size_t> nets, int tiles, std::size_t batch_size, TileBoxOf tile_box, RouteBatch route_batch)
+    {
+        batch_size = std::max<std::size_t>(batch_size, 1);
+        auto stamps = std::vector<std::size_t>(static_cast<std::size_t>(tiles) * tiles, 0);
+        std::size_t stamp = 0;
+
+        auto batch = std::vector<std::size_t>{};
+        auto deferred = std::vector<std::size_t>{};
+        while(!nets.empty()){
+            ++stamp;
+            batch.clear();
+            deferred.clear();
+
+            for(auto index : nets){
+                auto box = tile_box(index);
+
+                auto free = batch.size() < batch_size;
+                for(auto y = box.y_low; free && y <= box.y_high; ++y){
+                    for(auto x = box.x_low; free && x <= box.x_high; ++x){
+                        free = stamps[y * tiles + x] != stamp;
+                    }
+                }
+                if(!free){
+                    deferred.push_back(index);
+                    continue;
+                }
+                for(auto y = box.y_low; y <= box.y_high; ++y){
+                    for(auto x = box.x_low; x <= box.x_high; ++x){
+                        stamps[y * tiles + x] = stamp;
+                    }
+                }
+                batch.push_back(index);
+            }
+
+            route_batch(static_cast<const std::vector<std::size_t> &>(batch));
+
+            std::swap(nets, deferred);
+        }
+    }
+}
+
+#endif // OPHIDIAN_ROUTING_NET_BATCHES_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "TrackGrid.h"
+
+namespace ophidian::routing
+{
+    TrackAxis::TrackAxis(std::vector<TrackAxis::pattern_type> patterns)
+    {
+        patterns.erase(std::remove_if(patterns.begin(), patterns.end(),
+            [](const auto & pattern){ return pattern.number_of_tracks <= 0; }), patterns.end());
+
+        if(patterns.empty())
+        {
+            return;
+        }
+
+        std::sort(patterns.begin(), patterns.end(), [](const auto & a, const auto & b){
+            return a.start < b.start;
+        });
+
+        // patterns that continue each other with the same space form one uniform sequence
+        auto space = units::unit_cast<double>(patterns.front().space);
+        auto end = units::unit_cast<double>(patterns.front().start);
+        auto contiguous = space > 0.0;
+        for(const auto & pattern : patterns)
+        {
+            if(!contiguous)
+            {
+                break;
+            }
+            contiguous = units::unit_cast<double>(pattern.space) == space && units::unit_cast<double>(pattern.start) == end;
+            end += pattern.number_of_tracks * space;
+        }
+
+        if(contiguous)
+        {
+            m_start = units::unit_cast<double>(patterns.front().start);
+            m_space = space;
+            m_size = static_cast<scalar_type>(std::llround((end - m_start) / space));
+            return;
+        }
+
+        for(const auto & pattern : patterns)
+        {
+            auto start = units::unit_cast<double>(pattern.start);
+            auto step = units::unit_cast<double>(pattern.space);
+            for(scalar_type i = 0; i < pattern.number_of_tracks; ++i)
+            {
+                m_coordinates.push_back(start + i * step);
+            }
+        }
+        std::sort(m_coordinates.begin(), m_coordinates.end());
+        m_coordinates.erase(std::unique(m_coordinates.begin(), m_coordinates.end()), m_coordinates.end());
+        m_size = static_cast<scalar_type>(m_coordinates.size());
+    }
+}
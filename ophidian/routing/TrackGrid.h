@@ -0,0 +1,232 @@
+#ifndef OPHIDIAN_ROUTING_TRACK_GRID_H
+#define OPHIDIAN_ROUTING_TRACK_GRID_H
+
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace ophidian::routing
+{
+    enum class TrackOrientation {
+        X, Y
+    };
+
+    //! Track pattern
+
+    /*!
+       \brief One TRACKS statement: number_of_tracks tracks at start + i * space.
+     */
+    struct TrackPattern
+    {
+        util::database_unit_t start;
+        int number_of_tracks;
+        util::database_unit_t space;
+    };
+
+    //! Track axis
+
+    /*!
+       \brief Sorted track coordinates of one layer in one orientation. When the patterns form a
+       single uniform sequence the queries are pure arithmetic, otherwise they binary search the
+       explicit coordinates.
+     */
+    class TrackAxis
+    {
+    public:
+        using scalar_type           = int;
+        using unit_type             = util::database_unit_t;
+        using pattern_type          = TrackPattern;
+        using index_range_type      = std::pair<scalar_type, scalar_type>;
+
+        //! Index returned when the axis has no tracks
+        static constexpr scalar_type npos = -1;
+
+        //! Construct an empty axis
+        TrackAxis() = default;
+
+        //! Construct the axis from its track patterns
+        /*!
+           \brief Contiguous patterns with the same space are merged into one uniform sequence.
+           \param patterns Track patterns of the layer in this orientation
+         */
+        explicit TrackAxis(std::vector<pattern_type> patterns);
+
+        //! Number of tracks
+        scalar_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        //! True when every track is at start + i * space
+        bool uniform() const noexcept
+        {
+            return m_coordinates.empty();
+        }
+
+        //! Coordinate of a track
+        /*!
+           \param index Track index in [0, size())
+         */
+        unit_type coordinate(scalar_type index) const
+        {
+            if(uniform())
+            {
+                return unit_type{m_start + index * m_space};
+            }
+            return unit_type{m_coordinates[index]};
+        }
+
+        //! Nearest track
+        /*!
+           \brief Index of the track closest to a coordinate, ties go to the higher track.
+           \param coordinate Coordinate across the tracks
+           \return Track index, or npos when the axis has no tracks
+         */
+        scalar_type nearest(const unit_type & coordinate) const
+        {
+            if(m_size == 0)
+            {
+                return npos;
+            }
+
+            auto c = units::unit_cast<double>(coordinate);
+            if(uniform())
+            {
+                auto index = std::floor((c - m_start) / m_space + 0.5);
+                return static_cast<scalar_type>(std::clamp(index, 0.0, static_cast<double>(m_size - 1)));
+            }
+
+            auto next = std::lower_bound(m_coordinates.begin(), m_coordinates.end(), c);
+            if(next == m_coordinates.end())
+            {
+                return m_size - 1;
+            }
+            if(next != m_coordinates.begin() && c - *(next - 1) < *next - c)
+            {
+                --next;
+            }
+            return static_cast<scalar_type>(next - m_coordinates.begin());
+        }
+
+        //! Tracks crossing an interval
+        /*!
+           \brief Range of the tracks whose coordinate lies in [low, high].
+           \param low Lower end of the interval
+           \param high Upper end of the interval
+           \return Half open index range [first, second), empty when first == second
+         */
+        index_range_type crossing(const unit_type & low, const unit_type & high) const
+        {
+            auto l = units::unit_cast<double>(low);
+            auto h = units::unit_cast<double>(high);
+            if(uniform())
+            {
+                auto size = static_cast<double>(m_size);
+                auto first = std::clamp(std::ceil((l - m_start) / m_space), 0.0, size);
+                auto last = std::clamp(std::floor((h - m_start) / m_space) + 1.0, 0.0, size);
+                return {static_cast<scalar_type>(first), static_cast<scalar_type>(std::max(first, last))};
+            }
+
+            auto first = std::lower_bound(m_coordinates.begin(), m_coordinates.end(), l);
+            auto last = std::upper_bound(first, m_coordinates.end(), h);
+            return {static_cast<scalar_type>(first - m_coordinates.begin()), static_cast<scalar_type>(last - m_coordinates.begin())};
+        }
+
+        //! Number of tracks crossing an interval
+        scalar_type count(const unit_type & low, const unit_type & high) const
+        {
+            auto range = crossing(low, high);
+            return range.second - range.first;
+        }
+
+    private:
+        double m_start{0.0};
+        double m_space{0.0};
+        scalar_type m_size{0};
+        std::vector<double> m_coordinates{};
+    };
+
+    //! Track grid
+
+    /*!
+       \brief Track axes of one layer. X tracks are vertical lines placed along x, Y tracks
+       are horizontal lines placed along y.
+     */
+    class TrackGrid
+    {
+    public:
+        using scalar_type           = TrackAxis::scalar_type;
+        using unit_type             = TrackAxis::unit_type;
+        using axis_type             = TrackAxis;
+        using index_range_type      = TrackAxis::index_range_type;
+        using orientation_type      = TrackOrientation;
+        using box_type              = geometry::Box<unit_type>;
+
+        //! Construct an empty grid
+        TrackGrid() = default;
+
+        //! Construct the grid from its axes
+        TrackGrid(axis_type x_tracks, axis_type y_tracks) :
+            m_x_tracks{std::move(x_tracks)},
+            m_y_tracks{std::move(y_tracks)}
+        {
+        }
+
+        const axis_type & axis(const orientation_type & orientation) const noexcept
+        {
+            return orientation == orientation_type::X ? m_x_tracks : m_y_tracks;
+        }
+
+        //! Nearest track
+        /*!
+           \brief Index of the track of an orientation closest to a coordinate.
+           \param orientation Track orientation
+           \param coordinate x for X tracks, y for Y tracks
+           \return Track index, or TrackAxis::npos when there are no such tracks
+         */
+        scalar_type nearest_track(const orientation_type & orientation, const unit_type & coordinate) const
+        {
+            return axis(orientation).nearest(coordinate);
+        }
+
+        //! Track coordinate
+        unit_type track_coordinate(const orientation_type & orientation, scalar_type index) const
+        {
+            return axis(orientation).coordinate(index);
+        }
+
+        //! Tracks crossing an interval
+        /*!
+           \brief Half open index range of the tracks of an orientation inside [low, high].
+         */
+        index_range_type tracks_crossing(const orientation_type & orientation, const unit_type & low, const unit_type & high) const
+        {
+            return axis(orientation).crossing(low, high);
+        }
+
+        //! Number of tracks of an orientation inside a box
+        scalar_type number_of_tracks(const orientation_type & orientation, const box_type & box) const
+        {
+            if(orientation == orientation_type::X)
+            {
+                return m_x_tracks.count(box.min_corner().x(), box.max_corner().x());
+            }
+            return m_y_tracks.count(box.min_corner().y(), box.max_corner().y());
+        }
+
+        //! Number of tracks of both orientations inside a box
+        scalar_type number_of_tracks(const box_type & box) const
+        {
+            return number_of_tracks(orientation_type::X, box) + number_of_tracks(orientation_type::Y, box);
+        }
+
+    private:
+        axis_type m_x_tracks{};
+        axis_type m_y_tracks{};
+    };
+}
+
+#endif // OPHIDIAN_ROUTING_TRACK_GRID_H
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Elmore.h"
+
+#include <ophidian/interconnection/TreeReader.h>
+
+#include <cmath>
+#include <limits>
+
+namespace ophidian::timing
+{
+    namespace
+    {
+        constexpr auto no_parent = std::numeric_limits<std::uint32_t>::max();
+    }
+
+    Elmore::Elmore(Elmore::resistance_type horizontal_resistance, Elmore::capacitance_type horizontal_capacitance, Elmore::resistance_type vertical_resistance, Elmore::capacitance_type vertical_capacitance):
+        m_horizontal_resistance(units::unit_cast<double>(horizontal_resistance)),
+        m_horizontal_capacitance(units::unit_cast<double>(horizontal_capacitance)),
+        m_vertical_resistance(units::unit_cast<double>(vertical_resistance)),
+        m_vertical_capacitance(units::unit_cast<double>(vertical_capacitance))
+    {
+    }
+
+    Elmore::Elmore(const routing::Library & library, const Elmore::layer_type & horizontal, const Elmore::layer_type & vertical):
+        Elmore(library.resistance(horizontal), library.capacitance(horizontal), library.resistance(vertical), library.capacitance(vertical))
+    {
+    }
+
+    Elmore::Tree Elmore::flatten(const interconnection::SteinerTree & tree)
+    {
+        auto flat = Elmore::Tree{};
+        interconnection::detail::TreeReader::read(tree, flat.points, flat.segments);
+        return flat;
+    }
+
+    void Elmore::compute(const Elmore::Tree & tree, Elmore::node_type root, const std::vector<double> & loads, Elmore::Scratch & scratch) const
+    {
+        auto size = tree.points.size();
+        auto segments = tree.segments.size();
+
+        // segment resistances, and half of every segment capacitance on each of its ends
+        scratch.begins.assign(size + 1, 0);
+        scratch.resistances.resize(segments);
+        scratch.downstream.assign(loads.begin(), loads.begin() + size);
+        scratch.capacitance = 0.0;
+        for(std::size_t s = 0; s < segments; ++s)
+        {
+            auto [a, b] = tree.segments[s];
+            auto dx = std::abs(units::unit_cast<double>(tree.points[a].x() - tree.points[b].x()));
+            auto dy = std::abs(units::unit_cast<double>(tree.points[a].y() - tree.points[b].y()));
+            auto capacitance = m_horizontal_capacitance * dx + m_vertical_capacitance * dy;
+            scratch.resistances[s] = m_horizontal_resistance * dx + m_vertical_resistance * dy;
+            scratch.capacitance += capacitance;
+            scratch.downstream[a] += capacitance / 2;
+            scratch.downstream[b] += capacitance / 2;
+            ++scratch.begins[a + 1];
+            ++scratch.begins[b + 1];
+        }
+        for(std::size_t node = 0; node < size; ++node)
+        {
+            scratch.begins[node + 1] += scratch.begins[node];
+        }
+        scratch.adjacent.resize(2 * segments);
+        scratch.order.assign(scratch.begins.begin(), scratch.begins.end() - 1);
+        for(std::size_t s = 0; s < segments; ++s)
+        {
+            auto [a, b] = tree.segments[s];
+            scratch.adjacent[scratch.order[a]++] = {b, static_cast<std::uint32_t>(s)};
+            scratch.adjacent[scratch.order[b]++] = {a, static_cast<std::uint32_t>(s)};
+        }
+
+        // breadth first order, the parent segment of the root stays unset
+        scratch.parents.assign(size, no_parent);
+        scratch.order.clear();
+        scratch.order.push_back(root);
+        auto visited = [&](node_type node){ return node == root || scratch.parents[node] != no_parent; };
+        for(std::size_t i = 0; i < scratch.order.size(); ++i)
+        {
+            auto node = scratch.order[i];
+            for(auto j = scratch.begins[node]; j < scratch.begins[node + 1]; ++j)
+            {
+                auto [next, segment] = scratch.adjacent[j];
+                if(!visited(next))
+                {
+                    scratch.parents[next] = segment;
+                    scratch.order.push_back(next);
+                }
+            }
+        }
+
+        auto parent = [&](node_type node){
+            auto [a, b] = tree.segments[scratch.parents[node]];
+            return a == node ? b : a;
+        };
+
+        for(auto i = scratch.order.size(); i > 1; --i)
+        {
+            auto node = scratch.order[i - 1];
+            scratch.downstream[parent(node)] += scratch.downstream[node];
+        }
+
+        // nodes the root does not reach keep a zero delay
+        scratch.delays.assign(size, 0.0);
+        for(std::size_t i = 1; i < scratch.order.size(); ++i)
+        {
+            auto node = scratch.order[i];
+            scratch.delays[node] = scratch.delays[parent(node)] + scratch.resistances[scratch.parents[node]] * scratch.downstream[node];
+        }
+    }
+}
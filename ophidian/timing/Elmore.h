@@ -0,0 +1,113 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_ELMORE_H
+#define OPHIDIAN_TIMING_ELMORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <ophidian/geometry/Models.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/interconnection/SteinerTree.h>
+#include <ophidian/routing/Library.h>
+
+namespace ophidian::timing
+{
+    //! Elmore delay of rectilinear wire trees
+
+    /*!
+       \brief Turns a wire tree rooted at its driver into an RC tree and computes the Elmore
+       delay and the downstream capacitance of every node. Horizontal wire takes the unit
+       resistance and capacitance of one routing layer and vertical wire the ones of another;
+       a diagonal segment is charged as its horizontal and vertical parts. Every segment is a
+       pi model, half of its capacitance on each end.
+
+       The tree is ordered breadth first from the root, then a backward pass sums the
+       downstream capacitances and a forward pass accumulates the delays, both linear in the
+       size of the tree. All the storage lives in a Scratch, so a thread that keeps its own
+       Scratch computes any number of nets without allocating.
+     */
+    class Elmore
+    {
+    public:
+        using unit_type                 = util::database_unit_t;
+        using point_type                = geometry::Point<unit_type>;
+        using resistance_type           = routing::Library::resistance_type;
+        using capacitance_type          = routing::Library::capacitance_type;
+        using time_type                 = util::picosecond_t;
+        using layer_type                = routing::Library::layer_type;
+        using node_type                 = std::uint32_t;
+
+        //! Tree in flat form, segments are pairs of node indices
+        struct Tree
+        {
+            std::vector<point_type> points;
+            std::vector<std::pair<node_type, node_type>> segments;
+        };
+
+        //! Per thread storage and the results of the last compute()
+        struct Scratch
+        {
+            //! Elmore delay from the root to every node, in picoseconds
+            std::vector<double> delays;
+            //! Capacitance seen downstream of every node, loads included, in femtofarads
+            std::vector<double> downstream;
+            //! Total wire capacitance, in femtofarads
+            double capacitance{0.0};
+
+            std::vector<std::size_t> begins;
+            std::vector<std::pair<node_type, std::uint32_t>> adjacent;
+            std::vector<node_type> order;
+            std::vector<std::uint32_t> parents;
+            std::vector<double> resistances;
+        };
+
+        // Constructors
+        Elmore() = delete;
+
+        //! Construct from unit resistances and capacitances per database unit
+        Elmore(resistance_type horizontal_resistance, capacitance_type horizontal_capacitance, resistance_type vertical_resistance, capacitance_type vertical_capacitance);
+
+        //! Construct from the layers carrying the horizontal and the vertical wires
+        Elmore(const routing::Library & library, const layer_type & horizontal, const layer_type & vertical);
+
+        // Element access
+        //! Convert a Steiner tree to the flat form, nodes numbered as in the tree graph
+        static Tree flatten(const interconnection::SteinerTree & tree);
+
+        //! Compute delays and downstream capacitances
+        /*!
+           \param tree The wire tree
+           \param root Node of the driver
+           \param loads Pin capacitance on every node, in femtofarads
+           \param scratch Storage, holds the results
+         */
+        void compute(const Tree & tree, node_type root, const std::vector<double> & loads, Scratch & scratch) const;
+
+    private:
+        double m_horizontal_resistance;
+        double m_horizontal_capacitance;
+        double m_vertical_resistance;
+        double m_vertical_capacitance;
+    };
+}
+
+#endif // OPHIDIAN_TIMING_ELMORE_H
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Library.h"
+
+namespace ophidian::timing
+{
+    namespace
+    {
+        template <class Table>
+        Table zero_table()
+        {
+            using contents_type = typename Table::contents_type;
+            auto contents = contents_type{};
+            contents.row_values.resize(1);
+            contents.column_values.resize(1);
+            contents.values.assign(1, {typename contents_type::value_container_type::value_type::value_type{0.0}});
+            return Table{contents};
+        }
+    }
+
+    Library::Library(const circuit::StandardCells & std_cells):
+        m_capacitances{std_cells.make_property_pin<capacitance_type>()},
+        m_pin_arcs{std_cells.make_property_pin<timing_arc_list_type>()},
+        m_clocks{std_cells.make_property_pin<char>()}
+    {
+    }
+
+    Library::capacitance_type& Library::capacitance(const Library::std_cell_pin_type& pin)
+    {
+        return m_capacitances[pin];
+    }
+
+    const Library::capacitance_type& Library::capacitance(const Library::std_cell_pin_type& pin) const
+    {
+        return m_capacitances[pin];
+    }
+
+    const Library::timing_arc_list_type& Library::arcs(const Library::std_cell_pin_type& pin) const
+    {
+        return m_pin_arcs[pin];
+    }
+
+    const Library::std_cell_pin_type& Library::from(const Library::timing_arc_type& arc) const
+    {
+        return m_from[arc];
+    }
+
+    const Library::std_cell_pin_type& Library::to(const Library::timing_arc_type& arc) const
+    {
+        return m_to[arc];
+    }
+
+    Library::timing_sense_type& Library::sense(const Library::timing_arc_type& arc)
+    {
+        return m_senses[arc];
+    }
+
+    const Library::timing_sense_type& Library::sense(const Library::timing_arc_type& arc) const
+    {
+        return m_senses[arc];
+    }
+
+    Library::timing_type_type& Library::type(const Library::timing_arc_type& arc)
+    {
+        return m_types[arc];
+    }
+
+    const Library::timing_type_type& Library::type(const Library::timing_arc_type& arc) const
+    {
+        return m_types[arc];
+    }
+
+    Library::delay_table_type& Library::cell_rise(const Library::timing_arc_type& arc)
+    {
+        return m_cell_rise[arc];
+    }
+
+    const Library::delay_table_type& Library::cell_rise(const Library::timing_arc_type& arc) const
+    {
+        return m_cell_rise[arc];
+    }
+
+    Library::delay_table_type& Library::cell_fall(const Library::timing_arc_type& arc)
+    {
+        return m_cell_fall[arc];
+    }
+
+    const Library::delay_table_type& Library::cell_fall(const Library::timing_arc_type& arc) const
+    {
+        return m_cell_fall[arc];
+    }
+
+    Library::delay_table_type& Library::rise_transition(const Library::timing_arc_type& arc)
+    {
+        return m_rise_transition[arc];
+    }
+
+    const Library::delay_table_type& Library::rise_transition(const Library::timing_arc_type& arc) const
+    {
+        return m_rise_transition[arc];
+    }
+
+    Library::delay_table_type& Library::fall_transition(const Library::timing_arc_type& arc)
+    {
+        return m_fall_transition[arc];
+    }
+
+    const Library::delay_table_type& Library::fall_transition(const Library::timing_arc_type& arc) const
+    {
+        return m_fall_transition[arc];
+    }
+
+    Library::constraint_table_type& Library::rise_constraint(const Library::timing_arc_type& arc)
+    {
+        return m_rise_constraint[arc];
+    }
+
+    const Library::constraint_table_type& Library::rise_constraint(const Library::timing_arc_type& arc) const
+    {
+        return m_rise_constraint[arc];
+    }
+
+    Library::constraint_table_type& Library::fall_constraint(const Library::timing_arc_type& arc)
+    {
+        return m_fall_constraint[arc];
+    }
+
+    const Library::constraint_table_type& Library::fall_constraint(const Library::timing_arc_type& arc) const
+    {
+        return m_fall_constraint[arc];
+    }
+
+    bool Library::clock(const Library::std_cell_pin_type& pin) const
+    {
+        return m_clocks[pin] != 0;
+    }
+
+    Library::timing_arc_container_type::const_iterator Library::begin_timing_arc() const noexcept
+    {
+        return m_arcs.begin();
+    }
+
+    Library::timing_arc_container_type::const_iterator Library::end_timing_arc() const noexcept
+    {
+        return m_arcs.end();
+    }
+
+    Library::timing_arc_container_type::size_type Library::size_timing_arc() const noexcept
+    {
+        return m_arcs.size();
+    }
+
+    Library::timing_arc_type Library::add_timing_arc(const Library::std_cell_pin_type& from, const Library::std_cell_pin_type& to, Library::timing_sense_type sense, Library::timing_type_type type)
+    {
+        auto arc = m_arcs.add();
+        m_from[arc] = from;
+        m_to[arc] = to;
+        m_senses[arc] = sense;
+        m_types[arc] = type;
+        m_cell_rise[arc] = zero_table<delay_table_type>();
+        m_cell_fall[arc] = zero_table<delay_table_type>();
+        m_rise_transition[arc] = zero_table<delay_table_type>();
+        m_fall_transition[arc] = zero_table<delay_table_type>();
+        m_rise_constraint[arc] = zero_table<constraint_table_type>();
+        m_fall_constraint[arc] = zero_table<constraint_table_type>();
+        m_pin_arcs[to].push_back(arc);
+        if(type != TimingType::COMBINATIONAL)
+        {
+            m_clocks[from] = 1;
+        }
+        return arc;
+    }
+}
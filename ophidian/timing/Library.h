@@ -0,0 +1,159 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_LIBRARY_H
+#define OPHIDIAN_TIMING_LIBRARY_H
+
+#include <vector>
+
+#include <ophidian/entity_system/EntitySystem.h>
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/util/LookupTable.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/StandardCells.h>
+
+namespace ophidian::timing
+{
+    class TimingArc :
+        public entity_system::EntityBase
+    {
+    public:
+        using entity_system::EntityBase::EntityBase;
+    };
+
+    enum class TimingSense {
+        POSITIVE_UNATE, NEGATIVE_UNATE, NON_UNATE
+    };
+
+    enum class TimingType {
+        COMBINATIONAL, RISING_EDGE, FALLING_EDGE, SETUP_RISING, SETUP_FALLING, HOLD_RISING, HOLD_FALLING
+    };
+
+    //! Timing library
+
+    /*!
+       \brief Input capacitances of the standard cell pins and the timing arcs between them.
+       Delay and transition tables are indexed by the output load (rows) and the input slew
+       (columns); constraint tables by the slew of the related clock pin (rows) and the slew
+       of the constrained data pin (columns).
+     */
+    class Library
+    {
+    public:
+        using time_type                 = util::picosecond_t;
+        using capacitance_type          = util::femtofarad_t;
+
+        using delay_table_type          = util::LookupTable<capacitance_type, time_type, time_type, util::InterpolationStrategy<capacitance_type, time_type, time_type>>;
+        using delay_contents_type       = delay_table_type::contents_type;
+        using constraint_table_type     = util::LookupTable<time_type, time_type, time_type, util::InterpolationStrategy<time_type, time_type, time_type>>;
+        using constraint_contents_type  = constraint_table_type::contents_type;
+
+        using std_cell_pin_type         = circuit::StandardCells::pin_type;
+
+        using timing_arc_type           = TimingArc;
+        using timing_arc_container_type = entity_system::EntitySystem<timing_arc_type>;
+        using timing_arc_list_type      = std::vector<timing_arc_type>;
+
+        using timing_sense_type         = TimingSense;
+        using timing_type_type          = TimingType;
+
+        // Constructors
+        Library() = delete;
+
+        Library(const Library&) = delete;
+        Library& operator=(const Library&) = delete;
+
+        Library(Library&&) = delete;
+        Library& operator=(Library&&) = delete;
+
+        Library(const circuit::StandardCells & std_cells);
+
+        // Element access
+        capacitance_type& capacitance(const std_cell_pin_type& pin);
+        const capacitance_type& capacitance(const std_cell_pin_type& pin) const;
+
+        //! Arcs ending at a pin
+        const timing_arc_list_type& arcs(const std_cell_pin_type& pin) const;
+
+        const std_cell_pin_type& from(const timing_arc_type& arc) const;
+
+        const std_cell_pin_type& to(const timing_arc_type& arc) const;
+
+        timing_sense_type& sense(const timing_arc_type& arc);
+        const timing_sense_type& sense(const timing_arc_type& arc) const;
+
+        timing_type_type& type(const timing_arc_type& arc);
+        const timing_type_type& type(const timing_arc_type& arc) const;
+
+        delay_table_type& cell_rise(const timing_arc_type& arc);
+        const delay_table_type& cell_rise(const timing_arc_type& arc) const;
+
+        delay_table_type& cell_fall(const timing_arc_type& arc);
+        const delay_table_type& cell_fall(const timing_arc_type& arc) const;
+
+        delay_table_type& rise_transition(const timing_arc_type& arc);
+        const delay_table_type& rise_transition(const timing_arc_type& arc) const;
+
+        delay_table_type& fall_transition(const timing_arc_type& arc);
+        const delay_table_type& fall_transition(const timing_arc_type& arc) const;
+
+        constraint_table_type& rise_constraint(const timing_arc_type& arc);
+        const constraint_table_type& rise_constraint(const timing_arc_type& arc) const;
+
+        constraint_table_type& fall_constraint(const timing_arc_type& arc);
+        const constraint_table_type& fall_constraint(const timing_arc_type& arc) const;
+
+        //! True when the pin is the related pin of a sequential arc or a check
+        bool clock(const std_cell_pin_type& pin) const;
+
+        // Iterators
+        timing_arc_container_type::const_iterator begin_timing_arc() const noexcept;
+        timing_arc_container_type::const_iterator end_timing_arc() const noexcept;
+
+        // Capacity
+        timing_arc_container_type::size_type size_timing_arc() const noexcept;
+
+        // Modifiers
+        //! Add an arc, its tables return zero until they are set
+        timing_arc_type add_timing_arc(const std_cell_pin_type& from, const std_cell_pin_type& to, timing_sense_type sense, timing_type_type type);
+
+        template <typename Value>
+        entity_system::Property<timing_arc_type, Value> make_property_timing_arc() const noexcept
+        {
+            return entity_system::Property<timing_arc_type, Value>(m_arcs);
+        }
+
+    private:
+        timing_arc_container_type                                         m_arcs{};
+        entity_system::Property<std_cell_pin_type, capacitance_type>      m_capacitances;
+        entity_system::Property<std_cell_pin_type, timing_arc_list_type>  m_pin_arcs;
+        entity_system::Property<std_cell_pin_type, char>                  m_clocks;
+        entity_system::Property<timing_arc_type, std_cell_pin_type>       m_from{m_arcs};
+        entity_system::Property<timing_arc_type, std_cell_pin_type>       m_to{m_arcs};
+        entity_system::Property<timing_arc_type, timing_sense_type>       m_senses{m_arcs};
+        entity_system::Property<timing_arc_type, timing_type_type>        m_types{m_arcs};
+        entity_system::Property<timing_arc_type, delay_table_type>        m_cell_rise{m_arcs};
+        entity_system::Property<timing_arc_type, delay_table_type>        m_cell_fall{m_arcs};
+        entity_system::Property<timing_arc_type, delay_table_type>        m_rise_transition{m_arcs};
+        entity_system::Property<timing_arc_type, delay_table_type>        m_fall_transition{m_arcs};
+        entity_system::Property<timing_arc_type, constraint_table_type>   m_rise_constraint{m_arcs};
+        entity_system::Property<timing_arc_type, constraint_table_type>   m_fall_constraint{m_arcs};
+    };
+}
+
+#endif // OPHIDIAN_TIMING_LIBRARY_H
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include <sstream>
+#include <unordered_map>
+
+#include "LibraryFactory.h"
+
+namespace ophidian::timing::factory
+{
+    namespace
+    {
+        // Liberty tables put their variables in any order, library tables have a fixed row variable
+        template <class Contents>
+        Contents make_contents(const parser::Liberty::Table& table, const std::string& row_variable, double row_scale, double column_scale, double value_scale)
+        {
+            using row_type = typename Contents::row_container_type::value_type;
+            using column_type = typename Contents::column_container_type::value_type;
+            using value_type = typename Contents::value_container_type::value_type::value_type;
+
+            auto transpose = !table.variable_1.empty() && table.variable_1 != row_variable;
+            auto rows = transpose ? table.index_2 : table.index_1;
+            auto columns = transpose ? table.index_1 : table.index_2;
+            if(rows.empty())
+            {
+                rows.push_back(0.0);
+            }
+            if(columns.empty())
+            {
+                columns.push_back(0.0);
+            }
+
+            auto values = std::vector<std::vector<double>>(rows.size(), std::vector<double>(columns.size()));
+            for(std::size_t i = 0; i < rows.size(); ++i)
+            {
+                for(std::size_t j = 0; j < columns.size(); ++j)
+                {
+                    values[i][j] = transpose ? table.values[j][i] : table.values[i][j];
+                }
+            }
+
+            // interpolation needs two points on each axis of a table that is not a scalar
+            if(rows.size() == 1 && columns.size() > 1)
+            {
+                rows.push_back(rows.front() + 1.0);
+                values.push_back(values.front());
+            }
+            if(columns.size() == 1 && rows.size() > 1)
+            {
+                columns.push_back(columns.front() + 1.0);
+                for(auto & row : values)
+                {
+                    row.push_back(row.front());
+                }
+            }
+
+            auto contents = Contents{};
+            for(auto row : rows)
+            {
+                contents.row_values.push_back(row_type{row * row_scale});
+            }
+            for(auto column : columns)
+            {
+                contents.column_values.push_back(column_type{column * column_scale});
+            }
+            for(const auto & row : values)
+            {
+                contents.values.emplace_back();
+                for(auto value : row)
+                {
+                    contents.values.back().push_back(value_type{value * value_scale});
+                }
+            }
+            return contents;
+        }
+    }
+
+    void make_library(Library& library, const parser::Liberty& liberty, const circuit::StandardCells& std_cells)
+    {
+        // library units in picoseconds and femtofarads
+        auto time_scale = units::unit_cast<double>(liberty.time_unit()) * 1e12;
+        auto capacitance_scale = units::unit_cast<double>(liberty.capacitance_unit()) * 1e15;
+
+        auto std_pins = std::unordered_map<std::string, Library::std_cell_pin_type>{};
+        for(auto pin : std_cells.range_pin())
+        {
+            std_pins.emplace(std_cells.name(pin), pin);
+        }
+
+        auto delay = [&](const parser::Liberty::Table& table){
+            return Library::delay_table_type{make_contents<Library::delay_contents_type>(table, "total_output_net_capacitance", capacitance_scale, time_scale, time_scale)};
+        };
+        auto constraint = [&](const parser::Liberty::Table& table){
+            return Library::constraint_table_type{make_contents<Library::constraint_contents_type>(table, "related_pin_transition", time_scale, time_scale, time_scale)};
+        };
+
+        for(const auto & cell : liberty.cells())
+        {
+            for(const auto & pin : cell.pins)
+            {
+                auto to = std_pins.find(cell.name + ":" + pin.name);
+                if(to == std_pins.end())
+                {
+                    continue;
+                }
+                library.capacitance(to->second) = Library::capacitance_type{pin.capacitance * capacitance_scale};
+
+                for(const auto & timing : pin.timings)
+                {
+                    auto type = TimingType{};
+                    switch(timing.timing_type)
+                    {
+                    case parser::Liberty::TimingType::COMBINATIONAL: type = TimingType::COMBINATIONAL; break;
+                    case parser::Liberty::TimingType::RISING_EDGE: type = TimingType::RISING_EDGE; break;
+                    case parser::Liberty::TimingType::FALLING_EDGE: type = TimingType::FALLING_EDGE; break;
+                    case parser::Liberty::TimingType::SETUP_RISING: type = TimingType::SETUP_RISING; break;
+                    case parser::Liberty::TimingType::SETUP_FALLING: type = TimingType::SETUP_FALLING; break;
+                    case parser::Liberty::TimingType::HOLD_RISING: type = TimingType::HOLD_RISING; break;
+                    case parser::Liberty::TimingType::HOLD_FALLING: type = TimingType::HOLD_FALLING; break;
+                    default: continue;
+                    }
+                    auto sense = timing.timing_sense == parser::Liberty::TimingSense::POSITIVE_UNATE ? TimingSense::POSITIVE_UNATE :
+                                 timing.timing_sense == parser::Liberty::TimingSense::NEGATIVE_UNATE ? TimingSense::NEGATIVE_UNATE : TimingSense::NON_UNATE;
+
+                    auto related_pins = std::istringstream{timing.related_pin};
+                    auto related = std::string{};
+                    while(related_pins >> related)
+                    {
+                        auto from = std_pins.find(cell.name + ":" + related);
+                        if(from == std_pins.end())
+                        {
+                            continue;
+                        }
+                        auto arc = library.add_timing_arc(from->second, to->second, sense, type);
+                        if(!timing.cell_rise.empty())
+                        {
+                            library.cell_rise(arc) = delay(timing.cell_rise);
+                        }
+                        if(!timing.cell_fall.empty())
+                        {
+                            library.cell_fall(arc) = delay(timing.cell_fall);
+                        }
+                        if(!timing.rise_transition.empty())
+                        {
+                            library.rise_transition(arc) = delay(timing.rise_transition);
+                        }
+                        if(!timing.fall_transition.empty())
+                        {
+                            library.fall_transition(arc) = delay(timing.fall_transition);
+                        }
+                        if(!timing.rise_constraint.empty())
+                        {
+                            library.rise_constraint(arc) = constraint(timing.rise_constraint);
+                        }
+                        if(!timing.fall_constraint.empty())
+                        {
+                            library.fall_constraint(arc) = constraint(timing.fall_constraint);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
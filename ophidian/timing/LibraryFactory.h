@@ -0,0 +1,33 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_LIBRARYFACTORY_H
+#define OPHIDIAN_TIMING_LIBRARYFACTORY_H
+
+#include <ophidian/parser/Liberty.h>
+#include <ophidian/circuit/StandardCells.h>
+
+#include "Library.h"
+
+namespace ophidian::timing::factory
+{
+    //! Fill the library with the pins and arcs of the Liberty cells found in the standard cells
+    void make_library(Library& library, const parser::Liberty& liberty, const circuit::StandardCells& std_cells);
+}
+
+#endif // OPHIDIAN_TIMING_LIBRARYFACTORY_H
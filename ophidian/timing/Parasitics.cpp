@@ -0,0 +1,335 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "Parasitics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::timing
+{
+    Parasitics::Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Parasitics::Parameters & parameters):
+        Subscription(placement, *this),
+        m_graph(graph),
+        m_netlist(netlist),
+        m_placement(placement),
+        m_parameters(parameters),
+        m_elmore(nullptr),
+        m_drivers(netlist.make_property_net<vertex_type>()),
+        m_dirty(netlist.make_property_net<char>()),
+        m_wires(netlist.make_property_net<Wire>()),
+        m_workspaces(util::number_of_threads(parameters.number_of_threads)),
+        m_capacitances(graph.size_vertex(), 0.0),
+        m_delays(graph.size_arc(), 0.0)
+    {
+        // the driver is the pin with net arcs in its fanout
+        auto none = static_cast<vertex_type>(graph.size_vertex());
+        for(auto net = netlist.begin_net(); net != netlist.end_net(); ++net)
+        {
+            m_drivers[*net] = none;
+            m_dirty[*net] = 0;
+            for(auto pin : netlist.pins(*net))
+            {
+                auto vertex = graph.vertex(pin);
+                auto fanout = graph.fanout(vertex);
+                if(std::any_of(fanout.begin(), fanout.end(), [&](arc_type arc){ return graph.net_arc(arc); }))
+                {
+                    m_drivers[*net] = vertex;
+                    break;
+                }
+            }
+        }
+    }
+
+    Parasitics::Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement):
+        Parasitics(graph, netlist, placement, Parameters{})
+    {
+    }
+
+    Parasitics::Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Elmore & elmore, const Parasitics::Parameters & parameters):
+        Parasitics(graph, netlist, placement, parameters)
+    {
+        m_elmore = &elmore;
+    }
+
+    Parasitics::Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Elmore & elmore):
+        Parasitics(graph, netlist, placement, elmore, Parameters{})
+    {
+    }
+
+    Parasitics::vertex_type Parasitics::driver(const Parasitics::net_type & net) const
+    {
+        return m_drivers[net];
+    }
+
+    void Parasitics::update()
+    {
+        auto nets = std::vector<net_type>(m_netlist.begin_net(), m_netlist.end_net());
+
+        // every net writes its own wire and the entries of its own driver and net arcs
+        util::parallel_for(0, nets.size(), [&](std::size_t i, std::size_t thread){
+            if(m_elmore != nullptr)
+            {
+                build_wire(nets[i], m_workspaces[thread]);
+            }
+            estimate(nets[i], m_workspaces[thread]);
+        }, m_workspaces.size(), 1024);
+
+        for(auto net : m_dirty_nets)
+        {
+            m_dirty[net] = 0;
+        }
+        m_dirty_nets.clear();
+    }
+
+    void Parasitics::invalidate(const Parasitics::cell_type & cell)
+    {
+        for(auto pin : m_netlist.pins(cell))
+        {
+            auto net = m_netlist.net(pin);
+            if(net != net_type{})
+            {
+                invalidate(net);
+            }
+        }
+    }
+
+    void Parasitics::invalidate(const Parasitics::net_type & net)
+    {
+        if(!m_dirty[net])
+        {
+            m_dirty[net] = 1;
+            m_dirty_nets.push_back(net);
+        }
+    }
+
+    void Parasitics::moved(const placement::Placement::move_container_type & moves)
+    {
+        for(const auto & move : moves)
+        {
+            invalidate(move.cell);
+        }
+    }
+
+    void Parasitics::oriented(const Parasitics::cell_type & cell)
+    {
+        invalidate(cell);
+    }
+
+    Parasitics::vertex_container_type Parasitics::update_dirty()
+    {
+        auto drivers = vertex_container_type{};
+        for(auto net : m_dirty_nets)
+        {
+            m_dirty[net] = 0;
+            if(m_elmore != nullptr)
+            {
+                build_wire(net, m_workspaces.front());
+            }
+            if(estimate(net, m_workspaces.front()))
+            {
+                drivers.push_back(m_drivers[net]);
+            }
+        }
+        m_dirty_nets.clear();
+        std::sort(drivers.begin(), drivers.end());
+        return drivers;
+    }
+
+    bool Parasitics::location(const Parasitics::pin_type & pin, Elmore::point_type & point) const
+    {
+        if(m_netlist.cell(pin) != circuit::CellInstance{})
+        {
+            point = m_placement.location(pin);
+        }
+        else if(m_netlist.input(pin) != circuit::Input{})
+        {
+            point = m_placement.location(m_netlist.input(pin));
+        }
+        else if(m_netlist.output(pin) != circuit::Output{})
+        {
+            point = m_placement.location(m_netlist.output(pin));
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void Parasitics::build_wire(const Parasitics::net_type & net, Parasitics::Workspace & workspace)
+    {
+        auto & wire = m_wires[net];
+        wire.tree.points.clear();
+        wire.tree.segments.clear();
+        wire.nodes.clear();
+        if(m_drivers[net] == m_graph.size_vertex())
+        {
+            return;
+        }
+
+        auto none = static_cast<node_type>(-1);
+        auto & points = workspace.pins;
+        points.clear();
+        for(auto pin : m_netlist.pins(net))
+        {
+            auto point = Elmore::point_type{};
+            wire.nodes.push_back(location(pin, point) ? 0 : none);
+            if(wire.nodes.back() != none)
+            {
+                points.push_back(point);
+            }
+        }
+        m_topologies.create(points, wire.tree.points, wire.tree.segments);
+
+        // FLUTE rounds the pins to integer coordinates, a pin takes the nearest node
+        auto nodes = std::vector<std::pair<std::pair<double, double>, node_type>>{};
+        for(node_type node = 0; node < wire.tree.points.size(); ++node)
+        {
+            const auto & point = wire.tree.points[node];
+            nodes.emplace_back(std::make_pair(units::unit_cast<double>(point.x()), units::unit_cast<double>(point.y())), node);
+        }
+        std::sort(nodes.begin(), nodes.end());
+        auto next = points.begin();
+        for(auto & node : wire.nodes)
+        {
+            if(node == none)
+            {
+                continue;
+            }
+            auto key = std::make_pair(std::round(units::unit_cast<double>(next->x())), std::round(units::unit_cast<double>(next->y())));
+            auto found = std::lower_bound(nodes.begin(), nodes.end(), std::make_pair(key, node_type{0}));
+            if(found != nodes.end() && found->first == key)
+            {
+                node = found->second;
+            }
+            else
+            {
+                auto distance = [&](const auto & candidate){
+                    return std::abs(candidate.first.first - key.first) + std::abs(candidate.first.second - key.second);
+                };
+                node = std::min_element(nodes.begin(), nodes.end(), [&](const auto & a, const auto & b){ return distance(a) < distance(b); })->second;
+            }
+            ++next;
+        }
+    }
+
+    bool Parasitics::estimate(const Parasitics::net_type & net, Parasitics::Workspace & workspace)
+    {
+        if(m_elmore != nullptr)
+        {
+            return estimate_elmore(net, workspace);
+        }
+
+        auto driver = m_drivers[net];
+        if(driver == m_graph.size_vertex())
+        {
+            return false;
+        }
+
+        auto low_x = std::numeric_limits<double>::infinity();
+        auto low_y = low_x;
+        auto high_x = -low_x;
+        auto high_y = -low_x;
+        for(auto pin : m_netlist.pins(net))
+        {
+            auto point = Elmore::point_type{};
+            if(!location(pin, point))
+            {
+                continue;
+            }
+            auto x = units::unit_cast<double>(point.x());
+            auto y = units::unit_cast<double>(point.y());
+            low_x = std::min(low_x, x);
+            high_x = std::max(high_x, x);
+            low_y = std::min(low_y, y);
+            high_y = std::max(high_y, y);
+        }
+
+        auto length = (high_x - low_x) + (high_y - low_y);
+        auto resistance = units::unit_cast<double>(m_parameters.resistance) * length;
+        auto capacitance = units::unit_cast<double>(m_parameters.capacitance) * length;
+
+        // kiloohm times femtofarad is a picosecond
+        auto changed = m_capacitances[driver] != capacitance;
+        m_capacitances[driver] = capacitance;
+        for(auto arc : m_graph.fanout(driver))
+        {
+            if(m_graph.net_arc(arc))
+            {
+                auto sink = units::unit_cast<double>(m_graph.capacitance(m_graph.target(arc)));
+                auto delay = resistance * (capacitance / 2 + sink);
+                changed = changed || m_delays[arc] != delay;
+                m_delays[arc] = delay;
+            }
+        }
+        return changed;
+    }
+
+    bool Parasitics::estimate_elmore(const Parasitics::net_type & net, Parasitics::Workspace & workspace)
+    {
+        auto driver = m_drivers[net];
+        const auto & wire = m_wires[net];
+        if(driver == m_graph.size_vertex() || wire.tree.points.empty())
+        {
+            return false;
+        }
+
+        auto root = node_type{0};
+        auto none = static_cast<node_type>(-1);
+        workspace.loads.assign(wire.tree.points.size(), 0.0);
+        workspace.sinks.clear();
+        auto node = wire.nodes.begin();
+        for(auto pin : m_netlist.pins(net))
+        {
+            auto vertex = m_graph.vertex(pin);
+            auto pin_node = *node++;
+            if(pin_node == none)
+            {
+                continue;
+            }
+            if(vertex == driver)
+            {
+                root = pin_node;
+                continue;
+            }
+            workspace.loads[pin_node] += units::unit_cast<double>(m_graph.capacitance(vertex));
+            workspace.sinks.emplace_back(vertex, pin_node);
+        }
+        m_elmore->compute(wire.tree, root, workspace.loads, workspace.scratch);
+        std::sort(workspace.sinks.begin(), workspace.sinks.end());
+
+        auto capacitance = workspace.scratch.capacitance;
+        auto changed = m_capacitances[driver] != capacitance;
+        m_capacitances[driver] = capacitance;
+        for(auto arc : m_graph.fanout(driver))
+        {
+            if(m_graph.net_arc(arc))
+            {
+                auto sink = std::lower_bound(workspace.sinks.begin(), workspace.sinks.end(), std::make_pair(m_graph.target(arc), node_type{0}));
+                auto delay = sink != workspace.sinks.end() && sink->first == m_graph.target(arc) ? workspace.scratch.delays[sink->second] : 0.0;
+                changed = changed || m_delays[arc] != delay;
+                m_delays[arc] = delay;
+            }
+        }
+        return changed;
+    }
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_PARASITICS_H
+#define OPHIDIAN_TIMING_PARASITICS_H
+
+#include <cstddef>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/util/Units.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/placement/Placement.h>
+#include <ophidian/interconnection/TopologyCache.h>
+
+#include "Elmore.h"
+#include "TimingGraph.h"
+
+namespace ophidian::timing
+{
+    //! Placement based wire parasitics
+
+    /*!
+       \brief Estimates the wire of every net from the placement of its pins. By default the
+       wire is as long as the half perimeter of the pin bounding box, its capacitance loads the
+       driver and every sink sees the delay of the wire resistance driving half the wire
+       capacitance plus its own pin capacitance. Given an Elmore model, every net is a FLUTE
+       Steiner tree instead and sinks see its Elmore delay from the driver. Clock nets have no
+       net arcs in the timing graph and no wire.
+
+       The trees come from a topology cache, so nets that did not move or repeat the pin pattern
+       of another net skip FLUTE; the trees and the delays of all the nets are built in
+       parallel, each thread with its own Elmore scratch. FLUTE is not reentrant, so only the
+       cache misses wait for each other on the lock the caches share.
+
+       Moving a cell only changes the nets on its pins: invalidate() marks them and
+       update_dirty() re-estimates the marked nets, so the timing update after a move only
+       starts from the drivers of those nets. An attached estimator listens to the placement
+       and marks the nets of the moved and reoriented cells by itself.
+     */
+    class Parasitics :
+        private placement::Placement::Listener,
+        public placement::Placement::Subscription
+    {
+    public:
+        using unit_type                 = util::database_unit_t;
+        using time_type                 = Library::time_type;
+        using capacitance_type          = Library::capacitance_type;
+        using resistance_type           = util::kiloohm_t;
+        using net_type                  = circuit::Net;
+        using cell_type                 = circuit::CellInstance;
+        using pin_type                  = circuit::PinInstance;
+        using vertex_type               = TimingGraph::vertex_type;
+        using arc_type                  = TimingGraph::arc_type;
+        using vertex_container_type     = TimingGraph::vertex_container_type;
+
+        //! Wire parameters
+        struct Parameters
+        {
+            //! Half perimeter model resistance and capacitance of a database unit of wire, about 2 ohm and 0.2 fF per micrometer at 2000 units per micrometer
+            resistance_type resistance{1e-6};
+            capacitance_type capacitance{1e-4};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        Parasitics() = delete;
+
+        Parasitics(const Parasitics&) = delete;
+        Parasitics& operator=(const Parasitics&) = delete;
+
+        //! Construct the estimator, every net starts without wire
+        /*!
+           \param graph Timing graph of the netlist
+           \param netlist The netlist
+           \param placement Placement of the cells and pads, only read but followed once attached
+           \param parameters Wire parameters
+         */
+        Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Parameters & parameters);
+
+        Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement);
+
+        //! Construct an estimator using Steiner trees and Elmore delays
+        /*!
+           \param graph Timing graph of the netlist
+           \param netlist The netlist
+           \param placement Placement of the cells and pads, only read but followed once attached
+           \param elmore Wire model of the trees
+           \param parameters Wire parameters, only the number of threads is used
+         */
+        Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Elmore & elmore, const Parameters & parameters);
+
+        Parasitics(const TimingGraph & graph, const circuit::Netlist & netlist, placement::Placement & placement, const Elmore & elmore);
+
+        // Element access
+        //! Wire capacitance of the net driven by a vertex
+        capacitance_type capacitance(const vertex_type & driver) const
+        {
+            return capacitance_type{m_capacitances[driver]};
+        }
+
+        //! Wire delay of a net arc, zero for cell arcs
+        time_type delay(const arc_type & arc) const
+        {
+            return time_type{m_delays[arc]};
+        }
+
+        //! Driver vertex of a net, size_vertex() of the graph when the net has no net arcs
+        vertex_type driver(const net_type & net) const;
+
+        //! Steiner topologies of the nets, with its hit rate
+        const interconnection::TopologyCache & topologies() const noexcept
+        {
+            return m_topologies;
+        }
+
+        // Modifiers
+        //! Estimate every net and clear the invalidated ones
+        void update();
+
+        //! Mark the nets of the pins of a moved cell
+        void invalidate(const cell_type & cell);
+
+        //! Mark a net to be estimated again
+        void invalidate(const net_type & net);
+
+        //! Estimate the marked nets
+        /*!
+           \return The sorted drivers of the nets whose wires changed
+         */
+        vertex_container_type update_dirty();
+
+    private:
+        using node_type                 = Elmore::node_type;
+
+        //! Steiner tree of a net and the tree node of each of its pins
+        struct Wire
+        {
+            Elmore::Tree tree;
+            std::vector<node_type> nodes;
+        };
+
+        //! Per thread storage
+        struct Workspace
+        {
+            Elmore::Scratch scratch;
+            std::vector<double> loads;
+            std::vector<std::pair<vertex_type, node_type>> sinks;
+            std::vector<Elmore::point_type> pins;
+        };
+
+        bool location(const pin_type & pin, Elmore::point_type & point) const;
+        void build_wire(const net_type & net, Workspace & workspace);
+        bool estimate(const net_type & net, Workspace & workspace);
+        bool estimate_elmore(const net_type & net, Workspace & workspace);
+        void moved(const placement::Placement::move_container_type & moves) override;
+        void oriented(const cell_type & cell) override;
+
+        const TimingGraph &                                 m_graph;
+        const circuit::Netlist &                            m_netlist;
+        const placement::Placement &                        m_placement;
+        Parameters                                          m_parameters;
+        const Elmore *                                      m_elmore;
+
+        entity_system::Property<net_type, vertex_type>      m_drivers;
+        entity_system::Property<net_type, char>             m_dirty;
+        std::vector<net_type>                               m_dirty_nets;
+        entity_system::Property<net_type, Wire>             m_wires;
+        std::vector<Workspace>                              m_workspaces;
+        interconnection::TopologyCache                      m_topologies;
+
+        std::vector<double>                                 m_capacitances;
+        std::vector<double>                                 m_delays;
+    };
+}
+
+#endif // OPHIDIAN_TIMING_PARASITICS_H
@@ -0,0 +1,478 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "StaticTimingAnalysis.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <ophidian/util/Parallel.h>
+
+namespace ophidian::timing
+{
+    namespace
+    {
+        constexpr auto infinity = std::numeric_limits<double>::infinity();
+        constexpr auto no_model = std::numeric_limits<std::uint32_t>::max();
+
+        // vertices of a level handed to a worker at once
+        constexpr std::size_t grain = 256;
+    }
+
+    StaticTimingAnalysis::StaticTimingAnalysis(const TimingGraph & graph, const Library & library, const StaticTimingAnalysis::Parameters & parameters):
+        m_graph(graph),
+        m_library(library),
+        m_parasitics(nullptr),
+        m_parameters(parameters),
+        m_worst_slack(infinity),
+        m_total_negative_slack(0.0),
+        m_critical_endpoint(0)
+    {
+        // library arcs are looked up once, graph arcs keep the index of their model
+        auto indices = library.make_property_timing_arc<std::uint32_t>();
+        for(auto arc = library.begin_timing_arc(); arc != library.end_timing_arc(); ++arc)
+        {
+            indices[*arc] = static_cast<std::uint32_t>(m_models.size());
+            auto model = ArcModel{};
+            model.delays = {&library.cell_rise(*arc), &library.cell_fall(*arc)};
+            model.transitions = {&library.rise_transition(*arc), &library.fall_transition(*arc)};
+            constexpr auto rise = std::uint8_t{1} << RISE;
+            constexpr auto fall = std::uint8_t{1} << FALL;
+            switch(library.type(*arc))
+            {
+            case TimingType::COMBINATIONAL:
+                switch(library.sense(*arc))
+                {
+                case TimingSense::POSITIVE_UNATE: model.inputs = {rise, fall}; break;
+                case TimingSense::NEGATIVE_UNATE: model.inputs = {fall, rise}; break;
+                default: model.inputs = {rise | fall, rise | fall}; break;
+                }
+                break;
+            case TimingType::RISING_EDGE: model.inputs = {rise, rise}; break;
+            case TimingType::FALLING_EDGE: model.inputs = {fall, fall}; break;
+            default: model.inputs = {0, 0}; break;
+            }
+            m_models.push_back(model);
+        }
+
+        m_arc_models.resize(graph.size_arc());
+        for(TimingGraph::arc_type arc = 0; arc < graph.size_arc(); ++arc)
+        {
+            m_arc_models[arc] = graph.net_arc(arc) ? no_model : indices[graph.timing_arc(arc)];
+        }
+        const auto & checks = graph.checks();
+        m_check_begins.assign(graph.size_vertex() + 1, 0);
+        for(const auto & check : checks)
+        {
+            m_check_tables.push_back({&library.rise_constraint(check.arc), &library.fall_constraint(check.arc)});
+            ++m_check_begins[check.data + 1];
+        }
+        for(std::size_t vertex = 0; vertex < graph.size_vertex(); ++vertex)
+        {
+            m_check_begins[vertex + 1] += m_check_begins[vertex];
+        }
+        m_vertex_checks.resize(checks.size());
+        auto next = std::vector<std::size_t>(m_check_begins.begin(), m_check_begins.end() - 1);
+        for(std::size_t i = 0; i < checks.size(); ++i)
+        {
+            m_vertex_checks[next[checks[i].data]++] = static_cast<std::uint32_t>(i);
+        }
+
+        m_queues.resize(graph.size_level());
+        m_queued.assign(graph.size_vertex(), 0);
+    }
+
+    StaticTimingAnalysis::StaticTimingAnalysis(const TimingGraph & graph, const Library & library):
+        StaticTimingAnalysis(graph, library, Parameters{})
+    {
+    }
+
+    StaticTimingAnalysis::StaticTimingAnalysis(const TimingGraph & graph, const Library & library, Parasitics & parasitics, const StaticTimingAnalysis::Parameters & parameters):
+        StaticTimingAnalysis(graph, library, parameters)
+    {
+        m_parasitics = &parasitics;
+    }
+
+    StaticTimingAnalysis::StaticTimingAnalysis(const TimingGraph & graph, const Library & library, Parasitics & parasitics):
+        StaticTimingAnalysis(graph, library, parasitics, Parameters{})
+    {
+    }
+
+    void StaticTimingAnalysis::update()
+    {
+        auto size = m_graph.size_vertex();
+        auto threads = m_parameters.number_of_threads;
+        if(m_parasitics != nullptr)
+        {
+            m_parasitics->update();
+        }
+
+        m_loads.resize(size);
+        util::parallel_for(0, size, [&](std::size_t vertex){
+            m_loads[vertex] = compute_load(static_cast<vertex_type>(vertex));
+        }, threads, 4096);
+
+        m_arrivals.assign(2 * size, -infinity);
+        m_slews.assign(2 * size, 0.0);
+        m_delays.assign(2 * m_graph.size_arc(), 0.0);
+        for(std::size_t level = 0; level < m_graph.size_level(); ++level)
+        {
+            auto vertices = m_graph.level(level);
+            auto first = vertices.begin();
+            util::parallel_for(0, static_cast<std::size_t>(vertices.size()), [&](std::size_t i){
+                propagate_arrival(first[i]);
+            }, threads, grain);
+        }
+
+        m_required.assign(2 * size, infinity);
+        for(auto level = m_graph.size_level(); level > 0; --level)
+        {
+            auto vertices = m_graph.level(level - 1);
+            auto first = vertices.begin();
+            util::parallel_for(0, static_cast<std::size_t>(vertices.size()), [&](std::size_t i){
+                propagate_required(first[i]);
+            }, threads, grain);
+        }
+
+        update_slacks();
+    }
+
+    std::size_t StaticTimingAnalysis::update_incremental()
+    {
+        if(m_arrivals.empty())
+        {
+            update();
+            return m_graph.size_vertex();
+        }
+        if(m_parasitics == nullptr)
+        {
+            return 0;
+        }
+        auto drivers = m_parasitics->update_dirty();
+        if(drivers.empty())
+        {
+            return 0;
+        }
+
+        // a driver is timed again for its load, its sinks for the wire delays
+        for(auto driver : drivers)
+        {
+            m_loads[driver] = compute_load(driver);
+            enqueue(driver);
+            for(auto arc : m_graph.fanout(driver))
+            {
+                if(m_arc_models[arc] == no_model)
+                {
+                    enqueue(m_graph.target(arc));
+                }
+            }
+        }
+
+        // fanout cone; the sources of the timed vertices may see new arc delays and the
+        // timed vertices themselves new setup times, so they start the fanin cone
+        auto timed = std::size_t{0};
+        auto seeds = std::vector<vertex_type>{};
+        for(std::size_t level = 0; level < m_queues.size(); ++level)
+        {
+            auto & queue = m_queues[level];
+            for(std::size_t i = 0; i < queue.size(); ++i)
+            {
+                auto vertex = queue[i];
+                m_queued[vertex] = 0;
+                ++timed;
+                if(propagate_arrival(vertex))
+                {
+                    for(auto arc : m_graph.fanout(vertex))
+                    {
+                        enqueue(m_graph.target(arc));
+                    }
+                }
+                seeds.push_back(vertex);
+                for(auto arc = m_graph.fanin_begin(vertex); arc != m_graph.fanin_end(vertex); ++arc)
+                {
+                    seeds.push_back(m_graph.source(arc));
+                }
+            }
+            queue.clear();
+        }
+
+        for(auto vertex : seeds)
+        {
+            enqueue(vertex);
+        }
+        for(auto level = m_queues.size(); level > 0; --level)
+        {
+            auto & queue = m_queues[level - 1];
+            for(std::size_t i = 0; i < queue.size(); ++i)
+            {
+                auto vertex = queue[i];
+                m_queued[vertex] = 0;
+                ++timed;
+                if(propagate_required(vertex))
+                {
+                    for(auto arc = m_graph.fanin_begin(vertex); arc != m_graph.fanin_end(vertex); ++arc)
+                    {
+                        enqueue(m_graph.source(arc));
+                    }
+                }
+            }
+            queue.clear();
+        }
+
+        update_slacks();
+        return timed;
+    }
+
+    void StaticTimingAnalysis::enqueue(StaticTimingAnalysis::vertex_type vertex)
+    {
+        auto level = m_graph.depth(vertex);
+        if(level < m_queues.size() && !m_queued[vertex])
+        {
+            m_queued[vertex] = 1;
+            m_queues[level].push_back(vertex);
+        }
+    }
+
+    double StaticTimingAnalysis::compute_load(StaticTimingAnalysis::vertex_type vertex) const
+    {
+        auto output_load = units::unit_cast<double>(m_parameters.output_load);
+        auto load = m_parasitics != nullptr ? units::unit_cast<double>(m_parasitics->capacitance(vertex)) : 0.0;
+        for(auto arc : m_graph.fanout(vertex))
+        {
+            if(m_arc_models[arc] == no_model)
+            {
+                auto target = m_graph.target(arc);
+                load += units::unit_cast<double>(m_graph.capacitance(target));
+                load += m_graph.kind(target) == VertexKind::OUTPUT ? output_load : 0.0;
+            }
+        }
+        return load;
+    }
+
+    bool StaticTimingAnalysis::propagate_arrival(StaticTimingAnalysis::vertex_type vertex)
+    {
+        double arrival[2] = {-infinity, -infinity};
+        double slew[2] = {0.0, 0.0};
+        switch(m_graph.kind(vertex))
+        {
+        case VertexKind::INPUT:
+            arrival[RISE] = arrival[FALL] = units::unit_cast<double>(m_parameters.input_delay);
+            slew[RISE] = slew[FALL] = units::unit_cast<double>(m_parameters.input_slew);
+            break;
+        case VertexKind::CLOCK:
+            arrival[RISE] = 0.0;
+            arrival[FALL] = units::unit_cast<double>(m_parameters.clock_period) / 2;
+            slew[RISE] = slew[FALL] = units::unit_cast<double>(m_parameters.clock_slew);
+            break;
+        default:
+            break;
+        }
+
+        auto load = capacitance_type{m_loads[vertex]};
+        for(auto arc = m_graph.fanin_begin(vertex); arc != m_graph.fanin_end(vertex); ++arc)
+        {
+            auto source = m_graph.source(arc);
+            const auto * source_arrival = &m_arrivals[2 * source];
+            const auto * source_slew = &m_slews[2 * source];
+            auto model = m_arc_models[arc];
+            if(model == no_model)
+            {
+                auto wire = m_parasitics != nullptr ? units::unit_cast<double>(m_parasitics->delay(arc)) : 0.0;
+                for(auto transition : {RISE, FALL})
+                {
+                    arrival[transition] = std::max(arrival[transition], source_arrival[transition] + wire);
+                    slew[transition] = std::max(slew[transition], source_slew[transition]);
+                    m_delays[2 * arc + transition] = wire;
+                }
+                continue;
+            }
+
+            const auto & tables = m_models[model];
+            for(auto transition : {RISE, FALL})
+            {
+                auto worst = 0.0;
+                for(auto input : {RISE, FALL})
+                {
+                    if(!(tables.inputs[transition] & (1 << input)) || source_arrival[input] == -infinity)
+                    {
+                        continue;
+                    }
+                    auto input_slew = time_type{source_slew[input]};
+                    auto delay = units::unit_cast<double>(tables.delays[transition]->compute(load, input_slew));
+                    auto output_slew = units::unit_cast<double>(tables.transitions[transition]->compute(load, input_slew));
+                    arrival[transition] = std::max(arrival[transition], source_arrival[input] + delay);
+                    slew[transition] = std::max(slew[transition], output_slew);
+                    worst = std::max(worst, delay);
+                }
+                m_delays[2 * arc + transition] = worst;
+            }
+        }
+
+        auto * old_arrival = &m_arrivals[2 * vertex];
+        auto * old_slew = &m_slews[2 * vertex];
+        auto changed = old_arrival[RISE] != arrival[RISE] || old_arrival[FALL] != arrival[FALL] ||
+            old_slew[RISE] != slew[RISE] || old_slew[FALL] != slew[FALL];
+        old_arrival[RISE] = arrival[RISE];
+        old_arrival[FALL] = arrival[FALL];
+        old_slew[RISE] = slew[RISE];
+        old_slew[FALL] = slew[FALL];
+        return changed;
+    }
+
+    bool StaticTimingAnalysis::propagate_required(StaticTimingAnalysis::vertex_type vertex)
+    {
+        double required[2] = {infinity, infinity};
+        auto period = units::unit_cast<double>(m_parameters.clock_period);
+        if(m_graph.kind(vertex) == VertexKind::OUTPUT)
+        {
+            required[RISE] = required[FALL] = period - units::unit_cast<double>(m_parameters.output_delay);
+        }
+
+        const auto & checks = m_graph.checks();
+        for(auto i = m_check_begins[vertex]; i < m_check_begins[vertex + 1]; ++i)
+        {
+            auto index = m_vertex_checks[i];
+            const auto & check = checks[index];
+            auto edge = m_library.type(check.arc) == TimingType::SETUP_RISING ? RISE : FALL;
+            auto capture = m_arrivals[2 * check.clock + edge] + (edge == RISE ? period : 0.0);
+            auto clock_slew = time_type{m_slews[2 * check.clock + edge]};
+            for(auto transition : {RISE, FALL})
+            {
+                auto setup = units::unit_cast<double>(m_check_tables[index][transition]->compute(clock_slew, time_type{m_slews[2 * vertex + transition]}));
+                required[transition] = std::min(required[transition], capture - setup);
+            }
+        }
+
+        for(auto arc : m_graph.fanout(vertex))
+        {
+            const auto * target_required = &m_required[2 * m_graph.target(arc)];
+            auto model = m_arc_models[arc];
+            if(model == no_model)
+            {
+                required[RISE] = std::min(required[RISE], target_required[RISE] - m_delays[2 * arc + RISE]);
+                required[FALL] = std::min(required[FALL], target_required[FALL] - m_delays[2 * arc + FALL]);
+                continue;
+            }
+
+            const auto & tables = m_models[model];
+            for(auto transition : {RISE, FALL})
+            {
+                auto value = target_required[transition] - m_delays[2 * arc + transition];
+                for(auto input : {RISE, FALL})
+                {
+                    if(tables.inputs[transition] & (1 << input))
+                    {
+                        required[input] = std::min(required[input], value);
+                    }
+                }
+            }
+        }
+
+        auto * old_required = &m_required[2 * vertex];
+        auto changed = old_required[RISE] != required[RISE] || old_required[FALL] != required[FALL];
+        old_required[RISE] = required[RISE];
+        old_required[FALL] = required[FALL];
+        return changed;
+    }
+
+    void StaticTimingAnalysis::update_slacks()
+    {
+        m_worst_slack = infinity;
+        m_total_negative_slack = 0.0;
+        m_critical_endpoint = 0;
+        for(auto endpoint : m_graph.endpoints())
+        {
+            auto slack = units::unit_cast<double>(this->slack(m_graph.pin(endpoint)));
+            if(slack < m_worst_slack)
+            {
+                m_worst_slack = slack;
+                m_critical_endpoint = endpoint;
+            }
+            if(slack < 0.0)
+            {
+                m_total_negative_slack += slack;
+            }
+        }
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::rise_arrival(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_arrivals[2 * m_graph.vertex(pin) + RISE]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::fall_arrival(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_arrivals[2 * m_graph.vertex(pin) + FALL]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::rise_slew(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_slews[2 * m_graph.vertex(pin) + RISE]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::fall_slew(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_slews[2 * m_graph.vertex(pin) + FALL]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::rise_required(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_required[2 * m_graph.vertex(pin) + RISE]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::fall_required(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return time_type{m_required[2 * m_graph.vertex(pin) + FALL]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::slack(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        auto vertex = m_graph.vertex(pin);
+        auto result = infinity;
+        for(auto transition : {RISE, FALL})
+        {
+            auto arrival = m_arrivals[2 * vertex + transition];
+            auto required = m_required[2 * vertex + transition];
+            if(arrival != -infinity && required != infinity)
+            {
+                result = std::min(result, required - arrival);
+            }
+        }
+        return time_type{result};
+    }
+
+    StaticTimingAnalysis::capacitance_type StaticTimingAnalysis::load(const StaticTimingAnalysis::pin_type & pin) const
+    {
+        return capacitance_type{m_loads[m_graph.vertex(pin)]};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::worst_slack() const noexcept
+    {
+        return time_type{m_worst_slack};
+    }
+
+    StaticTimingAnalysis::time_type StaticTimingAnalysis::total_negative_slack() const noexcept
+    {
+        return time_type{m_total_negative_slack};
+    }
+
+    StaticTimingAnalysis::pin_type StaticTimingAnalysis::critical_endpoint() const
+    {
+        return m_graph.pin(m_critical_endpoint);
+    }
+}
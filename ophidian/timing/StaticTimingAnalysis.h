@@ -0,0 +1,193 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_STATICTIMINGANALYSIS_H
+#define OPHIDIAN_TIMING_STATICTIMINGANALYSIS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/util/Units.h>
+
+#include "Library.h"
+#include "Parasitics.h"
+#include "TimingGraph.h"
+
+namespace ophidian::timing
+{
+    //! Levelized static timing analysis
+
+    /*!
+       \brief Propagates rise and fall arrival times and slews forward over the levels of a
+       TimingGraph and required times backward, with NLDM tables looked up at the load of the
+       driving pin and the slew of the arc source. The clock is ideal: clock pins rise at 0 and
+       fall at half the period. Output pads are required at the clock period minus the output
+       delay and data pins at their capturing edge minus the setup time; setup_rising checks
+       capture at the next rising edge, setup_falling checks at the falling edge of the same
+       cycle. Net arcs keep the driver slew and have the wire delay of the Parasitics, if any;
+       the load of a driver is the sum of the pin capacitances of its net plus its wire.
+
+       The vertices of a level only read the previous levels, so every level is propagated
+       concurrently; the result does not depend on the number of threads.
+
+       After cells are moved and their nets invalidated in the Parasitics, update_incremental()
+       re-estimates those nets only and times again the fanout cone of their drivers, level by
+       level, followed by the fanin cone of the vertices whose arc delays or setup times changed.
+       A vertex whose values come out unchanged does not queue its neighbours, so the update
+       stops where the change dies out. The result is the same as the one of a full update.
+     */
+    class StaticTimingAnalysis
+    {
+    public:
+        using time_type                 = Library::time_type;
+        using capacitance_type          = Library::capacitance_type;
+        using pin_type                  = TimingGraph::pin_type;
+        using vertex_type               = TimingGraph::vertex_type;
+
+        //! Timing constraints and parameters
+        struct Parameters
+        {
+            time_type clock_period{1000.0};
+            //! Arrival time and slew of the input pads
+            time_type input_delay{0.0};
+            time_type input_slew{0.0};
+            //! Time taken from the period at the output pads
+            time_type output_delay{0.0};
+            //! Load of the output pads
+            capacitance_type output_load{0.0};
+            time_type clock_slew{0.0};
+            //! Number of threads, 0 for one per hardware thread
+            std::size_t number_of_threads{0};
+        };
+
+        // Constructors
+        StaticTimingAnalysis() = delete;
+
+        StaticTimingAnalysis(const StaticTimingAnalysis&) = delete;
+        StaticTimingAnalysis& operator=(const StaticTimingAnalysis&) = delete;
+
+        //! Construct the analysis
+        /*!
+           \param graph Timing graph of the netlist
+           \param library Timing library the graph was built with
+           \param parameters Timing constraints
+         */
+        StaticTimingAnalysis(const TimingGraph & graph, const Library & library, const Parameters & parameters);
+
+        StaticTimingAnalysis(const TimingGraph & graph, const Library & library);
+
+        //! Construct the analysis with wire parasitics
+        /*!
+           \param graph Timing graph of the netlist
+           \param library Timing library the graph was built with
+           \param parasitics Wire estimates of the graph nets, updated by the analysis
+           \param parameters Timing constraints
+         */
+        StaticTimingAnalysis(const TimingGraph & graph, const Library & library, Parasitics & parasitics, const Parameters & parameters);
+
+        StaticTimingAnalysis(const TimingGraph & graph, const Library & library, Parasitics & parasitics);
+
+        // Modifiers
+        //! Estimate every wire and compute the loads, arrival times and required times of every pin
+        void update();
+
+        //! Estimate the invalidated wires and time the pins they affect
+        /*!
+           \return Number of vertices timed again
+         */
+        std::size_t update_incremental();
+
+        // Element access
+        time_type rise_arrival(const pin_type & pin) const;
+        time_type fall_arrival(const pin_type & pin) const;
+
+        time_type rise_slew(const pin_type & pin) const;
+        time_type fall_slew(const pin_type & pin) const;
+
+        time_type rise_required(const pin_type & pin) const;
+        time_type fall_required(const pin_type & pin) const;
+
+        //! Smallest of the rise and fall slacks, infinite for unconstrained pins
+        time_type slack(const pin_type & pin) const;
+
+        //! Load driven by a pin
+        capacitance_type load(const pin_type & pin) const;
+
+        //! Smallest endpoint slack
+        time_type worst_slack() const noexcept;
+
+        //! Sum of the negative endpoint slacks
+        time_type total_negative_slack() const noexcept;
+
+        //! Endpoint with the worst slack
+        pin_type critical_endpoint() const;
+
+    private:
+        // index of the rise and fall values of a vertex or an arc
+        static constexpr std::size_t RISE = 0;
+        static constexpr std::size_t FALL = 1;
+
+        //! Tables of a library arc and the input transitions feeding each output transition
+        struct ArcModel
+        {
+            std::array<const Library::delay_table_type *, 2> delays;
+            std::array<const Library::delay_table_type *, 2> transitions;
+            //! Bit i of inputs[t] is set when input transition i drives output transition t
+            std::array<std::uint8_t, 2> inputs;
+        };
+
+        double compute_load(vertex_type vertex) const;
+        //! Time a vertex from its fanin, true when its arrivals or slews changed
+        bool propagate_arrival(vertex_type vertex);
+        //! Require a vertex from its fanout and its checks, true when its required times changed
+        bool propagate_required(vertex_type vertex);
+        void update_slacks();
+        void enqueue(vertex_type vertex);
+
+        const TimingGraph &             m_graph;
+        const Library &                 m_library;
+        Parasitics *                    m_parasitics;
+        Parameters                      m_parameters;
+
+        std::vector<ArcModel>           m_models;
+        std::vector<std::uint32_t>      m_arc_models;
+        //! Rise and fall setup tables of every check
+        std::vector<std::array<const Library::constraint_table_type *, 2>> m_check_tables;
+        //! Checks of the data vertex v are m_vertex_checks[m_check_begins[v], m_check_begins[v + 1])
+        std::vector<std::size_t>        m_check_begins;
+        std::vector<std::uint32_t>      m_vertex_checks;
+
+        std::vector<double>             m_loads;
+        std::vector<double>             m_arrivals;
+        std::vector<double>             m_slews;
+        std::vector<double>             m_required;
+        std::vector<double>             m_delays;
+
+        //! Vertices queued for the incremental update, by level
+        std::vector<std::vector<vertex_type>> m_queues;
+        std::vector<char>               m_queued;
+
+        double                          m_worst_slack;
+        double                          m_total_negative_slack;
+        vertex_type                     m_critical_endpoint;
+    };
+}
+
+#endif // OPHIDIAN_TIMING_STATICTIMINGANALYSIS_H
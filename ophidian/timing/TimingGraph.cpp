@@ -0,0 +1,259 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#include "TimingGraph.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ophidian::timing
+{
+    TimingGraph::TimingGraph(const circuit::Netlist & netlist, const circuit::StandardCells & std_cells, const Library & library):
+        m_vertices{netlist.make_property_pin_instance<vertex_type>()}
+    {
+        m_pins.assign(netlist.begin_pin_instance(), netlist.end_pin_instance());
+        auto size = m_pins.size();
+        m_kinds.assign(size, VertexKind::PIN);
+        m_capacitances.assign(size, capacitance_type{0.0});
+        auto drivers = std::vector<char>(size, 0);
+        for(vertex_type vertex = 0; vertex < size; ++vertex)
+        {
+            auto pin = m_pins[vertex];
+            m_vertices[pin] = vertex;
+            if(netlist.input(pin) != circuit::Input{})
+            {
+                m_kinds[vertex] = VertexKind::INPUT;
+                drivers[vertex] = 1;
+            }
+            else if(netlist.output(pin) != circuit::Output{})
+            {
+                m_kinds[vertex] = VertexKind::OUTPUT;
+            }
+            else if(netlist.cell(pin) != circuit::CellInstance{})
+            {
+                auto std_pin = netlist.std_cell_pin(pin);
+                m_capacitances[vertex] = library.capacitance(std_pin);
+                drivers[vertex] = std_cells.direction(std_pin) == circuit::PinDirection::OUTPUT;
+                if(library.clock(std_pin))
+                {
+                    m_kinds[vertex] = VertexKind::CLOCK;
+                }
+            }
+        }
+
+        // (target, source, library arc) of every arc
+        struct Edge
+        {
+            vertex_type target;
+            vertex_type source;
+            timing_arc_type arc;
+        };
+        auto edges = std::vector<Edge>{};
+
+        for(auto net = netlist.begin_net(); net != netlist.end_net(); ++net)
+        {
+            auto pins = netlist.pins(*net);
+            auto driver = std::find_if(pins.begin(), pins.end(), [&](const pin_type & pin){ return drivers[m_vertices[pin]]; });
+            if(driver == pins.end())
+            {
+                continue;
+            }
+            auto source = m_vertices[*driver];
+            for(auto pin : pins)
+            {
+                auto target = m_vertices[pin];
+                if(target != source && m_kinds[target] != VertexKind::CLOCK)
+                {
+                    edges.push_back(Edge{target, source, timing_arc_type{}});
+                }
+            }
+        }
+
+        auto cell_pins = std::vector<std::pair<circuit::Pin, vertex_type>>{};
+        for(auto cell = netlist.begin_cell_instance(); cell != netlist.end_cell_instance(); ++cell)
+        {
+            cell_pins.clear();
+            for(auto pin : netlist.pins(*cell))
+            {
+                cell_pins.emplace_back(netlist.std_cell_pin(pin), m_vertices[pin]);
+            }
+            for(const auto & to : cell_pins)
+            {
+                for(const auto & arc : library.arcs(to.first))
+                {
+                    auto from = std::find_if(cell_pins.begin(), cell_pins.end(), [&](const auto & pin){ return pin.first == library.from(arc); });
+                    if(from == cell_pins.end())
+                    {
+                        continue;
+                    }
+                    switch(library.type(arc))
+                    {
+                    case TimingType::COMBINATIONAL:
+                    case TimingType::RISING_EDGE:
+                    case TimingType::FALLING_EDGE:
+                        edges.push_back(Edge{to.second, from->second, arc});
+                        break;
+                    case TimingType::SETUP_RISING:
+                    case TimingType::SETUP_FALLING:
+                        m_checks.push_back(Check{to.second, from->second, arc});
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+        }
+
+        // arcs sorted by target, in the order they were found
+        m_fanin_begins.assign(size + 1, 0);
+        for(const auto & edge : edges)
+        {
+            ++m_fanin_begins[edge.target + 1];
+        }
+        for(std::size_t vertex = 0; vertex < size; ++vertex)
+        {
+            m_fanin_begins[vertex + 1] += m_fanin_begins[vertex];
+        }
+        auto arcs = edges.size();
+        m_sources.resize(arcs);
+        m_targets.resize(arcs);
+        m_timing_arcs.resize(arcs);
+        auto next = offset_container_type(m_fanin_begins.begin(), m_fanin_begins.end() - 1);
+        for(const auto & edge : edges)
+        {
+            auto arc = next[edge.target]++;
+            m_sources[arc] = edge.source;
+            m_targets[arc] = edge.target;
+            m_timing_arcs[arc] = edge.arc;
+        }
+
+        m_fanout_begins.assign(size + 1, 0);
+        for(auto source : m_sources)
+        {
+            ++m_fanout_begins[source + 1];
+        }
+        for(std::size_t vertex = 0; vertex < size; ++vertex)
+        {
+            m_fanout_begins[vertex + 1] += m_fanout_begins[vertex];
+        }
+        m_fanout_arcs.resize(arcs);
+        next.assign(m_fanout_begins.begin(), m_fanout_begins.end() - 1);
+        for(arc_type arc = 0; arc < arcs; ++arc)
+        {
+            m_fanout_arcs[next[m_sources[arc]]++] = arc;
+        }
+
+        for(vertex_type vertex = 0; vertex < size; ++vertex)
+        {
+            if(m_kinds[vertex] == VertexKind::OUTPUT)
+            {
+                m_endpoints.push_back(vertex);
+            }
+        }
+        for(const auto & check : m_checks)
+        {
+            m_endpoints.push_back(check.data);
+        }
+        std::sort(m_endpoints.begin(), m_endpoints.end());
+        m_endpoints.erase(std::unique(m_endpoints.begin(), m_endpoints.end()), m_endpoints.end());
+
+        levelize();
+    }
+
+    void TimingGraph::levelize()
+    {
+        auto size = m_pins.size();
+        auto remaining = std::vector<std::size_t>(size);
+        m_order.clear();
+        m_level_begins.assign(1, 0);
+        for(vertex_type vertex = 0; vertex < size; ++vertex)
+        {
+            remaining[vertex] = m_fanin_begins[vertex + 1] - m_fanin_begins[vertex];
+            if(remaining[vertex] == 0)
+            {
+                m_order.push_back(vertex);
+            }
+        }
+
+        // every level holds the vertices whose fanin is in the previous ones
+        auto first = std::size_t{0};
+        while(first < m_order.size())
+        {
+            auto last = m_order.size();
+            std::sort(m_order.begin() + first, m_order.end());
+            m_level_begins.push_back(last);
+            for(auto i = first; i < last; ++i)
+            {
+                for(auto arc : fanout(m_order[i]))
+                {
+                    if(--remaining[m_targets[arc]] == 0)
+                    {
+                        m_order.push_back(m_targets[arc]);
+                    }
+                }
+            }
+            first = last;
+        }
+
+        auto levels = m_level_begins.size() - 1;
+        m_depths.assign(size, levels);
+        for(std::size_t level = 0; level < levels; ++level)
+        {
+            for(auto i = m_level_begins[level]; i < m_level_begins[level + 1]; ++i)
+            {
+                m_depths[m_order[i]] = level;
+            }
+        }
+        m_loops = size - m_order.size();
+    }
+
+    std::size_t TimingGraph::size_vertex() const noexcept
+    {
+        return m_pins.size();
+    }
+
+    std::size_t TimingGraph::size_arc() const noexcept
+    {
+        return m_sources.size();
+    }
+
+    std::size_t TimingGraph::size_level() const noexcept
+    {
+        return m_level_begins.size() - 1;
+    }
+
+    TimingGraph::vertex_type TimingGraph::vertex(const TimingGraph::pin_type & pin) const
+    {
+        return m_vertices[pin];
+    }
+
+    const TimingGraph::check_container_type & TimingGraph::checks() const noexcept
+    {
+        return m_checks;
+    }
+
+    const TimingGraph::vertex_container_type & TimingGraph::endpoints() const noexcept
+    {
+        return m_endpoints;
+    }
+
+    std::size_t TimingGraph::loops() const noexcept
+    {
+        return m_loops;
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_TIMINGGRAPH_H
+#define OPHIDIAN_TIMING_TIMINGGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ophidian/entity_system/Property.h>
+#include <ophidian/util/Range.h>
+#include <ophidian/circuit/Netlist.h>
+#include <ophidian/circuit/StandardCells.h>
+
+#include "Library.h"
+
+namespace ophidian::timing
+{
+    enum class VertexKind {
+        PIN, INPUT, OUTPUT, CLOCK
+    };
+
+    //! Levelized timing graph
+
+    /*!
+       \brief Every pin instance is a vertex. Net arcs go from the driver of a net, an input pad
+       or an output pin of a cell, to its other pins; cell arcs follow the combinational and clock
+       to output arcs of the library. Setup arcs become checks between a data pin and a clock pin.
+       Clock pins are ideal: they are startpoints and no net arc reaches them.
+
+       Arcs are stored sorted by their target, so the fanin of a vertex is a contiguous range of
+       arc indices, and the fanout of every vertex is indexed by an offset vector. Vertices are
+       grouped into levels, every arc going from a lower level to a higher one, so the vertices of
+       a level can be timed concurrently. Vertices on or behind a combinational loop are left out
+       of the levels.
+     */
+    class TimingGraph
+    {
+    public:
+        using vertex_type               = std::uint32_t;
+        using arc_type                  = std::uint32_t;
+        using pin_type                  = circuit::PinInstance;
+        using timing_arc_type           = Library::timing_arc_type;
+        using capacitance_type          = Library::capacitance_type;
+        using vertex_kind_type          = VertexKind;
+        using vertex_container_type     = std::vector<vertex_type>;
+        using arc_container_type        = std::vector<arc_type>;
+        using offset_container_type     = std::vector<std::size_t>;
+        using vertex_range_type         = util::Range<vertex_container_type::const_iterator>;
+        using arc_range_type            = util::Range<arc_container_type::const_iterator>;
+
+        //! Setup check of a data pin against a clock pin
+        struct Check
+        {
+            vertex_type data;
+            vertex_type clock;
+            timing_arc_type arc;
+        };
+
+        using check_container_type      = std::vector<Check>;
+
+        // Constructors
+        TimingGraph() = delete;
+
+        TimingGraph(const TimingGraph&) = delete;
+        TimingGraph& operator=(const TimingGraph&) = delete;
+
+        //! Build the timing graph of a netlist
+        /*!
+           \param netlist Netlist with the pins and nets
+           \param std_cells Standard cells, giving the pin directions
+           \param library Timing library of the standard cells
+         */
+        TimingGraph(const circuit::Netlist & netlist, const circuit::StandardCells & std_cells, const Library & library);
+
+        // Capacity
+        std::size_t size_vertex() const noexcept;
+
+        std::size_t size_arc() const noexcept;
+
+        std::size_t size_level() const noexcept;
+
+        // Element access
+        const pin_type & pin(const vertex_type & vertex) const
+        {
+            return m_pins[vertex];
+        }
+
+        vertex_type vertex(const pin_type & pin) const;
+
+        vertex_kind_type kind(const vertex_type & vertex) const
+        {
+            return m_kinds[vertex];
+        }
+
+        //! Input capacitance of the library pin of a vertex
+        capacitance_type capacitance(const vertex_type & vertex) const
+        {
+            return m_capacitances[vertex];
+        }
+
+        vertex_type source(const arc_type & arc) const
+        {
+            return m_sources[arc];
+        }
+
+        vertex_type target(const arc_type & arc) const
+        {
+            return m_targets[arc];
+        }
+
+        bool net_arc(const arc_type & arc) const
+        {
+            return m_timing_arcs[arc] == timing_arc_type{};
+        }
+
+        //! Library arc of a cell arc
+        const timing_arc_type & timing_arc(const arc_type & arc) const
+        {
+            return m_timing_arcs[arc];
+        }
+
+        //! Arcs ending at a vertex are the indices in [fanin_begin, fanin_end)
+        arc_type fanin_begin(const vertex_type & vertex) const
+        {
+            return static_cast<arc_type>(m_fanin_begins[vertex]);
+        }
+
+        arc_type fanin_end(const vertex_type & vertex) const
+        {
+            return static_cast<arc_type>(m_fanin_begins[vertex + 1]);
+        }
+
+        //! Arcs leaving a vertex
+        arc_range_type fanout(const vertex_type & vertex) const
+        {
+            return arc_range_type(m_fanout_arcs.begin() + m_fanout_begins[vertex], m_fanout_arcs.begin() + m_fanout_begins[vertex + 1]);
+        }
+
+        //! Vertices of a level, sorted
+        vertex_range_type level(std::size_t index) const
+        {
+            return vertex_range_type(m_order.begin() + m_level_begins[index], m_order.begin() + m_level_begins[index + 1]);
+        }
+
+        //! Level of a vertex, size_level() for vertices left out of the levels
+        std::size_t depth(const vertex_type & vertex) const
+        {
+            return m_depths[vertex];
+        }
+
+        const check_container_type & checks() const noexcept;
+
+        //! Output pads and constrained data pins, sorted
+        const vertex_container_type & endpoints() const noexcept;
+
+        //! Number of vertices left out of the levels by combinational loops
+        std::size_t loops() const noexcept;
+
+    private:
+        void levelize();
+
+        std::vector<pin_type>                               m_pins;
+        entity_system::Property<pin_type, vertex_type>      m_vertices;
+        std::vector<vertex_kind_type>                       m_kinds;
+        std::vector<capacitance_type>                       m_capacitances;
+
+        vertex_container_type                               m_sources;
+        vertex_container_type                               m_targets;
+        std::vector<timing_arc_type>                        m_timing_arcs;
+        offset_container_type                               m_fanin_begins;
+        offset_container_type                               m_fanout_begins;
+        arc_container_type                                  m_fanout_arcs;
+
+        vertex_container_type                               m_order;
+        offset_container_type                               m_level_begins;
+        std::vector<std::size_t>                            m_depths;
+        check_container_type                                m_checks;
+        vertex_container_type                               m_endpoints;
+        std::size_t                                         m_loops{0};
+    };
+}
+
+#endif // OPHIDIAN_TIMING_TIMINGGRAPH_H
@@ -21,6 +21,19 @@
 #define OPHIDIAN_UTIL_LOOKUPTABLE_H
 
 #include <vector>
+#include <array>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include <units/units.h>
+
+// the vector kernels are compiled for their instruction sets and selected at run time
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OPHIDIAN_LOOKUP_TABLE_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 namespace ophidian::util
 {
@@ -37,18 +50,212 @@ namespace ophidian::util
         value_container_type values;
     };
 
+    //! Fixed capacity vector
+
+    /*!
+       \brief A std::array with a runtime size, usable in constant expressions.
+     */
+    template <class T, std::size_t Capacity>
+    class FixedVector
+    {
+    public:
+        using value_type     = T;
+        using const_iterator = const T *;
+
+        constexpr FixedVector() = default;
+
+        constexpr std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        static constexpr std::size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        constexpr void push_back(const T & value)
+        {
+            m_data[m_size++] = value;
+        }
+
+        constexpr T & operator[](std::size_t i)
+        {
+            return m_data[i];
+        }
+
+        constexpr const T & operator[](std::size_t i) const
+        {
+            return m_data[i];
+        }
+
+        constexpr const T & front() const
+        {
+            return m_data[0];
+        }
+
+        constexpr const T & back() const
+        {
+            return m_data[m_size - 1];
+        }
+
+        constexpr const T * data() const noexcept
+        {
+            return m_data.data();
+        }
+
+        constexpr const_iterator begin() const noexcept
+        {
+            return m_data.data();
+        }
+
+        constexpr const_iterator end() const noexcept
+        {
+            return m_data.data() + m_size;
+        }
+
+    private:
+        std::array<T, Capacity> m_data{};
+        std::size_t m_size{0};
+    };
+
+    //! Fixed size table contents
+
+    /*!
+       \brief Same layout as TableContents but with at most Rows x Columns entries stored inline.
+     */
+    template <class RowType, class ColumnType, class ValueType, std::size_t Rows, std::size_t Columns>
+    struct FixedTableContents
+    {
+        using row_container_type                = FixedVector<RowType, Rows>;
+        using column_container_type             = FixedVector<ColumnType, Columns>;
+        using value_container_type              = FixedVector<FixedVector<ValueType, Columns>, Rows>;
+        using dynamic_contents_type             = TableContents<RowType, ColumnType, ValueType>;
+
+        row_container_type row_values;
+        column_container_type column_values;
+        value_container_type values;
+
+        //! True when the dynamic table has at most Rows x Columns entries
+        static bool fits(const dynamic_contents_type & contents)
+        {
+            if(contents.row_values.size() > Rows || contents.column_values.size() > Columns
+               || contents.values.size() > Rows)
+            {
+                return false;
+            }
+            return std::all_of(contents.values.begin(), contents.values.end(),
+                [](const auto & row){ return row.size() <= Columns; });
+        }
+
+        constexpr FixedTableContents() = default;
+
+        //! Copies a dynamic table, which must fit
+        explicit FixedTableContents(const dynamic_contents_type & contents)
+        {
+            for(const auto & row_value : contents.row_values)
+            {
+                row_values.push_back(row_value);
+            }
+            for(const auto & column_value : contents.column_values)
+            {
+                column_values.push_back(column_value);
+            }
+            for(const auto & row : contents.values)
+            {
+                auto fixed_row = FixedVector<ValueType, Columns>{};
+                for(const auto & value : row)
+                {
+                    fixed_row.push_back(value);
+                }
+                values.push_back(fixed_row);
+            }
+        }
+    };
+
+    //! Table axis view
+
+    /*!
+       \brief Read only view over the row or column values of a table, whatever its storage.
+     */
+    template <class T>
+    class TableAxisView
+    {
+    public:
+        using value_type     = T;
+        using const_iterator = const T *;
+
+        constexpr TableAxisView() = default;
+
+        constexpr TableAxisView(const T * data, std::size_t size) :
+            m_data{data},
+            m_size{size}
+        {
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        constexpr const T & operator[](std::size_t i) const
+        {
+            return m_data[i];
+        }
+
+        constexpr const T & front() const
+        {
+            return m_data[0];
+        }
+
+        constexpr const T & back() const
+        {
+            return m_data[m_size - 1];
+        }
+
+        constexpr const T * data() const noexcept
+        {
+            return m_data;
+        }
+
+        constexpr const_iterator begin() const noexcept
+        {
+            return m_data;
+        }
+
+        constexpr const_iterator end() const noexcept
+        {
+            return m_data + m_size;
+        }
+
+    private:
+        const T * m_data{nullptr};
+        std::size_t m_size{0};
+    };
+
     template <class RowType, class ColumnType, class ValueType>
     struct InterpolationStrategy
     {
-        static ValueType compute(const RowType & rv, const ColumnType & cv, const TableContents<RowType, ColumnType, ValueType> & c){
+        template <class Contents>
+        static constexpr ValueType compute(const RowType & rv, const ColumnType & cv, const Contents & c){
             if (c.values.size() == 1)
                 if (c.values.front().size() == 1)
                     return c.values.front().front();
 
-            RowType y1, y2;
-            ColumnType x1, x2;
-            ValueType t[2][2];
-            std::size_t row1, row2, column1, column2;
+            RowType y1{}, y2{};
+            ColumnType x1{}, x2{};
+            ValueType t[2][2] = {};
+            std::size_t row1 = 0, row2 = 0, column1 = 0, column2 = 0;
 
             row1 = c.row_values.size() - 2;
             row2 = c.row_values.size() - 1;
@@ -105,9 +312,10 @@ namespace ophidian::util
     template <class RowType, class ColumnType, class ValueType>
     struct FloorStrategy
     {
-        static ValueType compute(const RowType & rv, const ColumnType & cv, const TableContents<RowType, ColumnType, ValueType> & c){
+        template <class Contents>
+        static constexpr ValueType compute(const RowType & rv, const ColumnType & cv, const Contents & c){
 
-            int row, col = 0;
+            int row = 0, col = 0;
             for (int i = 0; i < c.row_values.size(); ++i) {
                 if(rv > c.row_values[i]){
                     row = i;
@@ -131,9 +339,10 @@ namespace ophidian::util
     template <class RowType, class ColumnType, class ValueType>
     struct CeilingStrategy
     {
-        static ValueType compute(const RowType & rv, const ColumnType & cv, const TableContents<RowType, ColumnType, ValueType> & c){
+        template <class Contents>
+        static constexpr ValueType compute(const RowType & rv, const ColumnType & cv, const Contents & c){
 
-            int row, col = 0;
+            int row = 0, col = 0;
             for (int i = c.row_values.size() -1; i >= 0; --i) {
                 if(rv < c.row_values[i]){
                     row = i;
@@ -154,6 +363,255 @@ namespace ophidian::util
         }
     };
 
+    //! Raw double trait
+
+    /*!
+       \brief True when a table value type is a plain double, or a linear units::unit_t wrapping a single double,
+       so that an array of it can be read as an array of double by the batched kernels.
+     */
+    template <class T, class = void>
+    struct is_raw_double : std::is_same<T, double>
+    {};
+
+    template <class T>
+    struct is_raw_double<T, std::enable_if_t<units::traits::is_unit_t<T>::value>> :
+        std::integral_constant<bool,
+            std::is_same<typename T::underlying_type, double>::value &&
+            std::is_base_of<units::linear_scale<double>, T>::value &&
+            std::is_standard_layout<T>::value &&
+            sizeof(T) == sizeof(double)>
+    {};
+
+    namespace detail
+    {
+        //! Flat view of a bilinear interpolation table, with values stored row-major
+        struct BilinearTableView
+        {
+            const double * rows;
+            std::size_t    number_of_rows;
+            const double * columns;
+            std::size_t    number_of_columns;
+            const double * values;
+        };
+
+        // Segment selection mirrors InterpolationStrategy: the last segment containing x is chosen,
+        // points above the axis use the last segment and points below it use below_segment.
+        inline std::size_t interpolation_segment(const double * axis, std::size_t size, double x, std::size_t below_segment)
+        {
+            std::size_t count = 0;
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                count += axis[i] <= x;
+            }
+
+            if(count == 0)
+            {
+                return below_segment;
+            }
+
+            return std::min(count - 1, size - 2);
+        }
+
+        inline double bilinear(const BilinearTableView & t, double rv, double cv)
+        {
+            auto row1 = interpolation_segment(t.rows, t.number_of_rows, rv, t.number_of_rows - 2);
+            auto column1 = interpolation_segment(t.columns, t.number_of_columns, cv, 0);
+
+            auto y1 = t.rows[row1];
+            auto y2 = t.rows[row1 + 1];
+            auto x1 = t.columns[column1];
+            auto x2 = t.columns[column1 + 1];
+
+            auto wTransition = (cv - x1) / (x2 - x1);
+            auto wLoad = (rv - y1) / (y2 - y1);
+
+            auto base = t.values + row1 * t.number_of_columns + column1;
+
+            return ((1 - wTransition) * (1 - wLoad) * base[0])
+                    + (wTransition * (1 - wLoad) * base[1])
+                    + ((1 - wTransition) * wLoad * base[t.number_of_columns])
+                    + (wTransition * wLoad * base[t.number_of_columns + 1]);
+        }
+
+#if defined(OPHIDIAN_LOOKUP_TABLE_X86_KERNELS)
+        //! Widest bilinear kernel supported by the processor
+        enum class BatchKernel : int {
+            SCALAR, AVX2, AVX512
+        };
+
+        inline BatchKernel batch_kernel() noexcept
+        {
+            static const auto kernel = []{
+                __builtin_cpu_init();
+                if(__builtin_cpu_supports("avx512f"))
+                {
+                    return BatchKernel::AVX512;
+                }
+                if(__builtin_cpu_supports("avx2"))
+                {
+                    return BatchKernel::AVX2;
+                }
+                return BatchKernel::SCALAR;
+            }();
+            return kernel;
+        }
+
+        __attribute__((target("avx512f")))
+        inline __m256i interpolation_segment_avx512(const double * axis, std::size_t size, __m512d x, double below_segment)
+        {
+            auto count = _mm512_setzero_pd();
+            const auto one = _mm512_set1_pd(1.0);
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                auto le = _mm512_cmp_pd_mask(_mm512_set1_pd(axis[i]), x, _CMP_LE_OQ);
+                count = _mm512_mask_add_pd(count, le, count, one);
+            }
+
+            auto below = _mm512_cmp_pd_mask(count, _mm512_setzero_pd(), _CMP_EQ_OQ);
+            auto segment = _mm512_min_pd(_mm512_sub_pd(count, one), _mm512_set1_pd(static_cast<double>(size - 2)));
+            segment = _mm512_mask_mov_pd(segment, below, _mm512_set1_pd(below_segment));
+
+            return _mm512_cvtpd_epi32(segment);
+        }
+
+        __attribute__((target("avx512f")))
+        inline void bilinear_batch_avx512(const BilinearTableView & t, const double * rv, const double * cv, double * out, std::size_t & i, std::size_t n)
+        {
+            const auto one = _mm512_set1_pd(1.0);
+            const auto width = _mm256_set1_epi32(static_cast<int>(t.number_of_columns));
+            const auto next = _mm256_set1_epi32(1);
+            for(; i + 8 <= n; i += 8)
+            {
+                auto r = _mm512_loadu_pd(rv + i);
+                auto c = _mm512_loadu_pd(cv + i);
+
+                auto row1 = interpolation_segment_avx512(t.rows, t.number_of_rows, r, static_cast<double>(t.number_of_rows - 2));
+                auto column1 = interpolation_segment_avx512(t.columns, t.number_of_columns, c, 0.0);
+
+                auto y1 = _mm512_i32gather_pd(row1, t.rows, 8);
+                auto y2 = _mm512_i32gather_pd(_mm256_add_epi32(row1, next), t.rows, 8);
+                auto x1 = _mm512_i32gather_pd(column1, t.columns, 8);
+                auto x2 = _mm512_i32gather_pd(_mm256_add_epi32(column1, next), t.columns, 8);
+
+                auto index00 = _mm256_add_epi32(_mm256_mullo_epi32(row1, width), column1);
+                auto index10 = _mm256_add_epi32(index00, width);
+                auto t00 = _mm512_i32gather_pd(index00, t.values, 8);
+                auto t01 = _mm512_i32gather_pd(_mm256_add_epi32(index00, next), t.values, 8);
+                auto t10 = _mm512_i32gather_pd(index10, t.values, 8);
+                auto t11 = _mm512_i32gather_pd(_mm256_add_epi32(index10, next), t.values, 8);
+
+                auto wTransition = _mm512_div_pd(_mm512_sub_pd(c, x1), _mm512_sub_pd(x2, x1));
+                auto wLoad = _mm512_div_pd(_mm512_sub_pd(r, y1), _mm512_sub_pd(y2, y1));
+                auto oneMinusT = _mm512_sub_pd(one, wTransition);
+                auto oneMinusL = _mm512_sub_pd(one, wLoad);
+
+                auto result = _mm512_mul_pd(_mm512_mul_pd(oneMinusT, oneMinusL), t00);
+                result = _mm512_add_pd(result, _mm512_mul_pd(_mm512_mul_pd(wTransition, oneMinusL), t01));
+                result = _mm512_add_pd(result, _mm512_mul_pd(_mm512_mul_pd(oneMinusT, wLoad), t10));
+                result = _mm512_add_pd(result, _mm512_mul_pd(_mm512_mul_pd(wTransition, wLoad), t11));
+
+                _mm512_storeu_pd(out + i, result);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        inline __m128i interpolation_segment_avx2(const double * axis, std::size_t size, __m256d x, double below_segment)
+        {
+            auto count = _mm256_setzero_pd();
+            const auto one = _mm256_set1_pd(1.0);
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                auto le = _mm256_cmp_pd(_mm256_set1_pd(axis[i]), x, _CMP_LE_OQ);
+                count = _mm256_add_pd(count, _mm256_and_pd(le, one));
+            }
+
+            auto below = _mm256_cmp_pd(count, _mm256_setzero_pd(), _CMP_EQ_OQ);
+            auto segment = _mm256_min_pd(_mm256_sub_pd(count, one), _mm256_set1_pd(static_cast<double>(size - 2)));
+            segment = _mm256_blendv_pd(segment, _mm256_set1_pd(below_segment), below);
+
+            return _mm256_cvtpd_epi32(segment);
+        }
+
+        __attribute__((target("avx2")))
+        inline void bilinear_batch_avx2(const BilinearTableView & t, const double * rv, const double * cv, double * out, std::size_t & i, std::size_t n)
+        {
+            const auto one = _mm256_set1_pd(1.0);
+            const auto width = _mm_set1_epi32(static_cast<int>(t.number_of_columns));
+            const auto next = _mm_set1_epi32(1);
+            for(; i + 4 <= n; i += 4)
+            {
+                auto r = _mm256_loadu_pd(rv + i);
+                auto c = _mm256_loadu_pd(cv + i);
+
+                auto row1 = interpolation_segment_avx2(t.rows, t.number_of_rows, r, static_cast<double>(t.number_of_rows - 2));
+                auto column1 = interpolation_segment_avx2(t.columns, t.number_of_columns, c, 0.0);
+
+                auto y1 = _mm256_i32gather_pd(t.rows, row1, 8);
+                auto y2 = _mm256_i32gather_pd(t.rows, _mm_add_epi32(row1, next), 8);
+                auto x1 = _mm256_i32gather_pd(t.columns, column1, 8);
+                auto x2 = _mm256_i32gather_pd(t.columns, _mm_add_epi32(column1, next), 8);
+
+                auto index00 = _mm_add_epi32(_mm_mullo_epi32(row1, width), column1);
+                auto index10 = _mm_add_epi32(index00, width);
+                auto t00 = _mm256_i32gather_pd(t.values, index00, 8);
+                auto t01 = _mm256_i32gather_pd(t.values, _mm_add_epi32(index00, next), 8);
+                auto t10 = _mm256_i32gather_pd(t.values, index10, 8);
+                auto t11 = _mm256_i32gather_pd(t.values, _mm_add_epi32(index10, next), 8);
+
+                auto wTransition = _mm256_div_pd(_mm256_sub_pd(c, x1), _mm256_sub_pd(x2, x1));
+                auto wLoad = _mm256_div_pd(_mm256_sub_pd(r, y1), _mm256_sub_pd(y2, y1));
+                auto oneMinusT = _mm256_sub_pd(one, wTransition);
+                auto oneMinusL = _mm256_sub_pd(one, wLoad);
+
+                auto result = _mm256_mul_pd(_mm256_mul_pd(oneMinusT, oneMinusL), t00);
+                result = _mm256_add_pd(result, _mm256_mul_pd(_mm256_mul_pd(wTransition, oneMinusL), t01));
+                result = _mm256_add_pd(result, _mm256_mul_pd(_mm256_mul_pd(oneMinusT, wLoad), t10));
+                result = _mm256_add_pd(result, _mm256_mul_pd(_mm256_mul_pd(wTransition, wLoad), t11));
+
+                _mm256_storeu_pd(out + i, result);
+            }
+        }
+#endif
+
+        //! Batched bilinear interpolation
+        /*!
+           \brief Evaluates n points using the widest vector kernel the processor supports (AVX-512,
+           AVX2), finishing the remaining points with the scalar kernel.
+         */
+        inline void bilinear_batch(const BilinearTableView & t, const double * rv, const double * cv, double * out, std::size_t n)
+        {
+            std::size_t i = 0;
+#if defined(OPHIDIAN_LOOKUP_TABLE_X86_KERNELS)
+            switch(batch_kernel())
+            {
+            case BatchKernel::AVX512:
+                bilinear_batch_avx512(t, rv, cv, out, i, n);
+                bilinear_batch_avx2(t, rv, cv, out, i, n);
+                break;
+            case BatchKernel::AVX2:
+                bilinear_batch_avx2(t, rv, cv, out, i, n);
+                break;
+            case BatchKernel::SCALAR:
+                break;
+            }
+#endif
+            for(; i < n; ++i)
+            {
+                out[i] = bilinear(t, rv[i], cv[i]);
+            }
+        }
+    } // namespace detail
+
+    //! Fixed size table tag
+
+    /*!
+       \brief Selects the LookupTable specialization holding up to Rows x Columns entries inline.
+     */
+    template <class ComputeStrategy, std::size_t Rows, std::size_t Columns>
+    struct FixedSize
+    {
+    };
+
     template<class RowType, class ColumnType, class ValueType, class ComputeStrategy>
     class LookupTable{};
 
@@ -169,6 +627,11 @@ namespace ophidian::util
         using contents_type                     = TableContents<RowType, ColumnType, ValueType>;
         using compute_statrgy_type              = ComputeStrategy<RowType, ColumnType, ValueType>;
 
+        //! True when compute_batch() runs the vectorized bilinear kernel over raw doubles
+        static constexpr bool has_raw_batch_kernel =
+            std::is_same<compute_statrgy_type, InterpolationStrategy<RowType, ColumnType, ValueType>>::value &&
+            is_raw_double<RowType>::value && is_raw_double<ColumnType>::value && is_raw_double<ValueType>::value;
+
         //! LookupTable Constructor
         /*!
             \brief Construct the LUT table using the table contents.
@@ -176,11 +639,15 @@ namespace ophidian::util
         */
         LookupTable(const contents_type & lut) :
             m_contents(lut)
-        {}
+        {
+            flatten_values();
+        }
 
         LookupTable(contents_type && lut) :
             m_contents{std::move(lut)}
-        {}
+        {
+            flatten_values();
+        }
 
         //! Default Constructor
         LookupTable() = default;
@@ -210,6 +677,42 @@ namespace ophidian::util
             return compute_statrgy_type::compute(rv, cv, m_contents);
         }
 
+        //! Compute a batch of points
+        /*!
+           \brief Evaluates out[i] = compute(rv[i], cv[i]) for i in [0, n). Interpolation tables of
+           doubles (or units wrapping a double) run a SIMD bilinear kernel, other tables use the strategy.
+           \param rv Row values
+           \param cv Column values
+           \param out Output values, must hold n elements
+           \param n Number of points
+         */
+        void compute_batch(const RowType * rv, const ColumnType * cv, ValueType * out, std::size_t n) const
+        {
+            if constexpr (has_raw_batch_kernel)
+            {
+                auto rows = m_contents.row_values.size();
+                auto columns = m_contents.column_values.size();
+                if(rows >= 2 && columns >= 2)
+                {
+                    auto view = detail::BilinearTableView{
+                        reinterpret_cast<const double *>(m_contents.row_values.data()), rows,
+                        reinterpret_cast<const double *>(m_contents.column_values.data()), columns,
+                        reinterpret_cast<const double *>(m_flat_values.data())
+                    };
+                    detail::bilinear_batch(view,
+                        reinterpret_cast<const double *>(rv),
+                        reinterpret_cast<const double *>(cv),
+                        reinterpret_cast<double *>(out), n);
+                    return;
+                }
+            }
+
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = compute(rv[i], cv[i]);
+            }
+        }
+
         const row_container_type & row_values() const
         {
             return m_contents.row_values;
@@ -221,7 +724,138 @@ namespace ophidian::util
         }
 
     private:
+        void flatten_values()
+        {
+            if constexpr (has_raw_batch_kernel)
+            {
+                m_flat_values.reserve(m_contents.row_values.size() * m_contents.column_values.size());
+                for(const auto & row : m_contents.values)
+                {
+                    m_flat_values.insert(m_flat_values.end(), row.begin(), row.end());
+                }
+            }
+        }
+
         contents_type m_contents;
+        container_type<ValueType> m_flat_values;
+    };
+
+    template<class RowType, class ColumnType, class ValueType, template <class, class, class> class ComputeStrategy, std::size_t Rows, std::size_t Columns>
+    class LookupTable<RowType, ColumnType, ValueType, FixedSize<ComputeStrategy<RowType, ColumnType, ValueType>, Rows, Columns>>
+    {
+    public:
+        using contents_type                     = TableContents<RowType, ColumnType, ValueType>;
+        using fixed_contents_type               = FixedTableContents<RowType, ColumnType, ValueType, Rows, Columns>;
+        using compute_statrgy_type              = ComputeStrategy<RowType, ColumnType, ValueType>;
+        using row_container_type                = TableAxisView<RowType>;
+        using column_container_type             = TableAxisView<ColumnType>;
+
+        //! LookupTable Constructor
+        /*!
+            \brief Construct the LUT table using the table contents. Tables with at most
+            Rows x Columns entries are copied to inline storage, larger ones are kept on the heap.
+            \param lut table contents
+        */
+        LookupTable(const contents_type & lut)
+        {
+            if(fixed_contents_type::fits(lut))
+            {
+                m_fixed_contents = fixed_contents_type{lut};
+            }
+            else
+            {
+                m_dynamic_contents = std::make_shared<const contents_type>(lut);
+            }
+        }
+
+        //! LookupTable Constructor
+        /*!
+            \brief Construct the LUT table using fixed size table contents.
+            \param lut table contents
+        */
+        constexpr LookupTable(const fixed_contents_type & lut) :
+            m_fixed_contents(lut)
+        {
+        }
+
+        //! Default Constructor
+        LookupTable() = default;
+
+        //! Copy Constructor
+        LookupTable(const LookupTable&) = default;
+        LookupTable& operator=(const LookupTable&) = default;
+
+        //! Move Constructor
+        LookupTable(LookupTable&&) = default;
+        LookupTable& operator=(LookupTable&&) = default;
+
+        //! LookupTable Destructor
+        /*!
+           \brief Destroys the LookupTable object
+         */
+        ~LookupTable() = default;
+
+        //! Inline storage query
+        /*!
+           \brief Returns true when the table contents are stored inline
+         */
+        bool is_fixed() const noexcept
+        {
+            return m_dynamic_contents == nullptr;
+        }
+
+        //! Compute slew
+        /*!
+           \brief Equation for access strategy
+           \param rv Row index
+           \param cv Column index
+         */
+        ValueType compute(const RowType & rv, const ColumnType & cv) const
+        {
+            if(is_fixed())
+            {
+                return compute_statrgy_type::compute(rv, cv, m_fixed_contents);
+            }
+            return compute_statrgy_type::compute(rv, cv, *m_dynamic_contents);
+        }
+
+        //! Compute a batch of points
+        /*!
+           \brief Evaluates out[i] = compute(rv[i], cv[i]) for i in [0, n).
+           \param rv Row values
+           \param cv Column values
+           \param out Output values, must hold n elements
+           \param n Number of points
+         */
+        void compute_batch(const RowType * rv, const ColumnType * cv, ValueType * out, std::size_t n) const
+        {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = compute(rv[i], cv[i]);
+            }
+        }
+
+        row_container_type row_values() const
+        {
+            if(is_fixed())
+            {
+                return row_container_type{m_fixed_contents.row_values.data(), m_fixed_contents.row_values.size()};
+            }
+            return row_container_type{m_dynamic_contents->row_values.data(), m_dynamic_contents->row_values.size()};
+        }
+
+        column_container_type column_values() const
+        {
+            if(is_fixed())
+            {
+                return column_container_type{m_fixed_contents.column_values.data(), m_fixed_contents.column_values.size()};
+            }
+            return column_container_type{m_dynamic_contents->column_values.data(), m_dynamic_contents->column_values.size()};
+        }
+
+    private:
+        fixed_contents_type m_fixed_contents;
+        std::shared_ptr<const contents_type> m_dynamic_contents;
     };
 } // namespace ophidian::util
 
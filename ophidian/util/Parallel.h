@@ -0,0 +1,286 @@
+/*
+ * Copyright 2017 Ophidian
+   Licensed to the Apache Software Foundation (ASF) under one
+   or more contributor license agreements.  See the NOTICE file
+   distributed with this work for additional information
+   regarding copyright ownership.  The ASF licenses this file
+   to you under the Apache License, Version 2.0 (the
+   "License"); you may not use this file except in compliance
+   with the License.  You may obtain a copy of the License at
+   http://www.apache.org/licenses/LICENSE-2.0
+   Unless required by applicable law or agreed to in writing,
+   software distributed under the License is distributed on an
+   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+   KIND, either express or implied.  See the License for the
+   specific language governing permissions and limitations
+   under the License.
+
+ */
+
+#ifndef OPHIDIAN_UTIL_PARALLEL_H
+#define OPHIDIAN_UTIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ophidian::util
+{
+    //! Number of threads
+
+    /*!
+       \brief Resolves a requested number of threads, 0 meaning one per hardware thread.
+       \param requested Requested number of threads
+     */
+    inline std::size_t number_of_threads(std::size_t requested = 0) noexcept
+    {
+        if(requested != 0)
+        {
+            return requested;
+        }
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    //! Persistent worker threads
+
+    /*!
+       \brief Runs a job on a number of threads, the calling one included, and waits for it.
+       Worker threads are created on demand, the first time that many are needed, and then
+       sleep between jobs, so the cost of a run is a wake up instead of a thread creation.
+       One job runs at a time: a run from a thread already taking part in a job, or while
+       another thread owns the pool, gets fresh threads instead, which keeps nested and
+       concurrent parallel loops correct.
+     */
+    class ThreadPool
+    {
+    public:
+        using job_type = std::function<void(std::size_t)>;
+
+        // Constructors
+        ThreadPool() = default;
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool & operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                auto lock = std::lock_guard<std::mutex>{m_mutex};
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for(auto & worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        //! Pool shared by the parallel loops
+        static ThreadPool & instance()
+        {
+            static auto pool = ThreadPool{};
+            return pool;
+        }
+
+        // Modifiers
+
+        //! Call job(thread) for every thread in [0, threads) and wait for every call
+        /*!
+           \brief The calling thread runs job(0). The job must not throw.
+         */
+        void run(std::size_t threads, const job_type & job)
+        {
+            if(threads <= 1)
+            {
+                job(0);
+                return;
+            }
+
+            auto & busy = participating();
+            auto owner = std::unique_lock<std::mutex>{m_run_mutex, std::defer_lock};
+            if(busy || !owner.try_lock())
+            {
+                run_detached(threads, job);
+                return;
+            }
+
+            {
+                auto lock = std::lock_guard<std::mutex>{m_mutex};
+                while(m_workers.size() + 1 < threads)
+                {
+                    m_workers.emplace_back(&ThreadPool::work, this, m_workers.size() + 1, m_generation);
+                }
+                m_job = &job;
+                m_threads = threads;
+                m_remaining = threads - 1;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            busy = true;
+            job(0);
+            busy = false;
+
+            auto lock = std::unique_lock<std::mutex>{m_mutex};
+            m_done.wait(lock, [this]{ return m_remaining == 0; });
+            m_job = nullptr;
+        }
+
+    private:
+        static bool & participating()
+        {
+            thread_local auto value = false;
+            return value;
+        }
+
+        static void run_detached(std::size_t threads, const job_type & job)
+        {
+            auto workers = std::vector<std::thread>{};
+            workers.reserve(threads - 1);
+            for(std::size_t thread = 1; thread < threads; ++thread)
+            {
+                workers.emplace_back([&job, thread]{
+                    participating() = true;
+                    job(thread);
+                });
+            }
+            job(0);
+            for(auto & worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        void work(std::size_t thread, std::size_t generation)
+        {
+            participating() = true;
+            auto lock = std::unique_lock<std::mutex>{m_mutex};
+            while(true)
+            {
+                m_wake.wait(lock, [&]{ return m_stop || m_generation != generation; });
+                if(m_stop)
+                {
+                    return;
+                }
+                generation = m_generation;
+                if(thread < m_threads)
+                {
+                    auto job = m_job;
+                    lock.unlock();
+                    (*job)(thread);
+                    lock.lock();
+                    if(--m_remaining == 0)
+                    {
+                        m_done.notify_one();
+                    }
+                }
+            }
+        }
+
+        std::mutex                  m_run_mutex;
+        std::mutex                  m_mutex;
+        std::condition_variable     m_wake;
+        std::condition_variable     m_done;
+        std::vector<std::thread>    m_workers;
+        const job_type *            m_job{nullptr};
+        std::size_t                 m_threads{0};
+        std::size_t                 m_remaining{0};
+        std::size_t                 m_generation{0};
+        bool                        m_stop{false};
+    };
+
+    //! Parallel for
+
+    /*!
+       \brief Calls function(i) for every i in [begin, end), or function(i, thread) when the
+       function also takes the index of the worker thread, which is in [0, threads) and can select
+       per thread scratch storage. Indices are handed out in chunks of grain consecutive values.
+       The first exception thrown by a call is rethrown once every worker has stopped. The
+       workers come from ThreadPool::instance(), so short loops can be called repeatedly.
+       \param begin First index
+       \param end One past the last index
+       \param function The loop body
+       \param threads Number of threads, 0 for one per hardware thread
+       \param grain Number of consecutive indices taken by a worker at once
+     */
+    template <class Function>
+    void parallel_for(std::size_t begin, std::size_t end, Function && function, std::size_t threads = 0, std::size_t grain = 1)
+    {
+        if(begin >= end)
+        {
+            return;
+        }
+
+        auto call = [&function](std::size_t i, std::size_t thread) {
+            if constexpr (std::is_invocable_v<Function &, std::size_t, std::size_t>)
+            {
+                function(i, thread);
+            }
+            else
+            {
+                function(i);
+            }
+        };
+
+        grain = std::max<std::size_t>(1, grain);
+        auto workers = std::min(number_of_threads(threads), (end - begin + grain - 1) / grain);
+
+        if(workers <= 1)
+        {
+            for(auto i = begin; i < end; ++i)
+            {
+                call(i, 0);
+            }
+            return;
+        }
+
+        auto next = std::atomic<std::size_t>{begin};
+        auto failed = std::atomic<bool>{false};
+        auto error = std::exception_ptr{};
+        auto error_mutex = std::mutex{};
+
+        auto work = [&](std::size_t thread) {
+            try
+            {
+                while(!failed.load(std::memory_order_relaxed))
+                {
+                    auto first = next.fetch_add(grain, std::memory_order_relaxed);
+                    if(first >= end)
+                    {
+                        break;
+                    }
+                    auto last = std::min(end, first + grain);
+                    for(auto i = first; i < last; ++i)
+                    {
+                        call(i, thread);
+                    }
+                }
+            }
+            catch(...)
+            {
+                auto lock = std::lock_guard<std::mutex>{error_mutex};
+                if(!error)
+                {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        };
+
+        ThreadPool::instance().run(workers, std::ref(work));
+
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif // OPHIDIAN_UTIL_PARALLEL_H
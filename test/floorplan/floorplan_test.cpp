@@ -1,6 +1,7 @@
 #include <catch.hpp>
 #include <ophidian/floorplan/Floorplan.h>
 #include <ophidian/util/Units.h>
+#include <vector>
 
 using namespace ophidian::floorplan;
 using dbu_t = ophidian::util::database_unit_t;
@@ -170,3 +171,113 @@ TEST_CASE_METHOD(RowWithPropertiesFixture,"Floorplan: Row Upper Right Corner.",
     CHECK(floorplan.upper_right_corner(rowRet2).x() == urCorner2.x());
     CHECK(floorplan.upper_right_corner(rowRet2).y() == urCorner2.y());
 }
+
+namespace
+{
+    Floorplan::point_type point(double x, double y)
+    {
+        return Floorplan::point_type{dbu_t{x}, dbu_t{y}};
+    }
+}
+
+TEST_CASE("Floorplan: Row index with uniform pitch.", "[floorplan]")
+{
+    Floorplan floorplan;
+    auto site = floorplan.add_site("core", point(10, 100));
+    auto rows = std::vector<Floorplan::row_type>{};
+    for(auto i = 3; i >= 0; --i)
+    {
+        rows.push_back(floorplan.add_row(point(0, 100 * i), Floorplan::row_size_type{50}, site));
+    }
+    auto right = floorplan.add_row(point(1000, 200), Floorplan::row_size_type{20}, site);
+    floorplan.update_row_index();
+
+    CHECK(floorplan.uniform_row_pitch());
+
+    CHECK(floorplan.find_row(point(15, 5)) == rows[3]);
+    CHECK(floorplan.find_row(point(499, 399)) == rows[0]);
+    CHECK(floorplan.find_row(point(1100, 250)) == right);
+    CHECK(floorplan.find_row(point(700, 250)) == Floorplan::row_type{});
+    CHECK(floorplan.find_row(point(15, 400)) == Floorplan::row_type{});
+    CHECK(floorplan.find_row(point(-1, 50)) == Floorplan::row_type{});
+
+    CHECK(floorplan.nearest_row(point(15, 1000)) == rows[0]);
+    CHECK(floorplan.nearest_row(point(980, 250)) == right);
+    CHECK(floorplan.nearest_row(point(510, 250)) == rows[1]);
+
+    CHECK(floorplan.site_index(rows[2], dbu_t{25}) == Floorplan::row_size_type{2});
+    CHECK(floorplan.site_index(rows[2], dbu_t{-25}) == Floorplan::row_size_type{0});
+    CHECK(floorplan.site_index(rows[2], dbu_t{5000}) == Floorplan::row_size_type{49});
+
+    auto snapped = floorplan.snap_to_site(point(26, 140));
+    CHECK(snapped.x() == dbu_t{30});
+    CHECK(snapped.y() == dbu_t{100});
+
+    // the short row on the right is closer than the bottom row once x counts
+    snapped = floorplan.snap_to_site(point(2000, -300));
+    CHECK(snapped.x() == dbu_t{1190});
+    CHECK(snapped.y() == dbu_t{200});
+
+    snapped = floorplan.snap_to_site(point(700, -300));
+    CHECK(snapped.x() == dbu_t{490});
+    CHECK(snapped.y() == dbu_t{0});
+}
+
+TEST_CASE("Floorplan: Row index with irregular rows.", "[floorplan]")
+{
+    Floorplan floorplan;
+    auto site = floorplan.add_site("core", point(10, 100));
+    auto low = floorplan.add_row(point(0, 0), Floorplan::row_size_type{10}, site);
+    auto middle = floorplan.add_row(point(0, 100), Floorplan::row_size_type{10}, site);
+    auto high = floorplan.add_row(point(0, 500), Floorplan::row_size_type{10}, site);
+    floorplan.update_row_index();
+
+    CHECK(!floorplan.uniform_row_pitch());
+
+    CHECK(floorplan.find_row(point(5, 50)) == low);
+    CHECK(floorplan.find_row(point(5, 150)) == middle);
+    CHECK(floorplan.find_row(point(5, 550)) == high);
+    CHECK(floorplan.find_row(point(5, 300)) == Floorplan::row_type{});
+
+    CHECK(floorplan.nearest_row(point(5, 250)) == middle);
+    CHECK(floorplan.nearest_row(point(5, 420)) == high);
+
+    auto snapped = floorplan.snap_to_site(point(44, 420));
+    CHECK(snapped.x() == dbu_t{40});
+    CHECK(snapped.y() == dbu_t{500});
+
+    floorplan.erase(high);
+    floorplan.update_row_index();
+    CHECK(floorplan.uniform_row_pitch());
+    CHECK(floorplan.nearest_row(point(5, 420)) == middle);
+}
+
+TEST_CASE("Floorplan: Nearest row away from the neighbouring lines.", "[floorplan]")
+{
+    Floorplan floorplan;
+    auto site = floorplan.add_site("core", point(10, 100));
+    auto left = floorplan.add_row(point(0, 0), Floorplan::row_size_type{10}, site);
+    floorplan.add_row(point(1000, 100), Floorplan::row_size_type{10}, site);
+    floorplan.add_row(point(1000, 200), Floorplan::row_size_type{10}, site);
+    auto top = floorplan.add_row(point(0, 600), Floorplan::row_size_type{10}, site);
+    floorplan.update_row_index();
+
+    // the lines around y only have rows far away in x
+    CHECK(floorplan.nearest_row(point(50, 150)) == left);
+    CHECK(floorplan.nearest_row(point(50, 480)) == top);
+
+    auto snapped = floorplan.snap_to_site(point(52, 150));
+    CHECK(snapped.x() == dbu_t{50});
+    CHECK(snapped.y() == dbu_t{0});
+}
+
+TEST_CASE("Floorplan: Snapping without rows returns the point.", "[floorplan]")
+{
+    Floorplan floorplan;
+    floorplan.update_row_index();
+
+    auto snapped = floorplan.snap_to_site(point(13, 17));
+    CHECK(snapped.x() == dbu_t{13});
+    CHECK(snapped.y() == dbu_t{17});
+    CHECK(floorplan.find_row(point(13, 17)) == Floorplan::row_type{});
+}
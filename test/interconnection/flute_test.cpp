@@ -1,4 +1,8 @@
 #include <catch.hpp>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
 #include <ophidian/interconnection/SteinerTree.h>
 #include <ophidian/interconnection/Flute.h>
 #include <ophidian/geometry/Models.h>
@@ -110,3 +114,133 @@ TEST_CASE("Flute to EPS", "[interconnection]")
 
     ToEps::run(*tree, "output.eps");
 }
+
+namespace
+{
+    struct FluteDegree
+    {
+        explicit FluteDegree(std::size_t degree) :
+            previous(Flute::instance().maxFluteDegree())
+        {
+            Flute::instance().maxFluteDegree(degree);
+        }
+
+        ~FluteDegree()
+        {
+            Flute::instance().maxFluteDegree(previous);
+        }
+
+        std::size_t previous;
+    };
+
+    double spanning_tree_length(const std::vector<Flute::Point> & pins)
+    {
+        auto distance = std::vector<double>(pins.size(), std::numeric_limits<double>::max());
+        auto in_tree = std::vector<bool>(pins.size(), false);
+        auto length = 0.0;
+        distance[0] = 0.0;
+        for(std::size_t step = 0; step < pins.size(); ++step)
+        {
+            auto next = pins.size();
+            for(std::size_t i = 0; i < pins.size(); ++i)
+            {
+                if(!in_tree[i] && (next == pins.size() || distance[i] < distance[next]))
+                {
+                    next = i;
+                }
+            }
+            in_tree[next] = true;
+            length += distance[next];
+            for(std::size_t i = 0; i < pins.size(); ++i)
+            {
+                distance[i] = std::min(distance[i], units::unit_cast<double>(geometry::ManhattanDistance(pins[next], pins[i])));
+            }
+        }
+        return length;
+    }
+}
+
+TEST_CASE("Flute spanning tree heuristic for high fanout nets", "[interconnection]")
+{
+    auto generator = std::mt19937{7};
+    auto coordinate = std::uniform_int_distribution<int>{-500, 500};
+    auto pins = std::vector<Flute::Point>{};
+    for(int i = 0; i < 300; ++i)
+    {
+        pins.emplace_back(Flute::dbu_t{static_cast<double>(coordinate(generator))}, Flute::dbu_t{static_cast<double>(coordinate(generator))});
+    }
+
+    FluteDegree degree{100};
+    auto tree = Flute::instance().create(pins);
+
+    // a tree through every pin, never longer than the spanning tree
+    REQUIRE( tree->size(SteinerTree::Segment{}) + 1 == tree->size(SteinerTree::Point{}) );
+    REQUIRE( tree->size(SteinerTree::Point{}) >= pins.size() );
+    CHECK( units::unit_cast<double>(tree->length()) < spanning_tree_length(pins) );
+
+    auto positions = std::set<std::pair<double, double>>{};
+    for(auto point = tree->points().first; point != tree->points().second; ++point)
+    {
+        auto position = tree->position(*point);
+        positions.emplace(units::unit_cast<double>(position.x()), units::unit_cast<double>(position.y()));
+    }
+    for(const auto & pin : pins)
+    {
+        CHECK( positions.count({units::unit_cast<double>(pin.x()), units::unit_cast<double>(pin.y())}) == 1 );
+    }
+}
+
+TEST_CASE("Flute spanning tree heuristic adds the median Steiner point", "[interconnection]")
+{
+    FluteDegree degree{2};
+    auto tree = Flute::instance().create(
+        std::vector{
+            Flute::Point{Flute::dbu_t{0.0}, Flute::dbu_t{0.0}},
+            Flute::Point{Flute::dbu_t{10.0}, Flute::dbu_t{4.0}},
+            Flute::Point{Flute::dbu_t{4.0}, Flute::dbu_t{10.0}},
+            Flute::Point{Flute::dbu_t{4.0}, Flute::dbu_t{10.0}}
+        }
+    );
+
+    CHECK( tree->size(SteinerTree::Point{}) == 4 );
+    CHECK( tree->size(SteinerTree::Segment{}) == 3 );
+    CHECK( Approx(units::unit_cast<double>(tree->length())) == 20.0 );
+}
+
+TEST_CASE("Flute updates a tree after pin moves", "[interconnection]")
+{
+    auto generator = std::mt19937{11};
+    auto coordinate = std::uniform_int_distribution<int>{0, 200};
+    auto pins = std::vector<Flute::Point>{};
+    for(int i = 0; i < 12; ++i)
+    {
+        pins.emplace_back(Flute::dbu_t{static_cast<double>(coordinate(generator))}, Flute::dbu_t{static_cast<double>(coordinate(generator))});
+    }
+
+    auto & flute = Flute::instance();
+    auto tree = flute.create(pins);
+    auto pick = std::uniform_int_distribution<std::size_t>{0, pins.size() - 1};
+    for(int move = 0; move < 50; ++move)
+    {
+        auto i = pick(generator);
+        auto pin = tree->add(pins[i]);
+        auto before = units::unit_cast<double>(tree->length());
+        auto moved = Flute::Point{Flute::dbu_t{static_cast<double>(coordinate(generator))}, Flute::dbu_t{static_cast<double>(coordinate(generator))}};
+        auto displacement = units::unit_cast<double>(geometry::ManhattanDistance(pins[i], moved));
+        pins[i] = moved;
+
+        auto delta = units::unit_cast<double>(flute.update(tree, pin, moved, pins));
+        CHECK( Approx(before + delta) == units::unit_cast<double>(tree->length()) );
+        CHECK( units::unit_cast<double>(tree->length()) <= before + displacement + 1e-6 );
+    }
+
+    // every pin is still a point of the tree
+    for(const auto & pin : pins)
+    {
+        auto count = std::count_if(tree->points().first, tree->points().second, [&](const SteinerTree::Point & point){
+            auto position = tree->position(point);
+            return position.x() == pin.x() && position.y() == pin.y();
+        });
+        CHECK( count >= 1 );
+    }
+}
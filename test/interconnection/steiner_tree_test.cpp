@@ -159,3 +159,113 @@ TEST_CASE_METHOD(TreeWith4PointsFixture, "Steiner Tree/iterator general", "[inte
     auto it2 = std::next(it);
     CHECK(true);
 }
+
+namespace {
+    SteinerTree::DbuPoint at(double x, double y)
+    {
+        return SteinerTree::DbuPoint{SteinerTree::dbu_t{x}, SteinerTree::dbu_t{y}};
+    }
+
+    std::size_t segment_count(const SteinerTree & tree, const SteinerTree::Point & point)
+    {
+        auto segments = tree.segments(point);
+        return static_cast<std::size_t>(std::distance(segments.first, segments.second));
+    }
+
+    // a tree has one segment less than points and no point without segments
+    bool is_tree(const SteinerTree & tree)
+    {
+        auto points = tree.points();
+        return tree.size(SteinerTree::Segment{}) + 1 == tree.size(SteinerTree::Point{})
+            && std::all_of(points.first, points.second, [&](const auto & point){ return segment_count(tree, point) > 0; });
+    }
+}
+
+TEST_CASE("Steiner Tree/move a pin", "[interconnection]")
+{
+    // pins a, b and c joined at a Steiner point below c
+    auto tree = SteinerTree::create();
+    auto a = tree->add(at(0.0, 0.0));
+    auto b = tree->add(at(10.0, 0.0));
+    auto c = tree->add(at(5.0, 10.0));
+    auto s = tree->add(at(5.0, 0.0), false);
+    tree->add(a, s);
+    tree->add(s, b);
+    tree->add(s, c);
+    REQUIRE( Approx(tree->length()) == 20.0 );
+    CHECK( tree->terminal(c) );
+    CHECK( !tree->terminal(s) );
+
+    // c hangs from a new point of the segment towards b and s, which no longer branches, is erased
+    auto delta = tree->move(c, at(8.0, 6.0));
+    CHECK( Approx(delta) == -4.0 );
+    CHECK( Approx(tree->length()) == 16.0 );
+    CHECK( Approx(tree->position(c).x()) == 8.0 );
+    CHECK( tree->size(SteinerTree::Segment{}) == 3 );
+    CHECK( tree->size(SteinerTree::Point{}) == 4 );
+    CHECK( is_tree(*tree) );
+    CHECK( segment_count(*tree, a) == 1 );
+    CHECK( segment_count(*tree, b) == 1 );
+    CHECK( segment_count(*tree, c) == 1 );
+    CHECK( segment_count(*tree, tree->add(at(8.0, 0.0), false)) == 3 );
+
+    // the Steiner point moves along with c
+    delta = tree->move(c, at(2.0, 4.0));
+    CHECK( Approx(delta) == -2.0 );
+    CHECK( Approx(tree->length()) == 14.0 );
+    CHECK( tree->size(SteinerTree::Point{}) == 4 );
+    CHECK( is_tree(*tree) );
+    CHECK( segment_count(*tree, tree->add(at(2.0, 0.0), false)) == 3 );
+}
+
+TEST_CASE("Steiner Tree/move a pin joining its subtrees", "[interconnection]")
+{
+    // a chain of pins, moving the middle one reconnects its two sides
+    auto tree = SteinerTree::create();
+    auto a = tree->add(at(0.0, 0.0));
+    auto b = tree->add(at(10.0, 5.0));
+    auto c = tree->add(at(20.0, 0.0));
+    tree->add(a, b);
+    tree->add(b, c);
+    REQUIRE( Approx(tree->length()) == 30.0 );
+
+    auto delta = tree->move(b, at(10.0, -3.0));
+    CHECK( Approx(tree->length()) == 23.0 );
+    CHECK( Approx(delta) == -7.0 );
+    CHECK( is_tree(*tree) );
+    CHECK( segment_count(*tree, b) == 1 );
+}
+
+TEST_CASE("Steiner Tree/move a pin onto a Steiner point", "[interconnection]")
+{
+    auto tree = SteinerTree::create();
+    auto a = tree->add(at(0.0, 0.0));
+    auto b = tree->add(at(10.0, 0.0));
+    auto c = tree->add(at(5.0, 10.0));
+    auto s = tree->add(at(5.0, 0.0), false);
+    tree->add(a, s);
+    tree->add(s, b);
+    tree->add(s, c);
+
+    // the Steiner point is merged into the pin
+    auto delta = tree->move(c, at(5.0, 0.0));
+    CHECK( Approx(delta) == -10.0 );
+    CHECK( Approx(tree->length()) == 10.0 );
+    CHECK( tree->size(SteinerTree::Segment{}) == 2 );
+    CHECK( tree->size(SteinerTree::Point{}) == 3 );
+    CHECK( is_tree(*tree) );
+    CHECK( segment_count(*tree, c) == 2 );
+    CHECK( tree->add(at(5.0, 0.0)) == c );
+    CHECK( segment_count(*tree, tree->add(at(5.0, 0.0))) == 2 );
+
+    // moving it away leaves nothing at the old position
+    delta = tree->move(c, at(8.0, 6.0));
+    CHECK( Approx(delta) == 6.0 );
+    CHECK( tree->size(SteinerTree::Point{}) == 4 );
+    CHECK( is_tree(*tree) );
+    CHECK( segment_count(*tree, tree->add(at(8.0, 0.0), false)) == 3 );
+    auto point = tree->add(at(5.0, 0.0));
+    CHECK( !(point == a) );
+    CHECK( !(point == c) );
+    CHECK( segment_count(*tree, point) == 0 );
+}
@@ -0,0 +1,133 @@
+#include <catch.hpp>
+#include <thread>
+#include <vector>
+
+#include <ophidian/interconnection/TopologyCache.h>
+#include <ophidian/interconnection/SteinerTree.h>
+
+using namespace ophidian::interconnection;
+
+namespace
+{
+    TopologyCache::Point point(double x, double y)
+    {
+        return TopologyCache::Point{TopologyCache::dbu_t{x}, TopologyCache::dbu_t{y}};
+    }
+
+    std::vector<TopologyCache::Point> translate(std::vector<TopologyCache::Point> pins, double dx, double dy)
+    {
+        for(auto & pin : pins)
+        {
+            pin = point(units::unit_cast<double>(pin.x()) + dx, units::unit_cast<double>(pin.y()) + dy);
+        }
+        return pins;
+    }
+}
+
+TEST_CASE("TopologyCache matches FLUTE", "[interconnection][topology_cache]")
+{
+    auto cache = TopologyCache{};
+    auto pins = std::vector{point(0, 0), point(50, 4), point(15, -30), point(43, 22)};
+
+    auto cached = cache.create(pins);
+    auto tree = Flute::instance().create(pins);
+
+    CHECK(cached->size(SteinerTree::Point{}) == tree->size(SteinerTree::Point{}));
+    CHECK(cached->size(SteinerTree::Segment{}) == tree->size(SteinerTree::Segment{}));
+    CHECK(Approx(units::unit_cast<double>(cached->length())) == units::unit_cast<double>(tree->length()));
+    CHECK(cache.misses() == 1);
+    CHECK(cache.hits() == 0);
+}
+
+TEST_CASE("TopologyCache reuses unchanged and translated nets", "[interconnection][topology_cache]")
+{
+    auto cache = TopologyCache{};
+    auto pins = std::vector{point(10, 10), point(10, 30), point(30, 30), point(120, 25)};
+
+    auto points = TopologyCache::point_container_type{};
+    auto segments = TopologyCache::segment_container_type{};
+    cache.create(pins, points, segments);
+    auto first_points = points;
+    auto first_segments = segments;
+
+    // same pins in another order
+    cache.create({pins[3], pins[1], pins[0], pins[2]}, points, segments);
+    CHECK(cache.hits() == 1);
+    REQUIRE(points.size() == first_points.size());
+    CHECK(segments == first_segments);
+
+    // translated copy
+    cache.create(translate(pins, 1000, -500), points, segments);
+    CHECK(cache.hits() == 2);
+    CHECK(cache.misses() == 1);
+    CHECK(cache.size() == 1);
+    REQUIRE(points.size() == first_points.size());
+    for(std::size_t i = 0; i < points.size(); ++i)
+    {
+        CHECK(units::unit_cast<double>(points[i].x()) == units::unit_cast<double>(first_points[i].x()) + 1000);
+        CHECK(units::unit_cast<double>(points[i].y()) == units::unit_cast<double>(first_points[i].y()) - 500);
+    }
+    CHECK(cache.hit_rate() == Approx(2.0 / 3.0));
+
+    // a moved pin is a new pattern
+    pins[3] = point(121, 25);
+    cache.create(pins, points, segments);
+    CHECK(cache.misses() == 2);
+    CHECK(cache.size() == 2);
+
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(cache.hit_rate() == 0.0);
+}
+
+TEST_CASE("TopologyCache bypasses small and large nets", "[interconnection][topology_cache]")
+{
+    auto parameters = TopologyCache::Parameters{};
+    parameters.max_degree = 3;
+    auto cache = TopologyCache{parameters};
+    auto points = TopologyCache::point_container_type{};
+    auto segments = TopologyCache::segment_container_type{};
+
+    cache.create({point(1, 1)}, points, segments);
+    CHECK(points.size() == 1);
+    CHECK(segments.empty());
+
+    cache.create({point(1, 1), point(4, 5)}, points, segments);
+    CHECK(points.size() == 2);
+    CHECK(segments.size() == 1);
+
+    cache.create({point(1, 1), point(4, 5), point(9, 2), point(0, 7)}, points, segments);
+    CHECK(segments.size() + 1 == points.size());
+    CHECK(cache.hits() + cache.misses() == 0);
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("TopologyCache is shared by several threads", "[interconnection][topology_cache]")
+{
+    auto cache = TopologyCache{};
+    auto pins = std::vector{point(0, 0), point(7, 3), point(2, 9), point(5, 5), point(8, 1)};
+    auto reference = cache.create(pins);
+
+    auto threads = std::vector<std::thread>{};
+    auto lengths = std::vector<double>(4, 0.0);
+    for(std::size_t t = 0; t < lengths.size(); ++t)
+    {
+        threads.emplace_back([&, t](){
+            for(int i = 0; i < 100; ++i)
+            {
+                lengths[t] = units::unit_cast<double>(cache.create(translate(pins, 10.0 * i, 3.0 * t))->length());
+            }
+        });
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    for(auto length : lengths)
+    {
+        CHECK(length == Approx(units::unit_cast<double>(reference->length())));
+    }
+    CHECK(cache.hits() == 400);
+    CHECK(cache.misses() == 1);
+}
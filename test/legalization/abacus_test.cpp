@@ -0,0 +1,221 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ophidian/legalization/Abacus.h>
+
+using namespace ophidian::legalization;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = Abacus::point_type;
+    using box_type = ophidian::geometry::CellGeometry::box_type;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    double coordinate(const dbu_t & value)
+    {
+        return units::unit_cast<double>(value);
+    }
+
+    // rows of 100 sites 10 wide and 100 high, cells 1 to 5 sites wide
+    class AbacusFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::placement::Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        ophidian::placement::Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        std::vector<ophidian::circuit::Cell> widths;
+        ophidian::circuit::Cell tall_cell;
+
+        AbacusFixture()
+        {
+            for(auto sites = 1; sites <= 5; ++sites)
+            {
+                widths.push_back(std_cells.add_cell("W" + std::to_string(sites)));
+                library.geometry(widths.back()) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(10 * sites, 100)}}};
+            }
+            tall_cell = std_cells.add_cell("TALL");
+            library.geometry(tall_cell) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(10, 200)}}};
+        }
+
+        void add_rows(int rows)
+        {
+            auto site = floorplan.add_site("core", point(10, 100));
+            for(auto i = 0; i < rows; ++i)
+            {
+                floorplan.add_row(point(0, 100 * i), ophidian::util::database_unit_scalar_t{100}, site);
+            }
+        }
+
+        ophidian::circuit::CellInstance add_cell(int sites, const point_type & location)
+        {
+            auto cell = netlist.add_cell_instance("c" + std::to_string(netlist.size_cell_instance()));
+            netlist.connect(cell, widths[sites - 1]);
+            placement.place(cell, location);
+            return cell;
+        }
+
+        // cells sit on sites, inside rows and do not overlap
+        bool legal() const
+        {
+            auto boxes = std::vector<std::vector<std::pair<double, double>>>(floorplan.range_row().size());
+            for(auto it = netlist.begin_cell_instance(); it != netlist.end_cell_instance(); ++it)
+            {
+                auto box = placement.geometry(*it).front();
+                auto x = coordinate(box.min_corner().x());
+                auto y = coordinate(box.min_corner().y());
+                auto row = static_cast<std::size_t>(y / 100);
+                if(std::fmod(x, 10) != 0 || std::fmod(y, 100) != 0 || x < 0 || coordinate(box.max_corner().x()) > 1000 || row >= boxes.size())
+                {
+                    return false;
+                }
+                boxes[row].emplace_back(x, coordinate(box.max_corner().x()));
+            }
+            for(auto & row : boxes)
+            {
+                std::sort(row.begin(), row.end());
+                for(std::size_t i = 1; i < row.size(); ++i)
+                {
+                    if(row[i].first < row[i - 1].second)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+}
+
+TEST_CASE_METHOD(AbacusFixture, "Abacus: overlapping cells are clustered around their mean position", "[legalization][abacus]")
+{
+    add_rows(1);
+    auto a = add_cell(3, point(100, 0));
+    auto b = add_cell(3, point(100, 0));
+    auto c = add_cell(3, point(100, 0));
+
+    auto abacus = Abacus{netlist, floorplan, placement};
+    auto statistics = abacus.legalize();
+
+    CHECK(statistics.legalized == 3);
+    CHECK(statistics.failed == 0);
+    CHECK(placement.location(a).x() == dbu_t{70});
+    CHECK(placement.location(b).x() == dbu_t{100});
+    CHECK(placement.location(c).x() == dbu_t{130});
+    CHECK(statistics.total_displacement == dbu_t{60});
+    CHECK(statistics.average_displacement == dbu_t{20});
+    CHECK(statistics.max_displacement == dbu_t{30});
+}
+
+TEST_CASE_METHOD(AbacusFixture, "Abacus: fixed cells are blockages", "[legalization][abacus]")
+{
+    add_rows(2);
+    auto blockage = add_cell(5, point(100, 0));
+    placement.fix(blockage, true);
+    auto a = add_cell(2, point(110, 10));
+    auto b = add_cell(1, point(990, 140));
+    auto tall = netlist.add_cell_instance("tall");
+    netlist.connect(tall, tall_cell);
+    placement.place(tall, point(500, 0));
+
+    auto abacus = Abacus{netlist, floorplan, placement};
+    auto statistics = abacus.legalize();
+
+    CHECK(placement.location(blockage).x() == dbu_t{100});
+    CHECK(placement.location(a).x() == dbu_t{80});
+    CHECK(placement.location(a).y() == dbu_t{0});
+    CHECK(placement.location(b).x() == dbu_t{990});
+    CHECK(placement.location(b).y() == dbu_t{100});
+
+    CHECK(statistics.legalized == 2);
+    CHECK(statistics.failed == 1);
+    REQUIRE(abacus.failed().size() == 1);
+    CHECK(abacus.failed().front() == tall);
+    CHECK(placement.location(tall).x() == dbu_t{500});
+}
+
+TEST_CASE_METHOD(AbacusFixture, "Abacus: random placement is legalized deterministically", "[legalization][abacus]")
+{
+    add_rows(8);
+    auto generator = std::mt19937{42};
+    auto location = std::uniform_real_distribution<double>{0, 780};
+    auto width = std::uniform_int_distribution<int>{1, 5};
+
+    for(auto i = 0; i < 12; ++i)
+    {
+        auto blockage = add_cell(width(generator), point(10 * std::floor(location(generator) / 10), 100 * (i % 8)));
+        placement.fix(blockage, true);
+    }
+    for(auto i = 0; i < 200; ++i)
+    {
+        add_cell(width(generator), point(location(generator), location(generator)));
+    }
+
+    auto cells = std::vector<ophidian::circuit::CellInstance>(netlist.begin_cell_instance(), netlist.end_cell_instance());
+    auto initial = std::vector<point_type>{};
+    for(auto cell : cells)
+    {
+        initial.push_back(placement.location(cell));
+    }
+
+    auto run = [&](std::size_t threads){
+        for(std::size_t i = 0; i < cells.size(); ++i)
+        {
+            placement.place(cells[i], initial[i]);
+        }
+        auto parameters = Abacus::Parameters{};
+        parameters.lines_per_band = 2;
+        parameters.number_of_threads = threads;
+        auto abacus = Abacus{netlist, floorplan, placement, parameters};
+        auto statistics = abacus.legalize();
+        CHECK(statistics.failed == 0);
+        CHECK(statistics.legalized == 200);
+
+        auto result = std::vector<std::pair<double, double>>{};
+        for(auto cell : cells)
+        {
+            result.emplace_back(coordinate(placement.location(cell).x()), coordinate(placement.location(cell).y()));
+        }
+        return result;
+    };
+
+    auto serial = run(1);
+    CHECK(legal());
+    auto parallel = run(4);
+    CHECK(legal());
+    CHECK(serial == parallel);
+}
+
+TEST_CASE_METHOD(AbacusFixture, "Abacus: cells overflowing their band are retried on every line", "[legalization][abacus]")
+{
+    add_rows(2);
+    // 120 sites of cells for a row of 100, placed right to left
+    for(auto i = 59; i >= 0; --i)
+    {
+        add_cell(2, point(16 * i, 0));
+    }
+
+    auto parameters = Abacus::Parameters{};
+    parameters.lines_per_band = 1;
+    auto abacus = Abacus{netlist, floorplan, placement, parameters};
+    auto statistics = abacus.legalize();
+
+    CHECK(statistics.failed == 0);
+    CHECK(statistics.legalized == 60);
+    CHECK(legal());
+
+    auto upper = std::count_if(netlist.begin_cell_instance(), netlist.end_cell_instance(), [&](const ophidian::circuit::CellInstance & cell){
+        return placement.location(cell).y() == dbu_t{100};
+    });
+    CHECK(upper >= 10);
+}
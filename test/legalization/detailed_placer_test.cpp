@@ -0,0 +1,275 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ophidian/legalization/DetailedPlacer.h>
+
+using namespace ophidian::legalization;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = DetailedPlacer::point_type;
+    using box_type = ophidian::geometry::CellGeometry::box_type;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    double coordinate(const dbu_t & value)
+    {
+        return units::unit_cast<double>(value);
+    }
+
+    // rows of 100 sites 10 wide and 100 high, cells 1 to 3 sites wide with a pin at (5, 50)
+    class DetailedPlacerFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::placement::Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        ophidian::placement::Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        std::vector<ophidian::circuit::Cell> widths;
+        std::vector<ophidian::circuit::Pin> pins;
+
+        DetailedPlacerFixture()
+        {
+            floorplan.chip_upper_right_corner() = point(1000, 800);
+            for(auto sites = 1; sites <= 3; ++sites)
+            {
+                auto name = "W" + std::to_string(sites);
+                widths.push_back(std_cells.add_cell(name));
+                pins.push_back(std_cells.add_pin(name + ":A", ophidian::circuit::PinDirection::INPUT));
+                std_cells.connect(widths.back(), pins.back());
+                library.geometry(widths.back()) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(10 * sites, 100)}}};
+                library.offset(pins.back()) = point(5, 50);
+            }
+        }
+
+        void add_rows(int rows)
+        {
+            auto site = floorplan.add_site("core", point(10, 100));
+            for(auto i = 0; i < rows; ++i)
+            {
+                floorplan.add_row(point(0, 100 * i), ophidian::util::database_unit_scalar_t{100}, site);
+            }
+        }
+
+        ophidian::circuit::CellInstance add_cell(int sites, const point_type & location)
+        {
+            auto name = "c" + std::to_string(netlist.size_cell_instance());
+            auto cell = netlist.add_cell_instance(name);
+            netlist.connect(cell, widths[sites - 1]);
+            auto instance = netlist.add_pin_instance(name + ":A");
+            netlist.connect(instance, pins[sites - 1]);
+            netlist.connect(cell, instance);
+            placement.place(cell, location);
+            return cell;
+        }
+
+        ophidian::circuit::PinInstance pin(const ophidian::circuit::CellInstance & cell)
+        {
+            return netlist.find_pin_instance(netlist.name(cell) + ":A");
+        }
+
+        ophidian::circuit::PinInstance pad(const point_type & location)
+        {
+            auto instance = netlist.add_pin_instance("pad" + std::to_string(netlist.size_pin_instance()));
+            auto input = netlist.add_input_pad(instance);
+            placement.place(input, location);
+            return instance;
+        }
+
+        void connect(const std::vector<ophidian::circuit::PinInstance> & net_pins)
+        {
+            auto net = netlist.add_net("n" + std::to_string(netlist.size_net()));
+            for(auto p : net_pins)
+            {
+                netlist.connect(net, p);
+            }
+        }
+
+        DetailedPlacer::Parameters only(bool swaps, bool reordering, bool independent_set)
+        {
+            auto parameters = DetailedPlacer::Parameters{};
+            parameters.global_swap = swaps;
+            parameters.vertical_swap = swaps;
+            parameters.reordering = reordering;
+            parameters.independent_set = independent_set;
+            return parameters;
+        }
+
+        // cells sit on sites, inside rows and do not overlap
+        bool legal() const
+        {
+            auto boxes = std::vector<std::vector<std::pair<double, double>>>(floorplan.range_row().size());
+            for(auto it = netlist.begin_cell_instance(); it != netlist.end_cell_instance(); ++it)
+            {
+                auto box = placement.geometry(*it).front();
+                auto x = coordinate(box.min_corner().x());
+                auto y = coordinate(box.min_corner().y());
+                auto row = static_cast<std::size_t>(y / 100);
+                if(std::fmod(x, 10) != 0 || std::fmod(y, 100) != 0 || x < 0 || coordinate(box.max_corner().x()) > 1000 || row >= boxes.size())
+                {
+                    return false;
+                }
+                boxes[row].emplace_back(x, coordinate(box.max_corner().x()));
+            }
+            for(auto & row : boxes)
+            {
+                std::sort(row.begin(), row.end());
+                for(std::size_t i = 1; i < row.size(); ++i)
+                {
+                    if(row[i].first < row[i - 1].second)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+}
+
+TEST_CASE_METHOD(DetailedPlacerFixture, "DetailedPlacer: global swap exchanges crossed cells", "[legalization][detailed_placer]")
+{
+    add_rows(1);
+    auto a = add_cell(1, point(900, 0));
+    auto b = add_cell(1, point(50, 0));
+    connect({pin(a), pad(point(0, 50))});
+    connect({pin(b), pad(point(1000, 50))});
+
+    auto placer = DetailedPlacer{netlist, floorplan, placement, only(true, false, false)};
+    auto statistics = placer.place();
+
+    CHECK(statistics.global_swaps >= 1);
+    CHECK(statistics.wirelength < statistics.initial_wirelength);
+    CHECK(placement.location(a).x() < dbu_t{100});
+    CHECK(placement.location(b).x() >= dbu_t{900});
+    CHECK(legal());
+}
+
+TEST_CASE_METHOD(DetailedPlacerFixture, "DetailedPlacer: local reordering of a window", "[legalization][detailed_placer]")
+{
+    add_rows(1);
+    auto a = add_cell(1, point(400, 0));
+    auto b = add_cell(1, point(410, 0));
+    auto c = add_cell(1, point(420, 0));
+    connect({pin(a), pad(point(1000, 50))});
+    connect({pin(c), pad(point(0, 50))});
+
+    auto placer = DetailedPlacer{netlist, floorplan, placement, only(false, true, false)};
+    auto statistics = placer.place();
+
+    CHECK(statistics.reorderings == 1);
+    CHECK(statistics.initial_wirelength - statistics.wirelength == Approx(40));
+    CHECK(placement.location(c).x() == dbu_t{400});
+    CHECK(placement.location(b).x() == dbu_t{410});
+    CHECK(placement.location(a).x() == dbu_t{420});
+}
+
+TEST_CASE_METHOD(DetailedPlacerFixture, "DetailedPlacer: independent set matching reassigns slots", "[legalization][detailed_placer]")
+{
+    add_rows(2);
+    auto a = add_cell(2, point(100, 0));
+    auto b = add_cell(2, point(800, 100));
+    auto fixed = add_cell(3, point(500, 0));
+    placement.fix(fixed, true);
+    connect({pin(a), pad(point(1000, 150))});
+    connect({pin(b), pad(point(0, 50))});
+    connect({pin(fixed), pad(point(1000, 150))});
+
+    auto placer = DetailedPlacer{netlist, floorplan, placement, only(false, false, true)};
+    auto statistics = placer.place();
+
+    CHECK(statistics.matched == 2);
+    CHECK(placement.location(a).x() == dbu_t{800});
+    CHECK(placement.location(a).y() == dbu_t{100});
+    CHECK(placement.location(b).x() == dbu_t{100});
+    CHECK(placement.location(b).y() == dbu_t{0});
+    CHECK(placement.location(fixed).x() == dbu_t{500});
+}
+
+TEST_CASE_METHOD(DetailedPlacerFixture, "DetailedPlacer: random design stays legal and is deterministic", "[legalization][detailed_placer]")
+{
+    add_rows(8);
+    auto generator = std::mt19937{7};
+    auto width = std::uniform_int_distribution<int>{1, 3};
+    auto gap = std::uniform_int_distribution<int>{0, 2};
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto row = 0; row < 8; ++row)
+    {
+        auto x = 0;
+        while(true)
+        {
+            x += 10 * gap(generator);
+            auto sites = width(generator);
+            if(x + 10 * sites > 1000)
+            {
+                break;
+            }
+            cells.push_back(add_cell(sites, point(x, 100 * row)));
+            x += 10 * sites;
+        }
+    }
+    placement.fix(cells[5], true);
+
+    auto pick = std::uniform_int_distribution<std::size_t>{0, cells.size() - 1};
+    auto degree = std::uniform_int_distribution<int>{1, 3};
+    for(std::size_t i = 0; i < cells.size(); ++i)
+    {
+        auto members = std::vector<std::size_t>{i};
+        for(auto j = degree(generator); j > 0; --j)
+        {
+            members.push_back(pick(generator));
+        }
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()), members.end());
+        auto net_pins = std::vector<ophidian::circuit::PinInstance>{};
+        for(auto member : members)
+        {
+            net_pins.push_back(pin(cells[member]));
+        }
+        if(net_pins.size() > 1)
+        {
+            connect(net_pins);
+        }
+    }
+
+    auto initial = std::vector<point_type>{};
+    for(auto cell : cells)
+    {
+        initial.push_back(placement.location(cell));
+    }
+
+    auto run = [&](std::size_t threads){
+        for(std::size_t i = 0; i < cells.size(); ++i)
+        {
+            placement.place(cells[i], initial[i]);
+        }
+        auto parameters = DetailedPlacer::Parameters{};
+        parameters.number_of_threads = threads;
+        parameters.set_size = 8;
+        auto placer = DetailedPlacer{netlist, floorplan, placement, parameters};
+        auto statistics = placer.place();
+        CHECK(statistics.wirelength < 0.9 * statistics.initial_wirelength);
+        CHECK(legal());
+
+        auto result = std::vector<std::pair<double, double>>{};
+        for(auto cell : cells)
+        {
+            result.emplace_back(coordinate(placement.location(cell).x()), coordinate(placement.location(cell).y()));
+        }
+        return result;
+    };
+
+    auto serial = run(1);
+    auto parallel = run(4);
+    CHECK(serial == parallel);
+    CHECK(placement.location(cells[5]).x() == initial[5].x());
+}
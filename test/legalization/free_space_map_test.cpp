@@ -0,0 +1,152 @@
+#include <catch.hpp>
+#include <utility>
+#include <vector>
+
+#include <ophidian/legalization/FreeSpaceMap.h>
+
+using namespace ophidian::legalization;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = FreeSpaceMap::point_type;
+    using box_type = ophidian::geometry::CellGeometry::box_type;
+    using range_type = std::vector<std::pair<double, double>>;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    range_type ranges(const FreeSpaceMap::segment_container_type & segments)
+    {
+        auto result = range_type{};
+        for(const auto & segment : segments)
+        {
+            result.emplace_back(units::unit_cast<double>(segment.begin), units::unit_cast<double>(segment.end));
+        }
+        return result;
+    }
+
+    // three rows of 20 sites 10 wide and 100 high; a one row inverter and a two rows cell
+    class FreeSpaceMapFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::placement::Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        ophidian::placement::Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+
+        std::vector<ophidian::floorplan::Row> rows;
+        ophidian::circuit::CellInstance blockage, a, b, tall;
+
+        FreeSpaceMapFixture()
+        {
+            auto inv = std_cells.add_cell("INV");
+            auto dff = std_cells.add_cell("DFF2");
+            library.geometry(inv) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(30, 100)}}};
+            library.geometry(dff) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(20, 200)}}};
+
+            auto site = floorplan.add_site("core", point(10, 100));
+            for(auto y : {0, 100, 200})
+            {
+                rows.push_back(floorplan.add_row(point(0, y), ophidian::util::database_unit_scalar_t{20}, site));
+            }
+
+            auto add = [&](const std::string & name, const ophidian::circuit::Cell & std_cell, const point_type & location){
+                auto cell = netlist.add_cell_instance(name);
+                netlist.connect(cell, std_cell);
+                placement.place(cell, location);
+                return cell;
+            };
+            blockage = add("blockage", inv, point(100, 0));
+            a = add("a", inv, point(20, 0));
+            b = add("b", inv, point(35, 100));
+            tall = add("tall", dff, point(150, 100));
+            placement.fix(blockage, true);
+        }
+    };
+}
+
+TEST_CASE_METHOD(FreeSpaceMapFixture, "FreeSpaceMap: free space of the rows", "[legalization][free_space_map]")
+{
+    auto map = FreeSpaceMap{netlist, floorplan, placement};
+
+    REQUIRE(map.rows() == rows);
+
+    CHECK(ranges(map.segments(rows[0])) == range_type{{0, 100}, {130, 200}});
+    CHECK(ranges(map.free_segments(rows[0])) == range_type{{0, 20}, {50, 100}, {130, 200}});
+
+    // b covers sites 3 to 6 and the tall cell spans two rows
+    CHECK(ranges(map.segments(rows[1])) == range_type{{0, 200}});
+    CHECK(ranges(map.free_segments(rows[1])) == range_type{{0, 30}, {70, 150}, {170, 200}});
+    CHECK(ranges(map.free_segments(rows[2])) == range_type{{0, 150}, {170, 200}});
+
+    CHECK(map.cells(rows[1]) == std::vector<ophidian::circuit::CellInstance>{b, tall});
+    CHECK(map.cells(rows[2]) == std::vector<ophidian::circuit::CellInstance>{tall});
+
+    CHECK(map.free_width(rows[0], dbu_t{0}, dbu_t{200}) == dbu_t{140});
+    CHECK(map.free_width(rows[0], dbu_t{15}, dbu_t{105}) == dbu_t{50});
+    CHECK(map.is_free(rows[0], dbu_t{50}, dbu_t{100}));
+    CHECK(!map.is_free(rows[0], dbu_t{40}, dbu_t{100}));
+}
+
+TEST_CASE_METHOD(FreeSpaceMapFixture, "FreeSpaceMap: incremental updates", "[legalization][free_space_map]")
+{
+    auto map = FreeSpaceMap{netlist, floorplan, placement};
+
+    map.place(a, point(160, 200));
+    CHECK(placement.location(a).x() == dbu_t{160});
+    CHECK(ranges(map.free_segments(rows[0])) == range_type{{0, 100}, {130, 200}});
+    CHECK(ranges(map.free_segments(rows[2])) == range_type{{0, 150}, {190, 200}});
+    CHECK(map.cells(rows[2]) == std::vector<ophidian::circuit::CellInstance>{tall, a});
+
+    map.fix(b, true);
+    CHECK(ranges(map.segments(rows[1])) == range_type{{0, 30}, {70, 200}});
+
+    map.fix(blockage, false);
+    CHECK(ranges(map.segments(rows[0])) == range_type{{0, 200}});
+    CHECK(map.free_width(rows[0], dbu_t{0}, dbu_t{200}) == dbu_t{170});
+
+    // changes made directly on the placement are picked up by update
+    placement.place(b, point(0, 0));
+    map.update(b);
+    CHECK(ranges(map.free_segments(rows[0])) == range_type{{30, 100}, {130, 200}});
+    CHECK(ranges(map.free_segments(rows[1])) == range_type{{0, 150}, {170, 200}});
+}
+
+TEST_CASE_METHOD(FreeSpaceMapFixture, "FreeSpaceMap: parallel build matches the serial one", "[legalization][free_space_map]")
+{
+    auto serial = FreeSpaceMap{netlist, floorplan, placement, 1};
+    auto parallel = FreeSpaceMap{netlist, floorplan, placement, 4};
+
+    for(auto row : rows)
+    {
+        CHECK(ranges(serial.free_segments(row)) == ranges(parallel.free_segments(row)));
+        CHECK(serial.cells(row) == parallel.cells(row));
+    }
+}
+
+TEST_CASE_METHOD(FreeSpaceMapFixture, "FreeSpaceMap: an attached map follows the placement", "[legalization][free_space_map]")
+{
+    auto map = FreeSpaceMap{netlist, floorplan, placement};
+    map.attach();
+
+    placement.place(a, point(160, 200));
+    CHECK(ranges(map.free_segments(rows[2])) == range_type{{0, 150}, {190, 200}});
+
+    placement.fix(b, true);
+    CHECK(ranges(map.segments(rows[1])) == range_type{{0, 30}, {70, 200}});
+
+    placement.begin();
+    placement.place(b, point(0, 0));
+    placement.place(a, point(50, 0));
+    placement.rollback();
+    CHECK(ranges(map.free_segments(rows[0])) == range_type{{0, 100}, {130, 200}});
+    CHECK(ranges(map.free_segments(rows[2])) == range_type{{0, 150}, {190, 200}});
+
+    map.detach();
+    placement.place(a, point(20, 0));
+    CHECK(ranges(map.free_segments(rows[0])) == range_type{{0, 100}, {130, 200}});
+}
@@ -0,0 +1,93 @@
+#include <catch.hpp>
+
+#include <ophidian/parser/Liberty.h>
+#include <ophidian/parser/ParserException.h>
+
+using ophidian::parser::Liberty;
+
+TEST_CASE("Liberty: Try to load inexistent file", "[parser][Liberty]")
+{
+    CHECK_THROWS_AS(
+        Liberty{"a_file_with_this_name_should_not_exist"},
+        ophidian::parser::exceptions::InexistentFile
+    );
+}
+
+TEST_CASE("Liberty: Loading simple.lib", "[parser][Liberty][simple]")
+{
+    auto simple = Liberty{"input_files/simple/simple.lib"};
+
+    CHECK(simple.name() == "simple");
+    CHECK(units::unit_cast<double>(simple.time_unit()) == Approx(1e-12));
+    CHECK(units::unit_cast<double>(simple.capacitance_unit()) == Approx(1e-15));
+    CHECK(simple.cells().size() == 5);
+    CHECK(simple.find_cell("INV_X2") == nullptr);
+
+    SECTION("Pins and tables of INV_X1")
+    {
+        auto inverter = simple.find_cell("INV_X1");
+        REQUIRE(inverter != nullptr);
+        CHECK(inverter->area == 1.0);
+        REQUIRE(inverter->pins.size() == 2);
+
+        auto & a = inverter->pins[0];
+        CHECK(a.name == "a");
+        CHECK(a.direction == Liberty::Direction::INPUT);
+        CHECK(a.capacitance == 1.0);
+        CHECK(a.timings.empty());
+
+        auto & o = inverter->pins[1];
+        CHECK(o.direction == Liberty::Direction::OUTPUT);
+        CHECK(o.max_capacitance == 80.0);
+        REQUIRE(o.timings.size() == 1);
+        auto & timing = o.timings.front();
+        CHECK(timing.related_pin == "a");
+        CHECK(timing.timing_sense == Liberty::TimingSense::NEGATIVE_UNATE);
+        CHECK(timing.timing_type == Liberty::TimingType::COMBINATIONAL);
+
+        // indices come from the template
+        auto & rise = timing.cell_rise;
+        CHECK(rise.variable_1 == "input_net_transition");
+        CHECK(rise.variable_2 == "total_output_net_capacitance");
+        CHECK(rise.index_1 == std::vector<double>{10, 110});
+        CHECK(rise.index_2 == std::vector<double>{0, 10});
+        CHECK(rise.values == std::vector<std::vector<double>>{{10, 30}, {20, 40}});
+        CHECK(timing.rise_constraint.empty());
+    }
+
+    SECTION("Scalar tables, pin lists and capacitances")
+    {
+        auto buffer = simple.find_cell("INV_Z80");
+        REQUIRE(buffer != nullptr);
+        CHECK(buffer->pins[1].timings.front().cell_rise.values == std::vector<std::vector<double>>{{5}});
+        CHECK(buffer->pins[1].timings.front().cell_rise.index_1.empty());
+
+        auto nor = simple.find_cell("NOR2_X1");
+        REQUIRE(nor->pins.size() == 3);
+        CHECK(nor->pins[0].name == "a");
+        CHECK(nor->pins[1].name == "b");
+        CHECK(nor->pins[2].timings.front().related_pin == "a b");
+
+        auto nand = simple.find_cell("NAND2_X1");
+        CHECK(nand->pins[1].capacitance == 2.0);
+    }
+
+    SECTION("Sequential cell")
+    {
+        auto flip_flop = simple.find_cell("DFF_X80");
+        REQUIRE(flip_flop != nullptr);
+        REQUIRE(flip_flop->pins.size() == 3);
+        auto & d = flip_flop->pins[0];
+        REQUIRE(d.timings.size() == 2);
+        CHECK(d.timings[0].timing_type == Liberty::TimingType::SETUP_RISING);
+        CHECK(d.timings[1].timing_type == Liberty::TimingType::HOLD_RISING);
+        CHECK(d.timings[0].rise_constraint.variable_1 == "related_pin_transition");
+        CHECK(d.timings[0].fall_constraint.values[1][1] == 30);
+        CHECK(flip_flop->pins[1].clock);
+
+        auto & q = flip_flop->pins[2];
+        CHECK(q.timings.front().timing_type == Liberty::TimingType::RISING_EDGE);
+        CHECK(q.timings.front().rise_transition.index_2 == std::vector<double>{0, 20});
+        CHECK(q.timings.front().fall_transition.index_2 == std::vector<double>{0, 10});
+    }
+}
@@ -0,0 +1,170 @@
+#include <catch.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ophidian/partitioning/Clustering.h>
+
+using namespace ophidian::partitioning;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    // side x side grid of unit vertices, with a two pin hyperedge between neighbours
+    Hypergraph grid(std::size_t side)
+    {
+        auto edge_begins = Hypergraph::offset_container_type{0};
+        auto pins = Hypergraph::vertex_container_type{};
+        for(std::size_t y = 0; y < side; ++y)
+        {
+            for(std::size_t x = 0; x < side; ++x)
+            {
+                auto vertex = static_cast<Hypergraph::vertex_type>(y * side + x);
+                if(x + 1 < side)
+                {
+                    pins.insert(pins.end(), {vertex, vertex + 1});
+                    edge_begins.push_back(pins.size());
+                }
+                if(y + 1 < side)
+                {
+                    pins.insert(pins.end(), {vertex, static_cast<Hypergraph::vertex_type>(vertex + side)});
+                    edge_begins.push_back(pins.size());
+                }
+            }
+        }
+        auto edges = edge_begins.size() - 1;
+        return Hypergraph{Hypergraph::weight_container_type(side * side, 1.0), Hypergraph::weight_container_type(edges, 1.0), edge_begins, pins};
+    }
+}
+
+TEST_CASE("Clustering: first choice coarsening", "[partitioning][clustering]")
+{
+    auto fine = grid(40);
+    fine.fix(0, true);
+
+    auto run = [&](std::size_t threads){
+        auto parameters = Clustering::Parameters{};
+        parameters.coarsest_size = 50;
+        parameters.number_of_threads = threads;
+        auto clustering = std::make_unique<Clustering>(fine, parameters);
+        clustering->coarsen();
+        return clustering;
+    };
+    auto clustering_pointer = run(1);
+    auto & clustering = *clustering_pointer;
+
+    REQUIRE(clustering.levels() > 2);
+    CHECK(&clustering.hypergraph(0) == &fine);
+    auto limit = 1.5 * fine.total_weight() / 50;
+    for(std::size_t level = 1; level < clustering.levels(); ++level)
+    {
+        const auto & previous = clustering.hypergraph(level - 1);
+        const auto & coarse = clustering.hypergraph(level);
+        CHECK(coarse.size_vertex() < previous.size_vertex());
+        CHECK(coarse.size_edge() <= previous.size_edge());
+        CHECK(coarse.total_weight() == Approx(fine.total_weight()));
+        REQUIRE(clustering.parents(level - 1).size() == previous.size_vertex());
+
+        // clusters respect the weight limit and parallel hyperedges are merged
+        auto edge_weight = 0.0;
+        for(Hypergraph::edge_type edge = 0; edge < coarse.size_edge(); ++edge)
+        {
+            edge_weight += coarse.edge_weight(edge);
+            CHECK(coarse.edge_size(edge) >= 2);
+        }
+        CHECK(edge_weight <= 2 * 40 * 39);
+        for(Hypergraph::vertex_type vertex = 0; vertex < coarse.size_vertex(); ++vertex)
+        {
+            CHECK(coarse.weight(vertex) <= limit);
+        }
+    }
+    auto last = clustering.levels() - 1;
+    CHECK(clustering.hypergraph(last).size_vertex() < 200);
+
+    SECTION("Fixed vertices are not clustered")
+    {
+        auto vertex = clustering.cluster(0, last);
+        CHECK(clustering.hypergraph(last).fixed(vertex));
+        CHECK(clustering.hypergraph(last).weight(vertex) == 1.0);
+    }
+
+    SECTION("Values are projected down the hierarchy")
+    {
+        auto values = std::vector<int>(clustering.hypergraph(last).size_vertex());
+        for(std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = static_cast<int>(i);
+        }
+        for(auto level = last; level > 0; --level)
+        {
+            values = clustering.project(level, values);
+        }
+        REQUIRE(values.size() == fine.size_vertex());
+        for(Hypergraph::vertex_type vertex = 0; vertex < fine.size_vertex(); ++vertex)
+        {
+            CHECK(values[vertex] == static_cast<int>(clustering.cluster(vertex, last)));
+        }
+    }
+
+    SECTION("Coarsening does not depend on the number of threads")
+    {
+        auto parallel = run(4);
+        REQUIRE(parallel->levels() == clustering.levels());
+        for(std::size_t level = 0; level + 1 < clustering.levels(); ++level)
+        {
+            CHECK(parallel->parents(level) == clustering.parents(level));
+        }
+    }
+}
+
+TEST_CASE("Clustering: heavy edge matching places cells with their clusters", "[partitioning][clustering]")
+{
+    auto std_cells = ophidian::circuit::StandardCells{};
+    auto library = ophidian::placement::Library{std_cells};
+    auto netlist = ophidian::circuit::Netlist{};
+    auto placement = ophidian::placement::Placement{netlist, library};
+    auto inv = std_cells.add_cell("INV");
+    library.geometry(inv) = ophidian::geometry::CellGeometry{{ophidian::geometry::Box<dbu_t>{{dbu_t{0}, dbu_t{0}}, {dbu_t{10}, dbu_t{10}}}}};
+
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 4; ++i)
+    {
+        cells.push_back(netlist.add_cell_instance("c" + std::to_string(i)));
+        netlist.connect(cells.back(), inv);
+    }
+    // 0 and 1 share two nets, 2 and 3 share one, 1 and 2 share one net with 0
+    auto connect = [&](const std::string & name, const std::vector<std::size_t> & owners){
+        auto net = netlist.add_net(name);
+        for(auto owner : owners)
+        {
+            auto pin = netlist.add_pin_instance(name + ":" + std::to_string(owner));
+            netlist.connect(cells[owner], pin);
+            netlist.connect(net, pin);
+        }
+    };
+    connect("a", {0, 1});
+    connect("b", {0, 1});
+    connect("c", {2, 3});
+    connect("d", {0, 1, 2});
+
+    auto hypergraph = Hypergraph{netlist, library, placement};
+    auto parameters = Clustering::Parameters{};
+    parameters.scheme = Clustering::Scheme::HEAVY_EDGE;
+    parameters.coarsest_size = 2;
+    parameters.max_cluster_weight = 1.0;
+    auto clustering = Clustering{hypergraph, parameters};
+    clustering.coarsen();
+
+    REQUIRE(clustering.levels() == 2);
+    const auto & coarse = clustering.hypergraph(1);
+    CHECK(coarse.size_vertex() == 2);
+    CHECK(clustering.parents(0) == Clustering::vertex_container_type{0, 0, 1, 1});
+
+    // a, b and c end inside clusters, d becomes a two pin hyperedge
+    REQUIRE(coarse.size_edge() == 1);
+    CHECK(coarse.edge_weight(0) == 1.0);
+
+    clustering.place(1, {ophidian::util::LocationDbu{dbu_t{100}, dbu_t{0}}, ophidian::util::LocationDbu{dbu_t{300}, dbu_t{50}}}, placement);
+    CHECK(placement.location(cells[1]).x() == dbu_t{100});
+    CHECK(placement.location(cells[3]).y() == dbu_t{50});
+}
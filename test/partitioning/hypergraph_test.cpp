@@ -0,0 +1,86 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+
+#include <ophidian/partitioning/Hypergraph.h>
+
+using namespace ophidian::partitioning;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = ophidian::util::LocationDbu;
+    using box_type = ophidian::geometry::Box<dbu_t>;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+}
+
+TEST_CASE("Hypergraph: built from a netlist", "[partitioning][hypergraph]")
+{
+    auto std_cells = ophidian::circuit::StandardCells{};
+    auto library = ophidian::placement::Library{std_cells};
+    auto netlist = ophidian::circuit::Netlist{};
+    auto placement = ophidian::placement::Placement{netlist, library};
+
+    auto inv = std_cells.add_cell("INV");
+    library.geometry(inv) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(10, 20)}}};
+
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 3; ++i)
+    {
+        cells.push_back(netlist.add_cell_instance("c" + std::to_string(i)));
+        netlist.connect(cells.back(), inv);
+    }
+    placement.fix(cells[2], true);
+
+    auto connect = [&](const std::string & name, const std::vector<std::size_t> & owners, bool pad){
+        auto net = netlist.add_net(name);
+        for(auto owner : owners)
+        {
+            auto pin = netlist.add_pin_instance(name + ":" + std::to_string(owner) + ":" + std::to_string(netlist.size_pin_instance()));
+            netlist.connect(cells[owner], pin);
+            netlist.connect(net, pin);
+        }
+        if(pad)
+        {
+            auto pin = netlist.add_pin_instance(name + ":pad");
+            netlist.add_input_pad(pin);
+            netlist.connect(net, pin);
+        }
+    };
+    connect("n0", {0, 1, 2}, false);
+    connect("n1", {1, 2}, true);
+    connect("n2", {0, 0}, true);
+
+    auto hypergraph = Hypergraph{netlist, library, placement};
+
+    // pads and nets left with a single cell are dropped
+    CHECK(hypergraph.size_vertex() == 3);
+    CHECK(hypergraph.size_edge() == 2);
+    CHECK(hypergraph.size_pin() == 5);
+    CHECK(hypergraph.weight(0) == Approx(200));
+    CHECK(hypergraph.total_weight() == Approx(600));
+    CHECK(hypergraph.edge_size(0) == 3);
+    CHECK(std::vector<Hypergraph::vertex_type>(hypergraph.pins(1).begin(), hypergraph.pins(1).end()) == std::vector<Hypergraph::vertex_type>{1, 2});
+    CHECK(std::vector<Hypergraph::edge_type>(hypergraph.edges(2).begin(), hypergraph.edges(2).end()) == std::vector<Hypergraph::edge_type>{0, 1});
+    CHECK(hypergraph.edges(0).size() == 1);
+    CHECK(hypergraph.vertex(cells[1]) == 1);
+    CHECK(hypergraph.cells()[2] == cells[2]);
+    CHECK(!hypergraph.fixed(1));
+    CHECK(hypergraph.fixed(2));
+}
+
+TEST_CASE("Hypergraph: built from arrays", "[partitioning][hypergraph]")
+{
+    auto hypergraph = Hypergraph{{1.0, 2.0, 3.0, 4.0}, {1.0, 5.0}, {0, 2, 5}, {0, 3, 1, 2, 3}};
+
+    CHECK(hypergraph.size_vertex() == 4);
+    CHECK(hypergraph.total_weight() == Approx(10.0));
+    CHECK(hypergraph.edge_weight(1) == 5.0);
+    CHECK(hypergraph.edges(3).size() == 2);
+    CHECK(hypergraph.edges(0).size() == 1);
+    CHECK(hypergraph.cells().empty());
+}
@@ -0,0 +1,118 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <ophidian/partitioning/Partitioner.h>
+
+using namespace ophidian::partitioning;
+
+namespace
+{
+    // side x side grid of unit vertices, with a two pin hyperedge between neighbours
+    Hypergraph grid(std::size_t side)
+    {
+        auto edge_begins = Hypergraph::offset_container_type{0};
+        auto pins = Hypergraph::vertex_container_type{};
+        for(std::size_t y = 0; y < side; ++y)
+        {
+            for(std::size_t x = 0; x < side; ++x)
+            {
+                auto vertex = static_cast<Hypergraph::vertex_type>(y * side + x);
+                if(x + 1 < side)
+                {
+                    pins.insert(pins.end(), {vertex, vertex + 1});
+                    edge_begins.push_back(pins.size());
+                }
+                if(y + 1 < side)
+                {
+                    pins.insert(pins.end(), {vertex, static_cast<Hypergraph::vertex_type>(vertex + side)});
+                    edge_begins.push_back(pins.size());
+                }
+            }
+        }
+        auto edges = edge_begins.size() - 1;
+        return Hypergraph{Hypergraph::weight_container_type(side * side, 1.0), Hypergraph::weight_container_type(edges, 1.0), edge_begins, pins};
+    }
+}
+
+TEST_CASE("Partitioner: two clusters joined by one hyperedge", "[partitioning][partitioner]")
+{
+    // vertices 0-9 and 10-19 form two rings with chords, vertex 3 and 15 share a hyperedge
+    auto edge_begins = Hypergraph::offset_container_type{0};
+    auto pins = Hypergraph::vertex_container_type{};
+    for(Hypergraph::vertex_type base : {0u, 10u})
+    {
+        for(Hypergraph::vertex_type i = 0; i < 10; ++i)
+        {
+            pins.insert(pins.end(), {base + i, base + (i + 1) % 10, base + (i + 4) % 10});
+            edge_begins.push_back(pins.size());
+        }
+    }
+    pins.insert(pins.end(), {3, 15});
+    edge_begins.push_back(pins.size());
+    auto hypergraph = Hypergraph{Hypergraph::weight_container_type(20, 1.0), Hypergraph::weight_container_type(21, 1.0), edge_begins, pins};
+
+    auto parameters = Partitioner::Parameters{};
+    parameters.clustering.coarsest_size = 4;
+    auto partitioner = Partitioner{hypergraph, parameters};
+    partitioner.partition();
+
+    CHECK(partitioner.cut() == 1.0);
+    CHECK(partitioner.weight(0) == 10.0);
+    CHECK(partitioner.weight(1) == 10.0);
+    for(Hypergraph::vertex_type vertex = 1; vertex < 10; ++vertex)
+    {
+        CHECK(partitioner.partition(vertex) == partitioner.partition(0));
+        CHECK(partitioner.partition(vertex + 10) != partitioner.partition(0));
+    }
+}
+
+TEST_CASE("Partitioner: bisection and k-way partitions of a grid", "[partitioning][partitioner]")
+{
+    auto hypergraph = grid(32);
+
+    auto run = [&](std::size_t parts, std::size_t threads){
+        auto parameters = Partitioner::Parameters{};
+        parameters.number_of_partitions = parts;
+        parameters.number_of_threads = threads;
+        auto partitioner = Partitioner{hypergraph, parameters};
+        partitioner.partition();
+
+        auto share = hypergraph.total_weight() / parts;
+        auto total = 0.0;
+        for(Partitioner::partition_type partition = 0; partition < parts; ++partition)
+        {
+            CHECK(partitioner.weight(partition) <= 1.05 * share);
+            total += partitioner.weight(partition);
+        }
+        CHECK(total == hypergraph.total_weight());
+        return std::make_pair(partitioner.cut(), partitioner.partitions());
+    };
+
+    SECTION("Bisection")
+    {
+        auto [cut, partitions] = run(2, 1);
+        CHECK(cut >= 32.0);
+        CHECK(cut <= 48.0);
+    }
+
+    SECTION("Four blocks")
+    {
+        auto [cut, partitions] = run(4, 1);
+        CHECK(cut >= 64.0);
+        CHECK(cut <= 100.0);
+        CHECK(*std::max_element(partitions.begin(), partitions.end()) == 3);
+
+        auto [parallel_cut, parallel_partitions] = run(4, 4);
+        CHECK(parallel_cut == cut);
+        CHECK(parallel_partitions == partitions);
+    }
+
+    SECTION("Three blocks")
+    {
+        auto [cut, partitions] = run(3, 2);
+        CHECK(cut <= 100.0);
+        CHECK(std::count(partitions.begin(), partitions.end(), 2u) > 0);
+    }
+}
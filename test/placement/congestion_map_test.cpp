@@ -0,0 +1,167 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ophidian/placement/CongestionMap.h>
+
+using namespace ophidian::placement;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = CongestionMap::point_type;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    // 400 x 400 chip of 4 x 4 bins, buffers with their pins at the cell origin
+    class CongestionMapFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        ophidian::circuit::Cell buf;
+        ophidian::circuit::Pin buf_a, buf_z;
+
+        CongestionMapFixture()
+        {
+            floorplan.chip_upper_right_corner() = point(400, 400);
+            buf = std_cells.add_cell("BUF");
+            buf_a = std_cells.add_pin("BUF:a", ophidian::circuit::PinDirection::INPUT);
+            buf_z = std_cells.add_pin("BUF:z", ophidian::circuit::PinDirection::OUTPUT);
+            std_cells.connect(buf, buf_a);
+            std_cells.connect(buf, buf_z);
+        }
+
+        ophidian::circuit::CellInstance add(const point_type & location)
+        {
+            auto name = "c" + std::to_string(netlist.size_cell_instance());
+            auto cell = netlist.add_cell_instance(name);
+            netlist.connect(cell, buf);
+            for(auto [std_pin, suffix] : {std::make_pair(buf_a, ":a"), std::make_pair(buf_z, ":z")})
+            {
+                auto pin = netlist.add_pin_instance(name + suffix);
+                netlist.connect(cell, pin);
+                netlist.connect(pin, std_pin);
+            }
+            placement.place(cell, location);
+            return cell;
+        }
+
+        ophidian::circuit::PinInstance pin(const ophidian::circuit::CellInstance & cell, const std::string & suffix)
+        {
+            return netlist.find_pin_instance(netlist.name(cell) + suffix);
+        }
+    };
+}
+
+TEST_CASE_METHOD(CongestionMapFixture, "CongestionMap: RUDY spreads the bounding box", "[placement][congestion_map]")
+{
+    auto u1 = add(point(50, 50));
+    auto u2 = add(point(250, 150));
+    auto net = netlist.add_net("n0");
+    netlist.connect(net, pin(u1, ":z"));
+    netlist.connect(net, pin(u2, ":a"));
+
+    auto parameters = CongestionMap::Parameters{};
+    parameters.wire_pitch = dbu_t{2};
+    auto map = CongestionMap{netlist, floorplan, placement, 4, 4, parameters};
+
+    CHECK(map.width() == 4);
+    CHECK(map.horizontal(1, 1) == Approx(50));
+    CHECK(map.vertical(1, 1) == Approx(25));
+    CHECK(map.horizontal(3, 3) == Approx(0));
+    CHECK(map.congestion(1, 1) == Approx(75 * 2 / 10000.0));
+    CHECK(map.congestion()[1 * 4 + 1] == Approx(0.015f));
+    CHECK(map.total_wirelength() == Approx(300));
+
+    // a flat net is widened to a bin
+    map.place(u2, point(250, 50));
+    CHECK(map.total_wirelength() == Approx(200));
+    CHECK(map.horizontal(1, 0) == Approx(100));
+    CHECK(map.horizontal(1, 1) == Approx(0));
+    CHECK(map.vertical(1, 1) == Approx(0));
+    CHECK(map.max_congestion() == Approx(100 * 2 / 10000.0));
+}
+
+TEST_CASE_METHOD(CongestionMapFixture, "CongestionMap: probabilistic L shapes", "[placement][congestion_map]")
+{
+    auto u1 = add(point(50, 50));
+    auto u2 = add(point(250, 150));
+    auto net = netlist.add_net("n0");
+    netlist.connect(net, pin(u1, ":z"));
+    netlist.connect(net, pin(u2, ":a"));
+
+    auto parameters = CongestionMap::Parameters{};
+    parameters.model = CongestionMap::Model::PROBABILISTIC;
+    auto map = CongestionMap{netlist, floorplan, placement, 4, 4, parameters};
+
+    // half of the wire runs along each row and column of the pins
+    CHECK(map.horizontal(0, 0) == Approx(25));
+    CHECK(map.horizontal(1, 0) == Approx(50));
+    CHECK(map.horizontal(1, 1) == Approx(50));
+    CHECK(map.vertical(0, 0) == Approx(25));
+    CHECK(map.vertical(2, 1) == Approx(25));
+    CHECK(map.vertical(1, 1) == Approx(0));
+    CHECK(map.horizontal(1, 2) == Approx(0));
+    CHECK(map.total_wirelength() == Approx(300));
+}
+
+TEST_CASE_METHOD(CongestionMapFixture, "CongestionMap: incremental updates match a rebuild", "[placement][congestion_map]")
+{
+    auto generator = std::mt19937{3};
+    auto coordinate = std::uniform_real_distribution<double>{-20, 420};
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 120; ++i)
+    {
+        cells.push_back(add(point(coordinate(generator), coordinate(generator))));
+    }
+
+    // every input pin is on at most one net
+    auto sinks = cells;
+    std::shuffle(sinks.begin(), sinks.end(), generator);
+    auto next = sinks.begin();
+    for(auto i = 0; i < 40; ++i)
+    {
+        auto net = netlist.add_net("n" + std::to_string(i));
+        netlist.connect(net, pin(cells[i], ":z"));
+        for(auto sink = 0; sink < 1 + i % 4; ++sink)
+        {
+            netlist.connect(net, pin(*next++, ":a"));
+        }
+    }
+    auto pick = std::uniform_int_distribution<std::size_t>{0, cells.size() - 1};
+
+    for(auto model : {CongestionMap::Model::RUDY, CongestionMap::Model::PROBABILISTIC})
+    {
+        auto parameters = CongestionMap::Parameters{};
+        parameters.model = model;
+        parameters.max_degree = 3;
+        parameters.number_of_threads = 1;
+        auto map = CongestionMap{netlist, floorplan, placement, 8, 8, parameters};
+        for(auto i = 0; i < 200; ++i)
+        {
+            map.place(cells[pick(generator)], point(coordinate(generator), coordinate(generator)));
+        }
+
+        parameters.number_of_threads = 4;
+        auto rebuilt = CongestionMap{netlist, floorplan, placement, 8, 8, parameters};
+        for(std::size_t y = 0; y < 8; ++y)
+        {
+            for(std::size_t x = 0; x < 8; ++x)
+            {
+                CHECK(map.horizontal(x, y) == Approx(rebuilt.horizontal(x, y)).margin(1e-6));
+                CHECK(map.vertical(x, y) == Approx(rebuilt.vertical(x, y)).margin(1e-6));
+                CHECK(map.congestion(x, y) == Approx(rebuilt.congestion(x, y)).margin(1e-6));
+            }
+        }
+        CHECK(map.total_wirelength() == Approx(rebuilt.total_wirelength()));
+    }
+}
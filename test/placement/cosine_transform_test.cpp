@@ -0,0 +1,68 @@
+#include <catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include <ophidian/placement/CosineTransform.h>
+
+using namespace ophidian::placement;
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    double theta(std::size_t u, std::size_t x, std::size_t n)
+    {
+        return pi * u * (2 * x + 1) / (2.0 * n);
+    }
+
+    std::vector<double> samples(std::size_t n)
+    {
+        auto values = std::vector<double>(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            values[i] = std::sin(1.0 + 3.0 * i) + 0.25 * i;
+        }
+        return values;
+    }
+}
+
+TEST_CASE("CosineTransform matches the direct sums", "[placement][cosine_transform]")
+{
+    for(std::size_t n : {1, 2, 8, 64, 6, 12})
+    {
+        auto transform = CosineTransform{n};
+        auto workspace = CosineTransform::Workspace{};
+        auto f = samples(n);
+        REQUIRE(transform.size() == n);
+
+        auto dct = f;
+        transform.dct(dct.data(), workspace);
+        auto idct = f;
+        transform.idct(idct.data(), workspace);
+        auto idxst = f;
+        transform.idxst(idxst.data(), workspace);
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            auto expected_dct = 0.0;
+            auto expected_idct = f[0] / 2.0;
+            auto expected_idxst = 0.0;
+            for(std::size_t j = 0; j < n; ++j)
+            {
+                expected_dct += f[j] * std::cos(theta(i, j, n));
+                expected_idct += j > 0 ? f[j] * std::cos(theta(j, i, n)) : 0.0;
+                expected_idxst += f[j] * std::sin(theta(j, i, n));
+            }
+            CHECK(dct[i] == Approx(expected_dct).margin(1e-9));
+            CHECK(idct[i] == Approx(expected_idct).margin(1e-9));
+            CHECK(idxst[i] == Approx(expected_idxst).margin(1e-9));
+        }
+
+        // idct(dct(f)) = n / 2 f
+        transform.idct(dct.data(), workspace);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            CHECK(dct[i] == Approx(n / 2.0 * f[i]).margin(1e-9));
+        }
+    }
+}
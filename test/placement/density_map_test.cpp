@@ -0,0 +1,185 @@
+#include <catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ophidian/placement/DensityMap.h>
+
+using namespace ophidian::placement;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = DensityMap::point_type;
+    using box_type = DensityMap::box_type;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    // 400 x 400 chip, a 50 x 100 cell and a 100 x 200 macro
+    class DensityMapFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        ophidian::circuit::Cell inv, macro;
+
+        DensityMapFixture()
+        {
+            floorplan.chip_upper_right_corner() = point(400, 400);
+            inv = std_cells.add_cell("INV");
+            macro = std_cells.add_cell("MACRO");
+            library.geometry(inv) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(50, 100)}}};
+            library.geometry(macro) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(100, 200)}}};
+        }
+
+        ophidian::circuit::CellInstance add(const ophidian::circuit::Cell & std_cell, const point_type & location)
+        {
+            auto cell = netlist.add_cell_instance("c" + std::to_string(netlist.size_cell_instance()));
+            netlist.connect(cell, std_cell);
+            placement.place(cell, location);
+            return cell;
+        }
+    };
+}
+
+TEST_CASE_METHOD(DensityMapFixture, "DensityMap: areas and overflow", "[placement][density_map]")
+{
+    auto cell = add(inv, point(75, 0));
+    auto block = add(macro, point(200, 200));
+    placement.fix(block, true);
+    for(auto i = 0; i < 4; ++i)
+    {
+        add(inv, point(0, 100));
+    }
+
+    auto map = DensityMap{netlist, floorplan, placement, 4, 4};
+
+    CHECK(map.width() == 4);
+    CHECK(map.bin_width() == dbu_t{100});
+    CHECK(map.bin(point(250, 399)) == std::make_pair<std::size_t, std::size_t>(2, 3));
+    CHECK(map.bin(point(-10, 1000)) == std::make_pair<std::size_t, std::size_t>(0, 3));
+
+    CHECK(map.movable_area(0, 0) == Approx(2500));
+    CHECK(map.movable_area(1, 0) == Approx(2500));
+    CHECK(map.movable_density()[1] == Approx(0.25f));
+    CHECK(map.fixed_area(2, 2) == Approx(10000));
+    CHECK(map.fixed_density()[3 * 4 + 2] == Approx(1.0f));
+    CHECK(map.density(0, 1) == Approx(2.0));
+    CHECK(map.max_density() == Approx(2.0));
+
+    CHECK(map.total_movable_area() == Approx(25000));
+    CHECK(map.overflow_area(1.0) == Approx(10000));
+    CHECK(map.overflow(1.0) == Approx(0.4));
+
+    // movable cells on top of fixed ones overflow completely
+    map.place(cell, point(200, 200));
+    CHECK(map.movable_area(0, 0) == Approx(0));
+    CHECK(map.movable_area(2, 2) == Approx(5000));
+    CHECK(map.overflow_area(1.0) == Approx(15000));
+
+    // cells are clipped to the chip area
+    map.place(cell, point(375, 350));
+    CHECK(map.total_movable_area() == Approx(21250));
+
+    map.fix(block, false);
+    CHECK(map.fixed_area(2, 2) == Approx(0));
+    CHECK(map.total_movable_area() == Approx(41250));
+}
+
+TEST_CASE_METHOD(DensityMapFixture, "DensityMap: incremental updates match a rebuild", "[placement][density_map]")
+{
+    auto generator = std::mt19937{7};
+    auto coordinate = std::uniform_real_distribution<double>{-20, 380};
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 100; ++i)
+    {
+        cells.push_back(add(i % 10 == 0 ? macro : inv, point(coordinate(generator), coordinate(generator))));
+        placement.fix(cells.back(), i % 10 == 0);
+    }
+
+    auto map = DensityMap{netlist, floorplan, placement, 8, 8, 1};
+    for(auto i = 0; i < 500; ++i)
+    {
+        map.place(cells[i % cells.size()], point(coordinate(generator), coordinate(generator)));
+    }
+
+    auto rebuilt = DensityMap{netlist, floorplan, placement, 8, 8, 4};
+    for(std::size_t y = 0; y < 8; ++y)
+    {
+        for(std::size_t x = 0; x < 8; ++x)
+        {
+            CHECK(map.movable_area(x, y) == Approx(rebuilt.movable_area(x, y)).margin(1e-6));
+            CHECK(map.fixed_area(x, y) == Approx(rebuilt.fixed_area(x, y)).margin(1e-6));
+        }
+    }
+    CHECK(map.total_movable_area() == Approx(rebuilt.total_movable_area()));
+
+    auto serial = DensityMap{netlist, floorplan, placement, 8, 8, 1};
+    CHECK(serial.movable_density() == rebuilt.movable_density());
+    CHECK(serial.fixed_density() == rebuilt.fixed_density());
+}
+
+TEST_CASE_METHOD(DensityMapFixture, "DensityMap: an attached map follows the placement", "[placement][density_map]")
+{
+    auto generator = std::mt19937{11};
+    auto coordinate = std::uniform_real_distribution<double>{-20, 380};
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 100; ++i)
+    {
+        cells.push_back(add(i % 10 == 0 ? macro : inv, point(coordinate(generator), coordinate(generator))));
+    }
+
+    auto map = DensityMap{netlist, floorplan, placement, 8, 8, 1};
+    map.attach();
+    map.attach();
+    CHECK(map.attached());
+
+    auto check = [&](){
+        auto rebuilt = DensityMap{netlist, floorplan, placement, 8, 8, 1};
+        for(std::size_t y = 0; y < 8; ++y)
+        {
+            for(std::size_t x = 0; x < 8; ++x)
+            {
+                CHECK(map.movable_area(x, y) == Approx(rebuilt.movable_area(x, y)).margin(1e-6));
+                CHECK(map.fixed_area(x, y) == Approx(rebuilt.fixed_area(x, y)).margin(1e-6));
+            }
+        }
+    };
+
+    // single moves and fixes
+    for(auto i = 0; i < 50; ++i)
+    {
+        placement.place(cells[i], point(coordinate(generator), coordinate(generator)));
+        placement.fix(cells[i], i % 5 == 0);
+    }
+    map.place(cells[50], point(100, 100));
+    check();
+
+    // a small transaction is applied move by move, a large one rebuilds the map
+    for(auto size : {5, 60})
+    {
+        placement.begin();
+        for(auto i = 0; i < size; ++i)
+        {
+            placement.place(cells[i], point(coordinate(generator), coordinate(generator)));
+        }
+        placement.flush();
+        check();
+        placement.place(cells[size], point(0, 0));
+        placement.rollback();
+        check();
+    }
+
+    // a detached map is left behind
+    map.detach();
+    auto before = map.movable_area(0, 0);
+    placement.place(cells[1], point(0, 0));
+    placement.place(cells[2], point(0, 0));
+    CHECK(map.movable_area(0, 0) == before);
+}
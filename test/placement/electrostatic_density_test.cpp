@@ -0,0 +1,122 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ophidian/placement/ElectrostaticDensity.h>
+
+using namespace ophidian::placement;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = DensityMap::point_type;
+    using box_type = DensityMap::box_type;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    // 1600 x 1600 chip binned in 16 x 16, cells of one bin
+    class ElectrostaticFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        ophidian::circuit::Cell std_cell;
+
+        ElectrostaticFixture()
+        {
+            floorplan.chip_upper_right_corner() = point(1600, 1600);
+            std_cell = std_cells.add_cell("CELL");
+            library.geometry(std_cell) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(100, 100)}}};
+        }
+
+        ophidian::circuit::CellInstance add(const point_type & location)
+        {
+            auto cell = netlist.add_cell_instance("c" + std::to_string(netlist.size_cell_instance()));
+            netlist.connect(cell, std_cell);
+            placement.place(cell, location);
+            return cell;
+        }
+    };
+}
+
+TEST_CASE_METHOD(ElectrostaticFixture, "ElectrostaticDensity: uniform density has no field", "[placement][electrostatic_density]")
+{
+    for(auto y = 0; y < 16; ++y)
+    {
+        for(auto x = 0; x < 16; ++x)
+        {
+            add(point(100 * x, 100 * y));
+        }
+    }
+    auto density_map = DensityMap{netlist, floorplan, placement, 16, 16};
+    auto density = ElectrostaticDensity{netlist, placement, density_map};
+    density.update();
+
+    CHECK(density.energy() == Approx(0.0).margin(1e-6));
+    for(std::size_t i = 0; i < density.field_x().size(); ++i)
+    {
+        CHECK(density.field_x()[i] == Approx(0.0).margin(1e-9));
+        CHECK(density.field_y()[i] == Approx(0.0).margin(1e-9));
+    }
+}
+
+TEST_CASE_METHOD(ElectrostaticFixture, "ElectrostaticDensity: gradients push cells out of dense regions", "[placement][electrostatic_density]")
+{
+    // a block of 4 x 4 bins holding two cells each, centered on the chip
+    for(auto y = 6; y < 10; ++y)
+    {
+        for(auto x = 6; x < 10; ++x)
+        {
+            add(point(100 * x, 100 * y));
+            add(point(100 * x, 100 * y));
+        }
+    }
+    auto left = add(point(500, 750));
+    auto right = add(point(1000, 750));
+    auto below = add(point(750, 500));
+    auto center = add(point(750, 750));
+    auto macro = add(point(0, 0));
+    placement.fix(macro, true);
+
+    auto density_map = DensityMap{netlist, floorplan, placement, 16, 16};
+
+    auto solve = [&](std::size_t threads){
+        auto parameters = ElectrostaticDensity::Parameters{};
+        parameters.number_of_threads = threads;
+        auto density = std::make_unique<ElectrostaticDensity>(netlist, placement, density_map, parameters);
+        density->update();
+        return density;
+    };
+    auto density = solve(4);
+
+    CHECK(density->energy() > 0.0);
+
+    // moving against the gradient moves away from the block
+    CHECK(density->gradient(left).x > 0.0);
+    CHECK(density->gradient(right).x < 0.0);
+    CHECK(density->gradient(below).y > 0.0);
+    CHECK(density->gradient(left).x == Approx(-density->gradient(right).x).epsilon(0.1));
+    CHECK(std::abs(density->gradient(center).x) < 0.1 * density->gradient(left).x);
+    CHECK(density->gradient(macro).x == 0.0);
+    CHECK(density->gradient(macro).y == 0.0);
+
+    // the potential peaks inside the block
+    auto peak = std::max_element(density->potential().begin(), density->potential().end()) - density->potential().begin();
+    CHECK(peak % 16 >= 6);
+    CHECK(peak % 16 < 10);
+    CHECK(peak / 16 >= 6);
+    CHECK(peak / 16 < 10);
+
+    auto serial = solve(1);
+    CHECK(serial->potential() == density->potential());
+    CHECK(serial->gradient(left).x == density->gradient(left).x);
+}
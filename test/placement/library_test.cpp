@@ -1,4 +1,6 @@
 #include <catch.hpp>
+#include <utility>
+#include <vector>
 
 #include <ophidian/geometry/Models.h>
 #include <ophidian/placement/Library.h>
@@ -80,3 +82,49 @@ TEST_CASE_METHOD(StandardCellsFixture, "Library: setting offset of pins", "[plac
     REQUIRE(library.offset(pin1).x() != library.offset(pin2).x());
     REQUIRE(library.offset(pin1).y() != library.offset(pin2).y());
 }
+
+TEST_CASE_METHOD(StandardCellsFixture, "Library: oriented geometries and offsets", "[placement][library]")
+{
+    auto library = Library{std_cells};
+    auto point = [](double x, double y){ return Library::offset_type{Library::unit_type{x}, Library::unit_type{y}}; };
+
+    // a 20 x 10 cell with a pin at (5, 3) and a cell whose origin is not at zero
+    std_cells.connect(cell1, pin1);
+    std_cells.connect(cell2, pin2);
+    library.geometry(cell1) = CellGeometry{{CellGeometry::box_type{point(0, 0), point(20, 10)}}};
+    library.offset(pin1) = point(5, 3);
+    library.geometry(cell2) = CellGeometry{{CellGeometry::box_type{point(10, 10), point(30, 20)}}};
+    library.offset(pin2) = point(15, 13);
+    library.update_orientations(std_cells);
+
+    auto expected = std::vector<std::pair<Orientation, Library::offset_type>>{
+        {Orientation::N, point(5, 3)},
+        {Orientation::S, point(15, 7)},
+        {Orientation::W, point(7, 5)},
+        {Orientation::E, point(3, 15)},
+        {Orientation::FN, point(15, 3)},
+        {Orientation::FS, point(5, 7)},
+        {Orientation::FW, point(7, 15)},
+        {Orientation::FE, point(3, 5)}
+    };
+    for(const auto & [orientation, offset] : expected)
+    {
+        CHECK(library.offset(pin1, orientation).x() == offset.x());
+        CHECK(library.offset(pin1, orientation).y() == offset.y());
+        CHECK(library.offset(pin2, orientation).x() == offset.x() + Library::unit_type{10});
+        CHECK(library.offset(pin2, orientation).y() == offset.y() + Library::unit_type{10});
+    }
+
+    // rotated cells swap their width and height
+    const auto & west = library.geometry(cell1, Orientation::W).front();
+    CHECK(west.min_corner().x() == Library::unit_type{0});
+    CHECK(west.max_corner().x() == Library::unit_type{10});
+    CHECK(west.max_corner().y() == Library::unit_type{20});
+    const auto & south = library.geometry(cell2, Orientation::S).front();
+    CHECK(south.min_corner().x() == Library::unit_type{10});
+    CHECK(south.max_corner().y() == Library::unit_type{20});
+
+    // the N orientation is the library geometry itself
+    library.offset(pin1) = point(1, 1);
+    CHECK(library.offset(pin1, Orientation::N).x() == Library::unit_type{1});
+}
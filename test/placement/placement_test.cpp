@@ -4,6 +4,8 @@
 
 #include <ophidian/placement/Placement.h>
 
+#include <string>
+
 using namespace ophidian::placement;
 using namespace ophidian::circuit;
 
@@ -147,3 +149,335 @@ TEST_CASE_METHOD(NetlistFixture, "Placement: fixing two cells", "[placement]") {
     REQUIRE(!placement.fixed(cell1));
     REQUIRE(!placement.fixed(cell2));
 }
+
+namespace {
+    Placement::point_type at(double x, double y)
+    {
+        return Placement::point_type{Placement::unit_type{x}, Placement::unit_type{y}};
+    }
+
+    class RecordingListener : public Placement::Listener
+    {
+    public:
+        std::vector<Placement::move_container_type> batches;
+        std::vector<Placement::cell_type> fixes;
+        std::vector<Placement::cell_type> orientations;
+
+        void moved(const Placement::move_container_type & moves) override
+        {
+            batches.push_back(moves);
+        }
+
+        void fixed(const Placement::cell_type & cell) override
+        {
+            fixes.push_back(cell);
+        }
+
+        void oriented(const Placement::cell_type & cell) override
+        {
+            orientations.push_back(cell);
+        }
+    };
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: listeners see every move outside transactions", "[placement]") {
+    auto placement = Placement{netlist, library};
+    auto listener = RecordingListener{};
+
+    placement.place(cell1, at(1, 2));
+    placement.add_listener(listener);
+    placement.place(cell1, at(3, 4));
+
+    REQUIRE(listener.batches.size() == 1);
+    REQUIRE(listener.batches[0].size() == 1);
+    CHECK(listener.batches[0][0].cell == cell1);
+    CHECK(listener.batches[0][0].from.x() == Placement::unit_type{1});
+    CHECK(listener.batches[0][0].to.y() == Placement::unit_type{4});
+
+    placement.remove_listener(listener);
+    placement.place(cell1, at(5, 6));
+    CHECK(listener.batches.size() == 1);
+}
+
+namespace {
+    class Follower :
+        public RecordingListener,
+        public Placement::Subscription
+    {
+    public:
+        std::vector<bool> rebuilds;
+
+        Follower(Placement & placement):
+            Subscription(placement, *this)
+        {
+        }
+
+        void moved(const Placement::move_container_type & moves) override
+        {
+            RecordingListener::moved(moves);
+            rebuilds.push_back(rebuild(moves));
+        }
+    };
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: subscriptions follow the placement until detached", "[placement]") {
+    auto placement = Placement{netlist, library};
+    {
+        auto follower = Follower{placement};
+        CHECK(!follower.attached());
+        follower.attach();
+        follower.attach();
+        placement.place(cell1, at(1, 2));
+        REQUIRE(follower.batches.size() == 1);
+
+        // one of the two cells is more than an eighth of them, but not more than a half
+        follower.rebuild_fraction(0.5);
+        placement.place(cell1, at(3, 4));
+        CHECK(follower.rebuilds == std::vector<bool>{true, false});
+
+        follower.detach();
+        placement.place(cell1, at(5, 6));
+        CHECK(follower.batches.size() == 2);
+        follower.attach();
+    }
+
+    // the destroyed follower is no longer told about the moves
+    placement.place(cell1, at(7, 8));
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: committed transactions deliver one batch", "[placement]") {
+    auto placement = Placement{netlist, library};
+    auto listener = RecordingListener{};
+    placement.place(cell1, at(0, 0));
+    placement.place(cell2, at(10, 10));
+    placement.add_listener(listener);
+
+    placement.begin();
+    CHECK(placement.in_transaction());
+    placement.place(cell1, at(1, 1));
+    placement.place(cell1, at(2, 2));
+    placement.place(cell2, at(20, 20));
+    placement.place(cell2, at(10, 10));
+    CHECK(listener.batches.empty());
+    CHECK(placement.location(cell1).x() == Placement::unit_type{2});
+
+    // cell2 came back to where it was, only cell1 moved
+    placement.commit();
+    CHECK(!placement.in_transaction());
+    REQUIRE(listener.batches.size() == 1);
+    REQUIRE(listener.batches[0].size() == 1);
+    CHECK(listener.batches[0][0].cell == cell1);
+    CHECK(listener.batches[0][0].from.x() == Placement::unit_type{0});
+    CHECK(listener.batches[0][0].to.x() == Placement::unit_type{2});
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: rollback restores the locations", "[placement]") {
+    auto placement = Placement{netlist, library};
+    auto listener = RecordingListener{};
+    placement.place(cell1, at(0, 0));
+    placement.place(cell2, at(10, 10));
+    placement.add_listener(listener);
+
+    SECTION("Nothing flushed, nothing delivered")
+    {
+        placement.begin();
+        placement.place(cell1, at(1, 1));
+        placement.place(cell2, at(5, 5));
+        placement.rollback();
+
+        CHECK(listener.batches.empty());
+        CHECK(placement.location(cell1).x() == Placement::unit_type{0});
+        CHECK(placement.location(cell2).y() == Placement::unit_type{10});
+    }
+
+    SECTION("Flushed moves are reversed")
+    {
+        placement.begin();
+        placement.place(cell1, at(1, 1));
+        placement.flush();
+        placement.place(cell1, at(2, 2));
+        placement.place(cell2, at(5, 5));
+        REQUIRE(listener.batches.size() == 1);
+        CHECK(listener.batches[0][0].to.x() == Placement::unit_type{1});
+
+        placement.rollback();
+        REQUIRE(listener.batches.size() == 2);
+        REQUIRE(listener.batches[1].size() == 1);
+        CHECK(listener.batches[1][0].cell == cell1);
+        CHECK(listener.batches[1][0].from.x() == Placement::unit_type{1});
+        CHECK(listener.batches[1][0].to.x() == Placement::unit_type{0});
+        CHECK(placement.location(cell1).x() == Placement::unit_type{0});
+        CHECK(placement.location(cell2).x() == Placement::unit_type{10});
+    }
+
+    // a new transaction starts with an empty log
+    placement.begin();
+    placement.place(cell2, at(7, 7));
+    placement.commit();
+    REQUIRE(!listener.batches.empty());
+    CHECK(listener.batches.back().size() == 1);
+    CHECK(listener.batches.back()[0].from.x() == Placement::unit_type{10});
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: rollback restores the fixed state changes", "[placement]") {
+    auto placement = Placement{netlist, library};
+    auto listener = RecordingListener{};
+    placement.add_listener(listener);
+
+    placement.fix(cell1, true);
+    placement.fix(cell1, true);
+    placement.begin();
+    placement.fix(cell2, true);
+    placement.fix(cell1, false);
+    placement.rollback();
+
+    // nothing was flushed, so the listener never saw the changes nor their undo
+    CHECK(listener.fixes == std::vector<Placement::cell_type>{cell1});
+    CHECK(listener.batches.empty());
+    CHECK(!placement.fixed(cell2));
+    CHECK(placement.fixed(cell1));
+
+    // orientations and locations changed together are restored together
+    placement.place(cell2, at(1, 1));
+    placement.begin();
+    placement.place(cell2, at(5, 5));
+    placement.orient(cell2, Orientation::FS);
+    placement.flush();
+    placement.rollback();
+    CHECK(placement.orientation(cell2) == Orientation::N);
+    CHECK(placement.location(cell2).x() == Placement::unit_type{1});
+    CHECK(listener.orientations == std::vector<Placement::cell_type>{cell2, cell2});
+    REQUIRE(listener.batches.size() == 3);
+    CHECK(listener.batches.back()[0].to.x() == Placement::unit_type{1});
+
+    // committed changes stay
+    placement.begin();
+    placement.fix(cell2, true);
+    placement.commit();
+    CHECK(placement.fixed(cell2));
+}
+
+namespace {
+    // keeps its own copy of the locations and checks it whenever another change is told
+    class ViewListener : public Placement::Listener
+    {
+    public:
+        const Placement & placement;
+        std::vector<std::pair<Placement::cell_type, Placement::point_type>> locations;
+        std::string events;
+        bool consistent{true};
+
+        explicit ViewListener(const Placement & placement):
+            placement(placement)
+        {
+        }
+
+        void moved(const Placement::move_container_type & moves) override
+        {
+            events += 'm';
+            for(const auto & move : moves)
+            {
+                view(move.cell) = move.to;
+            }
+        }
+
+        void fixed(const Placement::cell_type & cell) override
+        {
+            events += 'f';
+            check(cell);
+        }
+
+        void oriented(const Placement::cell_type & cell) override
+        {
+            events += 'o';
+            check(cell);
+        }
+
+    private:
+        Placement::point_type & view(const Placement::cell_type & cell)
+        {
+            for(auto & location : locations)
+            {
+                if(location.first == cell)
+                {
+                    return location.second;
+                }
+            }
+            locations.emplace_back(cell, placement.location(cell));
+            return locations.back().second;
+        }
+
+        void check(const Placement::cell_type & cell)
+        {
+            const auto & seen = view(cell);
+            const auto & actual = placement.location(cell);
+            consistent = consistent && seen.x() == actual.x() && seen.y() == actual.y();
+        }
+    };
+}
+
+TEST_CASE_METHOD(NetlistFixture, "Placement: listeners see the moves before the other changes", "[placement]") {
+    auto placement = Placement{netlist, library};
+    placement.place(cell1, at(0, 0));
+    auto listener = ViewListener{placement};
+    listener.locations.emplace_back(cell1, at(0, 0));
+    placement.add_listener(listener);
+
+    placement.begin();
+    placement.orient(cell1, Orientation::FS);
+    placement.place(cell1, at(4, 4));
+    placement.fix(cell1, true);
+    CHECK(listener.events.empty());
+
+    placement.flush();
+    CHECK(listener.events == "mfo");
+
+    placement.place(cell1, at(8, 8));
+    placement.rollback();
+    CHECK(listener.events == "mfomfo");
+    CHECK(listener.consistent);
+    CHECK(listener.locations.front().second.x() == Placement::unit_type{0});
+    CHECK(!placement.fixed(cell1));
+    CHECK(placement.orientation(cell1) == Orientation::N);
+}
+
+TEST_CASE("Placement: pins and geometry follow the orientation", "[placement]") {
+    auto std_cells = StandardCells{};
+    auto library = Library{std_cells};
+    auto netlist = Netlist{};
+    auto placement = Placement{netlist, library};
+    auto point = [](double x, double y){ return Placement::point_type{Placement::unit_type{x}, Placement::unit_type{y}}; };
+
+    auto inv = std_cells.add_cell("INV");
+    auto output = std_cells.add_pin("INV:o", PinDirection::OUTPUT);
+    std_cells.connect(inv, output);
+    library.geometry(inv) = ophidian::geometry::CellGeometry{{ophidian::geometry::CellGeometry::box_type{point(0, 0), point(20, 10)}}};
+    library.offset(output) = point(5, 3);
+    library.update_orientations(std_cells);
+
+    auto cell = netlist.add_cell_instance("u1");
+    auto pin = netlist.add_pin_instance("u1:o");
+    netlist.connect(cell, inv);
+    netlist.connect(cell, pin);
+    netlist.connect(pin, output);
+    placement.place(cell, point(100, 200));
+    CHECK(placement.orientation(cell) == Orientation::N);
+    CHECK(placement.location(pin).x() == Placement::unit_type{105});
+
+    auto listener = RecordingListener{};
+    placement.add_listener(listener);
+    placement.orient(cell, Orientation::FS);
+    placement.orient(cell, Orientation::FS);
+    CHECK(listener.orientations == std::vector<Placement::cell_type>{cell});
+
+    CHECK(placement.location(pin).x() == Placement::unit_type{105});
+    CHECK(placement.location(pin).y() == Placement::unit_type{207});
+
+    placement.orient(cell, Orientation::E);
+    CHECK(placement.location(pin).x() == Placement::unit_type{103});
+    CHECK(placement.location(pin).y() == Placement::unit_type{215});
+    auto box = placement.geometry(cell).front();
+    CHECK(box.min_corner().x() == Placement::unit_type{100});
+    CHECK(box.max_corner().x() == Placement::unit_type{110});
+    CHECK(box.max_corner().y() == Placement::unit_type{220});
+}
@@ -0,0 +1,191 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+
+#include <ophidian/placement/QuadraticPlacer.h>
+
+using namespace ophidian::placement;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = QuadraticPlacer::point_type;
+    using box_type = ophidian::geometry::Box<dbu_t>;
+
+    point_type point(double x, double y)
+    {
+        return point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    double x_of(const Placement & placement, const ophidian::circuit::CellInstance & cell)
+    {
+        return units::unit_cast<double>(placement.location(cell).x());
+    }
+
+    // 1000 x 1000 chip, 10 x 10 cells with a pin at their center
+    class QuadraticPlacerFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        Library library{std_cells};
+        ophidian::circuit::Netlist netlist;
+        Placement placement{netlist, library};
+        ophidian::floorplan::Floorplan floorplan;
+        ophidian::circuit::Cell cell_type;
+        ophidian::circuit::Pin a, b;
+
+        QuadraticPlacerFixture()
+        {
+            floorplan.chip_upper_right_corner() = point(1000, 1000);
+            cell_type = std_cells.add_cell("BUF");
+            a = std_cells.add_pin("BUF:A", ophidian::circuit::PinDirection::INPUT);
+            b = std_cells.add_pin("BUF:Z", ophidian::circuit::PinDirection::OUTPUT);
+            std_cells.connect(cell_type, a);
+            std_cells.connect(cell_type, b);
+            library.geometry(cell_type) = ophidian::geometry::CellGeometry{{box_type{point(0, 0), point(10, 10)}}};
+            library.offset(a) = point(5, 5);
+            library.offset(b) = point(5, 5);
+        }
+
+        ophidian::circuit::CellInstance add(const point_type & location)
+        {
+            auto name = "c" + std::to_string(netlist.size_cell_instance());
+            auto cell = netlist.add_cell_instance(name);
+            netlist.connect(cell, cell_type);
+            for(auto pin : {a, b})
+            {
+                auto instance = netlist.add_pin_instance(name + ":" + std_cells.name(pin));
+                netlist.connect(instance, pin);
+                netlist.connect(cell, instance);
+            }
+            placement.place(cell, location);
+            return cell;
+        }
+
+        ophidian::circuit::PinInstance pin(const ophidian::circuit::CellInstance & cell, std::size_t index)
+        {
+            auto & std_pin = index == 0 ? a : b;
+            return netlist.find_pin_instance(netlist.name(cell) + ":" + std_cells.name(std_pin));
+        }
+
+        void connect(const std::string & name, const std::vector<ophidian::circuit::PinInstance> & pins)
+        {
+            auto net = netlist.add_net(name);
+            for(auto p : pins)
+            {
+                netlist.connect(net, p);
+            }
+        }
+
+        ophidian::circuit::PinInstance pad(const std::string & name, const point_type & location)
+        {
+            auto instance = netlist.add_pin_instance(name);
+            auto input = netlist.add_input_pad(instance);
+            placement.place(input, location);
+            return instance;
+        }
+    };
+}
+
+TEST_CASE_METHOD(QuadraticPlacerFixture, "QuadraticPlacer: a chain between two pads", "[placement][quadratic_placer]")
+{
+    auto left = pad("left", point(0, 500));
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 4; ++i)
+    {
+        cells.push_back(add(point(500, 500)));
+    }
+    auto right = add(point(990, 495));
+    placement.fix(right, true);
+
+    connect("n0", {left, pin(cells[0], 0)});
+    for(std::size_t i = 0; i + 1 < cells.size(); ++i)
+    {
+        connect("n" + std::to_string(i + 1), {pin(cells[i], 1), pin(cells[i + 1], 0)});
+    }
+    connect("n4", {pin(cells.back(), 1), pin(right, 0)});
+
+    auto parameters = QuadraticPlacer::Parameters{};
+    parameters.tolerance = 1e-10;
+    auto placer = QuadraticPlacer{netlist, floorplan, placement, parameters};
+    auto statistics = placer.place();
+
+    // sparse cells do not need spreading and end in order on the line between the pads
+    CHECK(statistics.iterations == 0);
+    CHECK(statistics.overflow == 0.0);
+    CHECK(statistics.wirelength == Approx(995).epsilon(1e-2));
+    auto previous = -5.0;
+    for(auto cell : cells)
+    {
+        CHECK(x_of(placement, cell) >= previous);
+        CHECK(units::unit_cast<double>(placement.location(cell).y()) == Approx(495).epsilon(1e-2));
+        previous = x_of(placement, cell);
+    }
+    CHECK(previous <= 985.0);
+    CHECK(x_of(placement, right) == 990);
+}
+
+TEST_CASE_METHOD(QuadraticPlacerFixture, "QuadraticPlacer: spreads a clump of cells", "[placement][quadratic_placer]")
+{
+    // 400 cells connected in a ring to four corner pads, all starting at the center
+    auto corners = std::vector<ophidian::circuit::PinInstance>{
+        pad("p0", point(0, 0)), pad("p1", point(1000, 0)), pad("p2", point(1000, 1000)), pad("p3", point(0, 1000))
+    };
+    auto cells = std::vector<ophidian::circuit::CellInstance>{};
+    for(auto i = 0; i < 400; ++i)
+    {
+        cells.push_back(add(point(495, 495)));
+    }
+    for(std::size_t i = 0; i < cells.size(); ++i)
+    {
+        connect("n" + std::to_string(i), {pin(cells[i], 1), pin(cells[(i + 1) % cells.size()], 0)});
+    }
+    for(std::size_t i = 0; i < corners.size(); ++i)
+    {
+        connect("p" + std::to_string(i), {corners[i], pin(cells[i * 100], 0)});
+    }
+
+    auto run = [&](std::size_t threads){
+        for(auto cell : cells)
+        {
+            placement.place(cell, point(495, 495));
+        }
+        auto parameters = QuadraticPlacer::Parameters{};
+        parameters.bins = 8;
+        parameters.target_density = 0.5;
+        parameters.target_overflow = 0.2;
+        parameters.number_of_threads = threads;
+        auto placer = QuadraticPlacer{netlist, floorplan, placement, parameters};
+        auto statistics = placer.place();
+
+        auto locations = std::vector<point_type>{};
+        for(auto cell : cells)
+        {
+            locations.push_back(placement.location(cell));
+        }
+        return std::make_pair(statistics, locations);
+    };
+
+    auto [statistics, locations] = run(1);
+    CHECK(statistics.iterations > 0);
+    CHECK(statistics.iterations < 50);
+    CHECK(statistics.overflow <= 0.2);
+    for(const auto & location : locations)
+    {
+        CHECK(location.x() >= dbu_t{0});
+        CHECK(location.x() <= dbu_t{990});
+        CHECK(location.y() >= dbu_t{0});
+        CHECK(location.y() <= dbu_t{990});
+    }
+
+    SECTION("Placement does not depend on the number of threads")
+    {
+        auto [parallel_statistics, parallel_locations] = run(4);
+        CHECK(parallel_statistics.iterations == statistics.iterations);
+        for(std::size_t i = 0; i < locations.size(); ++i)
+        {
+            CHECK(parallel_locations[i].x() == locations[i].x());
+            CHECK(parallel_locations[i].y() == locations[i].y());
+        }
+    }
+}
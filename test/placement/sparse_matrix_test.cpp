@@ -0,0 +1,98 @@
+#include <catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include <ophidian/placement/SparseMatrix.h>
+
+using namespace ophidian::placement;
+
+namespace
+{
+    // tridiagonal Laplacian of a chain anchored at both ends
+    SparseMatrix chain(std::size_t size)
+    {
+        auto entries = SparseMatrix::entry_container_type{};
+        for(std::size_t i = 0; i + 1 < size; ++i)
+        {
+            entries.emplace_back(i, i + 1);
+            entries.emplace_back(i + 1, i);
+        }
+        auto matrix = SparseMatrix{size};
+        matrix.set_pattern(entries);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            matrix.add(i, i, 2.0);
+            if(i + 1 < size)
+            {
+                matrix.add(i, i + 1, -1.0);
+                matrix.add(i + 1, i, -1.0);
+            }
+        }
+        return matrix;
+    }
+}
+
+TEST_CASE("SparseMatrix: pattern and values", "[placement][sparse_matrix]")
+{
+    auto matrix = SparseMatrix{4};
+    CHECK(matrix.non_zeros() == 4);
+    CHECK(matrix.contains(2, 2));
+    CHECK(!matrix.contains(0, 3));
+
+    matrix.extend_pattern({{0, 3}, {3, 0}, {0, 3}});
+    CHECK(matrix.non_zeros() == 6);
+    CHECK(matrix.contains(0, 3));
+
+    matrix.add(0, 3, 1.5);
+    matrix.add(0, 3, 1.0);
+    matrix.add(1, 1, 4.0);
+    CHECK(matrix.value(0, 3) == Approx(2.5));
+    CHECK(matrix.value(1, 2) == 0.0);
+    CHECK(matrix.diagonal(1) == Approx(4.0));
+
+    // extending keeps the old entries and clears the values
+    matrix.extend_pattern({{1, 2}});
+    CHECK(matrix.non_zeros() == 7);
+    CHECK(matrix.contains(0, 3));
+    CHECK(matrix.value(0, 3) == 0.0);
+
+    auto x = std::vector<double>{1.0, 2.0, 3.0, 4.0};
+    auto y = std::vector<double>{};
+    matrix.add(0, 3, 1.0);
+    matrix.add(1, 2, 2.0);
+    matrix.add(2, 2, 1.0);
+    matrix.multiply(x, y);
+    CHECK(y == std::vector<double>{4.0, 6.0, 3.0, 0.0});
+}
+
+TEST_CASE("ConjugateGradient: solves a chain", "[placement][sparse_matrix]")
+{
+    auto size = std::size_t{10000};
+    auto matrix = chain(size);
+
+    // the solution of the chain with unit loads is the parabola i (n + 1 - i) / 2, 1 based
+    auto b = std::vector<double>(size, 1.0);
+    auto solve = [&](std::size_t threads){
+        auto parameters = ConjugateGradient::Parameters{};
+        parameters.tolerance = 1e-10;
+        parameters.max_iterations = 2 * size;
+        parameters.number_of_threads = threads;
+        auto solver = ConjugateGradient{parameters};
+        auto x = std::vector<double>(size, 0.0);
+        auto iterations = solver.solve(matrix, b, x);
+        CHECK(iterations > 0);
+        CHECK(solver.residual() < 1e-10);
+        return x;
+    };
+
+    auto serial = solve(1);
+    for(std::size_t i = 0; i < size; i += 997)
+    {
+        CHECK(serial[i] == Approx((i + 1.0) * (size - i) / 2.0).epsilon(1e-6));
+    }
+
+    SECTION("The solution does not depend on the number of threads")
+    {
+        CHECK(solve(4) == serial);
+    }
+}
@@ -0,0 +1,245 @@
+#include <catch.hpp>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <ophidian/routing/DetailedRouter.h>
+#include <ophidian/routing/GlobalRouter.h>
+
+using namespace ophidian::routing;
+using ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = DetailedRouter::point_type;
+    using box_type = DetailedRouter::box_type;
+
+    box_type square(double half)
+    {
+        return box_type{{database_unit_t{-half}, database_unit_t{-half}}, {database_unit_t{half}, database_unit_t{half}}};
+    }
+
+    void make_library(Library & library)
+    {
+        auto pitch = database_unit_t{100};
+        auto zero = database_unit_t{0};
+        auto table = Library::spacing_table_type{Library::spacing_table_content_type{}};
+        library.add_layer("M1", LayerType::ROUTING, LayerDirection::HORIZONTAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("V1", LayerType::CUT, LayerDirection::NA, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("M2", LayerType::ROUTING, LayerDirection::VERTICAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("V2", LayerType::CUT, LayerDirection::NA, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("M3", LayerType::ROUTING, LayerDirection::HORIZONTAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+
+        library.add_via("VIA12_BIG", {{"M1", square(60)}, {"V1", square(30)}, {"M2", square(60)}});
+        library.add_via("VIA12", {{"M1", square(40)}, {"V1", square(30)}, {"M2", square(40)}});
+        library.add_via("VIA23", {{"M2", square(40)}, {"V2", square(30)}, {"M3", square(40)}});
+
+        for(auto layer : {"M1", "M2", "M3"})
+        {
+            library.add_track(TrackOrientation::X, database_unit_t{50}, 105, database_unit_t{100}, layer);
+            library.add_track(TrackOrientation::Y, database_unit_t{50}, 105, database_unit_t{100}, layer);
+        }
+        library.update_track_grids();
+    }
+
+    const box_type area{point_type{database_unit_t{0}, database_unit_t{0}}, point_type{database_unit_t{10500}, database_unit_t{10500}}};
+
+    point_type point(double x, double y)
+    {
+        return point_type{database_unit_t{x}, database_unit_t{y}};
+    }
+
+    bool on_wire(const DetailedRouter::Wire & wire, const point_type & p)
+    {
+        auto x0 = std::min(wire.start.x(), wire.end.x()), x1 = std::max(wire.start.x(), wire.end.x());
+        auto y0 = std::min(wire.start.y(), wire.end.y()), y1 = std::max(wire.start.y(), wire.end.y());
+        return p.x() >= x0 && p.x() <= x1 && p.y() >= y0 && p.y() <= y1;
+    }
+
+    // wires and vias form one connected component that touches every pin
+    bool connected(const Library & library, const DetailedRouter & router, const ophidian::circuit::Net & net, const std::vector<point_type> & pins)
+    {
+        const auto & wires = router.wires(net);
+        const auto & vias = router.vias(net);
+        auto size = wires.size() + vias.size();
+        auto parent = std::vector<std::size_t>(size);
+        std::iota(parent.begin(), parent.end(), 0);
+        std::function<std::size_t(std::size_t)> find = [&](std::size_t i){ return parent[i] == i ? i : parent[i] = find(parent[i]); };
+
+        auto via_on_layer = [&](std::size_t v, const Library::layer_type & layer){
+            for(const auto & geometry : library.geometries(vias[v].via))
+            {
+                if(geometry.first == layer)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for(std::size_t i = 0; i < wires.size(); ++i)
+        {
+            for(std::size_t j = 0; j < wires.size(); ++j)
+            {
+                if(wires[i].layer == wires[j].layer && (on_wire(wires[i], wires[j].start) || on_wire(wires[i], wires[j].end)))
+                {
+                    parent[find(i)] = find(j);
+                }
+            }
+            for(std::size_t v = 0; v < vias.size(); ++v)
+            {
+                if(via_on_layer(v, wires[i].layer) && on_wire(wires[i], vias[v].position))
+                {
+                    parent[find(i)] = find(wires.size() + v);
+                }
+            }
+        }
+        for(std::size_t v = 0; v < vias.size(); ++v)
+        {
+            for(std::size_t w = 0; w < vias.size(); ++w)
+            {
+                if(vias[v].position.x() == vias[w].position.x() && vias[v].position.y() == vias[w].position.y())
+                {
+                    parent[find(v + wires.size())] = find(w + wires.size());
+                }
+            }
+        }
+
+        auto root = size;
+        for(const auto & pin : pins)
+        {
+            auto element = size;
+            for(std::size_t i = 0; i < wires.size() && element == size; ++i)
+            {
+                if(on_wire(wires[i], pin))
+                {
+                    element = i;
+                }
+            }
+            for(std::size_t v = 0; v < vias.size() && element == size; ++v)
+            {
+                if(vias[v].position.x() == pin.x() && vias[v].position.y() == pin.y())
+                {
+                    element = wires.size() + v;
+                }
+            }
+            if(element == size || (root != size && find(element) != root))
+            {
+                return false;
+            }
+            root = find(element);
+        }
+        return true;
+    }
+}
+
+TEST_CASE("DetailedRouter connects pins inside the global routing guides", "[routing][detailed_router]")
+{
+    auto library = Library{};
+    make_library(library);
+    auto netlist = ophidian::circuit::Netlist{};
+    auto global_routing = GlobalRouting{netlist};
+
+    auto n0 = netlist.add_net("n0");
+    auto n1 = netlist.add_net("n1");
+    auto n2 = netlist.add_net("n2");
+    auto pins0 = std::vector<point_type>{point(750, 750), point(6750, 3750)};
+    auto pins1 = std::vector<point_type>{point(750, 3750), point(6750, 750), point(3750, 8250)};
+    auto pins2 = std::vector<point_type>{point(9050, 9050), point(9980, 9120)};
+
+    auto global_router = GlobalRouter{library, area};
+    global_router.add_net(n0, pins0);
+    global_router.add_net(n1, pins1);
+    global_router.add_net(n2, pins2);
+    global_router.route(global_routing);
+
+    auto run = [&](std::size_t threads, std::size_t batch_size = 1024){
+        auto parameters = DetailedRouter::Parameters{};
+        parameters.number_of_threads = threads;
+        parameters.batch_size = batch_size;
+        auto router = std::make_unique<DetailedRouter>(library, global_routing, netlist, parameters);
+        router->add_net(n0, pins0);
+        router->add_net(n1, pins1);
+        router->add_net(n2, pins2);
+        router->route();
+        return router;
+    };
+
+    auto routed = run(4);
+    auto & router = *routed;
+    CHECK(router.unrouted().empty());
+    CHECK(router.routed(n0));
+    CHECK(router.routed(n1));
+    CHECK(router.routed(n2));
+
+    SECTION("Wires follow the preferred directions")
+    {
+        for(auto net : {n0, n1})
+        {
+            for(const auto & wire : router.wires(net))
+            {
+                auto horizontal = library.direction(wire.layer) == LayerDirection::HORIZONTAL;
+                CHECK((horizontal ? wire.start.y() == wire.end.y() : wire.start.x() == wire.end.x()));
+            }
+            CHECK(!router.vias(net).empty());
+        }
+    }
+
+    SECTION("Vias use the smallest via of each cut")
+    {
+        for(const auto & via : router.vias(n0))
+        {
+            CHECK(library.name(via.via) != "VIA12_BIG");
+        }
+    }
+
+    SECTION("Pins are connected")
+    {
+        CHECK(connected(library, router, n0, pins0));
+        CHECK(connected(library, router, n1, pins1));
+
+        // off track pins get stubs to their access points
+        CHECK(connected(library, router, n2, pins2));
+    }
+
+    SECTION("Routing does not depend on the number of threads")
+    {
+        auto serial_router = run(1);
+        auto & serial = *serial_router;
+        for(auto net : {n0, n1, n2})
+        {
+            REQUIRE(serial.wires(net).size() == router.wires(net).size());
+            for(std::size_t i = 0; i < serial.wires(net).size(); ++i)
+            {
+                CHECK(serial.wires(net)[i].start.x() == router.wires(net)[i].start.x());
+                CHECK(serial.wires(net)[i].end.y() == router.wires(net)[i].end.y());
+            }
+        }
+    }
+
+    SECTION("An empty batch size routes one net at a time")
+    {
+        auto single_router = run(4, 0);
+        CHECK(single_router->unrouted().empty());
+        CHECK(connected(library, *single_router, n0, pins0));
+        CHECK(connected(library, *single_router, n1, pins1));
+    }
+}
+
+TEST_CASE("DetailedRouter reports nets without guides", "[routing][detailed_router]")
+{
+    auto library = Library{};
+    make_library(library);
+    auto netlist = ophidian::circuit::Netlist{};
+    auto global_routing = GlobalRouting{netlist};
+    auto net = netlist.add_net("n0");
+
+    auto router = DetailedRouter{library, global_routing, netlist};
+    router.add_net(net, {point(750, 750), point(6750, 3750)});
+    router.route();
+
+    CHECK(!router.routed(net));
+    REQUIRE(router.unrouted().size() == 1);
+    CHECK(router.unrouted().front() == net);
+}
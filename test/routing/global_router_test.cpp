@@ -0,0 +1,149 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <ophidian/routing/GlobalRouter.h>
+
+using namespace ophidian::routing;
+using ophidian::util::database_unit_t;
+
+namespace
+{
+    using point_type = GlobalRouter::point_type;
+    using box_type = GlobalRouter::box_type;
+
+    // three routing layers, H V H, with a 100 pitch; a GCell is 15 pitches wide
+    void make_library(Library & library, double track_space)
+    {
+        auto pitch = database_unit_t{100};
+        auto zero = database_unit_t{0};
+        auto table = Library::spacing_table_type{Library::spacing_table_content_type{}};
+        library.add_layer("M1", LayerType::ROUTING, LayerDirection::HORIZONTAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("V1", LayerType::CUT, LayerDirection::NA, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("M2", LayerType::ROUTING, LayerDirection::VERTICAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("V2", LayerType::CUT, LayerDirection::NA, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+        library.add_layer("M3", LayerType::ROUTING, LayerDirection::HORIZONTAL, pitch, zero, zero, zero, zero, zero, zero, zero, zero, table);
+
+        auto count = static_cast<int>(10500 / track_space);
+        for(auto layer : {"M1", "M2", "M3"})
+        {
+            library.add_track(TrackOrientation::X, database_unit_t{track_space / 2}, count, database_unit_t{track_space}, layer);
+            library.add_track(TrackOrientation::Y, database_unit_t{track_space / 2}, count, database_unit_t{track_space}, layer);
+        }
+        library.update_track_grids();
+    }
+
+    point_type center(int x, int y)
+    {
+        return point_type{database_unit_t{750.0 + 1500.0 * x}, database_unit_t{750.0 + 1500.0 * y}};
+    }
+
+    const box_type area{point_type{database_unit_t{0}, database_unit_t{0}}, point_type{database_unit_t{10500}, database_unit_t{10500}}};
+
+    using guide_type = std::tuple<std::string, double, double, double, double>;
+
+    std::vector<guide_type> guides(const Library & library, const GlobalRouting & global_routing, const ophidian::circuit::Net & net)
+    {
+        auto result = std::vector<guide_type>{};
+        for(auto region : global_routing.regions(net))
+        {
+            auto box = global_routing.geometry(region);
+            result.emplace_back(library.name(global_routing.layer(region)),
+                units::unit_cast<double>(box.min_corner().x()), units::unit_cast<double>(box.min_corner().y()),
+                units::unit_cast<double>(box.max_corner().x()), units::unit_cast<double>(box.max_corner().y()));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST_CASE("GlobalRouter GCell grid follows the library", "[routing][global_router]")
+{
+    auto library = Library{};
+    make_library(library, 100);
+
+    auto router = GlobalRouter{library, area};
+    auto & grid = router.grid();
+
+    CHECK(grid.width() == 7);
+    CHECK(grid.height() == 7);
+    REQUIRE(grid.layers().size() == 3);
+    CHECK(grid.horizontal(0));
+    CHECK(!grid.horizontal(1));
+    CHECK(grid.capacity(1, GCell{3, 0}) == 15);
+    CHECK(grid.gcell(center(2, 5)) == GCell{2, 5});
+}
+
+TEST_CASE("GlobalRouter routes a two pin net", "[routing][global_router]")
+{
+    auto library = Library{};
+    make_library(library, 100);
+    auto netlist = ophidian::circuit::Netlist{};
+    auto net = netlist.add_net("n0");
+    auto global_routing = GlobalRouting{netlist};
+
+    auto router = GlobalRouter{library, area};
+    router.add_net(net, {center(0, 0), center(4, 2)});
+    router.route(global_routing);
+
+    CHECK(router.overflow() == 0);
+    CHECK(router.wirelength() == 6);
+
+    auto result = guides(library, global_routing, net);
+    REQUIRE(!result.empty());
+
+    // pins are reachable from the lowest layer and wires only use M2 and M3
+    CHECK(std::count(result.begin(), result.end(), guide_type{"M1", 0, 0, 1500, 1500}) == 1);
+    CHECK(std::count(result.begin(), result.end(), guide_type{"M1", 6000, 3000, 7500, 4500}) == 1);
+    for(const auto & guide : result)
+    {
+        auto spans_gcells = std::get<3>(guide) - std::get<1>(guide) > 1500 || std::get<4>(guide) - std::get<2>(guide) > 1500;
+        CHECK((!spans_gcells || std::get<0>(guide) != "M1"));
+    }
+}
+
+TEST_CASE("GlobalRouter removes overflow and is deterministic", "[routing][global_router]")
+{
+    auto library = Library{};
+    make_library(library, 1500);
+    auto netlist = ophidian::circuit::Netlist{};
+
+    auto nets = std::vector<ophidian::circuit::Net>{};
+    auto pins = std::vector<GlobalRouter::pin_container_type>{};
+    for(int i = 0; i < 4; ++i)
+    {
+        nets.push_back(netlist.add_net("n" + std::to_string(i)));
+        pins.push_back({center(0, i), center(6, i + 3)});
+    }
+    nets.push_back(netlist.add_net("n4"));
+    pins.push_back({center(1, 1), center(5, 5), center(1, 5), center(3, 0)});
+
+    auto run = [&](std::size_t threads, std::size_t batch_size){
+        auto global_routing = GlobalRouting{netlist};
+        auto parameters = GlobalRouter::Parameters{};
+        parameters.number_of_threads = threads;
+        parameters.batch_size = batch_size;
+        auto router = GlobalRouter{library, area, parameters};
+        for(std::size_t i = 0; i < nets.size(); ++i)
+        {
+            router.add_net(nets[i], pins[i]);
+        }
+        router.route(global_routing);
+        CHECK(router.overflow() == 0);
+
+        auto result = std::vector<std::vector<guide_type>>{};
+        for(auto net : nets)
+        {
+            result.push_back(guides(library, global_routing, net));
+        }
+        return result;
+    };
+
+    auto serial = run(1, 2);
+    auto parallel = run(4, 2);
+    CHECK(serial == parallel);
+
+    // an empty batch size routes one net at a time
+    CHECK(run(4, 0) == run(4, 1));
+}
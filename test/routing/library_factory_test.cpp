@@ -60,6 +60,26 @@ TEST_CASE("Library Factory Test", "[routing][library][factory]")
         CHECK(box.min_corner().y() == database_unit_t{-70});
         CHECK(box.max_corner().x() == database_unit_t{130});
         CHECK(box.max_corner().y() == database_unit_t{70});
+
+        auto metal2 = library.find_layer("Metal2");
+        auto& handle_box = library.geometry(via, metal2);
+        CHECK(handle_box.min_corner().x() == database_unit_t{-130});
+        CHECK(handle_box.max_corner().y() == database_unit_t{70});
+        CHECK(library.geometries(via).size() == 3);
+    }
+
+    SECTION("Via enclosures are grouped by cut layer", "[routing][library][factory]")
+    {
+        auto via1 = library.find_layer("Via1");
+        auto& enclosures = library.via_enclosures(via1);
+        CHECK(enclosures.size() == 3);
+        for(auto& enclosure : enclosures)
+        {
+            CHECK(library.name(enclosure.bottom_layer) == "Metal1");
+            CHECK(library.name(enclosure.top_layer) == "Metal2");
+            CHECK(enclosure.cut.max_corner().x() == database_unit_t{70});
+        }
+        CHECK(library.via_enclosures(library.find_layer("Metal1")).empty());
     }
 
     SECTION("Tracks are created correctly", "[routing][library][factory]")
@@ -72,5 +92,18 @@ TEST_CASE("Library Factory Test", "[routing][library][factory]")
         CHECK(library.space(track) == database_unit_t{400});
         CHECK(library.name(library.layer(track)) == "Metal9");
     }
-}
 
+    SECTION("Track grids are precomputed", "[routing][library][factory]")
+    {
+        auto metal9 = library.find_layer("Metal9");
+        auto& grid = library.track_grid(metal9);
+        CHECK(grid.axis(ophidian::routing::TrackOrientation::X).size() == 52);
+        CHECK(grid.axis(ophidian::routing::TrackOrientation::Y).size() == 25);
+        CHECK(grid.nearest_track(ophidian::routing::TrackOrientation::X, database_unit_t{84150}) == 1);
+        CHECK(grid.track_coordinate(ophidian::routing::TrackOrientation::X, 51) == database_unit_t{104200});
+
+        auto box = ophidian::routing::TrackGrid::box_type{{database_unit_t{83800}, database_unit_t{72770}}, {database_unit_t{84600}, database_unit_t{73530}}};
+        CHECK(grid.number_of_tracks(ophidian::routing::TrackOrientation::X, box) == 3);
+        CHECK(grid.number_of_tracks(box) == 5);
+    }
+}
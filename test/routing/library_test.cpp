@@ -0,0 +1,66 @@
+#include <catch.hpp>
+
+#include <ophidian/routing/Library.h>
+
+using namespace ophidian::routing;
+using ophidian::util::database_unit_t;
+
+namespace
+{
+    Library::layer_type add_layer(Library & library, const std::string & name, LayerType type)
+    {
+        auto zero = database_unit_t{0};
+        return library.add_layer(name, type, LayerDirection::NA, zero, zero, zero, zero, zero, zero, zero, zero, zero,
+            Library::spacing_table_type{Library::spacing_table_content_type{}});
+    }
+
+    Library::via_geometry_type box(double size)
+    {
+        return Library::via_geometry_type{{database_unit_t{-size}, database_unit_t{-size}}, {database_unit_t{size}, database_unit_t{size}}};
+    }
+}
+
+TEST_CASE("Library via geometries are keyed by layer handles", "[routing][library]")
+{
+    auto library = Library{};
+    auto metal1 = add_layer(library, "M1", LayerType::ROUTING);
+    auto cut1 = add_layer(library, "V1", LayerType::CUT);
+    auto metal2 = add_layer(library, "M2", LayerType::ROUTING);
+    auto cut2 = add_layer(library, "V2", LayerType::CUT);
+    auto metal3 = add_layer(library, "M3", LayerType::ROUTING);
+
+    auto via12 = library.add_via("VIA12", {{"M2", box(3)}, {"M1", box(2)}, {"V1", box(1)}});
+    auto via23 = library.add_via("VIA23", {{"V2", box(1)}, {"M3", box(4)}, {"M2", box(5)}});
+
+    SECTION("Handle and name lookups agree")
+    {
+        CHECK(library.geometry(via12, metal1).max_corner().x() == database_unit_t{2});
+        CHECK(library.geometry(via12, "M2").max_corner().x() == database_unit_t{3});
+        CHECK(library.geometry(via23, metal3).max_corner().x() == library.geometry(via23, "M3").max_corner().x());
+    }
+
+    SECTION("Geometries follow the layer stack")
+    {
+        auto& geometries = library.geometries(via23);
+        REQUIRE(geometries.size() == 3);
+        CHECK(geometries[0].first == metal2);
+        CHECK(geometries[1].first == cut2);
+        CHECK(geometries[2].first == metal3);
+    }
+
+    SECTION("Enclosures are grouped by cut layer")
+    {
+        REQUIRE(library.via_enclosures(cut1).size() == 1);
+        auto& enclosure = library.via_enclosures(cut1).front();
+        CHECK(enclosure.via == via12);
+        CHECK(enclosure.bottom_layer == metal1);
+        CHECK(enclosure.bottom.max_corner().x() == database_unit_t{2});
+        CHECK(enclosure.top_layer == metal2);
+        CHECK(enclosure.top.max_corner().x() == database_unit_t{3});
+        CHECK(enclosure.cut.max_corner().x() == database_unit_t{1});
+
+        REQUIRE(library.via_enclosures(cut2).size() == 1);
+        CHECK(library.via_enclosures(cut2).front().via == via23);
+        CHECK(library.via_enclosures(metal2).empty());
+    }
+}
@@ -0,0 +1,93 @@
+#include <catch.hpp>
+
+#include <ophidian/routing/TrackGrid.h>
+
+using namespace ophidian::routing;
+using ophidian::util::database_unit_t;
+
+TEST_CASE("TrackAxis uniform queries", "[routing][track_grid]")
+{
+    auto axis = TrackAxis{{TrackPattern{database_unit_t{100}, 10, database_unit_t{200}}}};
+
+    CHECK(axis.uniform());
+    CHECK(axis.size() == 10);
+    CHECK(axis.coordinate(3) == database_unit_t{700});
+
+    CHECK(axis.nearest(database_unit_t{-500}) == 0);
+    CHECK(axis.nearest(database_unit_t{190}) == 0);
+    CHECK(axis.nearest(database_unit_t{200}) == 1);
+    CHECK(axis.nearest(database_unit_t{5000}) == 9);
+
+    CHECK(axis.crossing(database_unit_t{100}, database_unit_t{500}) == TrackAxis::index_range_type{0, 3});
+    CHECK(axis.crossing(database_unit_t{101}, database_unit_t{499}) == TrackAxis::index_range_type{1, 2});
+    CHECK(axis.count(database_unit_t{320}, database_unit_t{380}) == 0);
+    CHECK(axis.count(database_unit_t{-1000}, database_unit_t{10000}) == 10);
+    CHECK(axis.count(database_unit_t{5000}, database_unit_t{6000}) == 0);
+}
+
+TEST_CASE("TrackAxis intervals ending on a track", "[routing][track_grid]")
+{
+    // 1.0 / 49 and 1.0 / 75 are inexact, the index math must not round across a track
+    auto axis49 = TrackAxis{{TrackPattern{database_unit_t{0}, 20, database_unit_t{49}}}};
+    CHECK(axis49.nearest(database_unit_t{49}) == 1);
+    CHECK(axis49.crossing(database_unit_t{49}, database_unit_t{49}) == TrackAxis::index_range_type{1, 2});
+    CHECK(axis49.count(database_unit_t{0}, database_unit_t{49}) == 2);
+
+    auto axis75 = TrackAxis{{TrackPattern{database_unit_t{0}, 20, database_unit_t{75}}}};
+    CHECK(axis75.crossing(database_unit_t{7 * 75}, database_unit_t{10 * 75}) == TrackAxis::index_range_type{7, 11});
+    CHECK(axis75.count(database_unit_t{7 * 75}, database_unit_t{7 * 75}) == 1);
+
+    for(auto space = 1; space <= 2000; ++space)
+    {
+        auto axis = TrackAxis{{TrackPattern{database_unit_t{0}, 20, database_unit_t{static_cast<double>(space)}}}};
+        for(auto index = 0; index < 20; ++index)
+        {
+            auto coordinate = database_unit_t{static_cast<double>(index * space)};
+            REQUIRE(axis.nearest(coordinate) == static_cast<TrackAxis::scalar_type>(index));
+            REQUIRE(axis.count(coordinate, coordinate) == 1);
+        }
+    }
+}
+
+TEST_CASE("TrackAxis merges contiguous patterns", "[routing][track_grid]")
+{
+    auto axis = TrackAxis{{
+        TrackPattern{database_unit_t{500}, 3, database_unit_t{100}},
+        TrackPattern{database_unit_t{0}, 5, database_unit_t{100}}
+    }};
+
+    CHECK(axis.uniform());
+    CHECK(axis.size() == 8);
+    CHECK(axis.coordinate(7) == database_unit_t{700});
+}
+
+TEST_CASE("TrackAxis with irregular patterns", "[routing][track_grid]")
+{
+    auto axis = TrackAxis{{
+        TrackPattern{database_unit_t{0}, 3, database_unit_t{100}},
+        TrackPattern{database_unit_t{1000}, 2, database_unit_t{50}}
+    }};
+
+    CHECK(!axis.uniform());
+    CHECK(axis.size() == 5);
+    CHECK(axis.coordinate(4) == database_unit_t{1050});
+    CHECK(axis.nearest(database_unit_t{590}) == 2);
+    CHECK(axis.nearest(database_unit_t{610}) == 3);
+    CHECK(axis.crossing(database_unit_t{150}, database_unit_t{1000}) == TrackAxis::index_range_type{2, 4});
+}
+
+TEST_CASE("TrackGrid counts tracks inside a box", "[routing][track_grid]")
+{
+    auto grid = TrackGrid{
+        TrackAxis{{TrackPattern{database_unit_t{0}, 10, database_unit_t{100}}}},
+        TrackAxis{{TrackPattern{database_unit_t{50}, 5, database_unit_t{200}}}}
+    };
+
+    auto box = TrackGrid::box_type{{database_unit_t{0}, database_unit_t{0}}, {database_unit_t{250}, database_unit_t{500}}};
+
+    CHECK(grid.number_of_tracks(TrackOrientation::X, box) == 3);
+    CHECK(grid.number_of_tracks(TrackOrientation::Y, box) == 3);
+    CHECK(grid.number_of_tracks(box) == 6);
+    CHECK(grid.nearest_track(TrackOrientation::Y, database_unit_t{1000}) == 4);
+    CHECK(TrackGrid{}.nearest_track(TrackOrientation::X, database_unit_t{0}) == TrackAxis::npos);
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+
+#include <ophidian/timing/Elmore.h>
+
+using namespace ophidian::timing;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    Elmore::point_type point(double x, double y)
+    {
+        return Elmore::point_type{dbu_t{x}, dbu_t{y}};
+    }
+
+    // horizontal wire of 0.01 kiloohm and 0.02 fF per unit, vertical of 0.02 kiloohm and 0.01 fF
+    Elmore make_elmore()
+    {
+        return Elmore{Elmore::resistance_type{0.01}, Elmore::capacitance_type{0.02}, Elmore::resistance_type{0.02}, Elmore::capacitance_type{0.01}};
+    }
+}
+
+TEST_CASE("Elmore delays of a branching tree", "[timing][elmore]")
+{
+    // (0, 0) -> (100, 0) -> (100, 50) and (100, 0) -> (200, 0)
+    auto tree = Elmore::Tree{};
+    tree.points = {point(0, 0), point(100, 0), point(100, 50), point(200, 0)};
+    tree.segments = {{0, 1}, {2, 1}, {1, 3}};
+    auto loads = std::vector<double>{0.0, 0.0, 3.0, 2.0};
+
+    auto elmore = make_elmore();
+    auto scratch = Elmore::Scratch{};
+    elmore.compute(tree, 0, loads, scratch);
+
+    CHECK(scratch.capacitance == Approx(4.5));
+    CHECK(scratch.downstream[0] == Approx(9.5));
+    CHECK(scratch.downstream[1] == Approx(8.5));
+    CHECK(scratch.downstream[2] == Approx(3.25));
+    CHECK(scratch.downstream[3] == Approx(3.0));
+    CHECK(scratch.delays[0] == Approx(0.0));
+    CHECK(scratch.delays[1] == Approx(8.5));
+    CHECK(scratch.delays[2] == Approx(11.75));
+    CHECK(scratch.delays[3] == Approx(11.5));
+
+    SECTION("The scratch is reused from another root")
+    {
+        elmore.compute(tree, 3, std::vector<double>{4.0, 0.0, 3.0, 0.0}, scratch);
+        CHECK(scratch.downstream[3] == Approx(11.5));
+        CHECK(scratch.delays[3] == Approx(0.0));
+        CHECK(scratch.delays[1] == Approx(10.5));
+        CHECK(scratch.delays[0] == Approx(10.5 + 1.0 * 5.0));
+        CHECK(scratch.delays[2] == Approx(10.5 + 1.0 * 3.25));
+    }
+}
+
+TEST_CASE("Elmore reads layer parasitics and Steiner trees", "[timing][elmore]")
+{
+    auto library = ophidian::routing::Library{};
+    auto zero = dbu_t{0};
+    auto table = ophidian::routing::Library::spacing_table_type{ophidian::routing::Library::spacing_table_content_type{}};
+    auto m1 = library.add_layer("M1", ophidian::routing::LayerType::ROUTING, ophidian::routing::LayerDirection::HORIZONTAL, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+    auto m2 = library.add_layer("M2", ophidian::routing::LayerType::ROUTING, ophidian::routing::LayerDirection::VERTICAL, zero, zero, zero, zero, zero, zero, zero, zero, zero, table);
+    library.resistance(m1) = Elmore::resistance_type{0.01};
+    library.capacitance(m1) = Elmore::capacitance_type{0.02};
+    library.resistance(m2) = Elmore::resistance_type{0.02};
+    library.capacitance(m2) = Elmore::capacitance_type{0.01};
+
+    auto steiner = ophidian::interconnection::SteinerTree::create();
+    auto a = steiner->add(point(0, 0));
+    auto b = steiner->add(point(100, 0));
+    steiner->add(a, b);
+    steiner->add(b, steiner->add(point(100, 50)));
+    steiner->add(steiner->add(point(200, 0)), b);
+
+    auto tree = Elmore::flatten(*steiner);
+    REQUIRE(tree.points.size() == 4);
+    REQUIRE(tree.segments.size() == 3);
+    CHECK(tree.points[2].y() == dbu_t{50});
+
+    auto elmore = Elmore{library, m1, m2};
+    auto scratch = Elmore::Scratch{};
+    elmore.compute(tree, 0, std::vector<double>{0.0, 0.0, 3.0, 2.0}, scratch);
+    CHECK(scratch.capacitance == Approx(4.5));
+    CHECK(scratch.delays[2] == Approx(11.75));
+    CHECK(scratch.delays[3] == Approx(11.5));
+}
@@ -0,0 +1,67 @@
+#include <catch.hpp>
+
+#include <ophidian/circuit/StandardCellsFactory.h>
+#include <ophidian/timing/LibraryFactory.h>
+
+using namespace ophidian::timing;
+
+TEST_CASE("Timing library factory: populate with simple lib.", "[timing][library][factory]")
+{
+    auto std_cells = ophidian::circuit::StandardCells{};
+    auto lef = ophidian::parser::Lef{"input_files/simple/simple.lef"};
+    ophidian::circuit::factory::make_standard_cells(std_cells, lef);
+
+    auto liberty = ophidian::parser::Liberty{"input_files/simple/simple.lib"};
+    auto library = Library{std_cells};
+    factory::make_library(library, liberty, std_cells);
+
+    using time_type = Library::time_type;
+    using capacitance_type = Library::capacitance_type;
+    auto value = [](const time_type & time){ return units::unit_cast<double>(time); };
+
+    SECTION("Pin capacitances")
+    {
+        CHECK(units::unit_cast<double>(library.capacitance(std_cells.find_pin("INV_X1:a"))) == Approx(1.0));
+        CHECK(units::unit_cast<double>(library.capacitance(std_cells.find_pin("NAND2_X1:b"))) == Approx(2.0));
+        CHECK(units::unit_cast<double>(library.capacitance(std_cells.find_pin("DFF_X80:ck"))) == Approx(2.0));
+    }
+
+    SECTION("Delay tables are indexed by load and slew")
+    {
+        auto output = std_cells.find_pin("INV_X1:o");
+        REQUIRE(library.arcs(output).size() == 1);
+        auto arc = library.arcs(output).front();
+        CHECK(library.from(arc) == std_cells.find_pin("INV_X1:a"));
+        CHECK(library.sense(arc) == TimingSense::NEGATIVE_UNATE);
+        CHECK(library.type(arc) == TimingType::COMBINATIONAL);
+        CHECK(value(library.cell_rise(arc).compute(capacitance_type{10.0}, time_type{10.0})) == Approx(30.0));
+        CHECK(value(library.cell_rise(arc).compute(capacitance_type{0.0}, time_type{110.0})) == Approx(20.0));
+        CHECK(value(library.cell_fall(arc).compute(capacitance_type{5.0}, time_type{60.0})) == Approx(23.0));
+
+        auto scalar = library.arcs(std_cells.find_pin("INV_Z80:o")).front();
+        CHECK(value(library.cell_rise(scalar).compute(capacitance_type{3.0}, time_type{40.0})) == Approx(5.0));
+    }
+
+    SECTION("Related pin lists create one arc per pin")
+    {
+        CHECK(library.arcs(std_cells.find_pin("NOR2_X1:o")).size() == 2);
+        CHECK(library.arcs(std_cells.find_pin("NAND2_X1:o")).size() == 2);
+    }
+
+    SECTION("Sequential arcs and checks")
+    {
+        auto q = library.arcs(std_cells.find_pin("DFF_X80:q"));
+        REQUIRE(q.size() == 1);
+        CHECK(library.type(q.front()) == TimingType::RISING_EDGE);
+        CHECK(value(library.rise_transition(q.front()).compute(capacitance_type{20.0}, time_type{10.0})) == Approx(30.0));
+        CHECK(library.clock(std_cells.find_pin("DFF_X80:ck")));
+        CHECK(!library.clock(std_cells.find_pin("DFF_X80:d")));
+
+        auto d = library.arcs(std_cells.find_pin("DFF_X80:d"));
+        REQUIRE(d.size() == 2);
+        auto setup = library.type(d[0]) == TimingType::SETUP_RISING ? d[0] : d[1];
+        CHECK(library.type(setup) == TimingType::SETUP_RISING);
+        CHECK(value(library.rise_constraint(setup).compute(time_type{0.0}, time_type{100.0})) == Approx(30.0));
+        CHECK(value(library.rise_constraint(setup).compute(time_type{100.0}, time_type{0.0})) == Approx(25.0));
+    }
+}
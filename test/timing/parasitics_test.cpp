@@ -0,0 +1,171 @@
+#include <catch.hpp>
+
+#include <ophidian/timing/Parasitics.h>
+
+using namespace ophidian::timing;
+using ophidian::circuit::PinDirection;
+using dbu_t = ophidian::util::database_unit_t;
+
+namespace
+{
+    ophidian::util::LocationDbu point(double x, double y)
+    {
+        return ophidian::util::LocationDbu{dbu_t{x}, dbu_t{y}};
+    }
+
+    // in (0, 0) -> u1 (1000, 0) -> u2 (1000, 2000) and out (3000, 500)
+    class ParasiticsFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::circuit::Netlist netlist;
+        Library library{std_cells};
+        ophidian::placement::Library placement_library{std_cells};
+        ophidian::placement::Placement placement{netlist, placement_library};
+        ophidian::circuit::CellInstance u1, u2;
+        ophidian::circuit::PinInstance u1_a, u1_z, u2_a, out;
+        ophidian::circuit::Net n0, n1;
+
+        ParasiticsFixture()
+        {
+            auto inv = std_cells.add_cell("INV");
+            auto inv_a = std_cells.add_pin("INV:a", PinDirection::INPUT);
+            auto inv_z = std_cells.add_pin("INV:z", PinDirection::OUTPUT);
+            std_cells.connect(inv, inv_a);
+            std_cells.connect(inv, inv_z);
+            library.capacitance(inv_a) = Library::capacitance_type{2.0};
+            library.add_timing_arc(inv_a, inv_z, TimingSense::NEGATIVE_UNATE, TimingType::COMBINATIONAL);
+
+            auto in = netlist.add_pin_instance("in");
+            placement.place(netlist.add_input_pad(in), point(0, 0));
+            out = netlist.add_pin_instance("out");
+            placement.place(netlist.add_output_pad(out), point(3000, 500));
+
+            auto add_pin = [&](const ophidian::circuit::CellInstance & cell, const ophidian::circuit::Pin & std_pin, const std::string & name){
+                auto pin = netlist.add_pin_instance(name);
+                netlist.connect(cell, pin);
+                netlist.connect(pin, std_pin);
+                return pin;
+            };
+            u1 = netlist.add_cell_instance("u1");
+            netlist.connect(u1, inv);
+            u1_a = add_pin(u1, inv_a, "u1:a");
+            u1_z = add_pin(u1, inv_z, "u1:z");
+            u2 = netlist.add_cell_instance("u2");
+            netlist.connect(u2, inv);
+            u2_a = add_pin(u2, inv_a, "u2:a");
+            add_pin(u2, inv_z, "u2:z");
+            placement.place(u1, point(1000, 0));
+            placement.place(u2, point(1000, 2000));
+
+            n0 = netlist.add_net("n0");
+            netlist.connect(n0, in);
+            netlist.connect(n0, u1_a);
+            n1 = netlist.add_net("n1");
+            netlist.connect(n1, u1_z);
+            netlist.connect(n1, u2_a);
+            netlist.connect(n1, out);
+        }
+    };
+
+    Parasitics::Parameters parameters()
+    {
+        auto result = Parasitics::Parameters{};
+        result.resistance = Parasitics::resistance_type{1e-3};
+        result.capacitance = Parasitics::capacitance_type{1e-3};
+        return result;
+    }
+}
+
+TEST_CASE_METHOD(ParasiticsFixture, "Parasitics estimates half perimeter wires", "[timing][parasitics]")
+{
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto parasitics = Parasitics{graph, netlist, placement, parameters()};
+    auto driver = graph.vertex(u1_z);
+    REQUIRE(parasitics.driver(n1) == driver);
+    CHECK(units::unit_cast<double>(parasitics.capacitance(driver)) == Approx(0.0));
+
+    parasitics.update();
+
+    // 4000 units of wire, 4 kiloohm driving 2 fF of wire and the sink pin
+    CHECK(units::unit_cast<double>(parasitics.capacitance(driver)) == Approx(4.0));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(u2_a)))) == Approx(16.0));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(out)))) == Approx(8.0));
+    CHECK(units::unit_cast<double>(parasitics.capacitance(parasitics.driver(n0))) == Approx(1.0));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(u1_a)))) == Approx(2.5));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(u1_z)))) == Approx(0.0));
+}
+
+TEST_CASE_METHOD(ParasiticsFixture, "Parasitics only estimates the invalidated nets again", "[timing][parasitics]")
+{
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto parasitics = Parasitics{graph, netlist, placement, parameters()};
+    parasitics.update();
+    CHECK(parasitics.update_dirty().empty());
+
+    // moving inside the bounding box keeps the wire
+    placement.place(u2, point(2000, 2000));
+    parasitics.invalidate(u2);
+    CHECK(parasitics.update_dirty().empty());
+
+    placement.place(u2, point(2000, 1000));
+    CHECK(parasitics.update_dirty().empty());
+    CHECK(units::unit_cast<double>(parasitics.capacitance(graph.vertex(u1_z))) == Approx(4.0));
+
+    parasitics.invalidate(u2);
+    parasitics.invalidate(n1);
+    auto drivers = parasitics.update_dirty();
+    REQUIRE(drivers.size() == 1);
+    CHECK(drivers.front() == graph.vertex(u1_z));
+    CHECK(units::unit_cast<double>(parasitics.capacitance(drivers.front())) == Approx(3.0));
+    CHECK(parasitics.update_dirty().empty());
+}
+
+TEST_CASE_METHOD(ParasiticsFixture, "Parasitics attached to the placement follows the moves", "[timing][parasitics]")
+{
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto parasitics = Parasitics{graph, netlist, placement, parameters()};
+    parasitics.update();
+    parasitics.attach();
+    CHECK(parasitics.attached());
+
+    placement.place(u2, point(2000, 1000));
+    auto drivers = parasitics.update_dirty();
+    REQUIRE(drivers.size() == 1);
+    CHECK(drivers.front() == graph.vertex(u1_z));
+    CHECK(units::unit_cast<double>(parasitics.capacitance(drivers.front())) == Approx(3.0));
+
+    // a transaction invalidates the nets when it is flushed
+    placement.begin();
+    placement.place(u1, point(0, 0));
+    CHECK(parasitics.update_dirty().empty());
+    placement.commit();
+    CHECK(parasitics.update_dirty().size() == 2);
+
+    parasitics.detach();
+    placement.place(u2, point(1000, 2000));
+    CHECK(parasitics.update_dirty().empty());
+}
+
+TEST_CASE_METHOD(ParasiticsFixture, "Parasitics computes Elmore delays over Steiner trees", "[timing][parasitics]")
+{
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto elmore = Elmore{Elmore::resistance_type{1e-3}, Elmore::capacitance_type{1e-3}, Elmore::resistance_type{1e-3}, Elmore::capacitance_type{1e-3}};
+    auto parasitics = Parasitics{graph, netlist, placement, elmore};
+    parasitics.update();
+
+    // the Steiner point of n1 is (1000, 500), 500 units from the driver
+    auto driver = graph.vertex(u1_z);
+    CHECK(units::unit_cast<double>(parasitics.capacitance(driver)) == Approx(4.0));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(u2_a)))) == Approx(0.5 * 5.75 + 1.5 * 2.75));
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(out)))) == Approx(0.5 * 5.75 + 2.0 * 1.0));
+
+    // a two pin net is a single segment driving the pin
+    CHECK(units::unit_cast<double>(parasitics.delay(graph.fanin_begin(graph.vertex(u1_a)))) == Approx(1.0 * (0.5 + 2.0)));
+
+    placement.place(u2, point(1000, 1000));
+    parasitics.invalidate(u2);
+    auto drivers = parasitics.update_dirty();
+    REQUIRE(drivers.size() == 1);
+    CHECK(units::unit_cast<double>(parasitics.capacitance(driver)) == Approx(3.0));
+}
@@ -0,0 +1,332 @@
+#include <catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ophidian/timing/StaticTimingAnalysis.h>
+
+using namespace ophidian::timing;
+using ophidian::circuit::PinDirection;
+
+namespace
+{
+    using time_type = Library::time_type;
+    using capacitance_type = Library::capacitance_type;
+
+    // base + load_slope * load + slew_slope * slew over loads {0, 10} and slews {0, 100}
+    Library::delay_table_type delay_table(double base, double load_slope, double slew_slope)
+    {
+        auto contents = Library::delay_contents_type{};
+        contents.row_values = {capacitance_type{0.0}, capacitance_type{10.0}};
+        contents.column_values = {time_type{0.0}, time_type{100.0}};
+        for(auto load : {0.0, 10.0})
+        {
+            contents.values.push_back({time_type{base + load_slope * load}, time_type{base + load_slope * load + slew_slope * 100.0}});
+        }
+        return Library::delay_table_type{contents};
+    }
+
+    Library::constraint_table_type constraint_table(double value)
+    {
+        auto contents = Library::constraint_contents_type{};
+        contents.row_values = {time_type{0.0}, time_type{100.0}};
+        contents.column_values = {time_type{0.0}, time_type{100.0}};
+        contents.values = {{time_type{value}, time_type{value}}, {time_type{value}, time_type{value}}};
+        return Library::constraint_table_type{contents};
+    }
+
+    // INV: a (2fF) -> z, rise 10 + 2 load + 0.1 slew, fall 5
+    // DFF: d (1fF), ck (1fF) -> q rise 50 fall 40, setup rise 30 fall 20
+    class TimingFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::circuit::Netlist netlist;
+        Library library{std_cells};
+        ophidian::placement::Library placement_library{std_cells};
+        ophidian::placement::Placement placement{netlist, placement_library};
+        ophidian::circuit::Cell inv;
+        ophidian::circuit::Cell dff;
+        ophidian::circuit::Pin inv_a, inv_z, dff_d, dff_ck, dff_q;
+
+        TimingFixture()
+        {
+            inv = std_cells.add_cell("INV");
+            inv_a = std_cells.add_pin("INV:a", PinDirection::INPUT);
+            inv_z = std_cells.add_pin("INV:z", PinDirection::OUTPUT);
+            std_cells.connect(inv, inv_a);
+            std_cells.connect(inv, inv_z);
+            dff = std_cells.add_cell("DFF");
+            dff_d = std_cells.add_pin("DFF:d", PinDirection::INPUT);
+            dff_ck = std_cells.add_pin("DFF:ck", PinDirection::INPUT);
+            dff_q = std_cells.add_pin("DFF:q", PinDirection::OUTPUT);
+            std_cells.connect(dff, dff_d);
+            std_cells.connect(dff, dff_ck);
+            std_cells.connect(dff, dff_q);
+
+            library.capacitance(inv_a) = capacitance_type{2.0};
+            library.capacitance(dff_d) = capacitance_type{1.0};
+            library.capacitance(dff_ck) = capacitance_type{1.0};
+
+            auto arc = library.add_timing_arc(inv_a, inv_z, TimingSense::NEGATIVE_UNATE, TimingType::COMBINATIONAL);
+            library.cell_rise(arc) = delay_table(10.0, 2.0, 0.1);
+            library.cell_fall(arc) = delay_table(5.0, 0.0, 0.0);
+            library.rise_transition(arc) = delay_table(20.0, 0.0, 0.0);
+            library.fall_transition(arc) = delay_table(10.0, 0.0, 0.0);
+
+            arc = library.add_timing_arc(dff_ck, dff_q, TimingSense::NON_UNATE, TimingType::RISING_EDGE);
+            library.cell_rise(arc) = delay_table(50.0, 0.0, 0.0);
+            library.cell_fall(arc) = delay_table(40.0, 0.0, 0.0);
+            library.rise_transition(arc) = delay_table(10.0, 0.0, 0.0);
+            library.fall_transition(arc) = delay_table(10.0, 0.0, 0.0);
+
+            arc = library.add_timing_arc(dff_ck, dff_d, TimingSense::NON_UNATE, TimingType::SETUP_RISING);
+            library.rise_constraint(arc) = constraint_table(30.0);
+            library.fall_constraint(arc) = constraint_table(20.0);
+        }
+
+        ophidian::circuit::CellInstance add_cell(const std::string & name, const ophidian::circuit::Cell & std_cell)
+        {
+            auto cell = netlist.add_cell_instance(name);
+            netlist.connect(cell, std_cell);
+            return cell;
+        }
+
+        ophidian::circuit::PinInstance add_pin(const ophidian::circuit::CellInstance & cell, const ophidian::circuit::Pin & std_pin, const std::string & name)
+        {
+            auto pin = netlist.add_pin_instance(name);
+            netlist.connect(cell, pin);
+            netlist.connect(pin, std_pin);
+            return pin;
+        }
+        // inverters and registers fed by the earlier ones, 8 input pads and 16 output pads
+        std::vector<ophidian::circuit::PinInstance> random_network(int size)
+        {
+            auto generator = std::mt19937{7};
+            auto drivers = std::vector<ophidian::circuit::Net>{};
+            auto clock = netlist.add_pin_instance("clk");
+            netlist.add_input_pad(clock);
+            auto clock_net = netlist.add_net("clk");
+            netlist.connect(clock_net, clock);
+            for(int i = 0; i < 8; ++i)
+            {
+                auto pad = netlist.add_pin_instance("in" + std::to_string(i));
+                netlist.add_input_pad(pad);
+                drivers.push_back(netlist.add_net("in" + std::to_string(i)));
+                netlist.connect(drivers.back(), pad);
+            }
+
+            auto pins = std::vector<ophidian::circuit::PinInstance>{};
+            for(int i = 0; i < size; ++i)
+            {
+                auto name = "u" + std::to_string(i);
+                auto pick = std::uniform_int_distribution<std::size_t>{0, drivers.size() - 1}(generator);
+                if(i % 100 == 99)
+                {
+                    auto cell = add_cell(name, dff);
+                    netlist.connect(drivers[pick], add_pin(cell, dff_d, name + ":d"));
+                    netlist.connect(clock_net, add_pin(cell, dff_ck, name + ":ck"));
+                    pins.push_back(add_pin(cell, dff_q, name + ":q"));
+                }
+                else
+                {
+                    auto cell = add_cell(name, inv);
+                    netlist.connect(drivers[pick], add_pin(cell, inv_a, name + ":a"));
+                    pins.push_back(add_pin(cell, inv_z, name + ":z"));
+                }
+                drivers.push_back(netlist.add_net(name));
+                netlist.connect(drivers.back(), pins.back());
+            }
+            for(int i = 0; i < 16; ++i)
+            {
+                auto pad = netlist.add_pin_instance("out" + std::to_string(i));
+                netlist.add_output_pad(pad);
+                netlist.connect(drivers[drivers.size() - 1 - i], pad);
+            }
+            return pins;
+        }
+    };
+}
+
+TEST_CASE_METHOD(TimingFixture, "StaticTimingAnalysis times a register to register path", "[timing][static_timing_analysis]")
+{
+    // in -> u1 -> ff.d, clk -> ff.ck, ff.q -> u2 -> out
+    auto in = netlist.add_pin_instance("in");
+    netlist.add_input_pad(in);
+    auto clk = netlist.add_pin_instance("clk");
+    netlist.add_input_pad(clk);
+    auto out = netlist.add_pin_instance("out");
+    netlist.add_output_pad(out);
+
+    auto u1 = add_cell("u1", inv);
+    auto u1_a = add_pin(u1, inv_a, "u1:a");
+    auto u1_z = add_pin(u1, inv_z, "u1:z");
+    auto ff = add_cell("ff", dff);
+    auto ff_d = add_pin(ff, dff_d, "ff:d");
+    auto ff_ck = add_pin(ff, dff_ck, "ff:ck");
+    auto ff_q = add_pin(ff, dff_q, "ff:q");
+    auto u2 = add_cell("u2", inv);
+    auto u2_a = add_pin(u2, inv_a, "u2:a");
+    auto u2_z = add_pin(u2, inv_z, "u2:z");
+
+    auto connect = [&](const std::string & name, std::initializer_list<ophidian::circuit::PinInstance> pins){
+        auto net = netlist.add_net(name);
+        for(auto pin : pins)
+        {
+            netlist.connect(net, pin);
+        }
+    };
+    connect("n0", {in, u1_a});
+    connect("n1", {u1_z, ff_d});
+    connect("clk", {clk, ff_ck});
+    connect("n2", {ff_q, u2_a});
+    connect("n3", {u2_z, out});
+
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto parameters = StaticTimingAnalysis::Parameters{};
+    parameters.clock_period = time_type{100.0};
+    parameters.input_delay = time_type{100.0};
+    parameters.output_load = capacitance_type{4.0};
+    auto sta = StaticTimingAnalysis{graph, library, parameters};
+    sta.update();
+
+    auto value = [](const time_type & time){ return units::unit_cast<double>(time); };
+
+    SECTION("Loads sum the sink capacitances")
+    {
+        CHECK(units::unit_cast<double>(sta.load(u1_z)) == Approx(1.0));
+        CHECK(units::unit_cast<double>(sta.load(ff_q)) == Approx(2.0));
+        CHECK(units::unit_cast<double>(sta.load(u2_z)) == Approx(4.0));
+    }
+
+    SECTION("Arrivals follow the arc senses")
+    {
+        CHECK(value(sta.rise_arrival(u1_a)) == Approx(100.0));
+        CHECK(value(sta.rise_arrival(u1_z)) == Approx(112.0));
+        CHECK(value(sta.fall_arrival(u1_z)) == Approx(105.0));
+        CHECK(value(sta.rise_slew(ff_d)) == Approx(20.0));
+        CHECK(value(sta.fall_slew(ff_d)) == Approx(10.0));
+
+        CHECK(value(sta.rise_arrival(ff_ck)) == Approx(0.0));
+        CHECK(value(sta.fall_arrival(ff_ck)) == Approx(50.0));
+        CHECK(value(sta.rise_arrival(ff_q)) == Approx(50.0));
+        CHECK(value(sta.fall_arrival(ff_q)) == Approx(40.0));
+
+        // the rising output is driven by the falling input, 10 + 2 * 4 + 0.1 * 10
+        CHECK(value(sta.rise_arrival(u2_z)) == Approx(59.0));
+        CHECK(value(sta.fall_arrival(out)) == Approx(55.0));
+    }
+
+    SECTION("Required times come from the setup checks and the output pads")
+    {
+        CHECK(value(sta.rise_required(ff_d)) == Approx(70.0));
+        CHECK(value(sta.fall_required(ff_d)) == Approx(80.0));
+        CHECK(value(sta.rise_required(u1_a)) == Approx(75.0));
+        CHECK(value(sta.fall_required(u1_a)) == Approx(58.0));
+        CHECK(value(sta.rise_required(out)) == Approx(100.0));
+
+        CHECK(value(sta.slack(u1_a)) == Approx(-42.0));
+        CHECK(value(sta.slack(ff_d)) == Approx(-42.0));
+        CHECK(value(sta.slack(out)) == Approx(41.0));
+    }
+
+    SECTION("Endpoint summary")
+    {
+        CHECK(value(sta.worst_slack()) == Approx(-42.0));
+        CHECK(value(sta.total_negative_slack()) == Approx(-42.0));
+        CHECK(sta.critical_endpoint() == ff_d);
+    }
+}
+
+TEST_CASE_METHOD(TimingFixture, "StaticTimingAnalysis does not depend on the number of threads", "[timing][static_timing_analysis]")
+{
+    auto pins = random_network(3000);
+
+    auto graph = TimingGraph{netlist, std_cells, library};
+    CHECK(graph.loops() == 0);
+
+    auto run = [&](std::size_t threads){
+        auto parameters = StaticTimingAnalysis::Parameters{};
+        parameters.clock_period = time_type{150.0};
+        parameters.number_of_threads = threads;
+        auto sta = StaticTimingAnalysis{graph, library, parameters};
+        sta.update();
+        auto result = std::vector<double>{units::unit_cast<double>(sta.worst_slack()), units::unit_cast<double>(sta.total_negative_slack())};
+        for(auto pin : pins)
+        {
+            result.push_back(units::unit_cast<double>(sta.rise_arrival(pin)));
+            result.push_back(units::unit_cast<double>(sta.fall_required(pin)));
+        }
+        return result;
+    };
+
+    auto serial = run(1);
+    auto parallel = run(4);
+    CHECK(serial[0] < 0.0);
+    CHECK(serial == parallel);
+}
+
+TEST_CASE_METHOD(TimingFixture, "StaticTimingAnalysis incremental update matches a full update", "[timing][static_timing_analysis]")
+{
+    auto pins = random_network(600);
+    auto generator = std::mt19937{11};
+    auto coordinate = std::uniform_real_distribution<double>{0.0, 100000.0};
+    auto random_point = [&](){
+        return ophidian::util::LocationDbu{ophidian::util::database_unit_t{coordinate(generator)}, ophidian::util::database_unit_t{coordinate(generator)}};
+    };
+    auto cells = std::vector<ophidian::circuit::CellInstance>(netlist.begin_cell_instance(), netlist.end_cell_instance());
+    for(auto cell : cells)
+    {
+        placement.place(cell, random_point());
+    }
+    for(auto pad = netlist.begin_input_pad(); pad != netlist.end_input_pad(); ++pad)
+    {
+        placement.place(*pad, random_point());
+    }
+    for(auto pad = netlist.begin_output_pad(); pad != netlist.end_output_pad(); ++pad)
+    {
+        placement.place(*pad, random_point());
+    }
+
+    auto graph = TimingGraph{netlist, std_cells, library};
+    auto wires = Parasitics::Parameters{};
+    wires.resistance = Parasitics::resistance_type{1e-5};
+    auto parameters = StaticTimingAnalysis::Parameters{};
+    parameters.clock_period = time_type{150.0};
+    parameters.output_load = capacitance_type{4.0};
+
+    auto parasitics = Parasitics{graph, netlist, placement, wires};
+    auto sta = StaticTimingAnalysis{graph, library, parasitics, parameters};
+    sta.update();
+
+    auto values = [&](const StaticTimingAnalysis & analysis){
+        auto result = std::vector<double>{units::unit_cast<double>(analysis.worst_slack()), units::unit_cast<double>(analysis.total_negative_slack())};
+        for(auto pin = netlist.begin_pin_instance(); pin != netlist.end_pin_instance(); ++pin)
+        {
+            result.push_back(units::unit_cast<double>(analysis.rise_arrival(*pin)));
+            result.push_back(units::unit_cast<double>(analysis.fall_arrival(*pin)));
+            result.push_back(units::unit_cast<double>(analysis.rise_slew(*pin)));
+            result.push_back(units::unit_cast<double>(analysis.rise_required(*pin)));
+            result.push_back(units::unit_cast<double>(analysis.fall_required(*pin)));
+        }
+        return result;
+    };
+
+    auto timed = std::size_t{0};
+    for(int move = 0; move < 20; ++move)
+    {
+        auto cell = cells[std::uniform_int_distribution<std::size_t>{0, cells.size() - 1}(generator)];
+        placement.place(cell, random_point());
+        parasitics.invalidate(cell);
+        timed += sta.update_incremental();
+
+        auto full_parasitics = Parasitics{graph, netlist, placement, wires};
+        auto full = StaticTimingAnalysis{graph, library, full_parasitics, parameters};
+        full.update();
+        REQUIRE(values(sta) == values(full));
+    }
+
+    // a move only times its cones again
+    CHECK(timed < 20 * graph.size_vertex() / 4);
+    CHECK(sta.update_incremental() == 0);
+}
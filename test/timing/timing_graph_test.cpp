@@ -0,0 +1,162 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ophidian/timing/TimingGraph.h>
+
+using namespace ophidian::timing;
+using ophidian::circuit::PinDirection;
+
+namespace
+{
+    // INV a -> z and DFF ck -> q with a setup check ck -> d
+    class TimingGraphFixture
+    {
+    public:
+        ophidian::circuit::StandardCells std_cells;
+        ophidian::circuit::Netlist netlist;
+        Library library{std_cells};
+        ophidian::circuit::Cell inv, dff;
+        ophidian::circuit::Pin inv_a, inv_z, dff_d, dff_ck, dff_q;
+
+        TimingGraphFixture()
+        {
+            inv = std_cells.add_cell("INV");
+            inv_a = std_cells.add_pin("INV:a", PinDirection::INPUT);
+            inv_z = std_cells.add_pin("INV:z", PinDirection::OUTPUT);
+            std_cells.connect(inv, inv_a);
+            std_cells.connect(inv, inv_z);
+            dff = std_cells.add_cell("DFF");
+            dff_d = std_cells.add_pin("DFF:d", PinDirection::INPUT);
+            dff_ck = std_cells.add_pin("DFF:ck", PinDirection::INPUT);
+            dff_q = std_cells.add_pin("DFF:q", PinDirection::OUTPUT);
+            std_cells.connect(dff, dff_d);
+            std_cells.connect(dff, dff_ck);
+            std_cells.connect(dff, dff_q);
+
+            library.capacitance(inv_a) = Library::capacitance_type{2.0};
+            library.add_timing_arc(inv_a, inv_z, TimingSense::NEGATIVE_UNATE, TimingType::COMBINATIONAL);
+            library.add_timing_arc(dff_ck, dff_q, TimingSense::NON_UNATE, TimingType::RISING_EDGE);
+            library.add_timing_arc(dff_ck, dff_d, TimingSense::NON_UNATE, TimingType::SETUP_RISING);
+        }
+
+        ophidian::circuit::PinInstance add_pin(const ophidian::circuit::CellInstance & cell, const ophidian::circuit::Pin & std_pin, const std::string & name)
+        {
+            auto pin = netlist.add_pin_instance(name);
+            netlist.connect(cell, pin);
+            netlist.connect(pin, std_pin);
+            return pin;
+        }
+
+        ophidian::circuit::Net connect(const std::string & name, std::initializer_list<ophidian::circuit::PinInstance> pins)
+        {
+            auto net = netlist.add_net(name);
+            for(auto pin : pins)
+            {
+                netlist.connect(net, pin);
+            }
+            return net;
+        }
+    };
+}
+
+TEST_CASE_METHOD(TimingGraphFixture, "TimingGraph levelizes a register path", "[timing][timing_graph]")
+{
+    auto in = netlist.add_pin_instance("in");
+    netlist.add_input_pad(in);
+    auto clk = netlist.add_pin_instance("clk");
+    netlist.add_input_pad(clk);
+    auto out = netlist.add_pin_instance("out");
+    netlist.add_output_pad(out);
+
+    auto u1 = netlist.add_cell_instance("u1");
+    netlist.connect(u1, inv);
+    auto u1_a = add_pin(u1, inv_a, "u1:a");
+    auto u1_z = add_pin(u1, inv_z, "u1:z");
+    auto ff = netlist.add_cell_instance("ff");
+    netlist.connect(ff, dff);
+    auto ff_d = add_pin(ff, dff_d, "ff:d");
+    auto ff_ck = add_pin(ff, dff_ck, "ff:ck");
+    auto ff_q = add_pin(ff, dff_q, "ff:q");
+
+    connect("n0", {in, u1_a});
+    connect("n1", {u1_z, ff_d});
+    connect("clk", {clk, ff_ck});
+    connect("n2", {ff_q, out});
+
+    auto graph = TimingGraph{netlist, std_cells, library};
+
+    CHECK(graph.size_vertex() == 8);
+    // in -> u1:a -> u1:z -> ff:d, ff:ck -> ff:q -> out; the ideal clock net has no arcs
+    CHECK(graph.size_arc() == 5);
+    CHECK(graph.kind(graph.vertex(in)) == VertexKind::INPUT);
+    CHECK(graph.kind(graph.vertex(ff_ck)) == VertexKind::CLOCK);
+    CHECK(graph.kind(graph.vertex(out)) == VertexKind::OUTPUT);
+    CHECK(graph.kind(graph.vertex(u1_z)) == VertexKind::PIN);
+    CHECK(units::unit_cast<double>(graph.capacitance(graph.vertex(u1_a))) == Approx(2.0));
+
+    REQUIRE(graph.size_level() == 4);
+    CHECK(graph.loops() == 0);
+    CHECK(graph.depth(graph.vertex(in)) == 0);
+    CHECK(graph.depth(graph.vertex(ff_ck)) == 0);
+    CHECK(graph.depth(graph.vertex(ff_q)) == 1);
+    CHECK(graph.depth(graph.vertex(u1_z)) == 2);
+    CHECK(graph.depth(graph.vertex(ff_d)) == 3);
+    for(std::size_t level = 0; level < graph.size_level(); ++level)
+    {
+        auto vertices = graph.level(level);
+        CHECK(std::is_sorted(vertices.begin(), vertices.end()));
+        for(auto vertex : vertices)
+        {
+            for(auto arc = graph.fanin_begin(vertex); arc != graph.fanin_end(vertex); ++arc)
+            {
+                CHECK(graph.target(arc) == vertex);
+                CHECK(graph.depth(graph.source(arc)) < level);
+            }
+        }
+    }
+
+    auto u1_arc = graph.fanin_begin(graph.vertex(u1_z));
+    CHECK(!graph.net_arc(u1_arc));
+    CHECK(graph.source(u1_arc) == graph.vertex(u1_a));
+    CHECK(graph.net_arc(graph.fanin_begin(graph.vertex(u1_a))));
+
+    REQUIRE(graph.checks().size() == 1);
+    CHECK(graph.checks().front().data == graph.vertex(ff_d));
+    CHECK(graph.checks().front().clock == graph.vertex(ff_ck));
+
+    auto endpoints = graph.endpoints();
+    REQUIRE(endpoints.size() == 2);
+    CHECK(std::count(endpoints.begin(), endpoints.end(), graph.vertex(ff_d)) == 1);
+    CHECK(std::count(endpoints.begin(), endpoints.end(), graph.vertex(out)) == 1);
+}
+
+TEST_CASE_METHOD(TimingGraphFixture, "TimingGraph leaves combinational loops out of the levels", "[timing][timing_graph]")
+{
+    auto in = netlist.add_pin_instance("in");
+    netlist.add_input_pad(in);
+
+    // in -> u0, and the ring u1 -> u2 -> u1
+    auto pins = std::vector<ophidian::circuit::PinInstance>{};
+    for(auto name : {"u0", "u1", "u2"})
+    {
+        auto cell = netlist.add_cell_instance(name);
+        netlist.connect(cell, inv);
+        pins.push_back(add_pin(cell, inv_a, std::string{name} + ":a"));
+        pins.push_back(add_pin(cell, inv_z, std::string{name} + ":z"));
+    }
+    connect("n0", {in, pins[0]});
+    connect("n1", {pins[3], pins[4]});
+    connect("n2", {pins[5], pins[2]});
+
+    auto graph = TimingGraph{netlist, std_cells, library};
+
+    CHECK(graph.size_level() == 3);
+    CHECK(graph.loops() == 4);
+    CHECK(graph.depth(graph.vertex(pins[1])) == 2);
+    for(std::size_t i = 2; i < pins.size(); ++i)
+    {
+        CHECK(graph.depth(graph.vertex(pins[i])) == graph.size_level());
+    }
+}
@@ -1,8 +1,10 @@
 #include <catch.hpp>
+#include <random>
 #include <vector>
 
 
 #include <ophidian/util/LookupTable.h>
+#include <ophidian/util/Units.h>
 
 
 TEST_CASE("lookupTable Floor Test", "[util][lookupTable]")
@@ -48,3 +50,240 @@ TEST_CASE("lookupTable Ceiling Test", "[util][lookupTable]")
     REQUIRE( t.row_values().size() == 4);
     REQUIRE( t.column_values().size() == 1);
 }
+
+namespace
+{
+    template <class Table, class Contents, class Unit>
+    Table make_interpolation_table()
+    {
+        Contents c;
+        c.row_values = {Unit{0.0}, Unit{0.5}, Unit{1.0}, Unit{4.0}};
+        c.column_values = {Unit{1.0}, Unit{2.0}, Unit{8.0}};
+        c.values = {
+            {Unit{1.0}, Unit{2.0}, Unit{5.0}},
+            {Unit{1.5}, Unit{3.0}, Unit{7.0}},
+            {Unit{2.0}, Unit{4.0}, Unit{9.0}},
+            {Unit{6.0}, Unit{8.0}, Unit{20.0}}
+        };
+
+        return Table(c);
+    }
+}
+
+TEST_CASE("lookupTable Interpolation batch matches scalar compute", "[util][lookupTable]")
+{
+    using namespace ophidian::util;
+    using unit_type = double;
+    using strategy = InterpolationStrategy<unit_type, unit_type, unit_type>;
+    using table = LookupTable<unit_type, unit_type, unit_type, strategy>;
+    using contents = TableContents<unit_type, unit_type, unit_type>;
+
+    static_assert(table::has_raw_batch_kernel, "double interpolation tables must use the raw kernel");
+
+    auto t = make_interpolation_table<table, contents, unit_type>();
+
+    // covers points below, inside, on and above both axes, and a tail that is not a multiple of the vector width
+    std::vector<unit_type> rows, columns;
+    for(auto r : {-1.0, 0.0, 0.25, 0.5, 0.75, 1.0, 2.5, 4.0, 6.0})
+    {
+        for(auto c : {-3.0, 1.0, 1.5, 2.0, 5.0, 8.0, 10.0})
+        {
+            rows.push_back(r);
+            columns.push_back(c);
+        }
+    }
+
+    std::vector<unit_type> out(rows.size());
+    t.compute_batch(rows.data(), columns.data(), out.data(), rows.size());
+
+    for(std::size_t i = 0; i < rows.size(); ++i)
+    {
+        CHECK(out[i] == Approx(t.compute(rows[i], columns[i])));
+    }
+}
+
+TEST_CASE("lookupTable vector kernels match the scalar kernel", "[util][lookupTable]")
+{
+#if defined(OPHIDIAN_LOOKUP_TABLE_X86_KERNELS)
+    using namespace ophidian::util::detail;
+
+    auto rows = std::vector<double>{0.0, 0.5, 1.0, 4.0, 7.5};
+    auto columns = std::vector<double>{1.0, 2.0, 8.0, 9.0};
+    auto values = std::vector<double>(rows.size() * columns.size());
+    for(std::size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = 0.5 * i * i - 3.0 * i + 1.0;
+    }
+    auto view = BilinearTableView{rows.data(), rows.size(), columns.data(), columns.size(), values.data()};
+
+    // points below, inside and above both axes, with a tail shorter than the vector width
+    auto generator = std::mt19937{3};
+    auto row = std::uniform_real_distribution<double>{-2.0, 10.0};
+    auto column = std::uniform_real_distribution<double>{-1.0, 12.0};
+    auto rv = std::vector<double>(1003), cv = std::vector<double>(1003);
+    for(std::size_t i = 0; i < rv.size(); ++i)
+    {
+        rv[i] = i % 17 == 0 ? rows[i % rows.size()] : row(generator);
+        cv[i] = i % 13 == 0 ? columns[i % columns.size()] : column(generator);
+    }
+
+    auto check = [&](void (*kernel)(const BilinearTableView &, const double *, const double *, double *, std::size_t &, std::size_t)){
+        auto out = std::vector<double>(rv.size(), 0.0);
+        std::size_t i = 0;
+        kernel(view, rv.data(), cv.data(), out.data(), i, rv.size());
+        CHECK(i > rv.size() - 8);
+        for(std::size_t j = 0; j < i; ++j)
+        {
+            CHECK(out[j] == Approx(bilinear(view, rv[j], cv[j])));
+        }
+    };
+
+    if(batch_kernel() != BatchKernel::SCALAR)
+    {
+        check(bilinear_batch_avx2);
+    }
+    if(batch_kernel() == BatchKernel::AVX512)
+    {
+        check(bilinear_batch_avx512);
+    }
+
+    auto out = std::vector<double>(rv.size());
+    bilinear_batch(view, rv.data(), cv.data(), out.data(), rv.size());
+    for(std::size_t j = 0; j < rv.size(); ++j)
+    {
+        CHECK(out[j] == Approx(bilinear(view, rv[j], cv[j])));
+    }
+#endif
+}
+
+TEST_CASE("lookupTable Interpolation batch with database units", "[util][lookupTable]")
+{
+    using namespace ophidian::util;
+    using unit_type = database_unit_t;
+    using strategy = InterpolationStrategy<unit_type, unit_type, unit_type>;
+    using table = LookupTable<unit_type, unit_type, unit_type, strategy>;
+    using contents = TableContents<unit_type, unit_type, unit_type>;
+
+    static_assert(is_raw_double<unit_type>::value, "database_unit_t must be readable as a raw double");
+    static_assert(table::has_raw_batch_kernel, "database_unit_t interpolation tables must use the raw kernel");
+
+    auto t = make_interpolation_table<table, contents, unit_type>();
+
+    auto rows = std::vector<unit_type>{unit_type{0.25}, unit_type{3.0}, unit_type{-1.0}, unit_type{5.0}, unit_type{1.0}};
+    auto columns = std::vector<unit_type>{unit_type{1.5}, unit_type{4.0}, unit_type{0.0}, unit_type{9.0}, unit_type{2.0}};
+
+    std::vector<unit_type> out(rows.size());
+    t.compute_batch(rows.data(), columns.data(), out.data(), rows.size());
+
+    for(std::size_t i = 0; i < rows.size(); ++i)
+    {
+        CHECK(units::unit_cast<double>(out[i]) == Approx(units::unit_cast<double>(t.compute(rows[i], columns[i]))));
+    }
+}
+
+TEST_CASE("lookupTable Floor batch falls back to the strategy", "[util][lookupTable]")
+{
+    using namespace ophidian::util;
+    using unit_type = double;
+    using strategy = FloorStrategy<unit_type, unit_type, unit_type>;
+    using table = LookupTable<unit_type, unit_type, unit_type, strategy>;
+    using contents = TableContents<unit_type, unit_type, unit_type>;
+
+    static_assert(!table::has_raw_batch_kernel, "only interpolation tables have a raw kernel");
+
+    contents c;
+    c.row_values = {0.0, 0.1, 0.75, 1.5};
+    c.column_values = {0.0};
+    c.values = {{0.06}, {0.1}, {0.25}, {0.45}};
+
+    table t = table(c);
+
+    auto rows = std::vector<unit_type>{0.75, 0.05, 2.0};
+    auto columns = std::vector<unit_type>{0.0, 0.0, 0.0};
+    std::vector<unit_type> out(rows.size());
+    t.compute_batch(rows.data(), columns.data(), out.data(), rows.size());
+
+    for(std::size_t i = 0; i < rows.size(); ++i)
+    {
+        CHECK(out[i] == t.compute(rows[i], columns[i]));
+    }
+}
+
+namespace
+{
+    constexpr double constexpr_interpolation()
+    {
+        using namespace ophidian::util;
+        using strategy = InterpolationStrategy<double, double, double>;
+
+        auto c = FixedTableContents<double, double, double, 2, 2>{};
+        c.row_values.push_back(0.0);
+        c.row_values.push_back(1.0);
+        c.column_values.push_back(0.0);
+        c.column_values.push_back(2.0);
+        auto first = FixedVector<double, 2>{};
+        first.push_back(0.0);
+        first.push_back(2.0);
+        auto second = FixedVector<double, 2>{};
+        second.push_back(4.0);
+        second.push_back(6.0);
+        c.values.push_back(first);
+        c.values.push_back(second);
+
+        return strategy::compute(0.5, 1.0, c);
+    }
+}
+
+TEST_CASE("lookupTable fixed size matches the dynamic table", "[util][lookupTable]")
+{
+    using namespace ophidian::util;
+    using unit_type = double;
+    using strategy = InterpolationStrategy<unit_type, unit_type, unit_type>;
+    using table = LookupTable<unit_type, unit_type, unit_type, strategy>;
+    using fixed_table = LookupTable<unit_type, unit_type, unit_type, FixedSize<strategy, 4, 4>>;
+    using contents = TableContents<unit_type, unit_type, unit_type>;
+
+    static_assert(constexpr_interpolation() == 3.0, "axis search and interpolation must be constant expressions");
+
+    auto t = make_interpolation_table<table, contents, unit_type>();
+    auto fixed = make_interpolation_table<fixed_table, contents, unit_type>();
+
+    CHECK(fixed.is_fixed());
+    CHECK(fixed.row_values().size() == 4);
+    CHECK(fixed.column_values().size() == 3);
+    CHECK(fixed.row_values().back() == 4.0);
+
+    auto rows = std::vector<unit_type>{0.25, 3.0, -1.0, 5.0, 1.0, 0.5};
+    auto columns = std::vector<unit_type>{1.5, 4.0, 0.0, 9.0, 2.0, 8.0};
+    for(std::size_t i = 0; i < rows.size(); ++i)
+    {
+        CHECK(fixed.compute(rows[i], columns[i]) == Approx(t.compute(rows[i], columns[i])));
+    }
+}
+
+TEST_CASE("lookupTable fixed size keeps larger tables on the heap", "[util][lookupTable]")
+{
+    using namespace ophidian::util;
+    using unit_type = database_unit_t;
+    using strategy = FloorStrategy<unit_type, unit_type, unit_type>;
+    using table = LookupTable<unit_type, unit_type, unit_type, strategy>;
+    using fixed_table = LookupTable<unit_type, unit_type, unit_type, FixedSize<strategy, 2, 1>>;
+    using contents = TableContents<unit_type, unit_type, unit_type>;
+
+    contents c;
+    c.row_values = {unit_type{0}, unit_type{100}, unit_type{750}, unit_type{1500}};
+    c.column_values = {unit_type{0}};
+    c.values = {{unit_type{60}}, {unit_type{100}}, {unit_type{250}}, {unit_type{450}}};
+
+    auto t = table(c);
+    auto fixed = fixed_table(c);
+
+    CHECK(!fixed.is_fixed());
+    CHECK(fixed.row_values().size() == 4);
+    CHECK(fixed.column_values().size() == 1);
+
+    for(auto row : {unit_type{0}, unit_type{50}, unit_type{800}, unit_type{2000}})
+    {
+        CHECK(fixed.compute(row, unit_type{0}) == t.compute(row, unit_type{0}));
+    }
+}
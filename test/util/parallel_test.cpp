@@ -0,0 +1,87 @@
+#include <catch.hpp>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ophidian/util/Parallel.h>
+
+using namespace ophidian::util;
+
+TEST_CASE("parallel_for calls every index once", "[util][parallel]")
+{
+    auto counts = std::vector<std::atomic<int>>(1000);
+    for(auto round = 0; round < 50; ++round)
+    {
+        parallel_for(0, counts.size(), [&](std::size_t i){ ++counts[i]; }, 4, 7);
+    }
+    for(const auto & count : counts)
+    {
+        CHECK(count == 50);
+    }
+}
+
+TEST_CASE("parallel_for reuses the pool threads", "[util][parallel]")
+{
+    auto ids = std::set<std::thread::id>{};
+    auto threads = std::set<std::size_t>{};
+    auto mutex = std::mutex{};
+    for(auto round = 0; round < 20; ++round)
+    {
+        parallel_for(0, 64, [&](std::size_t, std::size_t thread){
+            auto lock = std::lock_guard<std::mutex>{mutex};
+            ids.insert(std::this_thread::get_id());
+            threads.insert(thread);
+        }, 4);
+    }
+    CHECK(*threads.rbegin() < 4);
+
+    // the caller and at most three persistent workers
+    CHECK(ids.size() <= 4);
+}
+
+TEST_CASE("parallel_for supports nested and concurrent loops", "[util][parallel]")
+{
+    auto sum = std::atomic<std::size_t>{0};
+    parallel_for(0, 8, [&](std::size_t i){
+        parallel_for(0, 100, [&](std::size_t j){ sum += i * 100 + j; }, 4);
+    }, 4);
+    CHECK(sum == 799 * 800 / 2);
+
+    auto total = std::atomic<std::size_t>{0};
+    auto callers = std::vector<std::thread>{};
+    for(auto caller = 0; caller < 3; ++caller)
+    {
+        callers.emplace_back([&]{
+            for(auto round = 0; round < 20; ++round)
+            {
+                parallel_for(0, 100, [&](std::size_t){ ++total; }, 3);
+            }
+        });
+    }
+    for(auto & caller : callers)
+    {
+        caller.join();
+    }
+    CHECK(total == 3 * 20 * 100);
+}
+
+TEST_CASE("parallel_for rethrows the first exception", "[util][parallel]")
+{
+    auto run = []{
+        parallel_for(0, 1000, [](std::size_t i){
+            if(i == 500)
+            {
+                throw std::runtime_error{"failed"};
+            }
+        }, 4);
+    };
+    CHECK_THROWS_AS(run(), std::runtime_error);
+
+    // the pool is still usable afterwards
+    auto count = std::atomic<int>{0};
+    parallel_for(0, 100, [&](std::size_t){ ++count; }, 4);
+    CHECK(count == 100);
+}